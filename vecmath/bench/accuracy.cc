@@ -0,0 +1,375 @@
+/// @file accuracy.cc
+/// @brief Accuracy versus speed regression harness
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Each function is swept over its input domain (every float when
+/// "--samples 0", else evenly spaced floats), its results compared against
+/// a double precision reference: max/mean ulp and max relative error are
+/// reported along with its throughput.
+///
+/// Usage:
+///   vecmath_accuracy [--samples N] [--baseline FILE [--check-throughput]]
+///                    [--update FILE]
+///
+/// With "--baseline" the process fails whenever a function exceeds its
+/// error budget (or throughput budget, if asked for) from the given file.
+/// "--update" writes a new baseline from the current measurements.
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "vecmath/bench/bench.h"
+
+#include "vecmath/inc/approximations.h"
+
+using vecmath::ApproxVectorMath;
+
+typedef PlatformVectorMath::FloatVec FloatVec;
+typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+/// @brief Processing block length, for both the sweep and throughput
+static const unsigned kBlockSize = 1024;
+/// @brief Default number of swept values per function
+static const unsigned kDefaultSamples = 1 << 20;
+
+/// @brief Some domain boundaries
+static const float kMinNormal = std::numeric_limits<float>::min();
+static const float kMaxFloat = std::numeric_limits<float>::max();
+/// 2^125: beyond this, reciprocals get close to denormals
+/// (flushed by the hardware estimates and -Ofast)
+static const float kMaxReciprocal = 4.25352959e37f;
+/// 2^-125: below this, refined square roots may get flushed to zero (-Ofast)
+static const float kMinSqrtFast = 2.3509887e-38f;
+static const float kMaxRounding = 1e9f;
+
+struct Measurement {
+  std::string name;
+  double max_ulp;
+  double mean_ulp;
+  double max_relative;
+  double msamples_per_second;
+};
+
+struct Budget {
+  double max_ulp;
+  double max_relative;
+  double min_msamples_per_second;
+};
+
+/// @brief Apply a FloatVec functor over a whole block
+template <typename TypeFunctor>
+void ApplyBlock(TypeFunctor functor,
+                const float* const input,
+                float* const output,
+                const unsigned length) {
+  for (unsigned i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+    PlatformVectorMath::Store(&output[i],
+                              functor(PlatformVectorMath::Fill(&input[i])));
+  }
+}
+
+/// @brief Sweep the functor over [begin ; end], measure its throughput
+///
+/// @param[in]  name   Function name, as written in the baseline file
+/// @param[in]  functor   FloatVec function to be evaluated
+/// @param[in]  reference   Double precision reference
+/// @param[in]  begin   Domain lower bound
+/// @param[in]  end   Domain upper bound
+/// @param[in]  samples   Number of swept values (0 for all of them)
+template <typename TypeFunctor>
+Measurement Sweep(const char* const name,
+                  TypeFunctor functor,
+                  double (*reference)(double),
+                  const float begin,
+                  const float end,
+                  const unsigned samples) {
+  alignas(16) float input[kBlockSize];
+  alignas(16) float output[kBlockSize];
+  const std::int64_t first(FloatToOrdered(begin));
+  const std::int64_t last(FloatToOrdered(end));
+  const std::int64_t count(last - first + 1);
+  const std::int64_t stride(samples == 0
+                            ? 1
+                            : std::max<std::int64_t>(1, count / samples));
+
+  Measurement measurement = {name, 0.0, 0.0, 0.0, 0.0};
+  double ulp_sum(0.0);
+  std::uint64_t swept(0);
+  std::int64_t current(first);
+  while (current <= last) {
+    unsigned filled(0);
+    while (filled < kBlockSize) {
+      input[filled] = OrderedToFloat(
+        static_cast<std::int32_t>(std::min(current, last)));
+      current += stride;
+      filled += 1;
+    }
+    ApplyBlock(functor, input, output, kBlockSize);
+    for (unsigned i(0); i < kBlockSize; ++i) {
+      const double expected(reference(input[i]));
+      const double ulp(UlpDistance(output[i], expected));
+      measurement.max_ulp = std::max(measurement.max_ulp, ulp);
+      ulp_sum += ulp;
+      if (expected != 0.0) {
+        measurement.max_relative = std::max(
+          measurement.max_relative,
+          std::fabs((output[i] - expected) / expected));
+      }
+    }
+    swept += kBlockSize;
+  }
+  measurement.mean_ulp = ulp_sum / static_cast<double>(swept);
+
+  // Throughput over values evenly spread over the domain
+  for (unsigned i(0); i < kBlockSize; ++i) {
+    input[i] = OrderedToFloat(
+      static_cast<std::int32_t>(first + (count - 1) * i / kBlockSize));
+  }
+  measurement.msamples_per_second = MeasureThroughput(
+    [&]() {
+      ApplyBlock(functor, input, output, kBlockSize);
+      kBenchSink = output[kBlockSize - 1];
+    },
+    kBlockSize);
+  return measurement;
+}
+
+// Double precision references
+static double ReferenceReciprocal(double x) { return 1.0 / x; }
+static double ReferenceReciprocalSqrt(double x) { return 1.0 / std::sqrt(x); }
+static double ReferenceSqrt(double x) { return std::sqrt(x); }
+static double ReferenceDiv(double x) { return static_cast<double>(1.7f) / x; }
+static double ReferenceRound(double x) { return std::nearbyint(x); }
+static double ReferenceTrunc(double x) { return std::trunc(x); }
+static double ReferenceFloor(double x) { return std::floor(x); }
+static double ReferenceCeil(double x) { return std::ceil(x); }
+static double ReferenceAtan(double x) { return std::atan(x); }
+static double ReferenceLog2(double x) { return std::log2(x); }
+static double ReferenceExp2(double x) { return std::exp2(x); }
+
+/// @brief Measure all functions
+static std::vector<Measurement> MeasureAll(const unsigned samples) {
+  std::vector<Measurement> results;
+  results.push_back(Sweep("Reciprocal",
+    [](FloatVecRead x) { return PlatformVectorMath::Reciprocal(x); },
+    &ReferenceReciprocal, kMinNormal, kMaxReciprocal, samples));
+  results.push_back(Sweep("ReciprocalFast<0>",
+    [](FloatVecRead x) { return PlatformVectorMath::ReciprocalFast<0>(x); },
+    &ReferenceReciprocal, kMinNormal, kMaxReciprocal, samples));
+  results.push_back(Sweep("ReciprocalFast<1>",
+    [](FloatVecRead x) { return PlatformVectorMath::ReciprocalFast<1>(x); },
+    &ReferenceReciprocal, kMinNormal, kMaxReciprocal, samples));
+  results.push_back(Sweep("ReciprocalFast<2>",
+    [](FloatVecRead x) { return PlatformVectorMath::ReciprocalFast<2>(x); },
+    &ReferenceReciprocal, kMinNormal, kMaxReciprocal, samples));
+  results.push_back(Sweep("ReciprocalSqrt",
+    [](FloatVecRead x) { return PlatformVectorMath::ReciprocalSqrt(x); },
+    &ReferenceReciprocalSqrt, kMinNormal, kMaxFloat, samples));
+  results.push_back(Sweep("ReciprocalSqrtFast<0>",
+    [](FloatVecRead x) { return PlatformVectorMath::ReciprocalSqrtFast<0>(x); },
+    &ReferenceReciprocalSqrt, kMinNormal, kMaxFloat, samples));
+  results.push_back(Sweep("ReciprocalSqrtFast<1>",
+    [](FloatVecRead x) { return PlatformVectorMath::ReciprocalSqrtFast<1>(x); },
+    &ReferenceReciprocalSqrt, kMinNormal, kMaxReciprocal, samples));
+  results.push_back(Sweep("ReciprocalSqrtFast<2>",
+    [](FloatVecRead x) { return PlatformVectorMath::ReciprocalSqrtFast<2>(x); },
+    &ReferenceReciprocalSqrt, kMinNormal, kMaxReciprocal, samples));
+  results.push_back(Sweep("Sqrt",
+    [](FloatVecRead x) { return PlatformVectorMath::Sqrt(x); },
+    &ReferenceSqrt, 0.0f, kMaxFloat, samples));
+  results.push_back(Sweep("SqrtFast<1>",
+    [](FloatVecRead x) { return PlatformVectorMath::SqrtFast<1>(x); },
+    &ReferenceSqrt, kMinSqrtFast, kMaxReciprocal, samples));
+  results.push_back(Sweep("SqrtFast<2>",
+    [](FloatVecRead x) { return PlatformVectorMath::SqrtFast<2>(x); },
+    &ReferenceSqrt, kMinSqrtFast, kMaxReciprocal, samples));
+  results.push_back(Sweep("DivFast<1>",
+    [](FloatVecRead x) {
+      return PlatformVectorMath::DivFast<1>(PlatformVectorMath::Fill(1.7f), x);
+    },
+    &ReferenceDiv, kMinNormal, kMaxReciprocal, samples));
+  results.push_back(Sweep("Round",
+    [](FloatVecRead x) { return PlatformVectorMath::Round(x); },
+    &ReferenceRound, -kMaxRounding, kMaxRounding, samples));
+  results.push_back(Sweep("Trunc",
+    [](FloatVecRead x) { return PlatformVectorMath::Trunc(x); },
+    &ReferenceTrunc, -kMaxRounding, kMaxRounding, samples));
+  results.push_back(Sweep("Floor",
+    [](FloatVecRead x) { return PlatformVectorMath::Floor(x); },
+    &ReferenceFloor, -kMaxRounding, kMaxRounding, samples));
+  results.push_back(Sweep("Ceil",
+    [](FloatVecRead x) { return PlatformVectorMath::Ceil(x); },
+    &ReferenceCeil, -kMaxRounding, kMaxRounding, samples));
+  results.push_back(Sweep("Atan",
+    [](FloatVecRead x) { return ApproxVectorMath::Atan(x); },
+    &ReferenceAtan, -kMaxFloat, kMaxFloat, samples));
+  results.push_back(Sweep("Log2",
+    [](FloatVecRead x) { return ApproxVectorMath::Log2(x); },
+    &ReferenceLog2, kMinNormal, kMaxFloat, samples));
+  results.push_back(Sweep("Exp2",
+    [](FloatVecRead x) { return ApproxVectorMath::Exp2(x); },
+    &ReferenceExp2, -126.0f, 127.0f, samples));
+  return results;
+}
+
+/// @brief Read a baseline file: one "name max_ulp max_relative min_msps"
+/// line per function, '#' starting a comment line
+static bool ReadBaseline(const std::string& path,
+                         std::map<std::string, Budget>* const budgets) {
+  std::ifstream file(path.c_str());
+  if (!file) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream stream(line);
+    std::string name;
+    Budget budget;
+    if (stream >> name
+               >> budget.max_ulp
+               >> budget.max_relative
+               >> budget.min_msamples_per_second) {
+      (*budgets)[name] = budget;
+    }
+  }
+  return true;
+}
+
+/// @brief Write a baseline from the given measurements, with some margin
+static bool WriteBaseline(const std::string& path,
+                          const std::vector<Measurement>& results) {
+  std::ofstream file(path.c_str());
+  if (!file) {
+    return false;
+  }
+  file << "# Accuracy and throughput budgets, checked by vecmath_accuracy\n"
+       << "# Generated with \"vecmath_accuracy --update\": measured errors + 25%,"
+       << " half the measured throughput\n"
+       << "# name max_ulp max_relative_error min_msamples_per_second\n";
+  for (std::vector<Measurement>::const_iterator result(results.begin());
+       result != results.end();
+       ++result) {
+    file << result->name << ' '
+         << std::setprecision(3) << result->max_ulp * 1.25 << ' '
+         << result->max_relative * 1.25 << ' '
+         << std::fixed << std::setprecision(0)
+         << result->msamples_per_second * 0.5
+         << std::defaultfloat << '\n';
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  unsigned samples(kDefaultSamples);
+  std::string baseline_path;
+  std::string update_path;
+  bool check_throughput(false);
+  for (int i(1); i < argc; ++i) {
+    const std::string argument(argv[i]);
+    if (argument == "--samples" && i + 1 < argc) {
+      samples = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (argument == "--baseline" && i + 1 < argc) {
+      baseline_path = argv[++i];
+    } else if (argument == "--update" && i + 1 < argc) {
+      update_path = argv[++i];
+    } else if (argument == "--check-throughput") {
+      check_throughput = true;
+    } else {
+      std::cerr << "Unknown argument: " << argument << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+
+  const std::vector<Measurement> results(MeasureAll(samples));
+  std::cout << std::left << std::setw(24) << "function"
+            << std::right << std::setw(12) << "max ulp"
+            << std::setw(12) << "mean ulp"
+            << std::setw(14) << "max rel err"
+            << std::setw(14) << "MSamples/s" << '\n';
+  for (std::vector<Measurement>::const_iterator result(results.begin());
+       result != results.end();
+       ++result) {
+    std::cout << std::left << std::setw(24) << result->name
+              << std::right << std::setw(12) << std::setprecision(3)
+              << result->max_ulp
+              << std::setw(12) << result->mean_ulp
+              << std::setw(14) << result->max_relative
+              << std::setw(14) << std::fixed << std::setprecision(1)
+              << result->msamples_per_second << std::defaultfloat << '\n';
+  }
+
+  if (!update_path.empty() && !WriteBaseline(update_path, results)) {
+    std::cerr << "Could not write " << update_path << '\n';
+    return EXIT_FAILURE;
+  }
+
+  if (baseline_path.empty()) {
+    return EXIT_SUCCESS;
+  }
+  std::map<std::string, Budget> budgets;
+  if (!ReadBaseline(baseline_path, &budgets)) {
+    std::cerr << "Could not read " << baseline_path << '\n';
+    return EXIT_FAILURE;
+  }
+  bool regression(false);
+  for (std::vector<Measurement>::const_iterator result(results.begin());
+       result != results.end();
+       ++result) {
+    const std::map<std::string, Budget>::const_iterator budget(
+      budgets.find(result->name));
+    if (budget == budgets.end()) {
+      std::cerr << result->name << ": no budget in " << baseline_path << '\n';
+      regression = true;
+      continue;
+    }
+    if (result->max_ulp > budget->second.max_ulp) {
+      std::cerr << result->name << ": max error " << result->max_ulp
+                << " ulp exceeds its budget (" << budget->second.max_ulp
+                << ")\n";
+      regression = true;
+    }
+    if (result->max_relative > budget->second.max_relative) {
+      std::cerr << result->name << ": max relative error "
+                << result->max_relative << " exceeds its budget ("
+                << budget->second.max_relative << ")\n";
+      regression = true;
+    }
+    if (check_throughput
+        && result->msamples_per_second
+           < budget->second.min_msamples_per_second) {
+      std::cerr << result->name << ": throughput "
+                << result->msamples_per_second
+                << " MSamples/s is below its budget ("
+                << budget->second.min_msamples_per_second << ")\n";
+      regression = true;
+    }
+  }
+  return regression ? EXIT_FAILURE : EXIT_SUCCESS;
+}
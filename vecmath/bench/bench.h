@@ -0,0 +1,110 @@
+/// @file bench.h
+/// @brief Benchmarks and accuracy harness common include file
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_BENCH_BENCH_H_
+#define VECMATH_BENCH_BENCH_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "vecmath/inc/maths.h"
+
+using vecmath::PlatformVectorMath;
+
+/// @brief Prevents the compiler from optimizing away a benchmark result
+static volatile float kBenchSink;
+
+/// @brief Run the given functor repeatedly for at least the given duration,
+/// return the achieved throughput in millions of samples per second
+///
+/// @param[in]  functor   Function processing "samples_per_call" samples
+/// @param[in]  samples_per_call    Samples processed by each functor call
+/// @param[in]  min_seconds   Minimum measurement duration
+template <typename TypeFunctor>
+double MeasureThroughput(TypeFunctor functor,
+                         const std::uint64_t samples_per_call,
+                         const double min_seconds = 0.02) {
+  typedef std::chrono::steady_clock Clock;
+  // Warm-up
+  functor();
+  std::uint64_t calls(0);
+  const Clock::time_point start(Clock::now());
+  double elapsed(0.0);
+  do {
+    for (unsigned i(0); i < 16; ++i) {
+      functor();
+    }
+    calls += 16;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  } while (elapsed < min_seconds);
+  return static_cast<double>(calls * samples_per_call) / elapsed * 1e-6;
+}
+
+/// @brief Distance, in units in the last place of the single precision
+/// rounded reference, between a result and its reference
+///
+/// Non-finite values are detected bitwise (-Ofast implies finite maths),
+/// and the ulp is computed in double precision (-Ofast flushes denormals)
+inline double UlpDistance(const float actual, const double reference) {
+  const float rounded(static_cast<float>(reference));
+  std::uint32_t actual_bits;
+  std::uint32_t rounded_bits;
+  std::memcpy(&actual_bits, &actual, sizeof(actual_bits));
+  std::memcpy(&rounded_bits, &rounded, sizeof(rounded_bits));
+  const std::uint32_t kExponentMask(0x7f800000u);
+  if ((actual_bits & kExponentMask) == kExponentMask
+      || (rounded_bits & kExponentMask) == kExponentMask) {
+    return actual_bits == rounded_bits
+           ? 0.0
+           : std::numeric_limits<double>::infinity();
+  }
+  int exponent(0);
+  std::frexp(reference, &exponent);
+  // Single precision ulp, clamped to the smallest denormal
+  const double ulp(std::ldexp(1.0, std::max(exponent - 24, -149)));
+  return std::fabs(static_cast<double>(actual) - reference) / ulp;
+}
+
+/// @brief Map an ordered integer onto floats, so that consecutive integers
+/// map onto consecutive floats (0 maps onto +0.0f)
+inline float OrderedToFloat(const std::int32_t ordered) {
+  const std::uint32_t bits(ordered >= 0
+                           ? static_cast<std::uint32_t>(ordered)
+                           : (0x80000000u | static_cast<std::uint32_t>(-ordered)));
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/// @brief Inverse of OrderedToFloat
+inline std::int32_t FloatToOrdered(const float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (bits & 0x80000000u)
+         ? -static_cast<std::int32_t>(bits & 0x7fffffffu)
+         : static_cast<std::int32_t>(bits);
+}
+
+#endif  // VECMATH_BENCH_BENCH_H_
@@ -0,0 +1,150 @@
+/// @file fft.cc
+/// @brief FFT benchmark, against a scalar radix-2 baseline
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Usage:
+///   vecmath_bench_fft
+///
+/// Reports throughput in MSamples/s (complex values per second for complex
+/// transforms, real values for real ones) for power-of-two sizes from 64 to
+/// 65536, plus a few mixed radix sizes (no scalar baseline for those).
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "vecmath/bench/bench.h"
+
+#include "vecmath/inc/fft.h"
+
+using vecmath::AlignedVector;
+using vecmath::ComplexFFT;
+using vecmath::RealFFT;
+
+/// @brief Scalar baseline: iterative radix-2 FFT with precomputed twiddles
+class ScalarFFT {
+ public:
+  explicit ScalarFFT(const unsigned int size)
+      : size_(size),
+        twiddles_(size) {
+    const double kTwoPi(6.283185307179586);
+    for (unsigned int k(0); k < size_ / 2; ++k) {
+      twiddles_[2 * k] = static_cast<float>(std::cos(-kTwoPi * k / size_));
+      twiddles_[2 * k + 1] = static_cast<float>(std::sin(-kTwoPi * k / size_));
+    }
+  }
+
+  void Forward(float* const data) const {
+    // Bit reversal
+    for (unsigned int i(1), j(0); i < size_; ++i) {
+      unsigned int bit(size_ >> 1);
+      for (; j & bit; bit >>= 1) {
+        j ^= bit;
+      }
+      j ^= bit;
+      if (i < j) {
+        std::swap(data[2 * i], data[2 * j]);
+        std::swap(data[2 * i + 1], data[2 * j + 1]);
+      }
+    }
+    for (unsigned int length(2); length <= size_; length <<= 1) {
+      const unsigned int half(length / 2);
+      const unsigned int stride(size_ / length);
+      for (unsigned int block(0); block < size_; block += length) {
+        for (unsigned int j(0); j < half; ++j) {
+          float* const even(&data[2 * (block + j)]);
+          float* const odd(&data[2 * (block + j + half)]);
+          const float w_re(twiddles_[2 * j * stride]);
+          const float w_im(twiddles_[2 * j * stride + 1]);
+          const float re(odd[0] * w_re - odd[1] * w_im);
+          const float im(odd[0] * w_im + odd[1] * w_re);
+          odd[0] = even[0] - re;
+          odd[1] = even[1] - im;
+          even[0] += re;
+          even[1] += im;
+        }
+      }
+    }
+  }
+
+ private:
+  unsigned int size_;
+  std::vector<float> twiddles_;
+};
+
+int main() {
+  std::cout << std::setw(8) << "size"
+            << std::setw(14) << "scalar"
+            << std::setw(14) << "complex"
+            << std::setw(10) << "speedup"
+            << std::setw(14) << "real" << '\n';
+  for (unsigned int size(64); size <= 65536; size *= 2) {
+    AlignedVector<float> input(2 * size);
+    for (unsigned int i(0); i < input.size(); ++i) {
+      input[i] = std::sin(0.1f * i);
+    }
+    AlignedVector<float> data(input);
+    const ScalarFFT scalar(size);
+    const ComplexFFT fft(size);
+    const RealFFT real_fft(size);
+    // Each transform is applied on a fresh copy of the input
+    const double scalar_throughput(MeasureThroughput([&]() {
+      std::copy(input.begin(), input.end(), data.begin());
+      scalar.Forward(&data[0]);
+      kBenchSink = data[1];
+    }, size));
+    const double complex_throughput(MeasureThroughput([&]() {
+      std::copy(input.begin(), input.end(), data.begin());
+      fft.Forward(&data[0]);
+      kBenchSink = data[1];
+    }, size));
+    const double real_throughput(MeasureThroughput([&]() {
+      std::copy(input.begin(), input.begin() + size, data.begin());
+      real_fft.Forward(&data[0]);
+      kBenchSink = data[1];
+    }, size));
+    std::cout << std::setw(8) << size
+              << std::fixed << std::setprecision(1)
+              << std::setw(14) << scalar_throughput
+              << std::setw(14) << complex_throughput
+              << std::setw(10) << complex_throughput / scalar_throughput
+              << std::setw(14) << real_throughput << '\n';
+  }
+
+  std::cout << "\nMixed radix sizes\n";
+  const unsigned int kMixedSizes[] = {240, 480, 960, 1920, 3840};
+  for (unsigned int size : kMixedSizes) {
+    const AlignedVector<float> input(2 * size, 0.5f);
+    AlignedVector<float> data(input);
+    const ComplexFFT fft(size);
+    const double complex_throughput(MeasureThroughput([&]() {
+      std::copy(input.begin(), input.end(), data.begin());
+      fft.Forward(&data[0]);
+      kBenchSink = data[1];
+    }, size));
+    std::cout << std::setw(8) << size
+              << std::setw(14) << "-"
+              << std::fixed << std::setprecision(1)
+              << std::setw(14) << complex_throughput << '\n';
+  }
+  return 0;
+}
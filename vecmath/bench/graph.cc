@@ -0,0 +1,126 @@
+/// @file bench/graph.cc
+/// @brief Processing graph scaling benchmark
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Usage:
+///   vecmath_bench_graph
+///
+/// Reports throughput in MSamples/s (per graph input) of a wide mixing
+/// graph, for each worker count and scheduling mode, compared to the same
+/// graph processed by the calling thread only.
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "vecmath/bench/bench.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/graph.h"
+
+using vecmath::AlignedVector;
+using vecmath::GainNode;
+using vecmath::GraphNode;
+using vecmath::MixNode;
+using vecmath::ProcessingGraph;
+using vecmath::SchedulingMode;
+
+static const unsigned int kInputs = 64;
+static const unsigned int kBranches = 4;
+static const unsigned int kBusses = 16;
+static const unsigned int kBlockLength = 256;
+
+// Inputs, each through a chain of gains into several busses, mixed down:
+// kInputs * kBranches * 2 + kBusses + 1 nodes
+static void Build(ProcessingGraph* const graph) {
+  std::vector<unsigned int> inputs;
+  for (unsigned int i(0); i < kInputs; ++i) {
+    inputs.push_back(graph->AddInput());
+  }
+  std::vector<std::vector<unsigned int> > busses(kBusses);
+  for (unsigned int i(0); i < kInputs; ++i) {
+    for (unsigned int branch(0); branch < kBranches; ++branch) {
+      const unsigned int gain(graph->AddNode(
+        std::unique_ptr<GraphNode>(new GainNode(0.5f)), {inputs[i]}));
+      const unsigned int trim(graph->AddNode(
+        std::unique_ptr<GraphNode>(new GainNode(0.25f)), {gain}));
+      busses[(i + branch) % kBusses].push_back(trim);
+    }
+  }
+  std::vector<unsigned int> bus_ids;
+  for (const std::vector<unsigned int>& bus : busses) {
+    bus_ids.push_back(graph->AddNode(
+      std::unique_ptr<GraphNode>(
+        new MixNode(std::vector<float>(bus.size(), 1.0f))),
+      bus));
+  }
+  graph->AddOutput(graph->AddNode(
+    std::unique_ptr<GraphNode>(
+      new MixNode(std::vector<float>(kBusses, 1.0f))),
+    bus_ids));
+  graph->Prepare();
+}
+
+static double Measure(const unsigned int workers, const SchedulingMode mode) {
+  ProcessingGraph graph(kBlockLength, workers, mode);
+  Build(&graph);
+  AlignedVector<float> input(kInputs * kBlockLength, 0.125f);
+  AlignedVector<float> output(kBlockLength);
+  std::vector<const float*> inputs;
+  for (unsigned int i(0); i < kInputs; ++i) {
+    inputs.push_back(&input[i * kBlockLength]);
+  }
+  float* outputs[] = {&output[0]};
+  return MeasureThroughput([&]() {
+    graph.Process(&inputs[0], outputs, kBlockLength);
+    kBenchSink = output[0];
+  }, kBlockLength, 0.2);
+}
+
+int main() {
+  const unsigned int kMaxWorkers(
+    std::max(1u, std::thread::hardware_concurrency()) - 1);
+  const double reference(Measure(0, vecmath::kSchedulingThroughput));
+  std::cout << kInputs * kBranches * 2 + kBusses + 1 << " nodes, blocks of "
+            << kBlockLength << '\n'
+            << std::setw(8) << "workers"
+            << std::setw(16) << "mode"
+            << std::setw(12) << "MS/s"
+            << std::setw(12) << "speedup" << '\n';
+  std::cout << std::setw(8) << 0
+            << std::setw(16) << "-"
+            << std::setw(12) << std::fixed << std::setprecision(2) << reference
+            << std::setw(12) << 1.0 << '\n';
+  for (unsigned int workers(1); workers <= kMaxWorkers; workers *= 2) {
+    const SchedulingMode kModes[] = {vecmath::kSchedulingThroughput,
+                                     vecmath::kSchedulingLatencyBounded};
+    const char* const kNames[] = {"throughput", "latency"};
+    for (unsigned int mode(0); mode < 2; ++mode) {
+      const double throughput(Measure(workers, kModes[mode]));
+      std::cout << std::setw(8) << workers
+                << std::setw(16) << kNames[mode]
+                << std::setw(12) << throughput
+                << std::setw(12) << throughput / reference << '\n';
+    }
+  }
+  return 0;
+}
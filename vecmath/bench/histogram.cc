@@ -0,0 +1,133 @@
+/// @file bench/histogram.cc
+/// @brief Histogram and quantization benchmark
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Usage:
+///   vecmath_bench_histogram
+///
+/// Reports throughput in MSamples/s of block histograms, for several bin
+/// counts, against a scalar loop, then of quantization kernels.
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "vecmath/bench/bench.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/histogram.h"
+#include "vecmath/inc/quantization.h"
+
+using vecmath::AlignedVector;
+using vecmath::Histogram;
+using vecmath::QuantizationVectorMath;
+
+static const unsigned int kBlockLength = 4096;
+
+int main() {
+  std::mt19937 generator(1234);
+  std::normal_distribution<float> distribution(0.0f, 0.3f);
+  AlignedVector<float> block(kBlockLength);
+  for (float& value : block) {
+    value = distribution(generator);
+  }
+
+  std::cout << std::setw(10) << "bins"
+            << std::setw(12) << "MSamples/s"
+            << std::setw(12) << "scalar"
+            << std::setw(10) << "speedup" << '\n';
+  const unsigned int kBins[] = {16, 256, 4096};
+  for (const unsigned int bins : kBins) {
+    Histogram histogram(bins, -1.0f, 1.0f);
+    const double throughput(MeasureThroughput([&]() {
+      histogram.Accumulate(&block[0], kBlockLength);
+      kBenchSink = static_cast<float>(histogram.Count(0));
+    }, kBlockLength));
+    // Scalar baseline: same clamping, one histogram
+    std::vector<std::uint64_t> counts(bins, 0);
+    const float scale(bins / 2.0f);
+    const double scalar(MeasureThroughput([&]() {
+      for (unsigned int i(0); i < kBlockLength; ++i) {
+        const float position((block[i] + 1.0f) * scale);
+        const unsigned int bin(
+          position < bins
+          ? static_cast<unsigned int>(position > 0.0f ? position : 0.0f)
+          : bins - 1);
+        counts[bin] += 1;
+      }
+      kBenchSink = static_cast<float>(counts[0]);
+    }, kBlockLength));
+    std::cout << std::setw(10) << bins
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << throughput
+              << std::setw(12) << scalar
+              << std::setw(10) << throughput / scalar
+              << std::defaultfloat << '\n';
+  }
+
+  AlignedVector<int> codes(kBlockLength);
+  AlignedVector<float> output(kBlockLength);
+  std::cout << '\n' << std::setw(20) << "kernel"
+            << std::setw(12) << "MSamples/s" << '\n';
+  const double quantize(MeasureThroughput([&]() {
+    QuantizationVectorMath::Quantize(&block[0], kBlockLength, 16, &codes[0]);
+    kBenchSink = static_cast<float>(codes[0]);
+  }, kBlockLength));
+  const double dequantize(MeasureThroughput([&]() {
+    QuantizationVectorMath::Dequantize(&codes[0], kBlockLength, 16, &output[0]);
+    kBenchSink = output[0];
+  }, kBlockLength));
+  const double mu_law(MeasureThroughput([&]() {
+    QuantizationVectorMath::MuLawQuantize(&block[0], kBlockLength, 8, &codes[0]);
+    kBenchSink = static_cast<float>(codes[0]);
+  }, kBlockLength));
+  const double mu_law_inverse(MeasureThroughput([&]() {
+    QuantizationVectorMath::MuLawDequantize(&codes[0],
+                                            kBlockLength,
+                                            8,
+                                            &output[0]);
+    kBenchSink = output[0];
+  }, kBlockLength));
+  const double a_law(MeasureThroughput([&]() {
+    QuantizationVectorMath::ALawQuantize(&block[0], kBlockLength, 8, &codes[0]);
+    kBenchSink = static_cast<float>(codes[0]);
+  }, kBlockLength));
+  const double a_law_inverse(MeasureThroughput([&]() {
+    QuantizationVectorMath::ALawDequantize(&codes[0],
+                                           kBlockLength,
+                                           8,
+                                           &output[0]);
+    kBenchSink = output[0];
+  }, kBlockLength));
+  std::cout << std::fixed << std::setprecision(1)
+            << std::setw(20) << "Quantize" << std::setw(12) << quantize << '\n'
+            << std::setw(20) << "Dequantize" << std::setw(12) << dequantize
+            << '\n'
+            << std::setw(20) << "MuLawQuantize" << std::setw(12) << mu_law
+            << '\n'
+            << std::setw(20) << "MuLawDequantize" << std::setw(12)
+            << mu_law_inverse << '\n'
+            << std::setw(20) << "ALawQuantize" << std::setw(12) << a_law << '\n'
+            << std::setw(20) << "ALawDequantize" << std::setw(12)
+            << a_law_inverse << '\n';
+  return 0;
+}
@@ -0,0 +1,109 @@
+/// @file bench/mixing.cc
+/// @brief Mixing matrices benchmark, against a scalar baseline
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Usage:
+///   vecmath_bench_mixing
+///
+/// Reports throughput in MFrames/s (one frame: one sample of each channel)
+/// for common upmix/downmix/decode sizes, with constant and interpolated
+/// gains.
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "vecmath/bench/bench.h"
+
+#include "vecmath/inc/mixing.h"
+
+using vecmath::AlignedVector;
+using vecmath::MixingMatrix;
+
+/// @brief Scalar baseline: one output after the other
+static void ScalarMix(const std::vector<float>& gains,
+                      const float* const* inputs,
+                      const unsigned int inputs_count,
+                      float* const* outputs,
+                      const unsigned int outputs_count,
+                      const unsigned int length) {
+  for (unsigned int output(0); output < outputs_count; ++output) {
+    for (unsigned int t(0); t < length; ++t) {
+      float sum(0.0f);
+      for (unsigned int input(0); input < inputs_count; ++input) {
+        sum += gains[output * inputs_count + input] * inputs[input][t];
+      }
+      outputs[output][t] = sum;
+    }
+  }
+}
+
+int main() {
+  const unsigned int kLength(512);
+  // Stereo to 5.1, 5.1 to stereo, 4x4, 3rd order ambisonics to 8 speakers
+  const unsigned int kSizes[][2] = {{2, 6}, {6, 2}, {4, 4}, {16, 8}};
+  std::cout << std::setw(10) << "size"
+            << std::setw(12) << "scalar"
+            << std::setw(12) << "constant"
+            << std::setw(10) << "speedup"
+            << std::setw(12) << "ramp" << '\n';
+  for (const auto& size : kSizes) {
+    const unsigned int inputs_count(size[0]);
+    const unsigned int outputs_count(size[1]);
+    AlignedVector<float> input_data(inputs_count * kLength, 0.25f);
+    AlignedVector<float> output_data(outputs_count * kLength);
+    std::vector<float*> inputs(inputs_count);
+    std::vector<float*> outputs(outputs_count);
+    for (unsigned int i(0); i < inputs_count; ++i) {
+      inputs[i] = &input_data[i * kLength];
+    }
+    for (unsigned int i(0); i < outputs_count; ++i) {
+      outputs[i] = &output_data[i * kLength];
+    }
+    std::vector<float> gains(inputs_count * outputs_count, 0.5f);
+    MixingMatrix matrix(inputs_count, outputs_count);
+    matrix.SetGains(&gains[0]);
+    matrix.Jump();
+    const double scalar_throughput(MeasureThroughput([&]() {
+      ScalarMix(gains, &inputs[0], inputs_count,
+                &outputs[0], outputs_count, kLength);
+      kBenchSink = outputs[0][0];
+    }, kLength));
+    const double constant_throughput(MeasureThroughput([&]() {
+      matrix.Process(&inputs[0], &outputs[0], kLength);
+      kBenchSink = outputs[0][0];
+    }, kLength));
+    float ramp_gain(0.0f);
+    const double ramp_throughput(MeasureThroughput([&]() {
+      // A gain change on each block
+      ramp_gain = 1.0f - ramp_gain;
+      matrix.SetGain(0, 0, ramp_gain);
+      matrix.Process(&inputs[0], &outputs[0], kLength);
+      kBenchSink = outputs[0][0];
+    }, kLength));
+    std::cout << std::setw(6) << inputs_count << " x " << outputs_count
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << scalar_throughput
+              << std::setw(12) << constant_throughput
+              << std::setw(10) << constant_throughput / scalar_throughput
+              << std::setw(12) << ramp_throughput << '\n';
+  }
+  return 0;
+}
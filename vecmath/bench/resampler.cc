@@ -0,0 +1,204 @@
+/// @file bench/resampler.cc
+/// @brief Sample rate converter benchmark: throughput and quality
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Usage:
+///   vecmath_bench_resampler
+///
+/// For each conversion and each quality, reports the throughput in input
+/// MSamples/s (streaming 1024 samples blocks) and the signal to noise ratio
+/// on a 997Hz sine wave. Polyphase qualities are compared against a scalar
+/// polyphase loop using the same filter.
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "vecmath/bench/bench.h"
+
+#include "vecmath/inc/filter_design.h"
+#include "vecmath/inc/resampler.h"
+
+using vecmath::FilterDesign;
+using vecmath::Resampler;
+
+static const double kBenchTwoPi = 6.283185307179586;
+
+/// @brief Scalar baseline: polyphase windowed sinc, phases interpolated
+class ScalarPolyphase {
+ public:
+  ScalarPolyphase(const double ratio,
+                  const unsigned int taps,
+                  const double attenuation,
+                  const unsigned int phases)
+      : taps_(taps),
+        phases_(phases),
+        step_(1.0 / ratio),
+        table_((phases + 1) * taps) {
+    const double cutoff(std::min(1.0, ratio)
+                        * (0.5 - 0.5 * FilterDesign::KaiserTransition(
+                                         attenuation,
+                                         taps * std::min(1.0, ratio))));
+    const double beta(FilterDesign::KaiserBeta(attenuation));
+    for (unsigned int phase(0); phase <= phases_; ++phase) {
+      for (unsigned int tap(0); tap < taps_; ++tap) {
+        table_[phase * taps_ + tap] = static_cast<float>(
+          FilterDesign::WindowedSinc(
+            tap - (0.5 * taps_ - 1.0) - static_cast<double>(phase) / phases_,
+            cutoff,
+            0.5 * taps_,
+            beta));
+      }
+    }
+  }
+
+  /// @brief Resample a whole buffer, return the output samples count
+  unsigned int Process(const std::vector<float>& input,
+                       std::vector<float>* output) const {
+    unsigned int produced(0);
+    for (double position(0.0);
+         static_cast<unsigned int>(position) + taps_ <= input.size()
+         && produced < output->size();
+         position += step_) {
+      const unsigned int start(static_cast<unsigned int>(position));
+      const double phase_position((position - start) * phases_);
+      const unsigned int phase(static_cast<unsigned int>(phase_position));
+      const float fraction(static_cast<float>(phase_position - phase));
+      const float* const current(&table_[phase * taps_]);
+      const float* const next(current + taps_);
+      float sum(0.0f);
+      for (unsigned int tap(0); tap < taps_; ++tap) {
+        sum += input[start + tap]
+               * (current[tap] + fraction * (next[tap] - current[tap]));
+      }
+      (*output)[produced] = sum;
+      produced += 1;
+    }
+    return produced;
+  }
+
+ private:
+  unsigned int taps_;
+  unsigned int phases_;
+  double step_;
+  std::vector<float> table_;
+};
+
+/// @brief Signal to noise ratio, in dB, of a resampled 997Hz sine wave
+static double SineSNR(const double input_rate,
+                      const double output_rate,
+                      const Resampler::Quality quality) {
+  const double kFrequency(997.0);
+  const unsigned int kLength(65536);
+  Resampler resampler(input_rate, output_rate, kLength, quality);
+  std::vector<float> input(kLength);
+  for (unsigned int i(0); i < kLength; ++i) {
+    input[i] = static_cast<float>(std::sin(kBenchTwoPi * kFrequency * i
+                                           / input_rate));
+  }
+  std::vector<float> output(resampler.MaxOutputCount(kLength));
+  const unsigned int produced(resampler.Process(&input[0],
+                                                kLength,
+                                                &output[0],
+                                                output.size()));
+  const unsigned int skip(static_cast<unsigned int>(
+    std::ceil(resampler.Taps() * output_rate / input_rate)));
+  double signal(0.0);
+  double noise(0.0);
+  for (unsigned int j(skip); j < produced; ++j) {
+    const double expected(std::sin(kBenchTwoPi * kFrequency * j
+                                   / output_rate));
+    signal += expected * expected;
+    noise += (output[j] - expected) * (output[j] - expected);
+  }
+  return 10.0 * std::log10(signal / noise);
+}
+
+int main() {
+  const double kRates[][2] = {{44100.0, 48000.0},
+                              {48000.0, 44100.0},
+                              {48000.0, 96000.0},
+                              {96000.0, 48000.0}};
+  const char* const kNames[] = {"linear", "cubic", "low",
+                                "medium", "high", "best"};
+  // Matching Resampler polyphase qualities
+  const unsigned int kTaps[] = {16, 32, 64, 128};
+  const double kAttenuations[] = {60.0, 90.0, 110.0, 120.0};
+  const unsigned int kPhases[] = {64, 128, 256, 512};
+  const unsigned int kBlockLength(1024);
+  std::vector<float> block(kBlockLength);
+  for (unsigned int i(0); i < kBlockLength; ++i) {
+    block[i] = std::sin(0.05f * i);
+  }
+
+  std::cout << std::setw(18) << "conversion"
+            << std::setw(10) << "quality"
+            << std::setw(12) << "MSamples/s"
+            << std::setw(10) << "SNR(dB)"
+            << std::setw(12) << "scalar"
+            << std::setw(10) << "speedup" << '\n';
+  for (const auto& rates : kRates) {
+    const double ratio(rates[1] / rates[0]);
+    for (unsigned int quality(Resampler::kLinear);
+         quality <= Resampler::kBest;
+         ++quality) {
+      Resampler resampler(rates[0],
+                          rates[1],
+                          kBlockLength,
+                          static_cast<Resampler::Quality>(quality));
+      std::vector<float> output(resampler.MaxOutputCount(kBlockLength));
+      const double throughput(MeasureThroughput([&]() {
+        resampler.Process(&block[0], kBlockLength, &output[0], output.size());
+        kBenchSink = output[0];
+      }, kBlockLength));
+      std::cout << std::setw(9) << static_cast<unsigned int>(rates[0])
+                << " -> " << std::setw(5)
+                << static_cast<unsigned int>(rates[1])
+                << std::setw(10) << kNames[quality]
+                << std::fixed << std::setprecision(1)
+                << std::setw(12) << throughput
+                << std::setw(10)
+                << SineSNR(rates[0],
+                           rates[1],
+                           static_cast<Resampler::Quality>(quality));
+      if (quality >= Resampler::kLow) {
+        const unsigned int index(quality - Resampler::kLow);
+        const unsigned int taps(static_cast<unsigned int>(
+          std::ceil(kTaps[index] / std::min(1.0, ratio))));
+        const ScalarPolyphase scalar(ratio,
+                                     taps,
+                                     kAttenuations[index],
+                                     kPhases[index]);
+        // Scalar baseline on the whole block, history included
+        std::vector<float> history_block(kBlockLength + taps);
+        std::copy(block.begin(), block.end(), history_block.begin());
+        const double scalar_throughput(MeasureThroughput([&]() {
+          scalar.Process(history_block, &output);
+          kBenchSink = output[0];
+        }, kBlockLength));
+        std::cout << std::setw(12) << scalar_throughput
+                  << std::setw(10) << throughput / scalar_throughput;
+      }
+      std::cout << std::defaultfloat << '\n';
+    }
+  }
+  return 0;
+}
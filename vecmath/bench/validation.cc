@@ -0,0 +1,90 @@
+/// @file bench/validation.cc
+/// @brief Block health checks benchmark
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Usage:
+///   vecmath_bench_validation
+///
+/// Reports throughput in MSamples/s of each check on clean buffers
+/// (no early exit), compared to a memcpy of the same buffer.
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include "vecmath/bench/bench.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/validation.h"
+
+using vecmath::AlignedVector;
+using vecmath::ValidationVectorMath;
+
+int main() {
+  // Typical block, and a buffer larger than the L1 cache
+  const unsigned int kLengths[] = {512, 65536};
+  std::cout << std::setw(8) << "length"
+            << std::setw(20) << "check"
+            << std::setw(12) << "MS/s"
+            << std::setw(12) << "vs memcpy" << '\n';
+  for (const unsigned int length : kLengths) {
+    AlignedVector<float> input(length, 0.25f);
+    AlignedVector<float> other(length, 0.25f);
+    AlignedVector<float> copy(length);
+    const double memcpy_throughput(MeasureThroughput([&]() {
+      std::memcpy(&copy[0], &input[0], length * sizeof(float));
+      kBenchSink = copy[length - 1];
+    }, length));
+    const double throughputs[] = {
+      MeasureThroughput([&]() {
+        kBenchSink = static_cast<float>(
+          ValidationVectorMath::FirstNonFiniteIndex(&input[0], length));
+      }, length),
+      MeasureThroughput([&]() {
+        kBenchSink = static_cast<float>(
+          ValidationVectorMath::CountDenormals(&input[0], length));
+      }, length),
+      MeasureThroughput([&]() {
+        kBenchSink = ValidationVectorMath::AllNear(&input[0], &other[0],
+                                                   length, 1e-6f) ? 1.0f : 0.0f;
+      }, length),
+      MeasureThroughput([&]() {
+        kBenchSink = ValidationVectorMath::MaxAbsDifference(&input[0],
+                                                            &other[0],
+                                                            length);
+      }, length)
+    };
+    const char* const kNames[] = {
+      "FirstNonFiniteIndex", "CountDenormals", "AllNear", "MaxAbsDifference"
+    };
+    std::cout << std::setw(8) << length
+              << std::setw(20) << "memcpy"
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << memcpy_throughput
+              << std::setw(12) << 1.0 << '\n';
+    for (unsigned int i(0); i < 4; ++i) {
+      std::cout << std::setw(8) << length
+                << std::setw(20) << kNames[i]
+                << std::setw(12) << throughputs[i]
+                << std::setw(12) << throughputs[i] / memcpy_throughput << '\n';
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,96 @@
+/// @file bench/waveshaper.cc
+/// @brief Oversampled waveshaper benchmark
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Usage:
+///   vecmath_bench_waveshaper
+///
+/// For each shaping function and oversampling factor, reports the
+/// throughput in MSamples/s (original rate, streaming 256 samples blocks)
+/// and the latency, compared to shaping without oversampling.
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include "vecmath/bench/bench.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/waveshaper.h"
+
+using vecmath::AlignedVector;
+using vecmath::HardClipShaper;
+using vecmath::Oversampler;
+using vecmath::PlatformVectorMath;
+using vecmath::TanhShaper;
+using vecmath::Waveshaper;
+
+static const unsigned int kBlockLength = 256;
+
+template <typename Shaper>
+static void Report(const char* const name, const AlignedVector<float>& block) {
+  AlignedVector<float> output(kBlockLength);
+  const double direct(MeasureThroughput([&]() {
+    for (unsigned int i(0); i < kBlockLength;
+         i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(&output[i],
+                                Shaper::Apply(PlatformVectorMath::Fill(
+                                  &block[i])));
+    }
+    kBenchSink = output[0];
+  }, kBlockLength));
+  std::cout << std::setw(10) << name
+            << std::setw(8) << "1x"
+            << std::fixed << std::setprecision(1)
+            << std::setw(12) << direct
+            << std::setw(10) << 0
+            << std::defaultfloat << '\n';
+  const Oversampler::Factor kFactors[] = {Oversampler::k2x,
+                                          Oversampler::k4x,
+                                          Oversampler::k8x};
+  for (const Oversampler::Factor factor : kFactors) {
+    Waveshaper<Shaper> shaper(factor, kBlockLength);
+    shaper.SetDrive(2.0f);
+    const double throughput(MeasureThroughput([&]() {
+      shaper.Process(&block[0], &output[0], kBlockLength);
+      kBenchSink = output[0];
+    }, kBlockLength));
+    std::cout << std::setw(10) << name
+              << std::setw(7) << shaper.Ratio() << 'x'
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << throughput
+              << std::setw(10) << shaper.Latency()
+              << std::defaultfloat << '\n';
+  }
+}
+
+int main() {
+  AlignedVector<float> block(kBlockLength);
+  for (unsigned int i(0); i < kBlockLength; ++i) {
+    block[i] = std::sin(0.05f * i);
+  }
+  std::cout << std::setw(10) << "shaper"
+            << std::setw(8) << "factor"
+            << std::setw(12) << "MSamples/s"
+            << std::setw(10) << "latency" << '\n';
+  Report<HardClipShaper>("hardclip", block);
+  Report<TanhShaper>("tanh", block);
+  return 0;
+}
@@ -0,0 +1,124 @@
+/// @file allocator.h
+/// @brief Aligned memory allocation, for FloatVec-friendly containers
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_INC_ALLOCATOR_H_
+#define VECMATH_INC_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace vecmath {
+
+/// @brief Default alignment of vecmath containers, in bytes:
+/// enough for any FloatVec width (and a cache line)
+static constexpr std::size_t kDefaultAlignment = 64;
+
+/// @brief Check whether the given pointer is aligned on "alignment" bytes
+inline bool IsAligned(const void* const pointer, const std::size_t alignment) {
+  return (reinterpret_cast<std::uintptr_t>(pointer) % alignment) == 0;
+}
+
+/// @brief Smallest power of two >= value
+inline unsigned int PowerOfTwoAbove(const unsigned int value) {
+  unsigned int result(1);
+  while (result < value) {
+    result *= 2;
+  }
+  return result;
+}
+
+/// @brief Standard allocator returning memory aligned on "Alignment" bytes
+///
+/// The original (unaligned) pointer is stored right before the returned one.
+template <typename Type, std::size_t Alignment = kDefaultAlignment>
+struct AlignedAllocator {
+  static_assert((Alignment & (Alignment - 1)) == 0,
+                "Alignment has to be a power of two");
+  static_assert(Alignment >= sizeof(void*),
+                "Alignment has to be at least the size of a pointer");
+
+  typedef Type value_type;
+
+  template <typename OtherType>
+  struct rebind {
+    typedef AlignedAllocator<OtherType, Alignment> other;
+  };
+
+  AlignedAllocator() {}
+
+  template <typename OtherType>
+  AlignedAllocator(const AlignedAllocator<OtherType, Alignment>&) {}
+
+  /// @brief Largest count whose allocation size, padding included,
+  /// does not overflow
+  std::size_t max_size() const {
+    return (std::numeric_limits<std::size_t>::max()
+            - Alignment
+            - sizeof(void*)) / sizeof(Type);
+  }
+
+  Type* allocate(const std::size_t count) {
+    if (count > max_size()) {
+      throw std::bad_alloc();
+    }
+    void* const raw(std::malloc(count * sizeof(Type)
+                                + Alignment
+                                + sizeof(void*)));
+    if (raw == nullptr) {
+      throw std::bad_alloc();
+    }
+    const std::uintptr_t aligned(
+      (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + Alignment - 1)
+      & ~static_cast<std::uintptr_t>(Alignment - 1));
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return reinterpret_cast<Type*>(aligned);
+  }
+
+  void deallocate(Type* const pointer, const std::size_t /*count*/) {
+    if (pointer != nullptr) {
+      std::free(reinterpret_cast<void**>(pointer)[-1]);
+    }
+  }
+};
+
+template <typename LeftType, typename RightType, std::size_t Alignment>
+inline bool operator==(const AlignedAllocator<LeftType, Alignment>&,
+                       const AlignedAllocator<RightType, Alignment>&) {
+  return true;
+}
+
+template <typename LeftType, typename RightType, std::size_t Alignment>
+inline bool operator!=(const AlignedAllocator<LeftType, Alignment>&,
+                       const AlignedAllocator<RightType, Alignment>&) {
+  return false;
+}
+
+/// @brief std::vector with aligned storage
+template <typename Type>
+using AlignedVector = std::vector<Type, AlignedAllocator<Type> >;
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_ALLOCATOR_H_
@@ -0,0 +1,205 @@
+/// @file approximations.h
+/// @brief Vectorized approximations of transcendental functions
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_INC_APPROXIMATIONS_H_
+#define VECMATH_INC_APPROXIMATIONS_H_
+
+#include <limits>
+
+#include "vecmath/inc/maths.h"
+#include "vecmath/inc/polynomial.h"
+
+namespace vecmath {
+
+/// @brief Polynomial approximations of transcendental functions,
+/// built upon PlatformVectorMath primitives
+///
+/// Each function maximum error is checked by vecmath_accuracy
+struct ApproxVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Element-wise arc tangent of y / x, in [-pi ; pi]
+  ///
+  /// Maximum error ~3 ulp; Atan2(0, 0) returns 0
+  ///
+  /// @param[in]  y   Ordinates
+  /// @param[in]  x   Abscissas
+  static inline FloatVec Atan2(FloatVecRead y, FloatVecRead x) {
+    const FloatVec zero(PlatformVectorMath::Fill(0.0f));
+    const FloatVec abs_y(CommonVectorMath::Abs(y));
+    const FloatVec abs_x(CommonVectorMath::Abs(x));
+    // Reduce to a ratio within [0 ; 1], avoiding 0 / 0
+    const FloatVec numerator(PlatformVectorMath::Min(abs_x, abs_y));
+    const FloatVec denominator(PlatformVectorMath::Max(
+      PlatformVectorMath::Max(abs_x, abs_y),
+      PlatformVectorMath::Fill(std::numeric_limits<float>::min())));
+    const FloatVec ratio(PlatformVectorMath::Div(numerator, denominator));
+    FloatVec output(AtanUnit(ratio));
+    // Undo the reduction: octant, then quadrant, then sign
+    output = PlatformVectorMath::Select(
+      PlatformVectorMath::LessThan(abs_x, abs_y),
+      PlatformVectorMath::Sub(PlatformVectorMath::Fill(kHalfPi), output),
+      output);
+    output = PlatformVectorMath::Select(
+      PlatformVectorMath::LessThan(x, zero),
+      PlatformVectorMath::Sub(PlatformVectorMath::Fill(kPi), output),
+      output);
+    return PlatformVectorMath::Select(
+      PlatformVectorMath::LessThan(y, zero),
+      PlatformVectorMath::Sub(zero, output),
+      output);
+  }
+
+  /// @brief Element-wise arc tangent, in [-pi / 2 ; pi / 2]
+  ///
+  /// Maximum error ~3 ulp
+  static inline FloatVec Atan(FloatVecRead input) {
+    return Atan2(input, PlatformVectorMath::Fill(1.0f));
+  }
+
+  /// @brief Element-wise base 2 logarithm
+  ///
+  /// Maximum error ~2 ulp. Inputs are clamped to the smallest normal
+  /// number: zero, negative and denormal inputs return -126
+  static inline FloatVec Log2(FloatVecRead input) {
+    const FloatVec one(PlatformVectorMath::Fill(1.0f));
+    const FloatVec clamped(PlatformVectorMath::Max(
+      input,
+      PlatformVectorMath::Fill(std::numeric_limits<float>::min())));
+    // Mantissa within [sqrt(2) / 2 ; sqrt(2)[
+    const FloatVec mantissa(PlatformVectorMath::Mantissa(clamped));
+    const FloatVec halve_mask(PlatformVectorMath::LessThan(
+      PlatformVectorMath::Fill(kSqrtTwo), mantissa));
+    const FloatVec exponent(PlatformVectorMath::Add(
+      PlatformVectorMath::Exponent(clamped),
+      PlatformVectorMath::ExtractValueFromMask(one, halve_mask)));
+    const FloatVec reduced(PlatformVectorMath::Sub(
+      PlatformVectorMath::Select(
+        halve_mask,
+        PlatformVectorMath::Mul(mantissa, PlatformVectorMath::Fill(0.5f)),
+        mantissa),
+      one));
+    // log(1 + x) = x - x^2 / 2 + x^3 P(x)
+    const FloatVec squared(PlatformVectorMath::Mul(reduced, reduced));
+    const FloatVec log(PlatformVectorMath::Add(
+      reduced,
+      PlatformVectorMath::MulAdd(
+        PlatformVectorMath::Mul(Polynomial<LogCoefficients>::Evaluate(reduced),
+                                reduced),
+        squared,
+        PlatformVectorMath::Mul(PlatformVectorMath::Fill(-0.5f), squared))));
+    return PlatformVectorMath::MulAdd(log,
+                                      PlatformVectorMath::Fill(kLog2E),
+                                      exponent);
+  }
+
+  /// @brief Element-wise 2^input
+  ///
+  /// Maximum error ~2 ulp. Inputs are clamped to [-126 ; 127.5[,
+  /// so that results are normal numbers
+  static inline FloatVec Exp2(FloatVecRead input) {
+    const FloatVec clamped(PlatformVectorMath::Min(
+      PlatformVectorMath::Max(input, PlatformVectorMath::Fill(-126.0f)),
+      PlatformVectorMath::Fill(127.49f)));
+    // 2^x = 2^n * 2^f, f within [-0.5 ; 0.5]
+    const FloatVec integer(PlatformVectorMath::Floor(
+      PlatformVectorMath::Add(clamped, PlatformVectorMath::Fill(0.5f))));
+    const FloatVec fraction(PlatformVectorMath::Sub(clamped, integer));
+    const FloatVec power(PlatformVectorMath::MulAdd(
+      Polynomial<Exp2Coefficients>::Evaluate(fraction),
+      fraction,
+      PlatformVectorMath::Fill(1.0f)));
+    return PlatformVectorMath::Mul(power,
+                                   PlatformVectorMath::PowerOfTwo(integer));
+  }
+
+ private:
+  static constexpr float kSqrtTwo = 1.41421356237310f;
+  static constexpr float kLog2E = 1.44269504088896f;
+  static constexpr float kPi = 3.14159265358979f;
+  static constexpr float kHalfPi = 1.57079632679490f;
+  static constexpr float kQuarterPi = 0.78539816339745f;
+  /// @brief tan(pi / 8)
+  static constexpr float kTanEighthPi = 0.41421356237310f;
+
+  /// @brief atan(x) = x + x^3 P(x^2) minimax coefficients
+  struct AtanCoefficients {
+    static constexpr float kCoefficients[] = {-3.33329491539e-1f,
+                                              1.99777106478e-1f,
+                                              -1.38776856032e-1f,
+                                              8.05374449538e-2f};
+  };
+
+  /// @brief log(1 + x) = x - x^2 / 2 + x^3 P(x) minimax coefficients
+  /// (Cephes logf), for x within [sqrt(2) / 2 - 1 ; sqrt(2) - 1]
+  struct LogCoefficients {
+    static constexpr float kCoefficients[] = {3.3333331174e-1f,
+                                              -2.4999993993e-1f,
+                                              2.0000714765e-1f,
+                                              -1.6668057665e-1f,
+                                              1.4249322787e-1f,
+                                              -1.2420140846e-1f,
+                                              1.1676998740e-1f,
+                                              -1.1514610310e-1f,
+                                              7.0376836292e-2f};
+  };
+
+  /// @brief 2^x = 1 + x P(x) minimax coefficients (Cephes exp2f),
+  /// for x within [-0.5 ; 0.5]
+  struct Exp2Coefficients {
+    static constexpr float kCoefficients[] = {6.931472028550421e-1f,
+                                              2.402264791363012e-1f,
+                                              5.550332471162809e-2f,
+                                              9.618437357674640e-3f,
+                                              1.339887440266574e-3f,
+                                              1.535336188319500e-4f};
+  };
+
+  /// @brief Arc tangent for inputs within [0 ; 1]
+  ///
+  /// Above tan(pi / 8) the input is reduced with
+  /// atan(x) = pi / 4 + atan((x - 1) / (x + 1)),
+  /// the result then being a minimax polynomial (Cephes atanf coefficients)
+  static inline FloatVec AtanUnit(FloatVecRead input) {
+    const FloatVec one(PlatformVectorMath::Fill(1.0f));
+    const FloatVec reduce_mask(PlatformVectorMath::LessThan(
+      PlatformVectorMath::Fill(kTanEighthPi), input));
+    const FloatVec reduced(PlatformVectorMath::Select(
+      reduce_mask,
+      PlatformVectorMath::Div(PlatformVectorMath::Sub(input, one),
+                              PlatformVectorMath::Add(input, one)),
+      input));
+    const FloatVec offset(PlatformVectorMath::ExtractValueFromMask(
+      PlatformVectorMath::Fill(kQuarterPi), reduce_mask));
+    const FloatVec squared(PlatformVectorMath::Mul(reduced, reduced));
+    const FloatVec polynomial(PlatformVectorMath::Mul(
+      Polynomial<AtanCoefficients>::Evaluate(squared),
+      squared));
+    return PlatformVectorMath::Add(
+      offset,
+      PlatformVectorMath::MulAdd(polynomial, reduced, reduced));
+  }
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_APPROXIMATIONS_H_
@@ -0,0 +1,309 @@
+/// @file complex.h
+/// @brief Complex vectors arithmetic, split and interleaved layouts
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_INC_COMPLEX_H_
+#define VECMATH_INC_COMPLEX_H_
+
+#include "vecmath/inc/approximations.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Split (SoA) complex vector: FloatVecSize complex values,
+/// real and imaginary parts each in their own FloatVec
+struct ComplexVec {
+  PlatformVectorMath::FloatVec re;
+  PlatformVectorMath::FloatVec im;
+};
+
+/// @brief Complex vectors arithmetic
+///
+/// Two layouts are supported:
+/// - split, as ComplexVec: (re0, re1, ...) and (im0, im1, ...)
+/// - interleaved, as a single FloatVec: (re0, im0, re1, im1, ...),
+/// holding FloatVecSize / 2 complex values
+///
+/// Interleaved functions names are suffixed with "Interleaved".
+struct ComplexVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+  typedef const ComplexVec& ComplexVecRead;
+
+  /// @brief Complex values count within a ComplexVec
+  static constexpr unsigned int ComplexVecSize = PlatformVectorMath::FloatVecSize;
+  /// @brief Complex values count within an interleaved FloatVec
+  static constexpr unsigned int InterleavedSize = PlatformVectorMath::FloatVecSize / 2;
+
+  /// @brief Build a ComplexVec from its real and imaginary parts
+  static inline ComplexVec Fill(FloatVecRead re, FloatVecRead im) {
+    const ComplexVec output = {re, im};
+    return output;
+  }
+
+  /// @brief Fill a whole ComplexVec with the given split arrays
+  static inline ComplexVec Fill(BlockIn re, BlockIn im) {
+    return Fill(PlatformVectorMath::Fill(re), PlatformVectorMath::Fill(im));
+  }
+
+  /// @brief Store the given ComplexVec into split arrays
+  static inline void Store(BlockOut re, BlockOut im, ComplexVecRead input) {
+    PlatformVectorMath::Store(re, input.re);
+    PlatformVectorMath::Store(im, input.im);
+  }
+
+  /// @brief Complex addition
+  static inline ComplexVec Add(ComplexVecRead left, ComplexVecRead right) {
+    return Fill(PlatformVectorMath::Add(left.re, right.re),
+                PlatformVectorMath::Add(left.im, right.im));
+  }
+
+  /// @brief Complex multiplication
+  static inline ComplexVec Mul(ComplexVecRead left, ComplexVecRead right) {
+    return Fill(
+      PlatformVectorMath::Sub(PlatformVectorMath::Mul(left.re, right.re),
+                              PlatformVectorMath::Mul(left.im, right.im)),
+      PlatformVectorMath::MulAdd(left.re, right.im,
+                                 PlatformVectorMath::Mul(left.im, right.re)));
+  }
+
+  /// @brief Multiplication by the conjugate: left * conj(right)
+  static inline ComplexVec MulConj(ComplexVecRead left, ComplexVecRead right) {
+    return Fill(
+      PlatformVectorMath::MulAdd(left.re, right.re,
+                                 PlatformVectorMath::Mul(left.im, right.im)),
+      PlatformVectorMath::Sub(PlatformVectorMath::Mul(left.im, right.re),
+                              PlatformVectorMath::Mul(left.re, right.im)));
+  }
+
+  /// @brief Complex multiply-add: left * right + addend
+  static inline ComplexVec MulAdd(ComplexVecRead left,
+                                  ComplexVecRead right,
+                                  ComplexVecRead addend) {
+    const FloatVec re(PlatformVectorMath::MulAdd(left.re, right.re, addend.re));
+    const FloatVec im(PlatformVectorMath::MulAdd(left.re, right.im, addend.im));
+    return Fill(
+      PlatformVectorMath::Sub(re, PlatformVectorMath::Mul(left.im, right.im)),
+      PlatformVectorMath::MulAdd(left.im, right.re, im));
+  }
+
+  /// @brief Squared magnitude re^2 + im^2
+  static inline FloatVec SquaredMagnitude(ComplexVecRead input) {
+    return PlatformVectorMath::MulAdd(input.re, input.re,
+                                      PlatformVectorMath::Mul(input.im,
+                                                              input.im));
+  }
+
+  /// @brief Magnitude sqrt(re^2 + im^2)
+  static inline FloatVec Magnitude(ComplexVecRead input) {
+    return PlatformVectorMath::Sqrt(SquaredMagnitude(input));
+  }
+
+  /// @brief Phase (argument) in [-pi ; pi], 0 for a null input
+  static inline FloatVec Phase(ComplexVecRead input) {
+    return ApproxVectorMath::Atan2(input.im, input.re);
+  }
+
+  /// @brief Complex multiplication, interleaved layout
+  static inline FloatVec MulInterleaved(FloatVecRead left, FloatVecRead right) {
+    // (lr * rr, li * rr) -/+ (li * ri, lr * ri)
+    const FloatVec real_products(
+      PlatformVectorMath::Mul(left, PlatformVectorMath::DuplicateEven(right)));
+    const FloatVec cross_products(
+      PlatformVectorMath::Mul(PlatformVectorMath::SwapPairs(left),
+                              PlatformVectorMath::DuplicateOdd(right)));
+    return PlatformVectorMath::AddSub(real_products, cross_products);
+  }
+
+  /// @brief Multiplication by the conjugate: left * conj(right),
+  /// interleaved layout
+  static inline FloatVec MulConjInterleaved(FloatVecRead left,
+                                            FloatVecRead right) {
+    // (lr * rr, li * rr) +/- (li * ri, lr * ri)
+    const FloatVec real_products(
+      PlatformVectorMath::Mul(left, PlatformVectorMath::DuplicateEven(right)));
+    const FloatVec negated_imaginary(
+      PlatformVectorMath::Sub(PlatformVectorMath::Fill(0.0f),
+                              PlatformVectorMath::DuplicateOdd(right)));
+    const FloatVec cross_products(
+      PlatformVectorMath::Mul(PlatformVectorMath::SwapPairs(left),
+                              negated_imaginary));
+    return PlatformVectorMath::AddSub(real_products, cross_products);
+  }
+
+  /// @brief Complex multiply-add: left * right + addend, interleaved layout
+  static inline FloatVec MulAddInterleaved(FloatVecRead left,
+                                           FloatVecRead right,
+                                           FloatVecRead addend) {
+    return PlatformVectorMath::Add(MulInterleaved(left, right), addend);
+  }
+
+  /// @brief Squared magnitudes of two interleaved vectors,
+  /// in the same order: (|low0|^2, |low1|^2, ..., |high0|^2, ...)
+  static inline FloatVec SquaredMagnitudeInterleaved(FloatVecRead low,
+                                                     FloatVecRead high) {
+    const FloatVec low_squared(PlatformVectorMath::Mul(low, low));
+    const FloatVec high_squared(PlatformVectorMath::Mul(high, high));
+    return PlatformVectorMath::Add(
+      PlatformVectorMath::DeinterleaveEven(low_squared, high_squared),
+      PlatformVectorMath::DeinterleaveOdd(low_squared, high_squared));
+  }
+
+  /// @brief Magnitudes of two interleaved vectors, in the same order
+  static inline FloatVec MagnitudeInterleaved(FloatVecRead low,
+                                              FloatVecRead high) {
+    return PlatformVectorMath::Sqrt(SquaredMagnitudeInterleaved(low, high));
+  }
+
+  /// @brief Phases of two interleaved vectors, in the same order
+  static inline FloatVec PhaseInterleaved(FloatVecRead low,
+                                          FloatVecRead high) {
+    return Phase(ToSplit(low, high));
+  }
+
+  /// @brief Convert two interleaved vectors into a split one
+  static inline ComplexVec ToSplit(FloatVecRead low, FloatVecRead high) {
+    return Fill(PlatformVectorMath::DeinterleaveEven(low, high),
+                PlatformVectorMath::DeinterleaveOdd(low, high));
+  }
+
+  /// @brief Convert a split vector into two interleaved ones
+  ///
+  /// @param[in]  input   Split vector to be converted
+  /// @param[out]  low   First half of the complex values
+  /// @param[out]  high   Second half of the complex values
+  static inline void ToInterleaved(ComplexVecRead input,
+                                   FloatVec* const low,
+                                   FloatVec* const high) {
+    *low = PlatformVectorMath::InterleaveLow(input.re, input.im);
+    *high = PlatformVectorMath::InterleaveHigh(input.re, input.im);
+  }
+
+  /// @brief Complex multiply-accumulate over whole interleaved blocks:
+  /// accumulator += left * right
+  ///
+  /// This is the inner loop of partitioned convolutions:
+  /// all blocks have to be aligned
+  ///
+  /// @param[in]  left   Interleaved complex values
+  /// @param[in]  right   Interleaved complex values
+  /// @param[in,out]  accumulator   Interleaved complex values
+  /// @param[in]  count   Complex values count, multiple of FloatVecSize / 2
+  static inline void MultiplyAccumulate(BlockIn left,
+                                        BlockIn right,
+                                        BlockOut accumulator,
+                                        const unsigned int count) {
+    VECMATH_PROFILE_KERNEL("ComplexMultiplyAccumulate",
+                           count,
+                           count * 6 * sizeof(float));
+    VECMATH_ASSERT(count % InterleavedSize == 0);
+    for (unsigned int i(0); i < count * 2;
+         i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(
+        &accumulator[i],
+        MulAddInterleaved(PlatformVectorMath::Fill(&left[i]),
+                          PlatformVectorMath::Fill(&right[i]),
+                          PlatformVectorMath::Fill(&accumulator[i])));
+    }
+  }
+
+  /// @brief Complex multiply-accumulate over whole split blocks:
+  /// accumulator += left * right
+  ///
+  /// @param[in]  left_re   Real parts of the left operand
+  /// @param[in]  left_im   Imaginary parts of the left operand
+  /// @param[in]  right_re   Real parts of the right operand
+  /// @param[in]  right_im   Imaginary parts of the right operand
+  /// @param[in,out]  accumulator_re   Real parts of the accumulator
+  /// @param[in,out]  accumulator_im   Imaginary parts of the accumulator
+  /// @param[in]  count   Complex values count, multiple of FloatVecSize
+  static inline void MultiplyAccumulate(BlockIn left_re,
+                                        BlockIn left_im,
+                                        BlockIn right_re,
+                                        BlockIn right_im,
+                                        BlockOut accumulator_re,
+                                        BlockOut accumulator_im,
+                                        const unsigned int count) {
+    VECMATH_PROFILE_KERNEL("ComplexMultiplyAccumulateSplit",
+                           count,
+                           count * 6 * sizeof(float));
+    VECMATH_ASSERT(count % ComplexVecSize == 0);
+    for (unsigned int i(0); i < count; i += ComplexVecSize) {
+      Store(&accumulator_re[i],
+            &accumulator_im[i],
+            MulAdd(Fill(&left_re[i], &left_im[i]),
+                   Fill(&right_re[i], &right_im[i]),
+                   Fill(&accumulator_re[i], &accumulator_im[i])));
+    }
+  }
+
+  /// @brief Convert a whole interleaved block into split blocks
+  ///
+  /// @param[in]  interleaved   Interleaved complex values
+  /// @param[out]  re   Real parts
+  /// @param[out]  im   Imaginary parts
+  /// @param[in]  count   Complex values count, multiple of FloatVecSize
+  static inline void InterleavedToSplit(BlockIn interleaved,
+                                        BlockOut re,
+                                        BlockOut im,
+                                        const unsigned int count) {
+    VECMATH_PROFILE_KERNEL("ComplexInterleavedToSplit",
+                           count,
+                           count * 4 * sizeof(float));
+    VECMATH_ASSERT(count % ComplexVecSize == 0);
+    for (unsigned int i(0); i < count; i += ComplexVecSize) {
+      Store(&re[i],
+            &im[i],
+            ToSplit(PlatformVectorMath::Fill(&interleaved[2 * i]),
+                    PlatformVectorMath::Fill(
+                      &interleaved[2 * i + PlatformVectorMath::FloatVecSize])));
+    }
+  }
+
+  /// @brief Convert whole split blocks into an interleaved block
+  ///
+  /// @param[in]  re   Real parts
+  /// @param[in]  im   Imaginary parts
+  /// @param[out]  interleaved   Interleaved complex values
+  /// @param[in]  count   Complex values count, multiple of FloatVecSize
+  static inline void SplitToInterleaved(BlockIn re,
+                                        BlockIn im,
+                                        BlockOut interleaved,
+                                        const unsigned int count) {
+    VECMATH_PROFILE_KERNEL("ComplexSplitToInterleaved",
+                           count,
+                           count * 4 * sizeof(float));
+    VECMATH_ASSERT(count % ComplexVecSize == 0);
+    for (unsigned int i(0); i < count; i += ComplexVecSize) {
+      FloatVec low;
+      FloatVec high;
+      ToInterleaved(Fill(&re[i], &im[i]), &low, &high);
+      PlatformVectorMath::Store(&interleaved[2 * i], low);
+      PlatformVectorMath::Store(
+        &interleaved[2 * i + PlatformVectorMath::FloatVecSize], high);
+    }
+  }
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_COMPLEX_H_
@@ -44,6 +44,14 @@
   #define _BUILD_CONFIGURATION_DEBUG 1
 #endif  // defined(NDEBUG) ?
 
+/// @brief Hot-path instrumentation (opt-in, see instrumentation.h):
+/// define VECMATH_INSTRUMENTATION to enable it, whatever the configuration
+#if(defined(VECMATH_INSTRUMENTATION))
+  #define _BUILD_CONFIGURATION_INSTRUMENTED 1
+#else  // defined(VECMATH_INSTRUMENTATION) ?
+  #define _BUILD_CONFIGURATION_INSTRUMENTED 0
+#endif  // defined(VECMATH_INSTRUMENTATION) ?
+
 /// @brief Architecture detection - compiler specific preprocessor macros
 #if _VEC_COMPILER_MSVC
   #if defined(_M_IX86)
@@ -70,4 +78,19 @@
   #endif
 #endif
 
+/// @brief Compiler vector extensions (vector_size attribute) availability
+#if (_VEC_COMPILER_GCC) && !defined(_DISABLE_VECTOR_EXTENSIONS)
+  #define _VEC_HAS_VECTOR_EXTENSIONS 1
+#else
+  #define _VEC_HAS_VECTOR_EXTENSIONS 0
+#endif
+
+/// @brief SSE4.1 enabling, based on compiler target flags
+/// (MSVC does not define __SSE4_1__, but AVX implies it)
+#if (_VEC_USE_SSE)
+  #if (defined(__SSE4_1__) || defined(__AVX__))
+    #define _VEC_USE_SSE4 1
+  #endif
+#endif
+
 #endif  // VECMATH_INC_CONFIGURATION_H_
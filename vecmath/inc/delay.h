@@ -0,0 +1,265 @@
+/// @file delay.h
+/// @brief Circular delay line with vectorized fractional reads
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// The buffer size is a power of two, followed by a copy of its first
+/// FloatVec ("mirrored padding"): any group of up to FloatVecSize + 1
+/// consecutive samples can be read without splitting around the end.
+///
+/// Samples are written one whole FloatVec at a time. Reads then return,
+/// for each element of the last written FloatVec, the input delayed by the
+/// matching element of a FloatVec of (fractional) delays: samples are
+/// gathered per element, the interpolation itself is vectorized.
+
+#ifndef VECMATH_INC_DELAY_H_
+#define VECMATH_INC_DELAY_H_
+
+#include <algorithm>
+#include <cmath>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/interpolation.h"
+#include "vecmath/inc/maths.h"
+#include "vecmath/inc/onepole.h"
+
+namespace vecmath {
+
+/// @brief Delay line, for chorus, flanger, comb and all-pass networks
+class DelayLine {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  enum Interpolation {
+    // Delays within [0 ; max]
+    kLinear = 0,
+    // First order all-pass, flat magnitude (for slowly modulated delays),
+    // delays within [1 ; max]
+    kAllpass,
+    // Catmull-Rom, delays within [1 ; max]
+    kCubic
+  };
+
+  /// @param[in]  max_delay   Longest delay to be read, in samples
+  explicit DelayLine(const unsigned int max_delay)
+      : max_delay_(max_delay),
+        size_(PowerOfTwoAbove(max_delay + 2 * PlatformVectorMath::FloatVecSize
+                              + 3)),
+        mask_(size_ - 1),
+        buffer_(size_ + PlatformVectorMath::FloatVecSize, 0.0f),
+        write_index_(0),
+        written_index_(0),
+        allpass_state_(0.0f) {
+    Reset();
+  }
+
+  /// @brief Clear the delayed samples and the all-pass state
+  void Reset() {
+    std::fill(buffer_.begin(), buffer_.end(), 0.0f);
+    write_index_ = 0;
+    // As if a null FloatVec had just been written
+    written_index_ = size_ - PlatformVectorMath::FloatVecSize;
+    allpass_state_ = 0.0f;
+  }
+
+  unsigned int MaxDelay() const {
+    return max_delay_;
+  }
+
+  /// @brief Push the next FloatVecSize input samples
+  void Write(FloatVecRead input) {
+    PlatformVectorMath::Store(&buffer_[write_index_], input);
+    if (write_index_ == 0) {
+      PlatformVectorMath::Store(&buffer_[size_], input);
+    }
+    written_index_ = write_index_;
+    write_index_ = (write_index_ + PlatformVectorMath::FloatVecSize) & mask_;
+  }
+
+  /// @brief Linear interpolated read, one delay per element
+  FloatVec ReadLinear(FloatVecRead delays) const {
+    const FloatVec clamped(Clamp(delays, 0.0f));
+    const FloatVec wholes(PlatformVectorMath::Floor(clamped));
+    FloatVec samples[2];
+    Gather<2>(wholes, samples);
+    // samples[1] is at "wholes", samples[0] one sample older
+    return InterpolationVectorMath::Linear(
+      samples[1], samples[0], PlatformVectorMath::Sub(clamped, wholes));
+  }
+
+  /// @brief Cubic interpolated read, one delay per element
+  FloatVec ReadCubic(FloatVecRead delays) const {
+    const FloatVec clamped(Clamp(delays, 1.0f));
+    const FloatVec wholes(PlatformVectorMath::Floor(clamped));
+    FloatVec samples[4];
+    Gather<4>(PlatformVectorMath::Sub(wholes, PlatformVectorMath::Fill(1.0f)),
+              samples);
+    // From the oldest sample: interpolate between samples[1] (at wholes + 1)
+    // and samples[2] (at wholes)
+    return InterpolationVectorMath::CatmullRom(
+      samples,
+      PlatformVectorMath::Sub(
+        PlatformVectorMath::Fill(1.0f),
+        PlatformVectorMath::Sub(clamped, wholes)));
+  }
+
+  /// @brief All-pass interpolated read, one delay per element
+  ///
+  /// y[n] = eta x[n - D] + x[n - D - 1] - eta y[n - 1],
+  /// eta = (1 - f) / (1 + f), delay = D + f with f within ]0 ; 1]
+  ///
+  /// @param[in]  delays   Delays, in samples
+  /// @param[in,out]  state   Previous output of this read
+  FloatVec ReadAllpass(FloatVecRead delays, float* const state) const {
+    const FloatVec kOne(PlatformVectorMath::Fill(1.0f));
+    const FloatVec clamped(Clamp(delays, 1.0f));
+    const FloatVec wholes(PlatformVectorMath::Sub(
+      PlatformVectorMath::Ceil(clamped),
+      kOne));
+    const FloatVec fractions(PlatformVectorMath::Sub(clamped, wholes));
+    const FloatVec etas(PlatformVectorMath::Div(
+      PlatformVectorMath::Sub(kOne, fractions),
+      PlatformVectorMath::Add(kOne, fractions)));
+    FloatVec samples[2];
+    Gather<2>(wholes, samples);
+    FloatVec products;
+    const FloatVec response(RecursiveVectorMath::ScanVarying(
+      PlatformVectorMath::MulAdd(etas, samples[1], samples[0]),
+      PlatformVectorMath::Sub(PlatformVectorMath::Fill(0.0f), etas),
+      &products));
+    const FloatVec output(PlatformVectorMath::MulAdd(
+      products,
+      PlatformVectorMath::Fill(*state),
+      response));
+    *state = PlatformVectorMath::GetByIndex<PlatformVectorMath::FloatVecSize
+                                            - 1>(output);
+    return output;
+  }
+
+  /// @brief Linear interpolated read, the same delay for all elements
+  ///
+  /// No gather: two unaligned loads
+  FloatVec ReadAt(const float delay) const {
+    const float clamped(std::min(std::max(delay, 0.0f),
+                                 static_cast<float>(max_delay_)));
+    const unsigned int whole(static_cast<unsigned int>(clamped));
+    const unsigned int start((written_index_ + size_ - whole - 1) & mask_);
+    return InterpolationVectorMath::Linear(
+      PlatformVectorMath::FillUnaligned(&buffer_[start + 1]),
+      PlatformVectorMath::FillUnaligned(&buffer_[start]),
+      PlatformVectorMath::Fill(clamped - static_cast<float>(whole)));
+  }
+
+  /// @brief Sum of several taps at fixed delays, e.g. early reflections or
+  /// the outputs of a feedback delay network line
+  ///
+  /// @param[in]  delays   Delay of each tap, in samples
+  /// @param[in]  gains   Gain of each tap
+  /// @param[in]  tap_count   Number of taps
+  FloatVec ReadTaps(const float* const delays,
+                    const float* const gains,
+                    const unsigned int tap_count) const {
+    FloatVec output(PlatformVectorMath::Fill(0.0f));
+    for (unsigned int tap(0); tap < tap_count; ++tap) {
+      output = PlatformVectorMath::MulAdd(PlatformVectorMath::Fill(gains[tap]),
+                                          ReadAt(delays[tap]),
+                                          output);
+    }
+    return output;
+  }
+
+  /// @brief Write the input then read it back at modulated delays
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[in]  delays   Aligned block of delays, one per sample
+  /// @param[out]  output   Aligned output block, may be the input
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  /// @param[in]  interpolation   Read interpolation kind
+  void Process(const float* const input,
+               const float* const delays,
+               float* const output,
+               const unsigned int length,
+               const Interpolation interpolation) {
+    VECMATH_PROFILE_KERNEL("DelayLine", length, length * 3 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      Write(PlatformVectorMath::Fill(&input[i]));
+      const FloatVec delay(PlatformVectorMath::Fill(&delays[i]));
+      FloatVec result;
+      if (interpolation == kLinear) {
+        result = ReadLinear(delay);
+      } else if (interpolation == kAllpass) {
+        result = ReadAllpass(delay, &allpass_state_);
+      } else {
+        result = ReadCubic(delay);
+      }
+      PlatformVectorMath::Store(&output[i], result);
+    }
+  }
+
+ private:
+  FloatVec Clamp(FloatVecRead delays, const float min_delay) const {
+    return PlatformVectorMath::Min(
+      PlatformVectorMath::Max(delays, PlatformVectorMath::Fill(min_delay)),
+      PlatformVectorMath::Fill(static_cast<float>(max_delay_)));
+  }
+
+  /// @brief For each element, gather Count consecutive samples, from the
+  /// one delayed by "wholes" + Count - 1 to the one delayed by "wholes"
+  ///
+  /// @param[in]  wholes   Integer delays, >= 1 - Count for each element
+  /// @param[out]  samples   Count FloatVecs, the oldest samples first
+  template <unsigned int Count>
+  void Gather(FloatVecRead wholes, FloatVec* samples) const {
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float delays[PlatformVectorMath::FloatVecSize];
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float gathered[Count][PlatformVectorMath::FloatVecSize];
+    PlatformVectorMath::Store(&delays[0], wholes);
+    for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+      // Plain integer conversion: the delays are integral, at least -1
+      const int back(static_cast<int>(delays[i]) + static_cast<int>(Count) - 1);
+      const unsigned int start(
+        (written_index_ + i + size_ - static_cast<unsigned int>(back))
+        & mask_);
+      for (unsigned int j(0); j < Count; ++j) {
+        gathered[j][i] = buffer_[start + j];
+      }
+    }
+    for (unsigned int j(0); j < Count; ++j) {
+      samples[j] = PlatformVectorMath::Fill(&gathered[j][0]);
+    }
+  }
+
+  const unsigned int max_delay_;
+  const unsigned int size_;
+  const unsigned int mask_;
+  AlignedVector<float> buffer_;
+  unsigned int write_index_;
+  /// Index of the last written FloatVec
+  unsigned int written_index_;
+  float allpass_state_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_DELAY_H_
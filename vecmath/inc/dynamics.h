@@ -0,0 +1,544 @@
+/// @file dynamics.h
+/// @brief Compressor and look-ahead limiter building blocks
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// A dynamics processor is a chain of block kernels:
+/// - detector: absolute value, the maximum over all channels when linked;
+/// - look-ahead: sliding maximum over the look-ahead window, the audio
+///   being delayed by the same amount;
+/// - gain computer: level to gain reduction, in dB, with a soft knee;
+/// - smoothing: attack/release envelope of the gain reduction;
+/// - gain: dB back to linear, applied to the delayed audio.
+
+#ifndef VECMATH_INC_DYNAMICS_H_
+#define VECMATH_INC_DYNAMICS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/approximations.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+#include "vecmath/inc/onepole.h"
+
+namespace vecmath {
+
+/// @brief Stateless conversions and gain computer
+struct DynamicsVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Element-wise 10^(dB / 20)
+  static inline FloatVec DecibelsToGain(FloatVecRead decibels) {
+    return ApproxVectorMath::Exp2(PlatformVectorMath::Mul(
+      decibels,
+      PlatformVectorMath::Fill(kDecibelsToLog2)));
+  }
+
+  /// @brief Element-wise 20 log10(gain)
+  ///
+  /// Gains below the smallest normal number return ~-758dB
+  static inline FloatVec GainToDecibels(FloatVecRead gain) {
+    return PlatformVectorMath::Mul(ApproxVectorMath::Log2(gain),
+                                   PlatformVectorMath::Fill(kLog2ToDecibels));
+  }
+
+  /// @brief Static curve: gain (dB, <= 0) to apply to the given level (dB)
+  ///
+  /// Below threshold - knee / 2 the gain is null, above threshold + knee / 2
+  /// the output level rises by 1 / ratio dB per input dB, a quadratic
+  /// joining both.
+  ///
+  /// @param[in]  level   Input levels, in dB
+  /// @param[in]  threshold   Threshold, in dB
+  /// @param[in]  slope   1 / ratio - 1, within [-1 ; 0] (-1: limiter)
+  /// @param[in]  knee   Knee width, in dB (0: hard knee)
+  static inline FloatVec GainComputer(FloatVecRead level,
+                                      const float threshold,
+                                      const float slope,
+                                      const float knee) {
+    const float half_knee(0.5f * knee);
+    const FloatVec over(PlatformVectorMath::Sub(
+      level,
+      PlatformVectorMath::Fill(threshold)));
+    // Distance into the knee, within [0 ; knee] while in the knee
+    const FloatVec into(PlatformVectorMath::Max(
+      PlatformVectorMath::Add(over, PlatformVectorMath::Fill(half_knee)),
+      PlatformVectorMath::Fill(0.0f)));
+    const FloatVec in_knee(PlatformVectorMath::Mul(
+      PlatformVectorMath::Mul(into, into),
+      PlatformVectorMath::Fill(
+        0.5f / (knee > kMinimumKnee ? knee : kMinimumKnee))));
+    const FloatVec above(PlatformVectorMath::LessThan(
+      PlatformVectorMath::Fill(knee),
+      into));
+    return PlatformVectorMath::Mul(PlatformVectorMath::Fill(slope),
+                                   PlatformVectorMath::Select(above,
+                                                              over,
+                                                              in_knee));
+  }
+
+  /// @brief Block 10^(dB / 20)
+  static inline void DecibelsToGain(BlockIn input,
+                                    const unsigned int length,
+                                    BlockOut output) {
+    VECMATH_PROFILE_KERNEL("DecibelsToGain", length, length * 2 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(&output[i],
+                                DecibelsToGain(PlatformVectorMath::Fill(&input[i])));
+    }
+  }
+
+  /// @brief Block 20 log10(gain)
+  static inline void GainToDecibels(BlockIn input,
+                                    const unsigned int length,
+                                    BlockOut output) {
+    VECMATH_PROFILE_KERNEL("GainToDecibels", length, length * 2 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(&output[i],
+                                GainToDecibels(PlatformVectorMath::Fill(&input[i])));
+    }
+  }
+
+ private:
+  /// @brief log2(10) / 20
+  static constexpr float kDecibelsToLog2 = 0.166096404744368f;
+  /// @brief 20 log10(2)
+  static constexpr float kLog2ToDecibels = 6.02059991327962f;
+  static constexpr float kMinimumKnee = 1e-6f;
+};
+
+/// @brief Maximum over the last "window" samples, including the current one
+///
+/// Van Herk / Gil-Werman algorithm: the stream is cut into segments of
+/// S samples (a multiple of FloatVecSize, S < window <= 2S + 1). Each
+/// window then spans the end of one or two previous segments, whose suffix
+/// maxima are stored when they complete, and the beginning of the current
+/// one, whose prefix maximum is running: a few Max per FloatVec, whatever
+/// the window length. Windows too short for such segments are computed
+/// directly from the last samples.
+class SlidingMaximum {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @param[in]  window   Window length, in samples (>= 1)
+  explicit SlidingMaximum(const unsigned int window)
+      : window_(window),
+        segment_(SegmentLength(window)),
+        inputs_(std::max(segment_, 3 * PlatformVectorMath::FloatVecSize)),
+        suffixes_(2 * segment_ + PlatformVectorMath::FloatVecSize),
+        lanes_(PlatformVectorMath::FloatVecSize) {
+    VECMATH_ASSERT(window > 0);
+    for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+      lanes_[i] = static_cast<float>(i);
+    }
+    Reset();
+  }
+
+  /// @brief Window length, in samples
+  unsigned int Window() const {
+    return window_;
+  }
+
+  /// @brief Restart, as if all previous samples were "value"
+  void Reset(const float value = 0.0f) {
+    std::fill(inputs_.begin(), inputs_.end(), value);
+    std::fill(suffixes_.begin(), suffixes_.end(), value);
+    prefix_ = std::numeric_limits<float>::lowest();
+    segment_position_ = 0;
+    ring_position_ = 0;
+  }
+
+  /// @brief Process a whole block
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[out]  output   Aligned output block
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  void Process(BlockIn input, BlockOut output, const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("SlidingMaximum", length, length * 2 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    if (segment_ == 0) {
+      ProcessShort(input, output, length);
+      return;
+    }
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    const unsigned int ring_length(2 * segment_);
+    const FloatVec lanes(PlatformVectorMath::Fill(&lanes_[0]));
+    for (unsigned int i(0); i < length; i += kVecSize) {
+      const FloatVec value(PlatformVectorMath::Fill(&input[i]));
+      PlatformVectorMath::Store(&inputs_[segment_position_], value);
+      // Current segment
+      const FloatVec prefix(PlatformVectorMath::Max(
+        MaxScan(value),
+        PlatformVectorMath::Fill(prefix_)));
+      prefix_ = PlatformVectorMath::GetByIndex<kVecSize - 1>(prefix);
+      // Previous segment(s), from the window start: the ring holds the
+      // two previous segments, mirrored so that any unaligned read is valid
+      const unsigned int start((ring_position_ + segment_position_
+                                + ring_length - (window_ - 1)) % ring_length);
+      FloatVec output_value(PlatformVectorMath::Max(
+        prefix,
+        PlatformVectorMath::FillUnaligned(&suffixes_[start])));
+      // Elements whose window starts two segments ago: the whole previous
+      // segment is within their window
+      const int before_previous(static_cast<int>(window_ - 1 - segment_)
+                                - static_cast<int>(segment_position_));
+      if (before_previous > 0) {
+        const float previous(
+          suffixes_[(ring_position_ + segment_) % ring_length]);
+        output_value = PlatformVectorMath::Select(
+          PlatformVectorMath::LessThan(
+            lanes,
+            PlatformVectorMath::Fill(static_cast<float>(before_previous))),
+          PlatformVectorMath::Max(output_value,
+                                  PlatformVectorMath::Fill(previous)),
+          output_value);
+      }
+      PlatformVectorMath::Store(&output[i], output_value);
+      segment_position_ += kVecSize;
+      if (segment_position_ == segment_) {
+        CloseSegment();
+      }
+    }
+  }
+
+ private:
+  /// @brief Segment length, 0 if too short
+  static unsigned int SegmentLength(const unsigned int window) {
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    if (window + 1 < 2 * kVecSize) {
+      return 0;
+    }
+    return kVecSize * ((window - 1) / kVecSize);
+  }
+
+  /// @brief Element-wise maximum of all elements up to this one
+  static inline FloatVec MaxScan(FloatVecRead input) {
+    return MaxScanSteps<1>::Apply(input);
+  }
+
+  template <unsigned Count,
+            bool Done = (Count >= PlatformVectorMath::FloatVecSize)>
+  struct MaxScanSteps {
+    static inline FloatVec Apply(FloatVecRead input) {
+      return MaxScanSteps<Count * 2>::Apply(PlatformVectorMath::Max(
+        input,
+        PlatformVectorMath::ShiftOnRight<Count>(
+          input,
+          std::numeric_limits<float>::lowest())));
+    }
+  };
+
+  template <unsigned Count>
+  struct MaxScanSteps<Count, true> {
+    static inline FloatVec Apply(FloatVecRead input) {
+      return input;
+    }
+  };
+
+  /// @brief Store the suffix maxima of the completed segment over the
+  /// oldest one, which is not needed anymore
+  void CloseSegment() {
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    float carry(std::numeric_limits<float>::lowest());
+    for (unsigned int j(segment_); j > 0; j -= kVecSize) {
+      const FloatVec suffix(PlatformVectorMath::Max(
+        PlatformVectorMath::Revert(MaxScan(PlatformVectorMath::Revert(
+          PlatformVectorMath::Fill(&inputs_[j - kVecSize])))),
+        PlatformVectorMath::Fill(carry)));
+      PlatformVectorMath::Store(&suffixes_[ring_position_ + j - kVecSize],
+                                suffix);
+      carry = PlatformVectorMath::GetByIndex<0>(suffix);
+    }
+    if (ring_position_ == 0) {
+      std::copy(suffixes_.begin(),
+                suffixes_.begin() + kVecSize,
+                suffixes_.begin() + 2 * segment_);
+    }
+    ring_position_ = (ring_position_ + segment_) % (2 * segment_);
+    segment_position_ = 0;
+    prefix_ = std::numeric_limits<float>::lowest();
+  }
+
+  /// @brief Short windows: Max of shifted unaligned reads over the last
+  /// 3 FloatVecs (window <= 2 FloatVecSize - 2)
+  void ProcessShort(BlockIn input, BlockOut output, const unsigned int length) {
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    float* const recent(&inputs_[0]);
+    for (unsigned int i(0); i < length; i += kVecSize) {
+      std::copy(recent + kVecSize, recent + 3 * kVecSize, recent);
+      PlatformVectorMath::Store(&recent[2 * kVecSize],
+                                PlatformVectorMath::Fill(&input[i]));
+      FloatVec output_value(PlatformVectorMath::Fill(&recent[2 * kVecSize]));
+      for (unsigned int k(1); k < window_; ++k) {
+        output_value = PlatformVectorMath::Max(
+          output_value,
+          PlatformVectorMath::FillUnaligned(&recent[2 * kVecSize - k]));
+      }
+      PlatformVectorMath::Store(&output[i], output_value);
+    }
+  }
+
+  const unsigned int window_;
+  // Segment length, 0 for short windows
+  const unsigned int segment_;
+  // Current segment samples (short windows: last 3 FloatVecs)
+  AlignedVector<float> inputs_;
+  // Suffix maxima of the two previous segments, first FloatVec mirrored
+  AlignedVector<float> suffixes_;
+  AlignedVector<float> lanes_;
+  float prefix_;
+  unsigned int segment_position_;
+  unsigned int ring_position_;
+};
+
+/// @brief Multichannel compressor / look-ahead limiter
+///
+/// With a ratio of 0 (infinite) and an attack time about the look-ahead
+/// length, peaks are caught before they reach the output.
+/// Output is delayed by Latency() samples.
+class DynamicsProcessor {
+ public:
+  /// @param[in]  channels   Number of channels
+  /// @param[in]  max_block_length   Longest block, multiple of FloatVecSize
+  /// @param[in]  sampling_rate   Sampling rate, in Hz
+  /// @param[in]  lookahead   Look-ahead length, in samples
+  /// @param[in]  linked   If true, all channels share the same gain,
+  ///                      computed from their maximum
+  DynamicsProcessor(const unsigned int channels,
+                    const unsigned int max_block_length,
+                    const float sampling_rate,
+                    const unsigned int lookahead,
+                    const bool linked = true)
+      : channels_(channels),
+        max_block_length_(max_block_length),
+        sampling_rate_(sampling_rate),
+        lookahead_(lookahead),
+        linked_(linked),
+        threshold_(0.0f),
+        slope_(0.0f),
+        knee_(0.0f),
+        makeup_(0.0f),
+        detector_(max_block_length),
+        held_(max_block_length),
+        reduction_(max_block_length),
+        gain_reduction_(linked ? 1 : channels, 0.0f) {
+    VECMATH_ASSERT(channels > 0);
+    VECMATH_ASSERT(max_block_length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int detectors(linked ? 1 : channels);
+    for (unsigned int detector(0); detector < detectors; ++detector) {
+      maxima_.push_back(SlidingMaximum(lookahead + 1));
+      smoothers_.push_back(EnvelopeFollower(1.0f, 1.0f));
+    }
+    for (unsigned int channel(0); channel < channels; ++channel) {
+      delays_.push_back(AlignedVector<float>(lookahead + max_block_length,
+                                             0.0f));
+    }
+    SetTimes(0.001f, 0.1f);
+  }
+
+  /// @brief Threshold, in dB
+  void SetThreshold(const float threshold) {
+    threshold_ = threshold;
+  }
+
+  /// @brief Compression ratio (>= 1), 0 for an infinite one (limiter)
+  void SetRatio(const float ratio) {
+    VECMATH_ASSERT(ratio == 0.0f || ratio >= 1.0f);
+    slope_ = ratio == 0.0f ? -1.0f : 1.0f / ratio - 1.0f;
+  }
+
+  /// @brief Soft knee width, in dB
+  void SetKnee(const float knee) {
+    VECMATH_ASSERT(knee >= 0.0f);
+    knee_ = knee;
+  }
+
+  /// @brief Gain applied after compression, in dB
+  void SetMakeup(const float makeup) {
+    makeup_ = makeup;
+  }
+
+  /// @brief Attack and release time constants, in seconds
+  void SetTimes(const float attack, const float release) {
+    const EnvelopeFollower reference(
+      EnvelopeFollower::FromTimes(attack, release, sampling_rate_));
+    for (EnvelopeFollower& smoother : smoothers_) {
+      const float state(smoother.State());
+      smoother = reference;
+      smoother.Reset(state);
+    }
+  }
+
+  /// @brief Delay of the output, in samples
+  unsigned int Latency() const {
+    return lookahead_;
+  }
+
+  /// @brief Current gain reduction of the given detector (0 if linked),
+  /// in dB (>= 0)
+  float GainReduction(const unsigned int detector = 0) const {
+    VECMATH_ASSERT(detector < gain_reduction_.size());
+    return gain_reduction_[detector];
+  }
+
+  void Reset() {
+    for (SlidingMaximum& maximum : maxima_) {
+      maximum.Reset();
+    }
+    for (EnvelopeFollower& smoother : smoothers_) {
+      smoother.Reset();
+    }
+    for (AlignedVector<float>& delay : delays_) {
+      std::fill(delay.begin(), delay.end(), 0.0f);
+    }
+    std::fill(gain_reduction_.begin(), gain_reduction_.end(), 0.0f);
+  }
+
+  /// @brief Process a whole block, in-place processing being allowed
+  ///
+  /// @param[in]  inputs   One aligned block per channel
+  /// @param[out]  outputs   One aligned block per channel
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  void Process(const float* const* inputs,
+               float* const* outputs,
+               const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("DynamicsProcessor",
+                           length * channels_,
+                           length * channels_ * 2 * sizeof(float));
+    VECMATH_ASSERT(length <= max_block_length_);
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    // Delay lines first: outputs may be the inputs
+    for (unsigned int channel(0); channel < channels_; ++channel) {
+      std::copy(inputs[channel],
+                inputs[channel] + length,
+                delays_[channel].begin() + lookahead_);
+    }
+    if (linked_) {
+      Detect(inputs, 0, channels_, length);
+      ComputeGains(0, length);
+      for (unsigned int channel(0); channel < channels_; ++channel) {
+        ApplyGains(channel, outputs[channel], length);
+      }
+    } else {
+      for (unsigned int channel(0); channel < channels_; ++channel) {
+        Detect(inputs, channel, 1, length);
+        ComputeGains(channel, length);
+        ApplyGains(channel, outputs[channel], length);
+      }
+    }
+    for (AlignedVector<float>& delay : delays_) {
+      std::copy(delay.begin() + length,
+                delay.begin() + length + lookahead_,
+                delay.begin());
+    }
+  }
+
+ private:
+  /// @brief Detector: maximum absolute value of the given channels
+  void Detect(const float* const* inputs,
+              const unsigned int first,
+              const unsigned int count,
+              const unsigned int length) {
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::FloatVec level(CommonVectorMath::Abs(
+        PlatformVectorMath::Fill(&inputs[first][i])));
+      for (unsigned int channel(first + 1); channel < first + count; ++channel) {
+        level = PlatformVectorMath::Max(
+          level,
+          CommonVectorMath::Abs(PlatformVectorMath::Fill(&inputs[channel][i])));
+      }
+      PlatformVectorMath::Store(&detector_[i], level);
+    }
+  }
+
+  /// @brief Look-ahead, gain computer and smoothing: linear gains into held_
+  void ComputeGains(const unsigned int detector, const unsigned int length) {
+    maxima_[detector].Process(&detector_[0], &held_[0], length);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      // Gain reduction, positive
+      PlatformVectorMath::Store(
+        &reduction_[i],
+        PlatformVectorMath::Sub(
+          PlatformVectorMath::Fill(0.0f),
+          DynamicsVectorMath::GainComputer(
+            DynamicsVectorMath::GainToDecibels(
+              PlatformVectorMath::Fill(&held_[i])),
+            threshold_,
+            slope_,
+            knee_)));
+    }
+    smoothers_[detector].Process(&reduction_[0], &detector_[0], length);
+    gain_reduction_[detector] = smoothers_[detector].State();
+    const PlatformVectorMath::FloatVec makeup(
+      PlatformVectorMath::Fill(makeup_));
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(
+        &held_[i],
+        DynamicsVectorMath::DecibelsToGain(PlatformVectorMath::Sub(
+          makeup,
+          PlatformVectorMath::Fill(&detector_[i]))));
+    }
+  }
+
+  /// @brief Delayed input times the gains computed in held_
+  void ApplyGains(const unsigned int channel,
+                  float* const output,
+                  const unsigned int length) {
+    const float* const delayed(&delays_[channel][0]);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(
+        &output[i],
+        PlatformVectorMath::Mul(PlatformVectorMath::Fill(&delayed[i]),
+                                PlatformVectorMath::Fill(&held_[i])));
+    }
+  }
+
+  const unsigned int channels_;
+  const unsigned int max_block_length_;
+  const float sampling_rate_;
+  const unsigned int lookahead_;
+  const bool linked_;
+  float threshold_;
+  float slope_;
+  float knee_;
+  float makeup_;
+  // One per detector (a single one if linked)
+  std::vector<SlidingMaximum> maxima_;
+  std::vector<EnvelopeFollower> smoothers_;
+  // Per channel: lookahead_ delayed samples, then the current block
+  std::vector<AlignedVector<float> > delays_;
+  // Work buffers
+  AlignedVector<float> detector_;
+  AlignedVector<float> held_;
+  AlignedVector<float> reduction_;
+  std::vector<float> gain_reduction_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_DYNAMICS_H_
@@ -0,0 +1,547 @@
+/// @file fft.h
+/// @brief Mixed radix (2, 3, 4, 5) complex and real FFT
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Complex data is interleaved (re0, im0, re1, im1, ...), as in complex.h.
+/// Transforms are computed in place on aligned buffers: each stage is a
+/// decimation in frequency butterfly pass, followed by a digit-reversal
+/// permutation. Plans are immutable once built, hence may be shared
+/// between threads. Inverse transforms are not normalized:
+/// Inverse(Forward(x)) = size * x
+
+#ifndef VECMATH_INC_FFT_H_
+#define VECMATH_INC_FFT_H_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/complex.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Complex to complex FFT plan, for sizes 2^a * 3^b * 5^c
+class ComplexFFT {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Check whether the given transform size is supported
+  static inline bool IsSupportedSize(const unsigned int size) {
+    if (size == 0) {
+      return false;
+    }
+    unsigned int remaining(size);
+    const unsigned int kRadices[] = {2, 3, 5};
+    for (unsigned int radix : kRadices) {
+      while (remaining % radix == 0) {
+        remaining /= radix;
+      }
+    }
+    return remaining == 1;
+  }
+
+  /// @brief Build the plan: stages, twiddles and output permutation
+  ///
+  /// @param[in]  size   Transform size, in complex values
+  explicit ComplexFFT(const unsigned int size)
+      : size_(size) {
+    VECMATH_ASSERT(IsSupportedSize(size));
+    BuildStages();
+    BuildPermutation();
+  }
+
+  /// @brief Transform size, in complex values
+  unsigned int Size() const {
+    return size_;
+  }
+
+  /// @brief Forward transform, in place
+  ///
+  /// @param[in,out]  data   "Size()" interleaved complex values, aligned
+  void Forward(float* const data) const {
+    VECMATH_PROFILE_KERNEL("ComplexFFTForward",
+                           size_,
+                           size_ * 4 * sizeof(float) * stages_.size());
+    Transform<false>(data);
+  }
+
+  /// @brief Inverse (not normalized) transform, in place
+  ///
+  /// @param[in,out]  data   "Size()" interleaved complex values, aligned
+  void Inverse(float* const data) const {
+    VECMATH_PROFILE_KERNEL("ComplexFFTInverse",
+                           size_,
+                           size_ * 4 * sizeof(float) * stages_.size());
+    Transform<true>(data);
+  }
+
+ private:
+  /// @brief One butterfly pass: sub-transforms of "length" complex values,
+  /// each split into "radix" interleaved sub-sequences of "span" values
+  struct Stage {
+    unsigned int radix;
+    unsigned int length;
+    unsigned int span;
+    /// Offset of this stage twiddles, in floats
+    unsigned int twiddles;
+  };
+
+  /// @brief Butterfly operations on FloatVec: InterleavedSize values at once
+  struct VectorOps {
+    typedef FloatVec Type;
+    static constexpr unsigned int Count = ComplexVectorMath::InterleavedSize;
+
+    static inline Type Load(const float* const data) {
+      return PlatformVectorMath::Fill(data);
+    }
+    static inline void Store(float* const data, const Type& value) {
+      PlatformVectorMath::Store(data, value);
+    }
+    static inline Type Add(const Type& left, const Type& right) {
+      return PlatformVectorMath::Add(left, right);
+    }
+    static inline Type Sub(const Type& left, const Type& right) {
+      return PlatformVectorMath::Sub(left, right);
+    }
+    static inline Type Scale(const float factor, const Type& value) {
+      return PlatformVectorMath::Mul(PlatformVectorMath::Fill(factor), value);
+    }
+    /// @brief Multiply by -i (forward) or i (inverse)
+    template <bool Inverse>
+    static inline Type Rotate(const Type& value) {
+      // AddSub(0, (im, re)) = (-im, re) = i * value
+      const Type rotated(PlatformVectorMath::AddSub(
+        PlatformVectorMath::Fill(0.0f),
+        PlatformVectorMath::SwapPairs(value)));
+      return Inverse
+             ? rotated
+             : PlatformVectorMath::Sub(PlatformVectorMath::Fill(0.0f),
+                                       rotated);
+    }
+    /// @brief Multiply by the twiddle (forward) or its conjugate (inverse)
+    template <bool Inverse>
+    static inline Type Twiddle(const Type& value,
+                               const float* const twiddle) {
+      return Inverse
+             ? ComplexVectorMath::MulConjInterleaved(value, Load(twiddle))
+             : ComplexVectorMath::MulInterleaved(value, Load(twiddle));
+    }
+  };
+
+  /// @brief Butterfly operations on a single complex value
+  struct ScalarOps {
+    struct Type {
+      float re;
+      float im;
+    };
+    static constexpr unsigned int Count = 1;
+
+    static inline Type Load(const float* const data) {
+      const Type output = {data[0], data[1]};
+      return output;
+    }
+    static inline void Store(float* const data, const Type& value) {
+      data[0] = value.re;
+      data[1] = value.im;
+    }
+    static inline Type Add(const Type& left, const Type& right) {
+      const Type output = {left.re + right.re, left.im + right.im};
+      return output;
+    }
+    static inline Type Sub(const Type& left, const Type& right) {
+      const Type output = {left.re - right.re, left.im - right.im};
+      return output;
+    }
+    static inline Type Scale(const float factor, const Type& value) {
+      const Type output = {factor * value.re, factor * value.im};
+      return output;
+    }
+    template <bool Inverse>
+    static inline Type Rotate(const Type& value) {
+      const Type output = {Inverse ? -value.im : value.im,
+                           Inverse ? value.re : -value.re};
+      return output;
+    }
+    template <bool Inverse>
+    static inline Type Twiddle(const Type& value,
+                               const float* const twiddle) {
+      const float im(Inverse ? -twiddle[1] : twiddle[1]);
+      const Type output = {value.re * twiddle[0] - value.im * im,
+                           value.re * im + value.im * twiddle[0]};
+      return output;
+    }
+  };
+
+  /// @brief Factorize the size into stages, odd radices first so that
+  /// most spans are even (hence vectorizable), radix-4 then radix-2 last
+  void BuildStages() {
+    std::vector<unsigned int> radices;
+    unsigned int remaining(size_);
+    const unsigned int kOddRadices[] = {5, 3};
+    for (unsigned int radix : kOddRadices) {
+      while (remaining % radix == 0) {
+        radices.push_back(radix);
+        remaining /= radix;
+      }
+    }
+    while (remaining % 4 == 0) {
+      radices.push_back(4);
+      remaining /= 4;
+    }
+    if (remaining == 2) {
+      radices.push_back(2);
+    }
+
+    const double kTwoPi(6.283185307179586);
+    unsigned int length(size_);
+    for (unsigned int radix : radices) {
+      const Stage stage = {radix,
+                           length,
+                           length / radix,
+                           static_cast<unsigned int>(twiddles_.size())};
+      // Twiddles W_length^(j * k), for k in [1 ; radix[ and j in [0 ; span[
+      for (unsigned int k(1); k < radix; ++k) {
+        for (unsigned int j(0); j < stage.span; ++j) {
+          const double angle(-kTwoPi * j * k / length);
+          twiddles_.push_back(static_cast<float>(std::cos(angle)));
+          twiddles_.push_back(static_cast<float>(std::sin(angle)));
+        }
+      }
+      // Keep each stage twiddles aligned
+      while (twiddles_.size() % PlatformVectorMath::FloatVecSize != 0) {
+        twiddles_.push_back(0.0f);
+      }
+      stages_.push_back(stage);
+      length = stage.span;
+    }
+  }
+
+  /// @brief Compute the digit-reversal permutation as a list of swaps
+  void BuildPermutation() {
+    // source[frequency] = position of this frequency after all stages
+    std::vector<unsigned int> source(size_);
+    for (unsigned int position(0); position < size_; ++position) {
+      unsigned int remainder(position);
+      unsigned int frequency(0);
+      unsigned int weight(1);
+      for (const Stage& stage : stages_) {
+        frequency += (remainder / stage.span) * weight;
+        remainder %= stage.span;
+        weight *= stage.radix;
+      }
+      source[frequency] = position;
+    }
+    // In place permutation, following each cycle from its smallest index
+    for (unsigned int i(0); i < size_; ++i) {
+      unsigned int k(source[i]);
+      while (k < i) {
+        k = source[k];
+      }
+      if (k != i) {
+        swaps_.push_back(2 * i);
+        swaps_.push_back(2 * k);
+      }
+    }
+  }
+
+  template <bool Inverse>
+  void Transform(float* const data) const {
+    VECMATH_ASSERT(IsAligned(data, PlatformVectorMath::FloatVecSizeBytes));
+    for (const Stage& stage : stages_) {
+      switch (stage.radix) {
+        case 2: RunStage<2, Inverse>(data, stage); break;
+        case 3: RunStage<3, Inverse>(data, stage); break;
+        case 4: RunStage<4, Inverse>(data, stage); break;
+        case 5: RunStage<5, Inverse>(data, stage); break;
+        default: VECMATH_ASSERT(false); break;
+      }
+    }
+    // Each complex value is moved as a whole
+    for (unsigned int i(0); i < swaps_.size(); i += 2) {
+      float* const left(&data[swaps_[i]]);
+      float* const right(&data[swaps_[i + 1]]);
+      std::uint64_t left_value;
+      std::uint64_t right_value;
+      std::memcpy(&left_value, left, sizeof(left_value));
+      std::memcpy(&right_value, right, sizeof(right_value));
+      std::memcpy(left, &right_value, sizeof(right_value));
+      std::memcpy(right, &left_value, sizeof(left_value));
+    }
+  }
+
+  /// @brief Select the implementation of the given stage
+  template <unsigned int Radix, bool Inverse>
+  void RunStage(float* const data, const Stage& stage) const {
+    if (stage.span % VectorOps::Count == 0) {
+      RunStage<VectorOps, Radix, Inverse>(data, stage);
+    } else if (stage.span == 1
+               && PlatformVectorMath::FloatVecSize == 4
+               && Radix == 4) {
+      RunLastRadix4<Inverse>(data);
+    } else if (stage.span == 1
+               && PlatformVectorMath::FloatVecSize == 4
+               && Radix == 2
+               && size_ % 4 == 0) {
+      RunLastRadix2(data);
+    } else {
+      RunStage<ScalarOps, Radix, Inverse>(data, stage);
+    }
+  }
+
+  /// @brief Generic butterfly pass, Ops::Count sub-sequences at once
+  template <typename Ops, unsigned int Radix, bool Inverse>
+  void RunStage(float* const data, const Stage& stage) const {
+    const float* const twiddles(&twiddles_[stage.twiddles]);
+    for (unsigned int block(0); block < size_; block += stage.length) {
+      for (unsigned int j(0); j < stage.span; j += Ops::Count) {
+        float* const base(&data[2 * (block + j)]);
+        typename Ops::Type values[Radix];
+        for (unsigned int q(0); q < Radix; ++q) {
+          values[q] = Ops::Load(&base[2 * q * stage.span]);
+        }
+        Butterfly<Ops, Inverse>(values);
+        Ops::Store(base, values[0]);
+        for (unsigned int k(1); k < Radix; ++k) {
+          Ops::Store(&base[2 * k * stage.span],
+                     Ops::template Twiddle<Inverse>(
+                       values[k],
+                       &twiddles[2 * ((k - 1) * stage.span + j)]));
+        }
+      }
+    }
+  }
+
+  /// @brief Last radix-4 pass (span 1, no twiddles): each block of
+  /// 4 values fits into 2 FloatVec, butterflies are made of half swaps
+  template <bool Inverse>
+  void RunLastRadix4(float* const data) const {
+    for (unsigned int i(0); i < 2 * size_; i += 8) {
+      const FloatVec low(PlatformVectorMath::Fill(&data[i]));
+      const FloatVec high(PlatformVectorMath::Fill(&data[i + 4]));
+      // (x0 + x2, x1 + x3) and (x0 - x2, x1 - x3)
+      const FloatVec sum(PlatformVectorMath::Add(low, high));
+      const FloatVec diff(PlatformVectorMath::Sub(low, high));
+      const FloatVec rotated(VectorOps::Rotate<Inverse>(diff));
+      const FloatVec even(PlatformVectorMath::TakeEachLeftHalf(sum, diff));
+      const FloatVec odd(PlatformVectorMath::TakeEachRightHalf(sum, rotated));
+      PlatformVectorMath::Store(&data[i], PlatformVectorMath::Add(even, odd));
+      PlatformVectorMath::Store(&data[i + 4],
+                                PlatformVectorMath::Sub(even, odd));
+    }
+  }
+
+  /// @brief Last radix-2 pass (span 1, no twiddles), two blocks at once
+  void RunLastRadix2(float* const data) const {
+    for (unsigned int i(0); i < 2 * size_; i += 8) {
+      const FloatVec first(PlatformVectorMath::Fill(&data[i]));
+      const FloatVec second(PlatformVectorMath::Fill(&data[i + 4]));
+      const FloatVec even(PlatformVectorMath::TakeEachLeftHalf(first, second));
+      const FloatVec odd(PlatformVectorMath::TakeEachRightHalf(first, second));
+      const FloatVec sum(PlatformVectorMath::Add(even, odd));
+      const FloatVec diff(PlatformVectorMath::Sub(even, odd));
+      PlatformVectorMath::Store(&data[i],
+                                PlatformVectorMath::TakeEachLeftHalf(sum, diff));
+      PlatformVectorMath::Store(&data[i + 4],
+                                PlatformVectorMath::TakeEachRightHalf(sum,
+                                                                      diff));
+    }
+  }
+
+  template <typename Ops, bool Inverse>
+  static inline void Butterfly(typename Ops::Type (&x)[2]) {
+    const typename Ops::Type sum(Ops::Add(x[0], x[1]));
+    x[1] = Ops::Sub(x[0], x[1]);
+    x[0] = sum;
+  }
+
+  template <typename Ops, bool Inverse>
+  static inline void Butterfly(typename Ops::Type (&x)[3]) {
+    const float kSinThird(0.86602540378444f);
+    const typename Ops::Type sum(Ops::Add(x[1], x[2]));
+    const typename Ops::Type half(Ops::Sub(x[0], Ops::Scale(0.5f, sum)));
+    const typename Ops::Type rotated(Ops::template Rotate<Inverse>(
+      Ops::Scale(kSinThird, Ops::Sub(x[1], x[2]))));
+    x[0] = Ops::Add(x[0], sum);
+    x[1] = Ops::Add(half, rotated);
+    x[2] = Ops::Sub(half, rotated);
+  }
+
+  template <typename Ops, bool Inverse>
+  static inline void Butterfly(typename Ops::Type (&x)[4]) {
+    const typename Ops::Type a(Ops::Add(x[0], x[2]));
+    const typename Ops::Type b(Ops::Sub(x[0], x[2]));
+    const typename Ops::Type c(Ops::Add(x[1], x[3]));
+    const typename Ops::Type d(Ops::template Rotate<Inverse>(
+      Ops::Sub(x[1], x[3])));
+    x[0] = Ops::Add(a, c);
+    x[1] = Ops::Add(b, d);
+    x[2] = Ops::Sub(a, c);
+    x[3] = Ops::Sub(b, d);
+  }
+
+  template <typename Ops, bool Inverse>
+  static inline void Butterfly(typename Ops::Type (&x)[5]) {
+    // cos/sin(2 pi / 5), cos/sin(4 pi / 5)
+    const float kCos1(0.30901699437495f);
+    const float kCos2(-0.80901699437495f);
+    const float kSin1(0.95105651629515f);
+    const float kSin2(0.58778525229247f);
+    const typename Ops::Type t1(Ops::Add(x[1], x[4]));
+    const typename Ops::Type t2(Ops::Add(x[2], x[3]));
+    const typename Ops::Type t3(Ops::Sub(x[1], x[4]));
+    const typename Ops::Type t4(Ops::Sub(x[2], x[3]));
+    const typename Ops::Type a1(Ops::Add(
+      x[0], Ops::Add(Ops::Scale(kCos1, t1), Ops::Scale(kCos2, t2))));
+    const typename Ops::Type a2(Ops::Add(
+      x[0], Ops::Add(Ops::Scale(kCos2, t1), Ops::Scale(kCos1, t2))));
+    const typename Ops::Type b1(Ops::template Rotate<Inverse>(
+      Ops::Add(Ops::Scale(kSin1, t3), Ops::Scale(kSin2, t4))));
+    const typename Ops::Type b2(Ops::template Rotate<Inverse>(
+      Ops::Sub(Ops::Scale(kSin2, t3), Ops::Scale(kSin1, t4))));
+    x[0] = Ops::Add(x[0], Ops::Add(t1, t2));
+    x[1] = Ops::Add(a1, b1);
+    x[2] = Ops::Add(a2, b2);
+    x[3] = Ops::Sub(a2, b2);
+    x[4] = Ops::Sub(a1, b1);
+  }
+
+  unsigned int size_;
+  std::vector<Stage> stages_;
+  AlignedVector<float> twiddles_;
+  /// Digit-reversal permutation, as (left, right) pairs of swapped
+  /// complex values offsets (in floats)
+  std::vector<unsigned int> swaps_;
+};
+
+/// @brief Real to complex FFT plan, for even sizes with size / 2 supported
+/// by ComplexFFT
+///
+/// Computed as a half size complex FFT followed by a split pass.
+/// The spectrum is packed into "size" floats: bin 0 and bin size / 2 (both
+/// real) come first, then bins [1 ; size / 2[ as interleaved complex values
+class RealFFT {
+ public:
+  /// @brief Check whether the given transform size is supported
+  static inline bool IsSupportedSize(const unsigned int size) {
+    return size % 2 == 0 && ComplexFFT::IsSupportedSize(size / 2);
+  }
+
+  /// @param[in]  size   Transform size, in real values
+  explicit RealFFT(const unsigned int size)
+      : size_(size),
+        complex_(size / 2) {
+    VECMATH_ASSERT(IsSupportedSize(size));
+    const double kTwoPi(6.283185307179586);
+    // W_size^k, for k in [0 ; size / 4]
+    for (unsigned int k(0); k <= size_ / 4; ++k) {
+      const double angle(-kTwoPi * k / size_);
+      twiddles_.push_back(static_cast<float>(std::cos(angle)));
+      twiddles_.push_back(static_cast<float>(std::sin(angle)));
+    }
+  }
+
+  /// @brief Transform size, in real values
+  unsigned int Size() const {
+    return size_;
+  }
+
+  /// @brief Forward transform, in place
+  ///
+  /// @param[in,out]  data   "Size()" real values, aligned;
+  ///                        replaced by the packed spectrum
+  void Forward(float* const data) const {
+    complex_.Forward(data);
+    VECMATH_PROFILE_KERNEL("RealFFTSplit", size_, size_ * 2 * sizeof(float));
+    const unsigned int half(size_ / 2);
+    const float re0(data[0]);
+    const float im0(data[1]);
+    data[0] = re0 + im0;
+    data[1] = re0 - im0;
+    for (unsigned int k(1); k <= half - k; ++k) {
+      float* const left(&data[2 * k]);
+      float* const right(&data[2 * (half - k)]);
+      // Even part: (Z[k] + conj(Z[half - k])) / 2
+      const float even_re(0.5f * (left[0] + right[0]));
+      const float even_im(0.5f * (left[1] - right[1]));
+      // Odd part: -i (Z[k] - conj(Z[half - k])) / 2
+      const float odd_re(0.5f * (left[1] + right[1]));
+      const float odd_im(-0.5f * (left[0] - right[0]));
+      // W^k * odd
+      const float w_re(twiddles_[2 * k]);
+      const float w_im(twiddles_[2 * k + 1]);
+      const float product_re(w_re * odd_re - w_im * odd_im);
+      const float product_im(w_re * odd_im + w_im * odd_re);
+      left[0] = even_re + product_re;
+      left[1] = even_im + product_im;
+      right[0] = even_re - product_re;
+      right[1] = -(even_im - product_im);
+    }
+  }
+
+  /// @brief Inverse (not normalized) transform, in place
+  ///
+  /// @param[in,out]  data   Packed spectrum of "Size()" floats, aligned;
+  ///                        replaced by "Size()" real values
+  void Inverse(float* const data) const {
+    {
+      VECMATH_PROFILE_KERNEL("RealFFTMerge", size_, size_ * 2 * sizeof(float));
+      const unsigned int half(size_ / 2);
+      const float first(data[0]);
+      const float last(data[1]);
+      data[0] = first + last;
+      data[1] = first - last;
+      for (unsigned int k(1); k <= half - k; ++k) {
+        float* const left(&data[2 * k]);
+        float* const right(&data[2 * (half - k)]);
+        // Even part: X[k] + conj(X[half - k])
+        const float even_re(left[0] + right[0]);
+        const float even_im(left[1] - right[1]);
+        // Odd part: conj(W^k) (X[k] - conj(X[half - k]))
+        const float diff_re(left[0] - right[0]);
+        const float diff_im(left[1] + right[1]);
+        const float w_re(twiddles_[2 * k]);
+        const float w_im(-twiddles_[2 * k + 1]);
+        const float odd_re(w_re * diff_re - w_im * diff_im);
+        const float odd_im(w_re * diff_im + w_im * diff_re);
+        // Z[k] = even + i odd, Z[half - k] = conj(even) + i conj(odd)
+        left[0] = even_re - odd_im;
+        left[1] = even_im + odd_re;
+        right[0] = even_re + odd_im;
+        right[1] = odd_re - even_im;
+      }
+    }
+    complex_.Inverse(data);
+  }
+
+ private:
+  unsigned int size_;
+  ComplexFFT complex_;
+  AlignedVector<float> twiddles_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_FFT_H_
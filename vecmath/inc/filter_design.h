@@ -0,0 +1,112 @@
+/// @file filter_design.h
+/// @brief Windowed-sinc FIR design helpers
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_INC_FILTER_DESIGN_H_
+#define VECMATH_INC_FILTER_DESIGN_H_
+
+#include <cmath>
+
+#include "vecmath/inc/common.h"
+
+namespace vecmath {
+
+/// @brief Kaiser-windowed sinc design, computed in double precision
+///
+/// Frequencies are normalized: 0.5 is the Nyquist frequency.
+struct FilterDesign {
+  /// @brief Zeroth order modified Bessel function of the first kind
+  static inline double BesselI0(const double input) {
+    // Power series, converging quickly for the arguments used here
+    const double quarter_squared(input * input * 0.25);
+    double term(1.0);
+    double output(1.0);
+    for (unsigned int k(1); term > output * 1e-17; ++k) {
+      term *= quarter_squared / (static_cast<double>(k) * k);
+      output += term;
+    }
+    return output;
+  }
+
+  /// @brief Kaiser window shape parameter achieving the given stopband
+  /// attenuation
+  ///
+  /// @param[in]  attenuation   Stopband attenuation in dB (positive)
+  static inline double KaiserBeta(const double attenuation) {
+    if (attenuation > 50.0) {
+      return 0.1102 * (attenuation - 8.7);
+    } else if (attenuation > 21.0) {
+      return 0.5842 * std::pow(attenuation - 21.0, 0.4)
+             + 0.07886 * (attenuation - 21.0);
+    }
+    return 0.0;
+  }
+
+  /// @brief Transition bandwidth of a Kaiser-windowed filter
+  ///
+  /// @param[in]  attenuation   Stopband attenuation in dB (positive)
+  /// @param[in]  length   Filter length, in samples
+  static inline double KaiserTransition(const double attenuation,
+                                        const double length) {
+    return (attenuation - 7.95) / (14.36 * length);
+  }
+
+  /// @brief Kaiser window value
+  ///
+  /// @param[in]  position   Position relative to the window center
+  /// @param[in]  half_width   Window half width: zero outside of it
+  /// @param[in]  beta   Shape parameter
+  static inline double Kaiser(const double position,
+                              const double half_width,
+                              const double beta) {
+    const double ratio(position / half_width);
+    if (ratio <= -1.0 || ratio >= 1.0) {
+      return 0.0;
+    }
+    return BesselI0(beta * std::sqrt(1.0 - ratio * ratio)) / BesselI0(beta);
+  }
+
+  /// @brief Normalized sinc: sin(pi x) / (pi x)
+  static inline double Sinc(const double input) {
+    const double kPi(3.141592653589793);
+    if (std::fabs(input) < 1e-12) {
+      return 1.0;
+    }
+    return std::sin(kPi * input) / (kPi * input);
+  }
+
+  /// @brief Kaiser-windowed ideal lowpass impulse response, unity DC gain
+  ///
+  /// @param[in]  position   Position relative to the filter center
+  /// @param[in]  cutoff   Cutoff frequency, within ]0 ; 0.5]
+  /// @param[in]  half_width   Window half width
+  /// @param[in]  beta   Kaiser shape parameter
+  static inline double WindowedSinc(const double position,
+                                    const double cutoff,
+                                    const double half_width,
+                                    const double beta) {
+    return 2.0 * cutoff * Sinc(2.0 * cutoff * position)
+           * Kaiser(position, half_width, beta);
+  }
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_FILTER_DESIGN_H_
@@ -0,0 +1,529 @@
+/// @file graph.h
+/// @brief Block processing graph with parallel scheduling
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Nodes wrap block kernels; each produces one block from the blocks of
+/// its sources, which are graph inputs or previously added nodes (so that
+/// the graph is acyclic by construction).
+///
+/// Prepare() plans everything once:
+/// - each node level is 1 + the highest level of its sources,
+///   nodes of a same level being independent;
+/// - the schedule lists nodes level after level;
+/// - buffers come from a pool, a buffer being reused by a node once all
+///   readers of its previous owner are at lower levels.
+///
+/// Each Process() call then runs the schedule: the calling thread and
+/// workers claim nodes in order, a node starting once all nodes of previous
+/// levels are done. Nothing is allocated nor locked while processing
+/// (except for waking sleeping workers, see SchedulingMode).
+
+#ifndef VECMATH_INC_GRAPH_H_
+#define VECMATH_INC_GRAPH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+#include "vecmath/inc/ringbuffer.h"
+
+#if _VEC_USE_SSE
+extern "C" {
+#include <emmintrin.h>
+}
+#endif  // _VEC_USE_SSE
+
+namespace vecmath {
+
+/// @brief Graph node interface
+class GraphNode {
+ public:
+  virtual ~GraphNode() {}
+
+  /// @brief Compute one block
+  ///
+  /// Called from any thread, never concurrently for a same node.
+  ///
+  /// @param[in]  inputs   One aligned block per source, in AddNode() order
+  /// @param[in]  input_count   Number of sources
+  /// @param[out]  output   Aligned output block, never one of the inputs
+  /// @param[in]  length   Block length, a multiple of FloatVecSize
+  virtual void Process(const float* const* inputs,
+                       const unsigned int input_count,
+                       BlockOut output,
+                       const unsigned int length) = 0;
+};
+
+/// @brief Weighted sum of all sources
+class MixNode : public GraphNode {
+ public:
+  explicit MixNode(const std::vector<float>& gains)
+      : gains_(gains) {}
+
+  void Process(const float* const* inputs,
+               const unsigned int input_count,
+               BlockOut output,
+               const unsigned int length) override {
+    VECMATH_PROFILE_KERNEL("MixNode",
+                           length * input_count,
+                           length * (input_count + 1) * sizeof(float));
+    VECMATH_ASSERT(input_count == gains_.size());
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::FloatVec sum(PlatformVectorMath::Fill(0.0f));
+      for (unsigned int input(0); input < input_count; ++input) {
+        sum = PlatformVectorMath::MulAdd(
+          PlatformVectorMath::Fill(gains_[input]),
+          PlatformVectorMath::Fill(&inputs[input][i]),
+          sum);
+      }
+      PlatformVectorMath::Store(&output[i], sum);
+    }
+  }
+
+ private:
+  const std::vector<float> gains_;
+};
+
+/// @brief Single source scaled by a constant gain
+class GainNode : public GraphNode {
+ public:
+  explicit GainNode(const float gain)
+      : gain_(gain) {}
+
+  void Process(const float* const* inputs,
+               const unsigned int input_count,
+               BlockOut output,
+               const unsigned int length) override {
+    VECMATH_PROFILE_KERNEL("GainNode", length, 2 * length * sizeof(float));
+    VECMATH_ASSERT(input_count == 1);
+    IGNORE(input_count);
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const PlatformVectorMath::FloatVec gain(PlatformVectorMath::Fill(gain_));
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(
+        &output[i],
+        PlatformVectorMath::Mul(gain, PlatformVectorMath::Fill(&inputs[0][i])));
+    }
+  }
+
+ private:
+  const float gain_;
+};
+
+/// @brief Wrap any callable with the GraphNode::Process() signature,
+/// e.g. a lambda calling vecmath kernels on its own state
+class FunctionNode : public GraphNode {
+ public:
+  typedef std::function<void(const float* const*,
+                             unsigned int,
+                             float*,
+                             unsigned int)> Function;
+
+  explicit FunctionNode(const Function& function)
+      : function_(function) {}
+
+  void Process(const float* const* inputs,
+               const unsigned int input_count,
+               BlockOut output,
+               const unsigned int length) override {
+    function_(inputs, input_count, output, length);
+  }
+
+ private:
+  const Function function_;
+};
+
+/// @brief How workers wait for the next block
+enum SchedulingMode {
+  /// Workers sleep between blocks: waking them locks a mutex and costs a
+  /// system call, their start latency is up to the OS scheduler
+  kSchedulingThroughput,
+  /// Workers spin between blocks: Process() neither locks nor calls the OS,
+  /// workers start within a few cycles, at the price of busy cores.
+  /// Meant for real-time deadlines, with at most one worker per spare core
+  kSchedulingLatencyBounded
+};
+
+/// @brief Directed acyclic graph of block processing nodes
+///
+/// Not copyable. Building (AddInput(), AddNode(), AddOutput(), Prepare())
+/// must not overlap with Process().
+class ProcessingGraph {
+ public:
+  /// @param[in]  max_block_length   Longest block, multiple of FloatVecSize
+  /// @param[in]  worker_count   Threads besides the Process() caller
+  /// @param[in]  mode   How workers wait between blocks
+  ProcessingGraph(const unsigned int max_block_length,
+                  const unsigned int worker_count,
+                  const SchedulingMode mode = kSchedulingThroughput)
+      : max_block_length_(max_block_length),
+        mode_(mode),
+        input_count_(0),
+        prepared_(false),
+        length_(0),
+        generation_(0),
+        next_task_(kIdle),
+        completed_tasks_(0),
+        task_count_(0),
+        stop_(false) {
+    VECMATH_ASSERT(max_block_length % PlatformVectorMath::FloatVecSize == 0);
+    VECMATH_ASSERT(max_block_length > 0);
+    for (unsigned int worker(0); worker < worker_count; ++worker) {
+      workers_.push_back(std::thread(&ProcessingGraph::WorkerLoop, this));
+    }
+  }
+
+  ProcessingGraph(const ProcessingGraph& other) = delete;
+  ProcessingGraph& operator=(const ProcessingGraph& other) = delete;
+
+  ~ProcessingGraph() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_.store(true);
+    }
+    wake_up_.notify_all();
+    for (std::thread& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  /// @brief Declare the next graph input, return its source id
+  unsigned int AddInput() {
+    VECMATH_ASSERT(nodes_.empty());
+    sources_.push_back(Source());
+    input_count_ += 1;
+    prepared_ = false;
+    return static_cast<unsigned int>(sources_.size() - 1);
+  }
+
+  /// @brief Add a node computed from the given (already added) sources,
+  /// return its source id
+  unsigned int AddNode(std::unique_ptr<GraphNode> node,
+                       const std::vector<unsigned int>& sources) {
+    const unsigned int id(static_cast<unsigned int>(sources_.size()));
+    Source source;
+    source.node = static_cast<unsigned int>(nodes_.size());
+    for (const unsigned int input : sources) {
+      VECMATH_ASSERT(input < id);
+      IGNORE(input);
+    }
+    sources_.push_back(source);
+    nodes_.push_back(std::move(node));
+    node_sources_.push_back(sources);
+    prepared_ = false;
+    return id;
+  }
+
+  /// @brief Declare the given source as the next graph output,
+  /// return the output index
+  unsigned int AddOutput(const unsigned int source) {
+    VECMATH_ASSERT(source < sources_.size());
+    outputs_.push_back(source);
+    prepared_ = false;
+    return static_cast<unsigned int>(outputs_.size() - 1);
+  }
+
+  /// @brief Plan levels, schedule and buffers: to be called after any
+  /// change, before Process()
+  void Prepare() {
+    // Late workers may still be claiming (nothing) from the last block
+    VECMATH_ASSERT(next_task_.load() >= kIdle);
+    const unsigned int kNoLevel(std::numeric_limits<unsigned int>::max());
+    // Levels, and the last level at which each source is read
+    unsigned int max_level(0);
+    for (unsigned int id(0); id < sources_.size(); ++id) {
+      Source& source(sources_[id]);
+      source.level = 0;
+      source.last_use = kNoLevel;
+      if (source.node != kInput) {
+        for (const unsigned int input : node_sources_[source.node]) {
+          source.level = std::max(source.level, sources_[input].level + 1);
+        }
+        source.level = std::max(source.level, 1u);
+        max_level = std::max(max_level, source.level);
+      }
+    }
+    for (unsigned int id(input_count_); id < sources_.size(); ++id) {
+      for (const unsigned int input : node_sources_[sources_[id].node]) {
+        Source& read(sources_[input]);
+        read.last_use = read.last_use == kNoLevel
+                        ? sources_[id].level
+                        : std::max(read.last_use, sources_[id].level);
+      }
+    }
+    // Outputs are read after the last level
+    for (const unsigned int output : outputs_) {
+      sources_[output].last_use = max_level + 1;
+    }
+
+    // Schedule: stable by level, then buffers in schedule order
+    std::vector<unsigned int> order;
+    for (unsigned int id(input_count_); id < sources_.size(); ++id) {
+      order.push_back(id);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [this](const unsigned int left, const unsigned int right) {
+      return sources_[left].level < sources_[right].level;
+    });
+    // Level each pool buffer is busy until
+    std::vector<unsigned int> busy_until;
+    for (const unsigned int id : order) {
+      Source& source(sources_[id]);
+      const unsigned int last_use(source.last_use == kNoLevel
+                                  ? source.level
+                                  : source.last_use);
+      unsigned int buffer(0);
+      while (buffer < busy_until.size() && busy_until[buffer] >= source.level) {
+        buffer += 1;
+      }
+      if (buffer == busy_until.size()) {
+        busy_until.push_back(last_use);
+      } else {
+        busy_until[buffer] = last_use;
+      }
+      source.buffer = buffer;
+    }
+    pool_.assign(busy_until.size() * max_block_length_, 0.0f);
+
+    // Tasks, with their flattened input pointers
+    tasks_.clear();
+    input_pointers_.clear();
+    external_inputs_.clear();
+    unsigned int level_start(0);
+    unsigned int current_level(0);
+    for (const unsigned int id : order) {
+      const Source& source(sources_[id]);
+      if (source.level != current_level) {
+        current_level = source.level;
+        level_start = static_cast<unsigned int>(tasks_.size());
+      }
+      Task task;
+      task.node = nodes_[source.node].get();
+      task.first_input = static_cast<unsigned int>(input_pointers_.size());
+      task.input_count
+        = static_cast<unsigned int>(node_sources_[source.node].size());
+      task.output = BufferOf(id);
+      task.ready_count = level_start;
+      for (const unsigned int input : node_sources_[source.node]) {
+        if (sources_[input].node == kInput) {
+          external_inputs_.push_back(ExternalInput{
+            static_cast<unsigned int>(input_pointers_.size()), input});
+          input_pointers_.push_back(nullptr);
+        } else {
+          input_pointers_.push_back(BufferOf(input));
+        }
+      }
+      tasks_.push_back(task);
+    }
+    // Never empty: &input_pointers_[first_input] is always valid
+    input_pointers_.push_back(nullptr);
+    task_count_.store(static_cast<unsigned int>(tasks_.size()));
+    prepared_ = true;
+  }
+
+  /// @brief Process one block
+  ///
+  /// @param[in]  inputs   One aligned block per graph input
+  /// @param[out]  outputs   One aligned block per graph output
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  void Process(const float* const* inputs,
+               float* const* outputs,
+               const unsigned int length) {
+    VECMATH_ASSERT(prepared_);
+    VECMATH_ASSERT(length <= max_block_length_);
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    for (const ExternalInput& external : external_inputs_) {
+      input_pointers_[external.pointer] = inputs[external.input];
+    }
+    length_ = length;
+    completed_tasks_.store(0, std::memory_order_relaxed);
+    // Publishes all the above
+    next_task_.store(0, std::memory_order_release);
+    if (!workers_.empty()) {
+      if (mode_ == kSchedulingLatencyBounded) {
+        generation_.fetch_add(1, std::memory_order_release);
+      } else {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          generation_.fetch_add(1, std::memory_order_release);
+        }
+        wake_up_.notify_all();
+      }
+    }
+    RunTasks();
+    const unsigned int task_count(task_count_.load(std::memory_order_relaxed));
+    while (completed_tasks_.load(std::memory_order_acquire) < task_count) {
+      Relax();
+    }
+    next_task_.store(kIdle, std::memory_order_relaxed);
+    for (unsigned int output(0); output < outputs_.size(); ++output) {
+      const unsigned int id(outputs_[output]);
+      const float* const source(sources_[id].node == kInput
+                                ? inputs[id]
+                                : BufferOf(id));
+      CopyBlock(source, outputs[output], length);
+    }
+  }
+
+  /// @brief Number of buffers in the pool (valid after Prepare())
+  unsigned int BufferCount() const {
+    return static_cast<unsigned int>(pool_.size() / max_block_length_);
+  }
+
+  /// @brief Number of levels, i.e. of sequential steps (valid after Prepare())
+  unsigned int LevelCount() const {
+    unsigned int levels(0);
+    for (const Source& source : sources_) {
+      levels = std::max(levels, source.level);
+    }
+    return levels;
+  }
+
+ private:
+  static constexpr unsigned int kInput = std::numeric_limits<unsigned int>::max();
+  static constexpr unsigned int kIdle = std::numeric_limits<unsigned int>::max() / 2;
+
+  struct Source {
+    Source()
+        : node(kInput),
+          level(0),
+          last_use(0),
+          buffer(0) {}
+
+    unsigned int node;
+    unsigned int level;
+    unsigned int last_use;
+    unsigned int buffer;
+  };
+
+  struct Task {
+    GraphNode* node;
+    unsigned int first_input;
+    unsigned int input_count;
+    float* output;
+    // Tasks to be completed before this one starts (previous levels)
+    unsigned int ready_count;
+  };
+
+  struct ExternalInput {
+    unsigned int pointer;
+    unsigned int input;
+  };
+
+  float* BufferOf(const unsigned int id) {
+    return &pool_[sources_[id].buffer * max_block_length_];
+  }
+
+  static inline void Relax() {
+#if _VEC_USE_SSE
+    _mm_pause();
+#else  // _VEC_USE_SSE
+    std::this_thread::yield();
+#endif  // _VEC_USE_SSE
+  }
+
+  /// @brief Claim and process tasks until none is left
+  void RunTasks() {
+    for (;;) {
+      const unsigned int index(
+        next_task_.fetch_add(1, std::memory_order_acq_rel));
+      if (index >= task_count_.load(std::memory_order_relaxed)) {
+        return;
+      }
+      const Task& task(tasks_[index]);
+      while (completed_tasks_.load(std::memory_order_acquire)
+             < task.ready_count) {
+        Relax();
+      }
+      task.node->Process(&input_pointers_[task.first_input],
+                         task.input_count,
+                         task.output,
+                         length_);
+      completed_tasks_.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  void WorkerLoop() {
+    unsigned int seen(0);
+    for (;;) {
+      if (mode_ == kSchedulingLatencyBounded) {
+        while (generation_.load(std::memory_order_acquire) == seen
+               && !stop_.load(std::memory_order_relaxed)) {
+          Relax();
+        }
+      } else {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_up_.wait(lock, [this, seen]() {
+          return generation_.load(std::memory_order_acquire) != seen
+                 || stop_.load(std::memory_order_relaxed);
+        });
+      }
+      if (stop_.load(std::memory_order_relaxed)) {
+        return;
+      }
+      seen = generation_.load(std::memory_order_acquire);
+      RunTasks();
+    }
+  }
+
+  const unsigned int max_block_length_;
+  const SchedulingMode mode_;
+  // Graph description
+  unsigned int input_count_;
+  std::vector<Source> sources_;
+  std::vector<std::unique_ptr<GraphNode> > nodes_;
+  std::vector<std::vector<unsigned int> > node_sources_;
+  std::vector<unsigned int> outputs_;
+  // Plan
+  bool prepared_;
+  AlignedVector<float> pool_;
+  std::vector<Task> tasks_;
+  std::vector<const float*> input_pointers_;
+  std::vector<ExternalInput> external_inputs_;
+  unsigned int length_;
+  // Scheduling
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_up_;
+  char padding_[kDefaultAlignment];
+  std::atomic<unsigned int> generation_;
+  char generation_padding_[kDefaultAlignment];
+  std::atomic<unsigned int> next_task_;
+  char next_padding_[kDefaultAlignment];
+  std::atomic<unsigned int> completed_tasks_;
+  char completed_padding_[kDefaultAlignment];
+  std::atomic<unsigned int> task_count_;
+  std::atomic<bool> stop_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_GRAPH_H_
@@ -0,0 +1,125 @@
+/// @file half.h
+/// @brief 16 bits floating point storage types
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Float16 is IEEE 754 binary16 (5 bits exponent, 10 bits mantissa),
+/// BFloat16 the upper half of a float (8 bits exponent, 7 bits mantissa).
+/// Both are storage only: computations are done on floats, see the
+/// FillFloat16/StoreFloat16 (resp. BFloat16) FloatVec conversions.
+
+#ifndef VECMATH_INC_HALF_H_
+#define VECMATH_INC_HALF_H_
+
+#include <cstdint>
+#include <cstring>
+
+namespace vecmath {
+
+/// @brief IEEE 754 half precision storage
+struct Float16 {
+  std::uint16_t bits;
+};
+
+/// @brief "Brain" floating point storage: the upper half of a float
+struct BFloat16 {
+  std::uint16_t bits;
+};
+
+static_assert(sizeof(Float16) == 2, "Float16 must be 16 bits");
+static_assert(sizeof(BFloat16) == 2, "BFloat16 must be 16 bits");
+
+/// @brief Scalar conversions, rounding to nearest even
+///
+/// Computed on the bits (except for a single exact float operation
+/// on normal numbers): valid with finite maths and flush-to-zero modes.
+/// NaNs remain NaNs, their payload is not preserved; the F16C vector
+/// conversions may keep part of it, and quiet signaling NaNs.
+struct HalfConversion {
+  static inline Float16 ToFloat16(const float value) {
+    const std::uint32_t bits(Bits(value));
+    const std::uint32_t sign(bits & 0x80000000u);
+    std::uint32_t magnitude(bits ^ sign);
+    std::uint32_t output;
+    if (magnitude >= 0x47800000u) {
+      // Overflow: infinity, NaN remains (quiet) NaN
+      output = magnitude > 0x7f800000u ? 0x7e00u : 0x7c00u;
+    } else if (magnitude < 0x38800000u) {
+      // Denormal or zero: adding 0.5 aligns the mantissa, the FPU rounds it
+      output = Bits(FromBits(magnitude) + 0.5f) - 0x3f000000u;
+    } else {
+      // Rebias the exponent, round to nearest even
+      const std::uint32_t odd((magnitude >> 13) & 1u);
+      magnitude += 0xc8000fffu + odd;
+      output = magnitude >> 13;
+    }
+    Float16 half;
+    half.bits = static_cast<std::uint16_t>(output | (sign >> 16));
+    return half;
+  }
+
+  static inline float ToFloat(const Float16 half) {
+    const std::uint32_t kShiftedExponent(0x7c00u << 13);
+    std::uint32_t output((half.bits & 0x7fffu) << 13);
+    const std::uint32_t exponent(output & kShiftedExponent);
+    output += 0x38000000u;
+    if (exponent == kShiftedExponent) {
+      // Infinity or NaN
+      output += 0x38000000u;
+    } else if (exponent == 0) {
+      // Denormal or zero: renormalized by an exact subtraction
+      output = Bits(FromBits(output + 0x00800000u) - FromBits(0x38800000u));
+    }
+    return FromBits(output | ((half.bits & 0x8000u) << 16));
+  }
+
+  static inline BFloat16 ToBFloat16(const float value) {
+    const std::uint32_t bits(Bits(value));
+    BFloat16 half;
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+      // NaN: rounding could turn it into infinity
+      half.bits = static_cast<std::uint16_t>((bits >> 16) | 0x0040u);
+    } else {
+      half.bits = static_cast<std::uint16_t>(
+        (bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+    }
+    return half;
+  }
+
+  static inline float ToFloat(const BFloat16 half) {
+    return FromBits(static_cast<std::uint32_t>(half.bits) << 16);
+  }
+
+ private:
+  static inline std::uint32_t Bits(const float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  static inline float FromBits(const std::uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_HALF_H_
@@ -0,0 +1,163 @@
+/// @file halfprecision.h
+/// @brief Block kernels on 16 bits floating point storage
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Blocks are stored as Float16 or BFloat16, halving their footprint and
+/// bandwidth; the fused kernels convert each FloatVec on load so that
+/// computations stay in float.
+
+#ifndef VECMATH_INC_HALFPRECISION_H_
+#define VECMATH_INC_HALFPRECISION_H_
+
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/half.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Stateless conversion and fused block kernels
+///
+/// "Half" is either Float16 or BFloat16. Half blocks do not need any
+/// alignment, float blocks are aligned; all lengths are multiples
+/// of FloatVecSize.
+struct HalfPrecisionVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Convert a float block, rounding to nearest even
+  template <typename Half>
+  static inline void ToHalf(BlockIn input,
+                            const unsigned int length,
+                            Half* const output) {
+    VECMATH_PROFILE_KERNEL("ToHalf",
+                           length,
+                           length * (sizeof(float) + sizeof(Half)));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      Store(&output[i], PlatformVectorMath::Fill(&input[i]));
+    }
+  }
+
+  /// @brief Convert a half block to floats (exact)
+  template <typename Half>
+  static inline void FromHalf(const Half* const input,
+                              const unsigned int length,
+                              BlockOut output) {
+    VECMATH_PROFILE_KERNEL("FromHalf",
+                           length,
+                           length * (sizeof(float) + sizeof(Half)));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(&output[i], Load(&input[i]));
+    }
+  }
+
+  /// @brief output = gain * input
+  template <typename Half>
+  static inline void Scale(const Half* const input,
+                           const unsigned int length,
+                           const float gain,
+                           BlockOut output) {
+    VECMATH_PROFILE_KERNEL("ScaleHalf",
+                           length,
+                           length * (sizeof(float) + sizeof(Half)));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const FloatVec gains(PlatformVectorMath::Fill(gain));
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(&output[i],
+                                PlatformVectorMath::Mul(gains,
+                                                        Load(&input[i])));
+    }
+  }
+
+  /// @brief output += gain * input, e.g. mixing a cached sample into a bus
+  template <typename Half>
+  static inline void Accumulate(const Half* const input,
+                                const unsigned int length,
+                                const float gain,
+                                BlockOut output) {
+    VECMATH_PROFILE_KERNEL("AccumulateHalf",
+                           length,
+                           length * (2 * sizeof(float) + sizeof(Half)));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const FloatVec gains(PlatformVectorMath::Fill(gain));
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(
+        &output[i],
+        PlatformVectorMath::MulAdd(gains,
+                                   Load(&input[i]),
+                                   PlatformVectorMath::Fill(&output[i])));
+    }
+  }
+
+  /// @brief Sum of input * weights, e.g. correlating a stored history
+  template <typename Half>
+  static inline float DotProduct(const Half* const input,
+                                 BlockIn weights,
+                                 const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("DotProductHalf",
+                           length,
+                           length * (sizeof(float) + sizeof(Half)));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    // Two accumulators hide the MulAdd latency
+    FloatVec even(PlatformVectorMath::Fill(0.0f));
+    FloatVec odd(PlatformVectorMath::Fill(0.0f));
+    unsigned int i(0);
+    for (; i + 2 * kVecSize <= length; i += 2 * kVecSize) {
+      even = PlatformVectorMath::MulAdd(Load(&input[i]),
+                                        PlatformVectorMath::Fill(&weights[i]),
+                                        even);
+      odd = PlatformVectorMath::MulAdd(
+        Load(&input[i + kVecSize]),
+        PlatformVectorMath::Fill(&weights[i + kVecSize]),
+        odd);
+    }
+    if (i < length) {
+      even = PlatformVectorMath::MulAdd(Load(&input[i]),
+                                        PlatformVectorMath::Fill(&weights[i]),
+                                        even);
+    }
+    return PlatformVectorMath::AddHorizontal(PlatformVectorMath::Add(even,
+                                                                     odd));
+  }
+
+ private:
+  static inline FloatVec Load(const Float16* const input) {
+    return PlatformVectorMath::FillFloat16(input);
+  }
+
+  static inline FloatVec Load(const BFloat16* const input) {
+    return PlatformVectorMath::FillBFloat16(input);
+  }
+
+  static inline void Store(Float16* const output, FloatVecRead input) {
+    PlatformVectorMath::StoreFloat16(output, input);
+  }
+
+  static inline void Store(BFloat16* const output, FloatVecRead input) {
+    PlatformVectorMath::StoreBFloat16(output, input);
+  }
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_HALFPRECISION_H_
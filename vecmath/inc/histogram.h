@@ -0,0 +1,184 @@
+/// @file histogram.h
+/// @brief Block histograms over uniform bins
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_INC_HISTOGRAM_H_
+#define VECMATH_INC_HISTOGRAM_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Histogram over uniform bins of a float range
+///
+/// Bin indices are computed FloatVecSize samples at once. Each lane then
+/// owns a sub-histogram, interleaved with the others (bin major), so that
+/// increments never conflict within a FloatVec: sub-histograms are only
+/// merged when reading the counts.
+///
+/// Samples below the range are counted into the first bin, samples at or
+/// above its end (NaNs included) into the last one.
+class Histogram {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @param[in]  bins   Number of bins, within [1 ; 2^20]
+  /// @param[in]  minimum   Start of the first bin
+  /// @param[in]  maximum   End of the last bin (> minimum)
+  Histogram(const unsigned int bins, const float minimum, const float maximum)
+      : bins_(bins),
+        minimum_(minimum),
+        scale_(static_cast<float>(bins) / (maximum - minimum)),
+        counts_(bins * PlatformVectorMath::FloatVecSize, 0),
+        lanes_(PlatformVectorMath::FloatVecSize),
+        slots_(kUnroll * PlatformVectorMath::FloatVecSize) {
+    VECMATH_ASSERT(bins > 0);
+    // Bin slots have to be exact in single precision
+    VECMATH_ASSERT(bins <= (1u << 20));
+    VECMATH_ASSERT(maximum > minimum);
+    for (unsigned int lane(0); lane < PlatformVectorMath::FloatVecSize; ++lane) {
+      lanes_[lane] = static_cast<float>(lane);
+    }
+  }
+
+  unsigned int Bins() const {
+    return bins_;
+  }
+
+  /// @brief Bin index of the given value, clamped as for Accumulate()
+  unsigned int BinIndex(const float value) const {
+    return static_cast<unsigned int>(
+      PlatformVectorMath::GetByIndex<0>(PlatformVectorMath::TruncToInt(
+        Bin(PlatformVectorMath::Fill(value)))));
+  }
+
+  void Reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+  }
+
+  /// @brief Count all samples of a block
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  void Accumulate(BlockIn input, const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("Histogram", length, length * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    const FloatVec lanes(PlatformVectorMath::Fill(&lanes_[0]));
+    const FloatVec vec_size(PlatformVectorMath::Fill(
+      static_cast<float>(kVecSize)));
+    unsigned int i(0);
+    // Several FloatVecs of slots computed before incrementing any
+    for (; i + kUnroll * kVecSize <= length; i += kUnroll * kVecSize) {
+      for (unsigned int j(0); j < kUnroll; ++j) {
+        PlatformVectorMath::StoreInt(
+          &slots_[j * kVecSize],
+          PlatformVectorMath::TruncToInt(PlatformVectorMath::MulAdd(
+            Bin(PlatformVectorMath::Fill(&input[i + j * kVecSize])),
+            vec_size,
+            lanes)));
+      }
+      for (unsigned int j(0); j < kUnroll * kVecSize; ++j) {
+        counts_[slots_[j]] += 1;
+      }
+    }
+    for (; i < length; i += kVecSize) {
+      PlatformVectorMath::StoreInt(
+        &slots_[0],
+        PlatformVectorMath::TruncToInt(PlatformVectorMath::MulAdd(
+          Bin(PlatformVectorMath::Fill(&input[i])),
+          vec_size,
+          lanes)));
+      for (unsigned int j(0); j < kVecSize; ++j) {
+        counts_[slots_[j]] += 1;
+      }
+    }
+  }
+
+  /// @brief Count of the given bin, all lanes merged
+  std::uint64_t Count(const unsigned int bin) const {
+    VECMATH_ASSERT(bin < bins_);
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    std::uint64_t count(0);
+    for (unsigned int lane(0); lane < kVecSize; ++lane) {
+      count += counts_[bin * kVecSize + lane];
+    }
+    return count;
+  }
+
+  /// @brief Counts of all bins, all lanes merged
+  ///
+  /// @param[out]  counts   Bins() counts
+  void Counts(std::uint64_t* const counts) const {
+    for (unsigned int bin(0); bin < bins_; ++bin) {
+      counts[bin] = Count(bin);
+    }
+  }
+
+  /// @brief Number of samples accumulated since the last reset
+  std::uint64_t Total() const {
+    std::uint64_t total(0);
+    for (const std::uint64_t count : counts_) {
+      total += count;
+    }
+    return total;
+  }
+
+ private:
+  /// @brief FloatVecs of slots computed ahead of the increments
+  static constexpr unsigned int kUnroll = 4;
+
+  /// @brief Element-wise bin index, as floats
+  inline FloatVec Bin(FloatVecRead input) const {
+    const FloatVec position(PlatformVectorMath::Mul(
+      PlatformVectorMath::Sub(input, PlatformVectorMath::Fill(minimum_)),
+      PlatformVectorMath::Fill(scale_)));
+    // Comparison first: false for NaNs
+    const FloatVec below_end(PlatformVectorMath::Select(
+      PlatformVectorMath::LessThan(
+        position,
+        PlatformVectorMath::Fill(static_cast<float>(bins_))),
+      position,
+      PlatformVectorMath::Fill(static_cast<float>(bins_ - 1))));
+    return PlatformVectorMath::Floor(PlatformVectorMath::Max(
+      below_end,
+      PlatformVectorMath::Fill(0.0f)));
+  }
+
+  const unsigned int bins_;
+  const float minimum_;
+  const float scale_;
+  // Bin major: counts_[bin * FloatVecSize + lane]
+  std::vector<std::uint64_t> counts_;
+  AlignedVector<float> lanes_;
+  AlignedVector<int> slots_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_HISTOGRAM_H_
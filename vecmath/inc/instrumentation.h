@@ -0,0 +1,358 @@
+/// @file instrumentation.h
+/// @brief Opt-in hot-path instrumentation: per-kernel counters and timers
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Block kernels open with VECMATH_PROFILE_KERNEL(name, samples, bytes).
+/// Unless VECMATH_INSTRUMENTATION is defined this expands to nothing
+/// (its arguments are not even evaluated), otherwise it times the enclosing
+/// scope and accumulates calls, samples, bytes, TSC cycles and nanoseconds
+/// into a table owned by the calling thread: no lock nor atomic
+/// read-modify-write on the hot path.
+///
+/// VECMATH_INSTRUMENTATION must be defined (or not) consistently
+/// for the whole program.
+
+#ifndef VECMATH_INC_INSTRUMENTATION_H_
+#define VECMATH_INC_INSTRUMENTATION_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "vecmath/inc/common.h"
+
+#if _BUILD_CONFIGURATION_INSTRUMENTED
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#if (_VEC_ARCHX86) || (_VEC_ARCHX64)
+#if _VEC_COMPILER_MSVC
+#include <intrin.h>
+#else  // _VEC_COMPILER_MSVC
+#include <x86intrin.h>
+#endif  // _VEC_COMPILER_MSVC
+#endif  // (_VEC_ARCHX86) || (_VEC_ARCHX64)
+#endif  // _BUILD_CONFIGURATION_INSTRUMENTED
+
+namespace vecmath {
+
+/// @brief Counters of one kernel, aggregated over all threads
+struct KernelReport {
+  std::string name;  ///< Kernel name, as given to VECMATH_PROFILE_KERNEL
+  std::uint64_t calls;  ///< Number of calls
+  std::uint64_t samples;  ///< Number of processed samples
+  std::uint64_t bytes;  ///< Number of bytes read and written
+  std::uint64_t cycles;  ///< Elapsed TSC cycles (0 if no TSC)
+  std::uint64_t nanoseconds;  ///< Elapsed wall-clock time
+
+  /// @brief Throughput, in samples per second
+  double SamplesPerSecond() const {
+    return nanoseconds > 0
+           ? static_cast<double>(samples) * 1e9 / static_cast<double>(nanoseconds)
+           : 0.0;
+  }
+
+  /// @brief Average cost, in TSC cycles per sample
+  double CyclesPerSample() const {
+    return samples > 0
+           ? static_cast<double>(cycles) / static_cast<double>(samples)
+           : 0.0;
+  }
+};
+
+#if _BUILD_CONFIGURATION_INSTRUMENTED
+
+/// @brief Instrumentation tables and reporting API
+class Instrumentation {
+ public:
+  /// @brief Maximum number of distinct kernel names
+  static constexpr unsigned kMaxKernels = 256;
+
+  /// @brief Return the identifier of the given kernel name,
+  /// registering it on first use (locks: call it once per call site)
+  static unsigned RegisterKernel(const char* name) {
+    Registry& registry(GetRegistry());
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    const std::vector<std::string>::const_iterator found(
+      std::find(registry.names.begin(), registry.names.end(), name));
+    if (found != registry.names.end()) {
+      return static_cast<unsigned>(found - registry.names.begin());
+    }
+    VECMATH_ASSERT(registry.names.size() < kMaxKernels);
+    if (registry.names.size() >= kMaxKernels) {
+      return kMaxKernels - 1;
+    }
+    registry.names.push_back(name);
+    return static_cast<unsigned>(registry.names.size() - 1);
+  }
+
+  /// @brief Accumulate one kernel call into the calling thread table
+  static void Record(const unsigned kernel_id,
+                     const std::uint64_t samples,
+                     const std::uint64_t bytes,
+                     const std::uint64_t cycles,
+                     const std::uint64_t nanoseconds) {
+    Counters& counters(GetThreadTable().counters[kernel_id]);
+    Bump(counters.values[kCalls], 1);
+    Bump(counters.values[kSamples], samples);
+    Bump(counters.values[kBytes], bytes);
+    Bump(counters.values[kCycles], cycles);
+    Bump(counters.values[kNanoseconds], nanoseconds);
+  }
+
+  /// @brief Aggregate all threads tables (including exited threads)
+  /// since the last call to Reset()
+  static std::vector<KernelReport> Collect() {
+    Registry& registry(GetRegistry());
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<KernelReport> reports;
+    for (unsigned kernel(0); kernel < registry.names.size(); ++kernel) {
+      std::uint64_t values[kCounterCount];
+      GatherLocked(registry, kernel, values);
+      const KernelReport report = {
+        registry.names[kernel],
+        values[kCalls] - registry.baseline[kernel][kCalls],
+        values[kSamples] - registry.baseline[kernel][kSamples],
+        values[kBytes] - registry.baseline[kernel][kBytes],
+        values[kCycles] - registry.baseline[kernel][kCycles],
+        values[kNanoseconds] - registry.baseline[kernel][kNanoseconds]
+      };
+      reports.push_back(report);
+    }
+    return reports;
+  }
+
+  /// @brief Dump per-kernel calls, samples/s and cycles/sample
+  static void Report(std::ostream& stream) {
+    const std::vector<KernelReport> reports(Collect());
+    stream << std::left << std::setw(32) << "kernel"
+           << std::right << std::setw(12) << "calls"
+           << std::setw(16) << "samples"
+           << std::setw(14) << "MSamples/s"
+           << std::setw(16) << "cycles/sample"
+           << std::setw(16) << "bytes" << '\n';
+    for (std::vector<KernelReport>::const_iterator report(reports.begin());
+         report != reports.end();
+         ++report) {
+      stream << std::left << std::setw(32) << report->name
+             << std::right << std::setw(12) << report->calls
+             << std::setw(16) << report->samples
+             << std::setw(14) << std::fixed << std::setprecision(2)
+             << report->SamplesPerSecond() * 1e-6
+             << std::setw(16) << report->CyclesPerSample()
+             << std::setw(16) << report->bytes << '\n';
+    }
+  }
+
+  /// @brief Restart all counters from zero
+  ///
+  /// Other threads tables are not written to: the current totals are
+  /// kept as a baseline, subtracted from any later Collect()
+  static void Reset() {
+    Registry& registry(GetRegistry());
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (unsigned kernel(0); kernel < registry.names.size(); ++kernel) {
+      GatherLocked(registry, kernel, registry.baseline[kernel]);
+    }
+  }
+
+ private:
+  enum CounterIndex {
+    kCalls = 0,
+    kSamples,
+    kBytes,
+    kCycles,
+    kNanoseconds,
+    kCounterCount
+  };
+
+  /// @brief One kernel counters within a thread table:
+  /// only written by the owner thread, read by Collect()
+  struct Counters {
+    std::atomic<std::uint64_t> values[kCounterCount];
+  };
+
+  struct ThreadTable;
+
+  /// @brief Process-wide registry of kernel names and thread tables
+  struct Registry {
+    Registry() {
+      std::memset(retired, 0, sizeof(retired));
+      std::memset(baseline, 0, sizeof(baseline));
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<const ThreadTable*> tables;
+    /// Totals of the threads which already exited
+    std::uint64_t retired[kMaxKernels][kCounterCount];
+    /// Totals at the time of the last Reset()
+    std::uint64_t baseline[kMaxKernels][kCounterCount];
+  };
+
+  /// @brief Per-thread counters, registered for its whole lifetime
+  struct ThreadTable {
+    ThreadTable() {
+      for (unsigned kernel(0); kernel < kMaxKernels; ++kernel) {
+        for (unsigned counter(0); counter < kCounterCount; ++counter) {
+          counters[kernel].values[counter].store(0, std::memory_order_relaxed);
+        }
+      }
+      Registry& registry(GetRegistry());
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.tables.push_back(this);
+    }
+
+    ~ThreadTable() {
+      Registry& registry(GetRegistry());
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      for (unsigned kernel(0); kernel < kMaxKernels; ++kernel) {
+        for (unsigned counter(0); counter < kCounterCount; ++counter) {
+          registry.retired[kernel][counter]
+            += counters[kernel].values[counter].load(std::memory_order_relaxed);
+        }
+      }
+      registry.tables.erase(std::find(registry.tables.begin(),
+                                      registry.tables.end(),
+                                      this));
+    }
+
+    Counters counters[kMaxKernels];
+  };
+
+  /// @brief Single writer increment: no need for a locked instruction
+  static void Bump(std::atomic<std::uint64_t>& counter,
+                   const std::uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+
+  /// @brief Sum one kernel counters over all tables, registry being locked
+  static void GatherLocked(const Registry& registry,
+                           const unsigned kernel,
+                           std::uint64_t (&values)[kCounterCount]) {
+    for (unsigned counter(0); counter < kCounterCount; ++counter) {
+      values[counter] = registry.retired[kernel][counter];
+    }
+    for (std::vector<const ThreadTable*>::const_iterator table(
+           registry.tables.begin());
+         table != registry.tables.end();
+         ++table) {
+      for (unsigned counter(0); counter < kCounterCount; ++counter) {
+        values[counter] += (*table)->counters[kernel].values[counter].load(
+          std::memory_order_relaxed);
+      }
+    }
+  }
+
+  static Registry& GetRegistry() {
+    static Registry registry;
+    return registry;
+  }
+
+  static ThreadTable& GetThreadTable() {
+    static thread_local ThreadTable table;
+    return table;
+  }
+};
+
+/// @brief Time the enclosing scope, and record it on destruction
+class ScopedKernelTimer {
+ public:
+  ScopedKernelTimer(const unsigned kernel_id,
+                    const std::uint64_t samples,
+                    const std::uint64_t bytes)
+      : kernel_id_(kernel_id),
+        samples_(samples),
+        bytes_(bytes),
+        start_cycles_(ReadCycles()),
+        start_time_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedKernelTimer() {
+    const std::uint64_t cycles(ReadCycles() - start_cycles_);
+    const std::chrono::steady_clock::duration elapsed(
+      std::chrono::steady_clock::now() - start_time_);
+    Instrumentation::Record(
+      kernel_id_,
+      samples_,
+      bytes_,
+      cycles,
+      static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+  }
+
+ private:
+  // No assignment operator
+  ScopedKernelTimer& operator=(const ScopedKernelTimer&);
+
+  /// @brief Time stamp counter, when the architecture has one
+  static std::uint64_t ReadCycles() {
+#if (_VEC_ARCHX86) || (_VEC_ARCHX64)
+    return __rdtsc();
+#else
+    return 0;
+#endif  // (_VEC_ARCHX86) || (_VEC_ARCHX64)
+  }
+
+  const unsigned kernel_id_;
+  const std::uint64_t samples_;
+  const std::uint64_t bytes_;
+  const std::uint64_t start_cycles_;
+  const std::chrono::steady_clock::time_point start_time_;
+};
+
+/// @brief Profile the enclosing block kernel
+///
+/// @param[in]  _name_      Kernel name (string literal)
+/// @param[in]  _samples_   Number of samples processed by this call
+/// @param[in]  _bytes_     Number of bytes read and written by this call
+#define VECMATH_PROFILE_KERNEL(_name_, _samples_, _bytes_) \
+  static const unsigned vecmath_kernel_id_( \
+    ::vecmath::Instrumentation::RegisterKernel(_name_)); \
+  const ::vecmath::ScopedKernelTimer vecmath_kernel_timer_( \
+    vecmath_kernel_id_, (_samples_), (_bytes_))
+
+#else  // _BUILD_CONFIGURATION_INSTRUMENTED
+
+/// @brief Reporting API stubs, so that callers do not need any #if
+class Instrumentation {
+ public:
+  static std::vector<KernelReport> Collect() {
+    return std::vector<KernelReport>();
+  }
+
+  static void Report(std::ostream& stream) {
+    stream << "Instrumentation disabled (define VECMATH_INSTRUMENTATION)\n";
+  }
+
+  static void Reset() {}
+};
+
+#define VECMATH_PROFILE_KERNEL(_name_, _samples_, _bytes_)
+
+#endif  // _BUILD_CONFIGURATION_INSTRUMENTED
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_INSTRUMENTATION_H_
@@ -0,0 +1,79 @@
+/// @file interpolation.h
+/// @brief Fractional position interpolators
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Each element is interpolated at its own fractional position between
+/// the matching elements of consecutive sample vectors.
+
+#ifndef VECMATH_INC_INTERPOLATION_H_
+#define VECMATH_INC_INTERPOLATION_H_
+
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Stateless interpolation kernels
+struct InterpolationVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Linear interpolation: "from" at fraction 0, "to" at fraction 1
+  static inline FloatVec Linear(FloatVecRead from,
+                                FloatVecRead to,
+                                FloatVecRead fraction) {
+    return PlatformVectorMath::MulAdd(
+      PlatformVectorMath::Sub(to, from),
+      fraction,
+      from);
+  }
+
+  /// @brief Catmull-Rom interpolation between the second and third samples
+  ///
+  /// @param[in]  samples   Four consecutive samples vectors
+  /// @param[in]  fraction   Position within [0 ; 1] between samples 1 and 2
+  static inline FloatVec CatmullRom(const FloatVec* samples,
+                                    FloatVecRead fraction) {
+    const FloatVec half(PlatformVectorMath::Fill(0.5f));
+    const FloatVec c1(PlatformVectorMath::Mul(
+      half,
+      PlatformVectorMath::Sub(samples[2], samples[0])));
+    const FloatVec c2(PlatformVectorMath::Add(
+      PlatformVectorMath::Sub(
+        samples[0],
+        PlatformVectorMath::Mul(PlatformVectorMath::Fill(2.5f), samples[1])),
+      PlatformVectorMath::Sub(
+        PlatformVectorMath::Add(samples[2], samples[2]),
+        PlatformVectorMath::Mul(half, samples[3]))));
+    const FloatVec c3(PlatformVectorMath::MulAdd(
+      PlatformVectorMath::Fill(1.5f),
+      PlatformVectorMath::Sub(samples[1], samples[2]),
+      PlatformVectorMath::Mul(half,
+                              PlatformVectorMath::Sub(samples[3],
+                                                      samples[0]))));
+    FloatVec output(PlatformVectorMath::MulAdd(c3, fraction, c2));
+    output = PlatformVectorMath::MulAdd(output, fraction, c1);
+    return PlatformVectorMath::MulAdd(output, fraction, samples[1]);
+  }
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_INTERPOLATION_H_
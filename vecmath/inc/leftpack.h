@@ -0,0 +1,131 @@
+/// @file leftpack.h
+/// @brief Left-packing kernels: keep only the samples matching a predicate
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Each FloatVec is compared at once, then its selected elements are stored
+/// contiguously with PlatformVectorMath::CompressStore, the output position
+/// being advanced by their count: no per-sample branch is required.
+
+#ifndef VECMATH_INC_LEFTPACK_H_
+#define VECMATH_INC_LEFTPACK_H_
+
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Stateless left-packing kernels
+///
+/// A predicate is anything callable as "FloatVec predicate(FloatVecRead)",
+/// returning a mask, e.g. a lambda around PlatformVectorMath::GreaterThan
+struct LeftPackVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Store contiguously the input samples matching the predicate,
+  /// return their count
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  /// @param[in]  predicate   Mask generator
+  /// @param[out]  output   Output, of at least "length" elements,
+  /// not necessarily aligned
+  template <typename Predicate>
+  static inline unsigned int Compress(BlockIn input,
+                                      const unsigned int length,
+                                      Predicate predicate,
+                                      BlockOut output) {
+    VECMATH_PROFILE_KERNEL("Compress", length, length * 2 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    unsigned int count(0);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      const FloatVec values(PlatformVectorMath::Fill(&input[i]));
+      count += PlatformVectorMath::CompressStore(&output[count],
+                                                 predicate(values),
+                                                 values);
+    }
+    return count;
+  }
+
+  /// @brief Store contiguously the indices of the input samples matching
+  /// the predicate, return their count
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[in]  length   Block length, multiple of FloatVecSize,
+  /// below 2^24 (indices are computed as floats)
+  /// @param[in]  predicate   Mask generator
+  /// @param[out]  indices   Output, of at least "length" elements
+  template <typename Predicate>
+  static inline unsigned int CompressIndices(BlockIn input,
+                                             const unsigned int length,
+                                             Predicate predicate,
+                                             unsigned int* const indices) {
+    VECMATH_PROFILE_KERNEL("CompressIndices",
+                           length,
+                           length * (sizeof(float) + sizeof(unsigned int)));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    VECMATH_ASSERT(length <= (1u << 24));
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float packed[PlatformVectorMath::FloatVecSize];
+    for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+      packed[i] = static_cast<float>(i);
+    }
+    const FloatVec kIncrement(PlatformVectorMath::Fill(
+      static_cast<float>(PlatformVectorMath::FloatVecSize)));
+    FloatVec positions(PlatformVectorMath::Fill(&packed[0]));
+    unsigned int count(0);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      const unsigned int selected(PlatformVectorMath::CompressStore(
+        &packed[0],
+        predicate(PlatformVectorMath::Fill(&input[i])),
+        positions));
+      for (unsigned int j(0); j < selected; ++j) {
+        indices[count + j] = static_cast<unsigned int>(packed[j]);
+      }
+      count += selected;
+      positions = PlatformVectorMath::Add(positions, kIncrement);
+    }
+    return count;
+  }
+
+  /// @brief Indices of the samples whose magnitude is above the threshold
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  /// @param[in]  threshold   Strict lower bound on the samples magnitude
+  /// @param[out]  indices   Output, of at least "length" elements
+  static inline unsigned int IndicesAbove(BlockIn input,
+                                          const unsigned int length,
+                                          const float threshold,
+                                          unsigned int* const indices) {
+    const FloatVec threshold_v(PlatformVectorMath::Fill(threshold));
+    return CompressIndices(input, length,
+                           [threshold_v](FloatVecRead values) {
+                             return PlatformVectorMath::GreaterThan(
+                               CommonVectorMath::Abs(values), threshold_v);
+                           },
+                           indices);
+  }
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_LEFTPACK_H_
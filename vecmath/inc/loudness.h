@@ -0,0 +1,464 @@
+/// @file loudness.h
+/// @brief ITU-R BS.1770 loudness and true-peak metering
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Channels are processed FloatVecSize at once, one channel per element:
+/// each input frame feeds the K-weighting filters (high shelf then
+/// high-pass), whose squared outputs are summed over 100ms sub-blocks.
+/// Momentary (400ms) and short-term (3s) loudness are sliding sums of
+/// these sub-blocks; each 400ms window (75% overlap) is also a gating block
+/// for the integrated loudness. Gating blocks are accumulated into a fixed
+/// histogram of 0.01 LU bins over [-70 ; +5] LUFS (count and power sum per
+/// bin): processing never allocates, and the integrated loudness costs
+/// the same whatever the stream length.
+///
+/// True peaks are detected on the signal oversampled 4 times by a polyphase
+/// FIR (4 phases of 12 taps), the running maximum being kept per element.
+
+#ifndef VECMATH_INC_LOUDNESS_H_
+#define VECMATH_INC_LOUDNESS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/filter_design.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Multichannel loudness meter (LUFS) and true-peak meter (dBTP)
+///
+/// Results are updated each 100ms of processed audio.
+class LoudnessMeter {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Second order section coefficients, a0 being normalized to 1
+  struct Biquad {
+    double b0;
+    double b1;
+    double b2;
+    double a1;
+    double a2;
+  };
+
+  /// @brief Loudness reported for silence (no energy or no block above the
+  /// gates): finite, so that it remains valid with finite maths flags
+  static constexpr double kSilence = -200.0;
+
+  /// @param[in]  channels   Number of channels
+  /// @param[in]  sampling_rate   Sampling rate, in Hz
+  ///
+  /// With 5 or 6 channels, the order is supposed to be L, R, C, (LFE,)
+  /// Ls, Rs: surround channels are weighted +1.5dB, LFE is ignored.
+  /// Otherwise all channels are weighted 1.0, see SetChannelWeight()
+  LoudnessMeter(const unsigned int channels, const double sampling_rate)
+      : channels_(channels),
+        groups_((channels + PlatformVectorMath::FloatVecSize - 1)
+                / PlatformVectorMath::FloatVecSize),
+        subblock_length_(static_cast<unsigned int>(
+          std::floor(sampling_rate / 10.0 + 0.5))),
+        weights_(groups_ * PlatformVectorMath::FloatVecSize, 0.0f),
+        coefficients_(kCoefficientCount * PlatformVectorMath::FloatVecSize),
+        peak_taps_(kPhases * kPhaseTaps * PlatformVectorMath::FloatVecSize),
+        states_(groups_ * kStateCount * PlatformVectorMath::FloatVecSize),
+        history_(groups_ * 2 * kPhaseTaps * PlatformVectorMath::FloatVecSize),
+        subblocks_(kShortTermSubblocks, 0.0),
+        gating_counts_(kGatingBins, 0),
+        gating_powers_(kGatingBins, 0.0) {
+    VECMATH_ASSERT(channels > 0);
+    VECMATH_ASSERT(sampling_rate > 0.0);
+    for (unsigned int channel(0); channel < channels_; ++channel) {
+      weights_[channel] = 1.0f;
+    }
+    if (channels_ == 5) {
+      weights_[3] = kSurroundWeight;
+      weights_[4] = kSurroundWeight;
+    } else if (channels_ == 6) {
+      weights_[3] = 0.0f;
+      weights_[4] = kSurroundWeight;
+      weights_[5] = kSurroundWeight;
+    }
+    Biquad shelf;
+    Biquad highpass;
+    KWeighting(sampling_rate, &shelf, &highpass);
+    const Biquad* const kSections[] = {&shelf, &highpass};
+    for (unsigned int section(0); section < 2; ++section) {
+      // b0, b1, b2, -a1, -a2
+      const double values[] = {
+        kSections[section]->b0, kSections[section]->b1, kSections[section]->b2,
+        -kSections[section]->a1, -kSections[section]->a2
+      };
+      for (unsigned int i(0); i < 5; ++i) {
+        Broadcast(static_cast<float>(values[i]), section * 5 + i,
+                  &coefficients_);
+      }
+    }
+    DesignTruePeakFilter();
+    Reset();
+  }
+
+  /// @brief K-weighting filters for the given sampling rate
+  /// (BS.1770-4, generalized from the 48kHz coefficients)
+  static void KWeighting(const double sampling_rate,
+                         Biquad* const shelf,
+                         Biquad* const highpass) {
+    const double kPi(3.141592653589793);
+    {
+      const double kFrequency(1681.974450955533);
+      const double kGain(3.999843853973347);
+      const double kQ(0.7071752369554196);
+      const double k(std::tan(kPi * kFrequency / sampling_rate));
+      const double vh(std::pow(10.0, kGain / 20.0));
+      const double vb(std::pow(vh, 0.4996667741545416));
+      const double a0(1.0 + k / kQ + k * k);
+      shelf->b0 = (vh + vb * k / kQ + k * k) / a0;
+      shelf->b1 = 2.0 * (k * k - vh) / a0;
+      shelf->b2 = (vh - vb * k / kQ + k * k) / a0;
+      shelf->a1 = 2.0 * (k * k - 1.0) / a0;
+      shelf->a2 = (1.0 - k / kQ + k * k) / a0;
+    }
+    {
+      const double kFrequency(38.13547087602444);
+      const double kQ(0.5003270373238773);
+      const double k(std::tan(kPi * kFrequency / sampling_rate));
+      const double a0(1.0 + k / kQ + k * k);
+      highpass->b0 = 1.0;
+      highpass->b1 = -2.0;
+      highpass->b2 = 1.0;
+      highpass->a1 = 2.0 * (k * k - 1.0) / a0;
+      highpass->a2 = (1.0 - k / kQ + k * k) / a0;
+    }
+  }
+
+  /// @brief Set the weight of the given channel (0 to ignore it)
+  void SetChannelWeight(const unsigned int channel, const float weight) {
+    VECMATH_ASSERT(channel < channels_);
+    weights_[channel] = weight;
+  }
+
+  /// @brief Restart all measurements
+  void Reset() {
+    std::fill(states_.begin(), states_.end(), 0.0f);
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    std::fill(subblocks_.begin(), subblocks_.end(), 0.0);
+    std::fill(gating_counts_.begin(), gating_counts_.end(), 0);
+    std::fill(gating_powers_.begin(), gating_powers_.end(), 0.0);
+    peaks_.assign(groups_ * PlatformVectorMath::FloatVecSize, 0.0f);
+    subblock_index_ = 0;
+    subblock_position_ = 0;
+    subblock_energy_ = 0.0;
+    subblock_count_ = 0;
+    history_position_ = 0;
+  }
+
+  /// @brief Measure the next frames
+  ///
+  /// @param[in]  inputs   One pointer per channel, no alignment required
+  /// @param[in]  length   Number of frames
+  void Process(const float* const* inputs, const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("LoudnessMeter",
+                           length * channels_,
+                           length * channels_ * sizeof(float));
+    unsigned int done(0);
+    while (done < length) {
+      // Process up to the end of the current sub-block
+      const unsigned int count(std::min(length - done,
+                                        subblock_length_ - subblock_position_));
+      unsigned int history_position(history_position_);
+      for (unsigned int group(0); group < groups_; ++group) {
+        history_position = ProcessGroup(inputs, group, done, count);
+      }
+      history_position_ = history_position;
+      done += count;
+      subblock_position_ += count;
+      if (subblock_position_ == subblock_length_) {
+        CloseSubblock();
+      }
+    }
+  }
+
+  /// @brief Momentary loudness (last 400ms), in LUFS
+  double Momentary() const {
+    return WindowLoudness(kMomentarySubblocks);
+  }
+
+  /// @brief Short-term loudness (last 3s), in LUFS
+  double ShortTerm() const {
+    return WindowLoudness(kShortTermSubblocks);
+  }
+
+  /// @brief Gated loudness since the last Reset(), in LUFS
+  ///
+  /// The relative gate is applied with the histogram resolution: blocks
+  /// in the same 0.01 LU bin as the gate are kept
+  double Integrated() const {
+    // Only blocks above the absolute gate are in the histogram
+    double sum(0.0);
+    std::uint64_t count(0);
+    for (unsigned int bin(0); bin < kGatingBins; ++bin) {
+      sum += gating_powers_[bin];
+      count += gating_counts_[bin];
+    }
+    if (count == 0) {
+      return kSilence;
+    }
+    // Relative gate: 10 LU below the loudness of the absolute-gated blocks
+    const unsigned int first_bin(
+      GatingBin(LoudnessFromPower(sum / static_cast<double>(count)) - 10.0));
+    sum = 0.0;
+    count = 0;
+    for (unsigned int bin(first_bin); bin < kGatingBins; ++bin) {
+      sum += gating_powers_[bin];
+      count += gating_counts_[bin];
+    }
+    return count == 0 ? kSilence
+                      : LoudnessFromPower(sum / static_cast<double>(count));
+  }
+
+  /// @brief Highest true peak of the given channel, in dBTP
+  double TruePeak(const unsigned int channel) const {
+    VECMATH_ASSERT(channel < channels_);
+    return Decibels(peaks_[channel]);
+  }
+
+  /// @brief Highest true peak over all channels, in dBTP
+  double MaxTruePeak() const {
+    return Decibels(*std::max_element(peaks_.begin(),
+                                      peaks_.begin() + channels_));
+  }
+
+ private:
+  static constexpr unsigned int kMomentarySubblocks = 4;
+  static constexpr unsigned int kShortTermSubblocks = 30;
+  static constexpr unsigned int kPhases = 4;
+  static constexpr unsigned int kPhaseTaps = 12;
+  // Two sections: b0, b1, b2, -a1, -a2
+  static constexpr unsigned int kCoefficientCount = 10;
+  // Two sections of two states, energy accumulator
+  static constexpr unsigned int kStateCount = 5;
+  static constexpr float kSurroundWeight = 1.41f;
+  // Gating histogram: 0.01 LU bins from the absolute gate (-70 LUFS)
+  // to +5 LUFS, louder blocks going into the last bin
+  static constexpr double kAbsoluteGate = -70.0;
+  static constexpr unsigned int kGatingBinsPerLU = 100;
+  static constexpr unsigned int kGatingBins = 75 * kGatingBinsPerLU;
+
+  static double LoudnessFromPower(const double power) {
+    return -0.691 + 10.0 * std::log10(std::max(power, 1e-20));
+  }
+
+  static double PowerFromLoudness(const double loudness) {
+    return std::pow(10.0, (loudness + 0.691) / 10.0);
+  }
+
+  /// @brief Histogram bin of a gating block loudness above the absolute
+  /// gate, the first bin for lower ones
+  static unsigned int GatingBin(const double loudness) {
+    const double position((loudness - kAbsoluteGate) * kGatingBinsPerLU);
+    if (!(position > 0.0)) {
+      return 0;
+    }
+    return std::min(static_cast<unsigned int>(position), kGatingBins - 1);
+  }
+
+  static double Decibels(const float amplitude) {
+    return 20.0 * std::log10(std::max(static_cast<double>(amplitude), 1e-10));
+  }
+
+  /// @brief Copy "value" over the FloatVec at "index" in "destination"
+  static void Broadcast(const float value,
+                        const unsigned int index,
+                        AlignedVector<float>* const destination) {
+    for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+      (*destination)[index * PlatformVectorMath::FloatVecSize + i] = value;
+    }
+  }
+
+  /// @brief 4x interpolation filter, each phase normalized to unity DC gain,
+  /// stored from the oldest to the newest input sample
+  void DesignTruePeakFilter() {
+    const unsigned int kLength(kPhases * kPhaseTaps);
+    const double kAttenuation(60.0);
+    const double beta(FilterDesign::KaiserBeta(kAttenuation));
+    const double half_width(0.5 * kLength);
+    const double center(0.5 * (kLength - 1));
+    for (unsigned int phase(0); phase < kPhases; ++phase) {
+      double taps[kPhaseTaps];
+      double sum(0.0);
+      for (unsigned int tap(0); tap < kPhaseTaps; ++tap) {
+        // Newest sample first in the prototype
+        const unsigned int index(tap * kPhases + phase);
+        taps[tap] = FilterDesign::WindowedSinc(index - center,
+                                               0.5 / kPhases,
+                                               half_width,
+                                               beta);
+        sum += taps[tap];
+      }
+      for (unsigned int tap(0); tap < kPhaseTaps; ++tap) {
+        Broadcast(static_cast<float>(taps[kPhaseTaps - 1 - tap] / sum),
+                  phase * kPhaseTaps + tap,
+                  &peak_taps_);
+      }
+    }
+  }
+
+  /// @brief Process "count" frames of the given channels group,
+  /// return the updated history position
+  unsigned int ProcessGroup(const float* const* inputs,
+                            const unsigned int group,
+                            const unsigned int start,
+                            const unsigned int count) {
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    const unsigned int first_channel(group * kVecSize);
+    const unsigned int lanes(std::min(kVecSize, channels_ - first_channel));
+    const float* const coefficients(&coefficients_[0]);
+    FloatVec c[kCoefficientCount];
+    for (unsigned int i(0); i < kCoefficientCount; ++i) {
+      c[i] = PlatformVectorMath::Fill(&coefficients[i * kVecSize]);
+    }
+    float* const states(&states_[group * kStateCount * kVecSize]);
+    FloatVec shelf_1(PlatformVectorMath::Fill(&states[0]));
+    FloatVec shelf_2(PlatformVectorMath::Fill(&states[kVecSize]));
+    FloatVec highpass_1(PlatformVectorMath::Fill(&states[2 * kVecSize]));
+    FloatVec highpass_2(PlatformVectorMath::Fill(&states[3 * kVecSize]));
+    FloatVec energy(PlatformVectorMath::Fill(0.0f));
+    FloatVec peak(PlatformVectorMath::Fill(&peaks_[first_channel]));
+    float* const history(&history_[group * 2 * kPhaseTaps * kVecSize]);
+    unsigned int history_position(history_position_);
+    alignas(PlatformVectorMath::FloatVecSizeBytes) float frame[kVecSize] = {};
+    for (unsigned int t(start); t < start + count; ++t) {
+      // Gather one frame, one channel per element
+      for (unsigned int lane(0); lane < lanes; ++lane) {
+        frame[lane] = inputs[first_channel + lane][t];
+      }
+      const FloatVec input(PlatformVectorMath::Fill(&frame[0]));
+
+      // K-weighting, transposed direct form II
+      const FloatVec shelved(PlatformVectorMath::MulAdd(c[0], input, shelf_1));
+      shelf_1 = PlatformVectorMath::MulAdd(
+        c[3], shelved, PlatformVectorMath::MulAdd(c[1], input, shelf_2));
+      shelf_2 = PlatformVectorMath::MulAdd(
+        c[4], shelved, PlatformVectorMath::Mul(c[2], input));
+      const FloatVec weighted(
+        PlatformVectorMath::MulAdd(c[5], shelved, highpass_1));
+      highpass_1 = PlatformVectorMath::MulAdd(
+        c[8], weighted, PlatformVectorMath::MulAdd(c[6], shelved, highpass_2));
+      highpass_2 = PlatformVectorMath::MulAdd(
+        c[9], weighted, PlatformVectorMath::Mul(c[7], shelved));
+      energy = PlatformVectorMath::MulAdd(weighted, weighted, energy);
+
+      // True peak: the history is written twice, so that the last
+      // kPhaseTaps frames are always contiguous
+      PlatformVectorMath::Store(&history[history_position * kVecSize], input);
+      PlatformVectorMath::Store(
+        &history[(history_position + kPhaseTaps) * kVecSize], input);
+      history_position = (history_position + 1) % kPhaseTaps;
+      const float* const window(&history[history_position * kVecSize]);
+      for (unsigned int phase(0); phase < kPhases; ++phase) {
+        const float* const taps(&peak_taps_[phase * kPhaseTaps * kVecSize]);
+        FloatVec interpolated(PlatformVectorMath::Fill(0.0f));
+        for (unsigned int tap(0); tap < kPhaseTaps; ++tap) {
+          interpolated = PlatformVectorMath::MulAdd(
+            PlatformVectorMath::Fill(&taps[tap * kVecSize]),
+            PlatformVectorMath::Fill(&window[tap * kVecSize]),
+            interpolated);
+        }
+        peak = PlatformVectorMath::Max(peak,
+                                       CommonVectorMath::Abs(interpolated));
+      }
+    }
+    PlatformVectorMath::Store(&states[0], shelf_1);
+    PlatformVectorMath::Store(&states[kVecSize], shelf_2);
+    PlatformVectorMath::Store(&states[2 * kVecSize], highpass_1);
+    PlatformVectorMath::Store(&states[3 * kVecSize], highpass_2);
+    PlatformVectorMath::Store(&peaks_[first_channel], peak);
+    subblock_energy_ += PlatformVectorMath::AddHorizontal(
+      PlatformVectorMath::Mul(
+        energy,
+        PlatformVectorMath::Fill(&weights_[first_channel])));
+    return history_position;
+  }
+
+  /// @brief Store the completed sub-block, update the gating blocks
+  void CloseSubblock() {
+    subblocks_[subblock_index_] = subblock_energy_;
+    subblock_index_ = (subblock_index_ + 1) % kShortTermSubblocks;
+    subblock_energy_ = 0.0;
+    subblock_position_ = 0;
+    subblock_count_ += 1;
+    if (subblock_count_ >= kMomentarySubblocks) {
+      const double power(WindowPower(kMomentarySubblocks));
+      if (power > PowerFromLoudness(kAbsoluteGate)) {
+        const unsigned int bin(GatingBin(LoudnessFromPower(power)));
+        gating_counts_[bin] += 1;
+        gating_powers_[bin] += power;
+      }
+    }
+  }
+
+  /// @brief Mean square over the last "subblocks" completed sub-blocks
+  double WindowPower(const unsigned int subblocks) const {
+    double sum(0.0);
+    for (unsigned int i(1); i <= subblocks; ++i) {
+      sum += subblocks_[(subblock_index_ + kShortTermSubblocks - i)
+                        % kShortTermSubblocks];
+    }
+    return sum / (static_cast<double>(subblocks) * subblock_length_);
+  }
+
+  double WindowLoudness(const unsigned int subblocks) const {
+    const double power(WindowPower(subblocks));
+    return power > 0.0 ? LoudnessFromPower(power) : kSilence;
+  }
+
+  const unsigned int channels_;
+  const unsigned int groups_;
+  const unsigned int subblock_length_;
+  AlignedVector<float> weights_;
+  AlignedVector<float> coefficients_;
+  AlignedVector<float> peak_taps_;
+  // Per group: filter states and energy, FloatVec after FloatVec
+  AlignedVector<float> states_;
+  // Per group: 2 * kPhaseTaps frames
+  AlignedVector<float> history_;
+  AlignedVector<float> peaks_;
+  // Weighted energy of the last kShortTermSubblocks sub-blocks
+  std::vector<double> subblocks_;
+  // Per histogram bin: number of 400ms gating blocks, sum of their
+  // mean squares
+  std::vector<std::uint64_t> gating_counts_;
+  std::vector<double> gating_powers_;
+  unsigned int subblock_index_;
+  unsigned int subblock_position_;
+  double subblock_energy_;
+  unsigned int subblock_count_;
+  unsigned int history_position_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_LOUDNESS_H_
@@ -24,11 +24,21 @@
 
 #include "vecmath/inc/common.h"
 
-#if _VEC_USE_SSE
+#if _VEC_USE_SSE4
+#include "vecmath/inc/platform/implem_sse4.h"
+namespace vecmath {
+typedef SSE4VectorMath PlatformVectorMath;
+}
+#elif _VEC_USE_SSE
 #include "vecmath/inc/platform/implem_sse2.h"
 namespace vecmath {
 typedef SSE2VectorMath PlatformVectorMath;
 }
+#elif (_VEC_HAS_VECTOR_EXTENSIONS) && !defined(_DISABLE_SIMD)
+#include "vecmath/inc/platform/implem_generic.h"
+namespace vecmath {
+typedef GenericVectorMath<4> PlatformVectorMath;
+}
 #else  // _VEC_USE_SSE
 #include "vecmath/inc/platform/implem_std.h"
 namespace vecmath {
@@ -0,0 +1,360 @@
+/// @file mixing.h
+/// @brief Mixing matrices: N input buses to M outputs
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Buffers are planar (one aligned buffer per channel): each output
+/// FloatVec is the sum of the input FloatVecs at the same time, multiplied
+/// by their gain broadcast over the whole FloatVec. Outputs are computed
+/// four at a time so that each input FloatVec is loaded once for all of
+/// them.
+
+#ifndef VECMATH_INC_MIXING_H_
+#define VECMATH_INC_MIXING_H_
+
+#include <algorithm>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Stateless mixing kernels
+///
+/// Gains are given "broadcast": gain (output, input) is expected as
+/// FloatVecSize copies at offset (output * inputs_count + input)
+/// * FloatVecSize, see BroadcastGains().
+struct MixingVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Copy each gain FloatVecSize times
+  ///
+  /// @param[in]  gains   Gains, row-major (one row per output)
+  /// @param[in]  count   Gains count
+  /// @param[out]  broadcast   Aligned, count * FloatVecSize long
+  static inline void BroadcastGains(const float* const gains,
+                                    const unsigned int count,
+                                    BlockOut broadcast) {
+    for (unsigned int i(0); i < count; ++i) {
+      PlatformVectorMath::Store(
+        &broadcast[i * PlatformVectorMath::FloatVecSize],
+        PlatformVectorMath::Fill(gains[i]));
+    }
+  }
+
+  /// @brief Constant gains mix: outputs = gains * inputs
+  ///
+  /// @param[in]  gains   Broadcast gains, outputs_count x inputs_count
+  /// @param[in]  inputs   Aligned input buffers
+  /// @param[in]  inputs_count   Input buffers count
+  /// @param[out]  outputs   Aligned output buffers, not aliasing any input
+  /// @param[in]  outputs_count   Output buffers count
+  /// @param[in]  length   Buffers length, multiple of FloatVecSize
+  static inline void Mix(BlockIn gains,
+                         const float* const* inputs,
+                         const unsigned int inputs_count,
+                         float* const* outputs,
+                         const unsigned int outputs_count,
+                         const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("Mix",
+                           length * outputs_count,
+                           length * (inputs_count + outputs_count)
+                           * sizeof(float));
+    Dispatch<false>(gains, nullptr, inputs, inputs_count,
+                    outputs, outputs_count, length);
+  }
+
+  /// @brief Mix with gains linearly interpolated over the block
+  ///
+  /// Sample t (within [0 ; length[) uses start + delta * (t + 1) / length,
+  /// so that the last sample reaches start + delta.
+  ///
+  /// @param[in]  start   Broadcast gains before the block
+  /// @param[in]  delta   Broadcast gains variations over the block
+  /// @param[in]  inputs   Aligned input buffers
+  /// @param[in]  inputs_count   Input buffers count
+  /// @param[out]  outputs   Aligned output buffers, not aliasing any input
+  /// @param[in]  outputs_count   Output buffers count
+  /// @param[in]  length   Buffers length, multiple of FloatVecSize
+  static inline void MixRamp(BlockIn start,
+                             BlockIn delta,
+                             const float* const* inputs,
+                             const unsigned int inputs_count,
+                             float* const* outputs,
+                             const unsigned int outputs_count,
+                             const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("MixRamp",
+                           length * outputs_count,
+                           length * (inputs_count + outputs_count)
+                           * sizeof(float));
+    Dispatch<true>(start, delta, inputs, inputs_count,
+                   outputs, outputs_count, length);
+  }
+
+  /// @brief Square matrix times the given frame (one channel per element),
+  /// e.g. a 4x4 matrix on a four channels frame
+  ///
+  /// @param[in]  columns   Matrix columns, FloatVecSize of them
+  /// @param[in]  frame   Frame to be transformed
+  static inline FloatVec TransformFrame(const FloatVec* columns,
+                                        FloatVecRead frame) {
+    return TransformSteps<1>::Apply(
+      columns,
+      frame,
+      PlatformVectorMath::Mul(
+        columns[0],
+        PlatformVectorMath::Fill(PlatformVectorMath::GetByIndex<0>(frame))));
+  }
+
+  /// @brief Apply a square matrix on each frame of an interleaved buffer
+  /// of FloatVecSize channels
+  ///
+  /// @param[in]  matrix   Aligned matrix, column-major
+  /// @param[in]  input   Aligned interleaved input
+  /// @param[out]  output   Aligned interleaved output
+  /// @param[in]  frames   Frames count
+  static inline void TransformFrames(BlockIn matrix,
+                                     BlockIn input,
+                                     BlockOut output,
+                                     const unsigned int frames) {
+    VECMATH_PROFILE_KERNEL("TransformFrames",
+                           frames * PlatformVectorMath::FloatVecSize,
+                           frames * 2 * PlatformVectorMath::FloatVecSizeBytes);
+    FloatVec columns[PlatformVectorMath::FloatVecSize];
+    for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+      columns[i] = PlatformVectorMath::Fill(
+        &matrix[i * PlatformVectorMath::FloatVecSize]);
+    }
+    for (unsigned int i(0);
+         i < frames * PlatformVectorMath::FloatVecSize;
+         i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(
+        &output[i],
+        TransformFrame(&columns[0], PlatformVectorMath::Fill(&input[i])));
+    }
+  }
+
+ private:
+  /// @brief Process outputs by blocks of four, then the remaining ones
+  template <bool Ramp>
+  static inline void Dispatch(const float* start,
+                              const float* delta,
+                              const float* const* inputs,
+                              const unsigned int inputs_count,
+                              float* const* outputs,
+                              const unsigned int outputs_count,
+                              const unsigned int length) {
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int row_size(inputs_count
+                                * PlatformVectorMath::FloatVecSize);
+    unsigned int output(0);
+    for (; output + 4 <= outputs_count; output += 4) {
+      MixRows<4, Ramp>(start + output * row_size,
+                       Ramp ? delta + output * row_size : nullptr,
+                       inputs, inputs_count, &outputs[output], length);
+    }
+    const float* const rows_delta(Ramp ? delta + output * row_size : nullptr);
+    switch (outputs_count - output) {
+      case 3:
+        MixRows<3, Ramp>(start + output * row_size, rows_delta,
+                         inputs, inputs_count, &outputs[output], length);
+        break;
+      case 2:
+        MixRows<2, Ramp>(start + output * row_size, rows_delta,
+                         inputs, inputs_count, &outputs[output], length);
+        break;
+      case 1:
+        MixRows<1, Ramp>(start + output * row_size, rows_delta,
+                         inputs, inputs_count, &outputs[output], length);
+        break;
+      default:
+        break;
+    }
+  }
+
+  /// @brief Compute "Rows" outputs, each accumulator staying in a register
+  template <unsigned int Rows, bool Ramp>
+  static inline void MixRows(const float* start,
+                             const float* delta,
+                             const float* const* inputs,
+                             const unsigned int inputs_count,
+                             float* const* outputs,
+                             const unsigned int length) {
+    const unsigned int row_size(inputs_count
+                                * PlatformVectorMath::FloatVecSize);
+    // Ramp position of the first FloatVec: (t + 1) / length
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float first_positions[PlatformVectorMath::FloatVecSize];
+    const float normalization(1.0f / static_cast<float>(length));
+    for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+      first_positions[i] = static_cast<float>(i + 1) * normalization;
+    }
+    const FloatVec first_position(PlatformVectorMath::Fill(&first_positions[0]));
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      const FloatVec position(PlatformVectorMath::Add(
+        first_position,
+        PlatformVectorMath::Fill(static_cast<float>(i) * normalization)));
+      FloatVec sums[Rows];
+      for (unsigned int row(0); row < Rows; ++row) {
+        sums[row] = PlatformVectorMath::Fill(0.0f);
+      }
+      for (unsigned int input(0); input < inputs_count; ++input) {
+        const FloatVec samples(PlatformVectorMath::Fill(&inputs[input][i]));
+        const unsigned int offset(input * PlatformVectorMath::FloatVecSize);
+        for (unsigned int row(0); row < Rows; ++row) {
+          FloatVec gain(PlatformVectorMath::Fill(
+            &start[row * row_size + offset]));
+          if (Ramp) {
+            gain = PlatformVectorMath::MulAdd(
+              PlatformVectorMath::Fill(&delta[row * row_size + offset]),
+              position,
+              gain);
+          }
+          sums[row] = PlatformVectorMath::MulAdd(gain, samples, sums[row]);
+        }
+      }
+      for (unsigned int row(0); row < Rows; ++row) {
+        PlatformVectorMath::Store(&outputs[row][i], sums[row]);
+      }
+    }
+  }
+
+  template <unsigned int Column,
+            bool Done = (Column >= PlatformVectorMath::FloatVecSize)>
+  struct TransformSteps {
+    static inline FloatVec Apply(const FloatVec* columns,
+                                 FloatVecRead frame,
+                                 FloatVecRead sum) {
+      return TransformSteps<Column + 1>::Apply(
+        columns,
+        frame,
+        PlatformVectorMath::MulAdd(
+          columns[Column],
+          PlatformVectorMath::Fill(
+            PlatformVectorMath::GetByIndex<Column>(frame)),
+          sum));
+    }
+  };
+
+  template <unsigned int Column>
+  struct TransformSteps<Column, true> {
+    static inline FloatVec Apply(const FloatVec* /*columns*/,
+                                 FloatVecRead /*frame*/,
+                                 FloatVecRead sum) {
+      return sum;
+    }
+  };
+};
+
+/// @brief Mixing matrix whose gain changes are smoothed over one block
+///
+/// Gain changes apply to the next Process() call, interpolated linearly
+/// over the whole block to avoid zipper noise.
+class MixingMatrix {
+ public:
+  /// @param[in]  inputs_count   Input buses count
+  /// @param[in]  outputs_count   Output buses count
+  MixingMatrix(const unsigned int inputs_count,
+               const unsigned int outputs_count)
+      : inputs_count_(inputs_count),
+        outputs_count_(outputs_count),
+        target_(inputs_count * outputs_count, 0.0f),
+        current_(inputs_count * outputs_count, 0.0f),
+        start_(inputs_count * outputs_count
+               * PlatformVectorMath::FloatVecSize, 0.0f),
+        delta_(inputs_count * outputs_count
+               * PlatformVectorMath::FloatVecSize, 0.0f) {
+    VECMATH_ASSERT(inputs_count > 0);
+    VECMATH_ASSERT(outputs_count > 0);
+  }
+
+  unsigned int InputsCount() const {
+    return inputs_count_;
+  }
+
+  unsigned int OutputsCount() const {
+    return outputs_count_;
+  }
+
+  /// @brief Set one gain, effective at the end of the next block
+  void SetGain(const unsigned int output,
+               const unsigned int input,
+               const float gain) {
+    VECMATH_ASSERT(output < outputs_count_);
+    VECMATH_ASSERT(input < inputs_count_);
+    target_[output * inputs_count_ + input] = gain;
+  }
+
+  /// @brief Set all gains, row-major (one row per output),
+  /// effective at the end of the next block
+  void SetGains(const float* const gains) {
+    std::copy(gains, gains + target_.size(), target_.begin());
+  }
+
+  /// @brief Currently applied gain
+  float Gain(const unsigned int output, const unsigned int input) const {
+    return current_[output * inputs_count_ + input];
+  }
+
+  /// @brief Apply the target gains at once, without interpolation
+  void Jump() {
+    std::copy(target_.begin(), target_.end(), current_.begin());
+  }
+
+  /// @brief Mix one block
+  ///
+  /// @param[in]  inputs   Aligned input buffers
+  /// @param[out]  outputs   Aligned output buffers, not aliasing any input
+  /// @param[in]  length   Buffers length, multiple of FloatVecSize
+  void Process(const float* const* inputs,
+               float* const* outputs,
+               const unsigned int length) {
+    const unsigned int count(static_cast<unsigned int>(current_.size()));
+    MixingVectorMath::BroadcastGains(&current_[0], count, &start_[0]);
+    if (std::equal(current_.begin(), current_.end(), target_.begin())) {
+      MixingVectorMath::Mix(&start_[0], inputs, inputs_count_,
+                            outputs, outputs_count_, length);
+      return;
+    }
+    for (unsigned int i(0); i < count; ++i) {
+      PlatformVectorMath::Store(
+        &delta_[i * PlatformVectorMath::FloatVecSize],
+        PlatformVectorMath::Fill(target_[i] - current_[i]));
+    }
+    MixingVectorMath::MixRamp(&start_[0], &delta_[0], inputs, inputs_count_,
+                              outputs, outputs_count_, length);
+    Jump();
+  }
+
+ private:
+  unsigned int inputs_count_;
+  unsigned int outputs_count_;
+  AlignedVector<float> target_;
+  AlignedVector<float> current_;
+  /// @brief Broadcast versions of the current gains and their variations
+  AlignedVector<float> start_;
+  AlignedVector<float> delta_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_MIXING_H_
@@ -0,0 +1,256 @@
+/// @file multichannel.h
+/// @brief Planar multichannel buffers and views
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_INC_MULTICHANNEL_H_
+#define VECMATH_INC_MULTICHANNEL_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Non-owning view over consecutive channels of a planar buffer,
+/// for a range of samples
+///
+/// Channels are "stride" samples apart. The view start and stride are
+/// aligned on a FloatVec, and so is each channel: Channel() can be given
+/// to any block kernel (BlockIn or BlockOut) without further check.
+///
+/// Sample is either float or const float; mutable views convert
+/// to const ones.
+template <typename Sample>
+class BasicMultiChannelView {
+ public:
+  /// @param[in]  data   First sample of the first channel, aligned
+  /// @param[in]  channels   Number of channels
+  /// @param[in]  length   Samples per channel, multiple of FloatVecSize
+  /// @param[in]  stride   Distance between channels, multiple of
+  ///                      FloatVecSize, >= length
+  BasicMultiChannelView(Sample* const data,
+                        const unsigned int channels,
+                        const unsigned int length,
+                        const unsigned int stride)
+      : data_(data),
+        channels_(channels),
+        length_(length),
+        stride_(stride) {
+    VECMATH_ASSERT(IsAligned(data, sizeof(PlatformVectorMath::FloatVec)));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    VECMATH_ASSERT(stride % PlatformVectorMath::FloatVecSize == 0);
+    VECMATH_ASSERT(channels <= 1 || length <= stride);
+  }
+
+  /// @brief Conversion from a mutable view to a const one
+  template <typename OtherSample>
+  BasicMultiChannelView(const BasicMultiChannelView<OtherSample>& other)
+      : data_(other.Data()),
+        channels_(other.Channels()),
+        length_(other.Length()),
+        stride_(other.Stride()) {}
+
+  Sample* Data() const {
+    return data_;
+  }
+
+  unsigned int Channels() const {
+    return channels_;
+  }
+
+  /// @brief Samples per channel
+  unsigned int Length() const {
+    return length_;
+  }
+
+  /// @brief Distance between two channels, in samples
+  unsigned int Stride() const {
+    return stride_;
+  }
+
+  /// @brief Aligned samples of the given channel
+  Sample* Channel(const unsigned int channel) const {
+    VECMATH_ASSERT(channel < channels_);
+    return data_ + static_cast<std::size_t>(channel) * stride_;
+  }
+
+  /// @brief View over the same channels, from "start" on
+  ///
+  /// @param[in]  start   First sample, multiple of FloatVecSize
+  /// @param[in]  length   Samples per channel, multiple of FloatVecSize
+  BasicMultiChannelView Range(const unsigned int start,
+                              const unsigned int length) const {
+    VECMATH_ASSERT(start % PlatformVectorMath::FloatVecSize == 0);
+    VECMATH_ASSERT(start + length <= length_);
+    return BasicMultiChannelView(data_ + start, channels_, length, stride_);
+  }
+
+  /// @brief View over "count" channels, from "first" on
+  BasicMultiChannelView ChannelRange(const unsigned int first,
+                                     const unsigned int count) const {
+    VECMATH_ASSERT(first + count <= channels_);
+    return BasicMultiChannelView(data_ + static_cast<std::size_t>(first)
+                                         * stride_,
+                                 count,
+                                 length_,
+                                 stride_);
+  }
+
+  /// @brief Call function(Channel(channel), Length()) for each channel
+  template <typename Function>
+  void Apply(Function function) const {
+    for (unsigned int channel(0); channel < channels_; ++channel) {
+      function(Channel(channel), length_);
+    }
+  }
+
+ private:
+  Sample* data_;
+  unsigned int channels_;
+  unsigned int length_;
+  unsigned int stride_;
+};
+
+typedef BasicMultiChannelView<float> MultiChannelView;
+typedef BasicMultiChannelView<const float> ConstMultiChannelView;
+
+/// @brief Call function(input.Channel(channel), output.Channel(channel),
+/// length) for each channel
+///
+/// Both views must have the same shape; in-place processing is up to the
+/// kernel (BlockIn/BlockOut are restrict pointers).
+template <typename Function>
+inline void ApplyChannels(const ConstMultiChannelView& input,
+                          const MultiChannelView& output,
+                          Function function) {
+  VECMATH_ASSERT(input.Channels() == output.Channels());
+  VECMATH_ASSERT(input.Length() == output.Length());
+  for (unsigned int channel(0); channel < input.Channels(); ++channel) {
+    function(input.Channel(channel), output.Channel(channel), input.Length());
+  }
+}
+
+/// @brief Planar multichannel audio, all channels in a single aligned slab
+///
+/// Each channel stride is padded to an odd number of cache lines
+/// (so of FloatVecs): with an even one, channels k apart for some small k
+/// would lie a multiple of 4KiB apart, map to the same cache sets, and same
+/// index accesses across channels would suffer from 4K aliasing.
+class MultiChannelBuffer {
+ public:
+  /// @param[in]  channels   Number of channels
+  /// @param[in]  length   Samples per channel, multiple of FloatVecSize
+  MultiChannelBuffer(const unsigned int channels, const unsigned int length)
+      : channels_(channels),
+        length_(length),
+        stride_(PaddedStride(length)),
+        data_(static_cast<std::size_t>(channels) * stride_, 0.0f),
+        pointers_(channels) {
+    VECMATH_ASSERT(channels > 0);
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    for (unsigned int channel(0); channel < channels; ++channel) {
+      pointers_[channel] = &data_[static_cast<std::size_t>(channel) * stride_];
+    }
+  }
+
+  // Channel pointers refer to the slab: moving keeps it, copying does not
+  MultiChannelBuffer(MultiChannelBuffer&& other) = default;
+  MultiChannelBuffer(const MultiChannelBuffer& other) = delete;
+  MultiChannelBuffer& operator=(const MultiChannelBuffer& other) = delete;
+
+  unsigned int Channels() const {
+    return channels_;
+  }
+
+  /// @brief Samples per channel
+  unsigned int Length() const {
+    return length_;
+  }
+
+  /// @brief Distance between two channels, in samples
+  unsigned int Stride() const {
+    return stride_;
+  }
+
+  /// @brief Aligned samples of the given channel
+  float* Channel(const unsigned int channel) {
+    VECMATH_ASSERT(channel < channels_);
+    return pointers_[channel];
+  }
+
+  const float* Channel(const unsigned int channel) const {
+    VECMATH_ASSERT(channel < channels_);
+    return pointers_[channel];
+  }
+
+  /// @brief Channel pointers, for kernels taking one block per channel
+  float* const* Pointers() {
+    return &pointers_[0];
+  }
+
+  const float* const* Pointers() const {
+    return &pointers_[0];
+  }
+
+  /// @brief View over the whole buffer
+  MultiChannelView View() {
+    return MultiChannelView(&data_[0], channels_, length_, stride_);
+  }
+
+  ConstMultiChannelView View() const {
+    return ConstMultiChannelView(&data_[0], channels_, length_, stride_);
+  }
+
+  /// @brief Set all samples to 0
+  void Clear() {
+    std::fill(data_.begin(), data_.end(), 0.0f);
+  }
+
+  /// @brief Padded stride of channels of the given length, in samples
+  static unsigned int PaddedStride(const unsigned int length) {
+    const unsigned int line(static_cast<unsigned int>(kDefaultAlignment
+                                                      / sizeof(float)));
+    const unsigned int lines(std::max(1u, (length + line - 1) / line));
+    // Odd number of lines: never a multiple of 4KiB apart for k < 64
+    return (lines | 1u) * line;
+  }
+
+ private:
+  /// @brief Address bits compared by store to load forwarding, in bytes
+  static constexpr unsigned int kAliasingPeriod = 4096;
+
+  static_assert(kDefaultAlignment % sizeof(PlatformVectorMath::FloatVec) == 0,
+                "Cache lines have to hold whole FloatVecs");
+  static_assert(kAliasingPeriod % kDefaultAlignment == 0,
+                "Odd numbers of cache lines have to avoid 4K aliasing");
+
+  const unsigned int channels_;
+  const unsigned int length_;
+  const unsigned int stride_;
+  AlignedVector<float> data_;
+  std::vector<float*> pointers_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_MULTICHANNEL_H_
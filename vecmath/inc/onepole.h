@@ -0,0 +1,398 @@
+/// @file onepole.h
+/// @brief First order recursive filters, vectorized across time
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// A first order recurrence y[n] = pole * y[n - 1] + gain * x[n] is
+/// computed FloatVecSize samples at once: an in-register scan first gives
+/// the response to the current FloatVec inputs alone, then the previous
+/// output (carried from the last element) is added, multiplied by
+/// precomputed powers of the pole.
+
+#ifndef VECMATH_INC_ONEPOLE_H_
+#define VECMATH_INC_ONEPOLE_H_
+
+#include <cmath>
+
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+#include "vecmath/inc/scan.h"
+
+namespace vecmath {
+
+/// @brief Building blocks of vectorized first order recurrences
+struct RecursiveVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Response of y[n] = pole * y[n - 1] + x[n] to the input alone
+  /// (null initial state)
+  ///
+  /// Given (x0, x1, x2, x3)
+  /// return (x0, p x0 + x1, p^2 x0 + p x1 + x2, p^3 x0 + p^2 x1 + p x2 + x3)
+  static inline FloatVec Scan(FloatVecRead input, const float pole) {
+    return ScanSteps<1>::Apply(input, pole);
+  }
+
+  /// @brief Response of y[n] = a[n] * y[n - 1] + x[n] to the input alone,
+  /// with a different coefficient a[n] for each element
+  ///
+  /// @param[in]  input   x[n]
+  /// @param[in]  coefficients   a[n]
+  /// @param[out]  products   a[0] * ... * a[n], the factor to apply to the
+  /// output preceding this FloatVec
+  static inline FloatVec ScanVarying(FloatVecRead input,
+                                     FloatVecRead coefficients,
+                                     FloatVec* products) {
+    FloatVec output(input);
+    *products = coefficients;
+    VaryingScanSteps<1>::Apply(&output, products);
+    return output;
+  }
+
+  /// @brief Powers of the pole: (pole, pole^2, ..., pole^FloatVecSize)
+  static inline FloatVec Powers(const float pole) {
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float powers[PlatformVectorMath::FloatVecSize];
+    double power(pole);
+    for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+      powers[i] = static_cast<float>(power);
+      power *= pole;
+    }
+    return PlatformVectorMath::Fill(&powers[0]);
+  }
+
+  /// @brief Pole of a one-pole smoother with the given time constant
+  /// (time to reach 1 - 1/e of a step)
+  ///
+  /// @param[in]  seconds   Time constant, in seconds
+  /// @param[in]  sampling_rate   Sampling rate, in Hz
+  static inline float PoleFromTimeConstant(const float seconds,
+                                           const float sampling_rate) {
+    VECMATH_ASSERT(seconds > 0.0f);
+    VECMATH_ASSERT(sampling_rate > 0.0f);
+    return static_cast<float>(std::exp(-1.0 / (static_cast<double>(seconds)
+                                               * sampling_rate)));
+  }
+
+ private:
+  /// @brief Add to each element the one Count elements before,
+  /// multiplied by pole^Count, then recurse with twice the shift
+  template <unsigned Count,
+            bool Done = (Count >= PlatformVectorMath::FloatVecSize)>
+  struct ScanSteps {
+    static inline FloatVec Apply(FloatVecRead input, const float factor) {
+      return ScanSteps<Count * 2>::Apply(
+        PlatformVectorMath::MulAdd(
+          PlatformVectorMath::Fill(factor),
+          PlatformVectorMath::ShiftOnRight<Count>(input, 0.0f),
+          input),
+        factor * factor);
+    }
+  };
+
+  template <unsigned Count>
+  struct ScanSteps<Count, true> {
+    static inline FloatVec Apply(FloatVecRead input, const float /*factor*/) {
+      return input;
+    }
+  };
+
+  /// @brief Same as ScanSteps, the factors being the products of the
+  /// coefficients over the Count previous elements
+  template <unsigned Count,
+            bool Done = (Count >= PlatformVectorMath::FloatVecSize)>
+  struct VaryingScanSteps {
+    static inline void Apply(FloatVec* output, FloatVec* products) {
+      *output = PlatformVectorMath::MulAdd(
+        *products,
+        PlatformVectorMath::ShiftOnRight<Count>(*output, 0.0f),
+        *output);
+      *products = PlatformVectorMath::Mul(
+        *products,
+        PlatformVectorMath::ShiftOnRight<Count>(*products, 1.0f));
+      VaryingScanSteps<Count * 2>::Apply(output, products);
+    }
+  };
+
+  template <unsigned Count>
+  struct VaryingScanSteps<Count, true> {
+    static inline void Apply(FloatVec* /*output*/, FloatVec* /*products*/) {}
+  };
+};
+
+/// @brief One-pole filter: y[n] = pole * y[n - 1] + gain * x[n]
+///
+/// - leaky integrator: gain = 1
+/// - smoother (unity DC gain lowpass): gain = 1 - pole
+class OnePole {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+
+  /// @param[in]  pole   Feedback coefficient, within ]-1 ; 1[ for stability
+  /// @param[in]  gain   Input gain
+  explicit OnePole(const float pole = 0.0f, const float gain = 1.0f)
+      : pole_(0.0f),
+        gain_(0.0f),
+        state_(0.0f) {
+    SetCoefficients(pole, gain);
+  }
+
+  /// @brief Build a unity DC gain smoother with the given time constant
+  static OnePole Smoother(const float seconds, const float sampling_rate) {
+    const float pole(RecursiveVectorMath::PoleFromTimeConstant(seconds,
+                                                               sampling_rate));
+    return OnePole(pole, 1.0f - pole);
+  }
+
+  void SetCoefficients(const float pole, const float gain) {
+    pole_ = pole;
+    gain_ = gain;
+  }
+
+  /// @brief Set the filter state, i.e. the previous output
+  void Reset(const float state = 0.0f) {
+    state_ = state;
+  }
+
+  /// @brief Previous output
+  float State() const {
+    return state_;
+  }
+
+  /// @brief Process a single sample
+  float Process(const float input) {
+    state_ = pole_ * state_ + gain_ * input;
+    return state_;
+  }
+
+  /// @brief Process a whole block
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[out]  output   Aligned output block
+  /// @param[in]  count   Block length, multiple of FloatVecSize
+  void Process(BlockIn input, BlockOut output, const unsigned int count) {
+    ProcessBlock(input, output, count);
+  }
+
+  /// @brief Process a whole block in place
+  ///
+  /// @param[in,out]  buffer   Aligned block
+  /// @param[in]  count   Block length, multiple of FloatVecSize
+  void Process(float* const buffer, const unsigned int count) {
+    ProcessBlock(buffer, buffer, count);
+  }
+
+ private:
+  /// @brief Block implementation, input and output possibly aliased:
+  /// each FloatVec is read before being written
+  void ProcessBlock(const float* const input,
+                    float* const output,
+                    const unsigned int count) {
+    VECMATH_PROFILE_KERNEL("OnePole", count, count * 2 * sizeof(float));
+    VECMATH_ASSERT(count % PlatformVectorMath::FloatVecSize == 0);
+    const FloatVec gain(PlatformVectorMath::Fill(gain_));
+    const FloatVec powers(RecursiveVectorMath::Powers(pole_));
+    FloatVec state(PlatformVectorMath::Fill(state_));
+    for (unsigned int i(0); i < count; i += PlatformVectorMath::FloatVecSize) {
+      const FloatVec response(RecursiveVectorMath::Scan(
+        PlatformVectorMath::Mul(gain, PlatformVectorMath::Fill(&input[i])),
+        pole_));
+      const FloatVec filtered(PlatformVectorMath::MulAdd(powers,
+                                                         state,
+                                                         response));
+      PlatformVectorMath::Store(&output[i], filtered);
+      state = ScanVectorMath::FillWithLast(filtered);
+    }
+    state_ = PlatformVectorMath::GetByIndex<0>(state);
+  }
+
+  float pole_;
+  float gain_;
+  float state_;
+};
+
+/// @brief DC blocker: y[n] = x[n] - x[n - 1] + pole * y[n - 1]
+///
+/// The first difference is computed in-register, then filtered by a OnePole
+class DCBlocker {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+
+  /// @param[in]  pole   Feedback coefficient, typically close to 1 (0.995)
+  explicit DCBlocker(const float pole = 0.995f)
+      : filter_(pole, 1.0f),
+        previous_(0.0f) {
+  }
+
+  void SetPole(const float pole) {
+    filter_.SetCoefficients(pole, 1.0f);
+  }
+
+  void Reset() {
+    filter_.Reset();
+    previous_ = 0.0f;
+  }
+
+  /// @brief Process a whole block, in place allowed
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[out]  output   Aligned output block
+  /// @param[in]  count   Block length, multiple of FloatVecSize
+  void Process(const float* const input,
+               float* const output,
+               const unsigned int count) {
+    VECMATH_ASSERT(count % PlatformVectorMath::FloatVecSize == 0);
+    for (unsigned int i(0); i < count; i += PlatformVectorMath::FloatVecSize) {
+      const FloatVec current(PlatformVectorMath::Fill(&input[i]));
+      PlatformVectorMath::Store(
+        &output[i],
+        PlatformVectorMath::Sub(
+          current,
+          PlatformVectorMath::ShiftOnRight<1>(current, previous_)));
+      previous_ = PlatformVectorMath::GetByIndex<
+        PlatformVectorMath::FloatVecSize - 1>(current);
+    }
+    filter_.Process(output, count);
+  }
+
+ private:
+  OnePole filter_;
+  float previous_;
+};
+
+/// @brief Peak envelope follower with distinct attack and release:
+///
+/// y[n] = y[n - 1] + c * (|x[n]| - y[n - 1]),
+/// c being the attack coefficient if |x[n]| > y[n - 1], release otherwise
+///
+/// Both recurrences are computed vectorized; one of them is kept whenever
+/// all its elements agree with their attack/release condition, otherwise
+/// (at the boundaries between attack and release) the FloatVec is
+/// computed sample by sample. Attack/release decisions are thus always
+/// consistent with the computed envelope, which matches the scalar
+/// recurrence up to rounding.
+class EnvelopeFollower {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+
+  /// @param[in]  attack   Attack coefficient, within ]0 ; 1]
+  /// @param[in]  release   Release coefficient, within ]0 ; 1]
+  EnvelopeFollower(const float attack, const float release)
+      : attack_(attack),
+        release_(release),
+        state_(0.0f) {
+  }
+
+  /// @brief Build an envelope follower from attack/release time constants
+  static EnvelopeFollower FromTimes(const float attack_seconds,
+                                    const float release_seconds,
+                                    const float sampling_rate) {
+    return EnvelopeFollower(
+      1.0f - RecursiveVectorMath::PoleFromTimeConstant(attack_seconds,
+                                                       sampling_rate),
+      1.0f - RecursiveVectorMath::PoleFromTimeConstant(release_seconds,
+                                                       sampling_rate));
+  }
+
+  void SetCoefficients(const float attack, const float release) {
+    attack_ = attack;
+    release_ = release;
+  }
+
+  void Reset(const float state = 0.0f) {
+    state_ = state;
+  }
+
+  /// @brief Current envelope value
+  float State() const {
+    return state_;
+  }
+
+  /// @brief Process a single sample
+  float Process(const float input) {
+    const float rectified(std::fabs(input));
+    const float coefficient(rectified > state_ ? attack_ : release_);
+    state_ += coefficient * (rectified - state_);
+    return state_;
+  }
+
+  /// @brief Process a whole block
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[out]  output   Aligned envelope block
+  /// @param[in]  count   Block length, multiple of FloatVecSize
+  void Process(BlockIn input, BlockOut output, const unsigned int count) {
+    VECMATH_PROFILE_KERNEL("EnvelopeFollower",
+                           count,
+                           count * 2 * sizeof(float));
+    VECMATH_ASSERT(count % PlatformVectorMath::FloatVecSize == 0);
+    const float attack_pole(1.0f - attack_);
+    const float release_pole(1.0f - release_);
+    const FloatVec attack(PlatformVectorMath::Fill(attack_));
+    const FloatVec release(PlatformVectorMath::Fill(release_));
+    const FloatVec attack_powers(RecursiveVectorMath::Powers(attack_pole));
+    const FloatVec release_powers(RecursiveVectorMath::Powers(release_pole));
+    for (unsigned int i(0); i < count; i += PlatformVectorMath::FloatVecSize) {
+      const FloatVec rectified(CommonVectorMath::Abs(
+        PlatformVectorMath::Fill(&input[i])));
+      const FloatVec state(PlatformVectorMath::Fill(state_));
+      const FloatVec attacked(PlatformVectorMath::MulAdd(
+        attack_powers,
+        state,
+        RecursiveVectorMath::Scan(PlatformVectorMath::Mul(attack, rectified),
+                                  attack_pole)));
+      if (PlatformVectorMath::IsMaskFull(PlatformVectorMath::GreaterThan(
+            rectified,
+            PlatformVectorMath::ShiftOnRight<1>(attacked, state_)))) {
+        PlatformVectorMath::Store(&output[i], attacked);
+        state_ = PlatformVectorMath::GetByIndex<
+          PlatformVectorMath::FloatVecSize - 1>(attacked);
+        continue;
+      }
+      const FloatVec released(PlatformVectorMath::MulAdd(
+        release_powers,
+        state,
+        RecursiveVectorMath::Scan(PlatformVectorMath::Mul(release, rectified),
+                                  release_pole)));
+      if (PlatformVectorMath::IsMaskFull(PlatformVectorMath::LessEqual(
+            rectified,
+            PlatformVectorMath::ShiftOnRight<1>(released, state_)))) {
+        PlatformVectorMath::Store(&output[i], released);
+        state_ = PlatformVectorMath::GetByIndex<
+          PlatformVectorMath::FloatVecSize - 1>(released);
+        continue;
+      }
+      // Attack/release transition
+      for (unsigned int j(0); j < PlatformVectorMath::FloatVecSize; ++j) {
+        output[i + j] = Process(input[i + j]);
+      }
+    }
+  }
+
+ private:
+  float attack_;
+  float release_;
+  float state_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_ONEPOLE_H_
@@ -0,0 +1,367 @@
+/// @file oversampling.h
+/// @brief Power of two oversampling with polyphase half-band filters
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Each 2x stage is a linear phase half-band FIR in polyphase form: the
+/// upsampler interleaves the delayed input with the FIR phase output, the
+/// decimator only computes the outputs kept. Stages are cascaded up to 8x,
+/// all intermediate blocks being allocated at construction.
+
+#ifndef VECMATH_INC_OVERSAMPLING_H_
+#define VECMATH_INC_OVERSAMPLING_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/filter_design.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Linear phase half-band FIR, polyphase form
+///
+/// Half of the coefficients of a half-band filter are null, but the
+/// center one: one phase is a pure delay, the other one a symmetric FIR
+/// of 2 * half_taps coefficients, computed over FloatVecSize consecutive
+/// low rate samples at once.
+class HalfBandFilter {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Delay, in low rate samples
+  unsigned int Latency() const {
+    return half_taps_;
+  }
+
+  /// @brief Number of non-null coefficients on each side of the center
+  unsigned int HalfTaps() const {
+    return half_taps_;
+  }
+
+ protected:
+  /// @param[in]  half_taps   Number of coefficients of each FIR phase side
+  /// @param[in]  attenuation   Stopband attenuation in dB (positive)
+  HalfBandFilter(const unsigned int half_taps, const double attenuation)
+      : half_taps_(half_taps),
+        coefficients_(half_taps) {
+    VECMATH_ASSERT(half_taps > 0);
+    // Non-null coefficients are at odd offsets from the center, in high
+    // rate samples: +/-1, +/-3, ... +/-(2 half_taps - 1)
+    const double beta(FilterDesign::KaiserBeta(attenuation));
+    double sum(0.0);
+    std::vector<double> design(half_taps);
+    for (unsigned int tap(0); tap < half_taps; ++tap) {
+      design[tap] = FilterDesign::WindowedSinc(2.0 * tap + 1.0 - 2.0 * half_taps,
+                                               0.25,
+                                               2.0 * half_taps,
+                                               beta);
+      sum += 2.0 * design[tap];
+    }
+    // Exact unity DC gain of the FIR phase, that is interpolating twice
+    // the half-band filter
+    for (unsigned int tap(0); tap < half_taps; ++tap) {
+      coefficients_[tap] = static_cast<float>(design[tap] / sum);
+    }
+  }
+
+  /// @brief FIR phase applied to 2 half_taps consecutive values, the
+  /// output matching the middle of them
+  inline FloatVec Convolve(const float* const samples) const {
+    const unsigned int last(2 * half_taps_ - 1);
+    // Two accumulators, halving the dependency chain
+    FloatVec even(PlatformVectorMath::Fill(0.0f));
+    FloatVec odd(PlatformVectorMath::Fill(0.0f));
+    unsigned int tap(0);
+    for (; tap + 1 < half_taps_; tap += 2) {
+      even = PlatformVectorMath::MulAdd(
+        PlatformVectorMath::Add(
+          PlatformVectorMath::FillUnaligned(&samples[tap]),
+          PlatformVectorMath::FillUnaligned(&samples[last - tap])),
+        PlatformVectorMath::Fill(coefficients_[tap]),
+        even);
+      odd = PlatformVectorMath::MulAdd(
+        PlatformVectorMath::Add(
+          PlatformVectorMath::FillUnaligned(&samples[tap + 1]),
+          PlatformVectorMath::FillUnaligned(&samples[last - tap - 1])),
+        PlatformVectorMath::Fill(coefficients_[tap + 1]),
+        odd);
+    }
+    if (tap < half_taps_) {
+      even = PlatformVectorMath::MulAdd(
+        PlatformVectorMath::Add(
+          PlatformVectorMath::FillUnaligned(&samples[tap]),
+          PlatformVectorMath::FillUnaligned(&samples[last - tap])),
+        PlatformVectorMath::Fill(coefficients_[tap]),
+        even);
+    }
+    return PlatformVectorMath::Add(even, odd);
+  }
+
+  const unsigned int half_taps_;
+  // First half of the FIR phase, scaled for a unity DC gain
+  AlignedVector<float> coefficients_;
+};
+
+/// @brief Upsample by 2
+///
+/// Even outputs are the input delayed by Latency() samples, odd ones the
+/// half-band interpolation between two of them.
+class HalfBandUpsampler : public HalfBandFilter {
+ public:
+  /// @param[in]  half_taps   Number of coefficients of each FIR phase side
+  /// @param[in]  attenuation   Stopband attenuation in dB (positive)
+  /// @param[in]  max_length   Longest input block
+  HalfBandUpsampler(const unsigned int half_taps,
+                    const double attenuation,
+                    const unsigned int max_length)
+      : HalfBandFilter(half_taps, attenuation),
+        history_(2 * half_taps + max_length, 0.0f) {
+    VECMATH_ASSERT(max_length % PlatformVectorMath::FloatVecSize == 0);
+  }
+
+  void Reset() {
+    std::fill(history_.begin(), history_.end(), 0.0f);
+  }
+
+  /// @brief Process a whole block
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[out]  output   Aligned output block, 2 * length samples
+  /// @param[in]  length   Input block length, multiple of FloatVecSize
+  void Process(BlockIn input, BlockOut output, const unsigned int length) {
+    VECMATH_ASSERT(2 * half_taps_ + length <= history_.size());
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int history(2 * half_taps_);
+    std::copy(input, input + length, history_.begin() + history);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      const FloatVec direct(
+        PlatformVectorMath::FillUnaligned(&history_[i + half_taps_]));
+      const FloatVec interpolated(Convolve(&history_[i + 1]));
+      PlatformVectorMath::Store(
+        &output[2 * i],
+        PlatformVectorMath::InterleaveLow(direct, interpolated));
+      PlatformVectorMath::Store(
+        &output[2 * i + PlatformVectorMath::FloatVecSize],
+        PlatformVectorMath::InterleaveHigh(direct, interpolated));
+    }
+    std::copy(history_.begin() + length,
+              history_.begin() + length + history,
+              history_.begin());
+  }
+
+ private:
+  // Last 2 half_taps inputs, then the current block
+  AlignedVector<float> history_;
+};
+
+/// @brief Downsample by 2
+///
+/// Each output is centered on an even input, delayed by Latency() output
+/// samples.
+class HalfBandDecimator : public HalfBandFilter {
+ public:
+  /// @param[in]  half_taps   Number of coefficients of each FIR phase side
+  /// @param[in]  attenuation   Stopband attenuation in dB (positive)
+  /// @param[in]  max_length   Longest output block
+  HalfBandDecimator(const unsigned int half_taps,
+                    const double attenuation,
+                    const unsigned int max_length)
+      : HalfBandFilter(half_taps, attenuation),
+        even_(2 * half_taps + max_length, 0.0f),
+        odd_(2 * half_taps + max_length, 0.0f) {
+    VECMATH_ASSERT(max_length % PlatformVectorMath::FloatVecSize == 0);
+  }
+
+  void Reset() {
+    std::fill(even_.begin(), even_.end(), 0.0f);
+    std::fill(odd_.begin(), odd_.end(), 0.0f);
+  }
+
+  /// @brief Process a whole block
+  ///
+  /// @param[in]  input   Aligned input block, 2 * length samples
+  /// @param[out]  output   Aligned output block
+  /// @param[in]  length   Output block length, multiple of FloatVecSize
+  void Process(BlockIn input, BlockOut output, const unsigned int length) {
+    VECMATH_ASSERT(2 * half_taps_ + length <= even_.size());
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    const unsigned int history(2 * half_taps_);
+    for (unsigned int i(0); i < length; i += kVecSize) {
+      const FloatVec first(PlatformVectorMath::Fill(&input[2 * i]));
+      const FloatVec second(PlatformVectorMath::Fill(&input[2 * i + kVecSize]));
+      PlatformVectorMath::StoreUnaligned(
+        &even_[history + i],
+        PlatformVectorMath::DeinterleaveEven(first, second));
+      PlatformVectorMath::StoreUnaligned(
+        &odd_[history + i],
+        PlatformVectorMath::DeinterleaveOdd(first, second));
+    }
+    const FloatVec half(PlatformVectorMath::Fill(0.5f));
+    for (unsigned int i(0); i < length; i += kVecSize) {
+      // Both phases weighted by 1/2: the FIR phase is scaled for
+      // interpolation
+      PlatformVectorMath::Store(
+        &output[i],
+        PlatformVectorMath::Mul(
+          half,
+          PlatformVectorMath::Add(
+            PlatformVectorMath::FillUnaligned(&even_[i + half_taps_]),
+            Convolve(&odd_[i]))));
+    }
+    std::copy(even_.begin() + length,
+              even_.begin() + length + history,
+              even_.begin());
+    std::copy(odd_.begin() + length,
+              odd_.begin() + length + history,
+              odd_.begin());
+  }
+
+ private:
+  // Last 2 half_taps inputs of each phase, then the current block
+  AlignedVector<float> even_;
+  AlignedVector<float> odd_;
+};
+
+/// @brief Cascade of half-band filters, up to 8x
+///
+/// The first stage, at the lowest rate, is the steepest: later ones only
+/// have to reject images far from the original band, hence much shorter
+/// filters. All stages reject images by 100dB, the passband extending to
+/// 0.4 times the original sampling rate.
+class Oversampler {
+ public:
+  enum Factor {
+    k2x = 1,
+    k4x,
+    k8x
+  };
+
+  /// @param[in]  factor   Oversampling factor, see Factor
+  /// @param[in]  max_block_length   Longest original rate block, multiple
+  ///                                of FloatVecSize
+  Oversampler(const Factor factor, const unsigned int max_block_length)
+      : stages_(static_cast<unsigned int>(factor)),
+        max_block_length_(max_block_length),
+        buffers_{AlignedVector<float>(max_block_length << stages_),
+                 AlignedVector<float>(max_block_length << stages_)} {
+    VECMATH_ASSERT(max_block_length % PlatformVectorMath::FloatVecSize == 0);
+    for (unsigned int stage(0); stage < stages_; ++stage) {
+      upsamplers_.push_back(HalfBandUpsampler(HalfTaps(stage),
+                                              kAttenuation,
+                                              max_block_length << stage));
+      decimators_.push_back(HalfBandDecimator(HalfTaps(stage),
+                                              kAttenuation,
+                                              max_block_length << stage));
+    }
+  }
+
+  /// @brief Oversampling ratio
+  unsigned int Ratio() const {
+    return 1u << stages_;
+  }
+
+  /// @brief Delay of an upsampling / downsampling round trip, in original
+  /// rate samples
+  unsigned int Latency() const {
+    unsigned int latency(0);
+    for (unsigned int stage(0); stage < stages_; ++stage) {
+      // Each stage half at its low rate
+      latency += (upsamplers_[stage].Latency() + decimators_[stage].Latency())
+                 >> stage;
+    }
+    return latency;
+  }
+
+  void Reset() {
+    for (HalfBandUpsampler& upsampler : upsamplers_) {
+      upsampler.Reset();
+    }
+    for (HalfBandDecimator& decimator : decimators_) {
+      decimator.Reset();
+    }
+  }
+
+  /// @brief Upsample a whole block
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  ///
+  /// @return Internal aligned buffer holding length * Ratio() samples,
+  /// valid until the next call, which may be modified in place before
+  /// calling Downsample()
+  float* Upsample(BlockIn input, const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("OversamplerUp",
+                           length << stages_,
+                           (length + (length << stages_)) * sizeof(float));
+    VECMATH_ASSERT(length <= max_block_length_);
+    const float* source(input);
+    for (unsigned int stage(0); stage < stages_; ++stage) {
+      float* const destination(&buffers_[stage % 2][0]);
+      upsamplers_[stage].Process(source, destination, length << stage);
+      source = destination;
+    }
+    return &buffers_[(stages_ - 1) % 2][0];
+  }
+
+  /// @brief Downsample the block returned by the last Upsample() call
+  ///
+  /// @param[out]  output   Aligned output block
+  /// @param[in]  length   Output block length, as given to Upsample()
+  void Downsample(BlockOut output, const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("OversamplerDown",
+                           length << stages_,
+                           (length + (length << stages_)) * sizeof(float));
+    VECMATH_ASSERT(length <= max_block_length_);
+    for (unsigned int stage(stages_ - 1); stage > 0; --stage) {
+      decimators_[stage].Process(&buffers_[stage % 2][0],
+                                 &buffers_[(stage + 1) % 2][0],
+                                 length << stage);
+    }
+    decimators_[0].Process(&buffers_[0][0], output, length);
+  }
+
+ private:
+  /// @brief Half taps count of the given stage
+  ///
+  /// The latency of each stage must be a whole number of original samples:
+  /// the third stage half taps count has to be even
+  static unsigned int HalfTaps(const unsigned int stage) {
+    static const unsigned int kHalfTaps[] = {16, 6, 6};
+    return kHalfTaps[stage];
+  }
+
+  static constexpr double kAttenuation = 100.0;
+
+  const unsigned int stages_;
+  const unsigned int max_block_length_;
+  std::vector<HalfBandUpsampler> upsamplers_;
+  std::vector<HalfBandDecimator> decimators_;
+  // Ping-pong buffers, the last stage writing into buffers_[(stages_ - 1) % 2]
+  AlignedVector<float> buffers_[2];
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_OVERSAMPLING_H_
@@ -0,0 +1,1007 @@
+/// @file implem_generic.h
+/// @brief VecMath maths header - width-generic implementation
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of VecMath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_INC_PLATFORM_IMPLEM_GENERIC_H_
+#define VECMATH_INC_PLATFORM_IMPLEM_GENERIC_H_
+
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/half.h"
+
+namespace vecmath {
+
+#if _VEC_HAS_VECTOR_EXTENSIONS
+/// @brief Vector extension types for each supported width
+///
+/// Explicit specializations are required: some gcc versions silently drop
+/// the vector_size attribute when its argument depends on a template parameter
+template <unsigned N> struct GenericVectorTypes;
+
+template <> struct GenericVectorTypes<4> {
+  typedef float FloatVec __attribute__((vector_size(16)));
+  typedef int IntVec __attribute__((vector_size(16)));
+};
+
+template <> struct GenericVectorTypes<8> {
+  typedef float FloatVec __attribute__((vector_size(32)));
+  typedef int IntVec __attribute__((vector_size(32)));
+};
+
+template <> struct GenericVectorTypes<16> {
+  typedef float FloatVec __attribute__((vector_size(64)));
+  typedef int IntVec __attribute__((vector_size(64)));
+};
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+
+/// @brief Portable implementation for any FloatVec width N
+///
+/// Relies on compiler vector extensions (gcc/clang) so that the compiler
+/// maps it onto whatever SIMD instructions the target has,
+/// or on plain scalar arrays for other compilers.
+///
+/// Masks follow the SSE convention: all bits set or all bits cleared.
+template <unsigned N>
+struct GenericVectorMath {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "Width must be a power of 2");
+
+#if _VEC_HAS_VECTOR_EXTENSIONS
+  /// @brief "FloatVec" type - actually, this is the data computed at each "tick";
+  /// If using vectorization it will be longer than 1 audio sample
+  typedef typename GenericVectorTypes<N>::FloatVec FloatVec;
+  typedef typename GenericVectorTypes<N>::IntVec IntVec;
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+  struct FloatVec {
+    float& operator[](const unsigned i) { return data_[i]; }
+    const float& operator[](const unsigned i) const { return data_[i]; }
+    float data_[N];
+  };
+  struct IntVec {
+    int& operator[](const unsigned i) { return data_[i]; }
+    const int& operator[](const unsigned i) const { return data_[i]; }
+    int data_[N];
+  };
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+
+  /// @brief Type for FloatVec parameter "read only":
+  /// It should be passed by value since it allows to keep it into a register,
+  /// instead of passing its address and loading it.
+  typedef const FloatVec FloatVecRead;
+
+  /// @brief "FloatVec" type size in bytes
+  static constexpr unsigned int FloatVecSizeBytes = sizeof(FloatVec);
+  /// @brief "FloatVec" type size compared to audio samples
+  static constexpr unsigned int FloatVecSize = N;
+
+  /// @brief Fill a whole FloatVec with the given value
+  ///
+  /// @param[in]  value   Value to be copied through the whole FloatVec
+  static inline FloatVec Fill(const float value) {
+    FloatVec output = FloatVec();
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = value;
+    }
+    return output;
+  }
+
+  /// @brief Fill a whole FloatVec with the given float array
+  ///
+  /// @param[in]  value   Pointer to the float array to be used:
+  ///                     must be FloatVecSizeBytes long
+  static inline FloatVec Fill(BlockIn value) {
+    FloatVec output;
+    std::memcpy(&output, value, sizeof(output));
+    return output;
+  }
+
+  static inline FloatVec FillUnaligned(BlockIn value) {
+    return Fill(value);
+  }
+
+  /// @brief Fill a whole FloatVec with all given scalars, first one first
+  ///
+  /// There must be exactly FloatVecSize of them
+  template <typename... Values,
+            typename std::enable_if<(sizeof...(Values) == N) && (N > 1),
+                                    int>::type = 0>
+  static inline FloatVec Fill(const Values... values) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    const FloatVec output = { static_cast<float>(values)... };
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    const FloatVec output = {{ static_cast<float>(values)... }};
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+    return output;
+  }
+
+  /// @brief Extract one element from a FloatVec (compile-time version)
+  ///
+  /// @param[in]  input   FloatVec to be read
+  template<unsigned i>
+  static float GetByIndex(FloatVecRead input) {
+    static_assert(i < N, "Index out of bounds");
+    return input[i];
+  }
+
+  /// @brief Integer version of the above
+  template<unsigned i>
+  static int GetByIndex(const IntVec input) {
+    static_assert(i < N, "Index out of bounds");
+    return input[i];
+  }
+
+  /// @brief Extract one element from a FloatVec (runtime version, in loops)
+  ///
+  /// @param[in]  input   FloatVec to be read
+  /// @param[in]  i   Index of the element to retrieve
+  static inline float GetByIndex(FloatVecRead input, const unsigned i) {
+    VECMATH_ASSERT(i < FloatVecSize);
+    return input[i];
+  }
+
+  /// @brief Replace one element of a FloatVec (compile-time version)
+  ///
+  /// @param[in]  input   FloatVec to be modified
+  /// @param[in]  value   Value to be inserted at index i
+  template<unsigned i>
+  static FloatVec SetByIndex(FloatVecRead input, const float value) {
+    static_assert(i < N, "Index out of bounds");
+    FloatVec output(input);
+    output[i] = value;
+    return output;
+  }
+
+  /// @brief Add "left" to "right"
+  static inline FloatVec Add(FloatVecRead left, FloatVecRead right) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return left + right;
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    FloatVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = left[i] + right[i];
+    }
+    return output;
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Sum all elements of a FloatVec
+  ///
+  /// Pairwise, in order to match the SIMD implementations summation order
+  static inline float AddHorizontal(FloatVecRead input) {
+    FloatVec sum(input);
+    for (unsigned width(N / 2); width > 0; width /= 2) {
+      for (unsigned i(0); i < width; ++i) {
+        sum[i] += sum[i + width];
+      }
+    }
+    return sum[0];
+  }
+
+  /// @brief Substract "right" from "left"
+  static inline FloatVec Sub(FloatVecRead left, FloatVecRead right) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return left - right;
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    FloatVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = left[i] - right[i];
+    }
+    return output;
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Element-wise multiplication
+  static inline FloatVec Mul(FloatVecRead left, FloatVecRead right) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return left * right;
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    FloatVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = left[i] * right[i];
+    }
+    return output;
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Element-wise division of "left" by "right" (exact)
+  static inline FloatVec Div(FloatVecRead left, FloatVecRead right) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return left / right;
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    FloatVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = left[i] / right[i];
+    }
+    return output;
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Element-wise square root (exact)
+  static inline FloatVec Sqrt(FloatVecRead input) {
+    FloatVec output(input);
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = std::sqrt(input[i]);
+    }
+    return output;
+  }
+
+  /// @brief Element-wise reciprocal 1 / input (exact)
+  static inline FloatVec Reciprocal(FloatVecRead input) {
+    return Div(Fill(1.0f), input);
+  }
+
+  /// @brief Element-wise reciprocal square root 1 / sqrt(input) (exact)
+  static inline FloatVec ReciprocalSqrt(FloatVecRead input) {
+    return Div(Fill(1.0f), Sqrt(input));
+  }
+
+  /// @brief Element-wise approximate reciprocal 1 / input
+  ///
+  /// There is no portable hardware estimate: this is the exact version
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec ReciprocalFast(FloatVecRead input) {
+    static_assert(NewtonSteps <= 2, "At most 2 Newton-Raphson steps");
+    return Reciprocal(input);
+  }
+
+  /// @brief Element-wise approximate reciprocal square root 1 / sqrt(input)
+  ///
+  /// Exact version, see ReciprocalFast
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec ReciprocalSqrtFast(FloatVecRead input) {
+    static_assert(NewtonSteps <= 2, "At most 2 Newton-Raphson steps");
+    return ReciprocalSqrt(input);
+  }
+
+  /// @brief Element-wise approximate square root
+  ///
+  /// Exact version, see ReciprocalFast
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec SqrtFast(FloatVecRead input) {
+    static_assert(NewtonSteps <= 2, "At most 2 Newton-Raphson steps");
+    return Sqrt(input);
+  }
+
+  /// @brief Element-wise approximate division "left" / "right"
+  ///
+  /// Exact version, see ReciprocalFast
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec DivFast(FloatVecRead left, FloatVecRead right) {
+    static_assert(NewtonSteps <= 2, "At most 2 Newton-Raphson steps");
+    return Div(left, right);
+  }
+
+  /// @brief Shift to right all elements of the input by 1,
+  /// and shift in the given value
+  ///
+  /// E.g. given (x_{n}, x_{n + 1}, ..., x_{n + N - 1})
+  /// return (value, x_{n}, ..., x_{n + N - 2})
+  ///
+  /// @param[in]  input   FloatVec to be shifted
+  /// @param[in]  value   value to be shifted in
+  static inline FloatVec RotateOnRight(FloatVecRead input, const float value) {
+    FloatVec output(input);
+    output[0] = value;
+    for (unsigned i(1); i < N; ++i) {
+      output[i] = input[i - 1];
+    }
+    return output;
+  }
+
+  /// @brief Shift to left all elements of the input by 1,
+  /// and shift in the given value
+  ///
+  /// E.g. given (x_{n}, x_{n + 1}, ..., x_{n + N - 1})
+  /// return (x_{n + 1}, ..., x_{n + N - 1}, value)
+  ///
+  /// @param[in]  input   FloatVec to be shifted
+  /// @param[in]  value   value to be shifted in
+  static inline FloatVec RotateOnLeft(FloatVecRead input, const float value) {
+    FloatVec output(input);
+    for (unsigned i(0); i < N - 1; ++i) {
+      output[i] = input[i + 1];
+    }
+    output[N - 1] = value;
+    return output;
+  }
+
+  /// @brief Shift to right all elements of the input by Count,
+  /// and shift in the given value
+  ///
+  /// E.g. with Count = 2, given (x0, x1, ..., x{N-1})
+  /// return (value, value, x0, ..., x{N-3})
+  ///
+  /// @param[in]  input   FloatVec to be shifted
+  /// @param[in]  value   value to be shifted in
+  template <unsigned Count>
+  static inline FloatVec ShiftOnRight(FloatVecRead input, const float value) {
+    static_assert(Count > 0 && Count < N, "Invalid shift");
+    FloatVec output(input);
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = i < Count ? value : input[i - Count];
+    }
+    return output;
+  }
+
+  /// @brief Return the sign of each element of the FloatVec
+  ///
+  /// Sgn(0.0) return 0.0
+  static inline FloatVec Sgn(FloatVecRead input) {
+    const FloatVec kZero(Fill(0.0f));
+    return Sub(ExtractValueFromMask(Fill(1.0f), GreaterThan(input, kZero)),
+               ExtractValueFromMask(Fill(1.0f), LessThan(input, kZero)));
+  }
+
+  /// @brief Return the sign of each element of the FloatVec, no zero version
+  ///
+  /// Sgn(0.0) return 1.0f
+  static inline FloatVec SgnNoZero(FloatVecRead input) {
+    return Select(GreaterEqual(input, Fill(0.0f)), Fill(1.0f), Fill(-1.0f));
+  }
+
+  /// @brief Store the given FloatVec into memory
+  ///
+  /// @param[in]  buffer   Memory to be filled with the input
+  /// @param[in]  input   FloatVec to be stored
+  static inline void Store(float* const buffer, FloatVecRead input) {
+    std::memcpy(buffer, &input, sizeof(input));
+  }
+
+  static inline void StoreUnaligned(float* const buffer, FloatVecRead input) {
+    Store(buffer, input);
+  }
+
+  /// @brief Get each left half of the two given vectors
+  ///
+  /// Given left = (x0, ..., x{N-1}) and right = (y0, ..., y{N-1})
+  /// it will return (x0, ..., x{N/2-1}, y0, ..., y{N/2-1})
+  static inline FloatVec TakeEachLeftHalf(FloatVecRead left,
+                                          FloatVecRead right) {
+    FloatVec output(left);
+    for (unsigned i(0); i < N / 2; ++i) {
+      output[i + N / 2] = right[i];
+    }
+    return output;
+  }
+
+  /// @brief Get each right half of the two given vectors
+  ///
+  /// Given left = (x0, ..., x{N-1}) and right = (y0, ..., y{N-1})
+  /// it will return (x{N/2}, ..., x{N-1}, y{N/2}, ..., y{N-1})
+  static inline FloatVec TakeEachRightHalf(FloatVecRead left,
+                                           FloatVecRead right) {
+    FloatVec output(left);
+    for (unsigned i(0); i < N / 2; ++i) {
+      output[i] = left[i + N / 2];
+      output[i + N / 2] = right[i + N / 2];
+    }
+    return output;
+  }
+
+  /// @brief Revert the given vector values order
+  ///
+  /// Given value = (x0, ..., x{N-1})
+  /// it will return (x{N-1}, ..., x0)
+  static inline FloatVec Revert(FloatVecRead input) {
+    FloatVec output(input);
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = input[N - 1 - i];
+    }
+    return output;
+  }
+
+  /// @brief Element-wise multiply-add: left * right + addend
+  static inline FloatVec MulAdd(FloatVecRead left,
+                                FloatVecRead right,
+                                FloatVecRead addend) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return left * right + addend;
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    FloatVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = left[i] * right[i] + addend[i];
+    }
+    return output;
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Alternatively substract and add "right" to "left"
+  ///
+  /// Given left = (x0, x1, ...) and right = (y0, y1, ...)
+  /// it will return (x0 - y0, x1 + y1, ...)
+  static inline FloatVec AddSub(FloatVecRead left, FloatVecRead right) {
+    FloatVec output(left);
+    for (unsigned i(0); i < N; i += 2) {
+      output[i] = left[i] - right[i];
+      output[i + 1] = left[i + 1] + right[i + 1];
+    }
+    return output;
+  }
+
+  /// @brief Duplicate each even element
+  ///
+  /// Given value = (x0, x1, x2, x3, ...)
+  /// it will return (x0, x0, x2, x2, ...)
+  static inline FloatVec DuplicateEven(FloatVecRead value) {
+    FloatVec output(value);
+    for (unsigned i(0); i < N; i += 2) {
+      output[i + 1] = value[i];
+    }
+    return output;
+  }
+
+  /// @brief Duplicate each odd element
+  ///
+  /// Given value = (x0, x1, x2, x3, ...)
+  /// it will return (x1, x1, x3, x3, ...)
+  static inline FloatVec DuplicateOdd(FloatVecRead value) {
+    FloatVec output(value);
+    for (unsigned i(0); i < N; i += 2) {
+      output[i] = value[i + 1];
+    }
+    return output;
+  }
+
+  /// @brief Swap elements of each pair
+  ///
+  /// Given value = (x0, x1, x2, x3, ...)
+  /// it will return (x1, x0, x3, x2, ...)
+  static inline FloatVec SwapPairs(FloatVecRead value) {
+    FloatVec output(value);
+    for (unsigned i(0); i < N; i += 2) {
+      output[i] = value[i + 1];
+      output[i + 1] = value[i];
+    }
+    return output;
+  }
+
+  /// @brief Interleave the low halves of the two given vectors
+  ///
+  /// Given left = (x0, ..., x{N-1}) and right = (y0, ..., y{N-1})
+  /// it will return (x0, y0, ..., x{N/2-1}, y{N/2-1})
+  static inline FloatVec InterleaveLow(FloatVecRead left, FloatVecRead right) {
+    FloatVec output(left);
+    for (unsigned i(0); i < N / 2; ++i) {
+      output[2 * i] = left[i];
+      output[2 * i + 1] = right[i];
+    }
+    return output;
+  }
+
+  /// @brief Interleave the high halves of the two given vectors
+  ///
+  /// Given left = (x0, ..., x{N-1}) and right = (y0, ..., y{N-1})
+  /// it will return (x{N/2}, y{N/2}, ..., x{N-1}, y{N-1})
+  static inline FloatVec InterleaveHigh(FloatVecRead left, FloatVecRead right) {
+    FloatVec output(left);
+    for (unsigned i(0); i < N / 2; ++i) {
+      output[2 * i] = left[i + N / 2];
+      output[2 * i + 1] = right[i + N / 2];
+    }
+    return output;
+  }
+
+  /// @brief Gather even elements of the two given vectors
+  ///
+  /// Given left = (x0, ..., x{N-1}) and right = (y0, ..., y{N-1})
+  /// it will return (x0, x2, ..., x{N-2}, y0, y2, ..., y{N-2})
+  static inline FloatVec DeinterleaveEven(FloatVecRead left,
+                                          FloatVecRead right) {
+    FloatVec output(left);
+    for (unsigned i(0); i < N / 2; ++i) {
+      output[i] = left[2 * i];
+      output[i + N / 2] = right[2 * i];
+    }
+    return output;
+  }
+
+  /// @brief Gather odd elements of the two given vectors
+  ///
+  /// Given left = (x0, ..., x{N-1}) and right = (y0, ..., y{N-1})
+  /// it will return (x1, x3, ..., x{N-1}, y1, y3, ..., y{N-1})
+  static inline FloatVec DeinterleaveOdd(FloatVecRead left,
+                                         FloatVecRead right) {
+    FloatVec output(left);
+    for (unsigned i(0); i < N / 2; ++i) {
+      output[i] = left[2 * i + 1];
+      output[i + N / 2] = right[2 * i + 1];
+    }
+    return output;
+  }
+
+  /// @brief Return each min element of both inputs
+  static inline FloatVec Min(FloatVecRead left, FloatVecRead right) {
+    return Select(LessThan(left, right), left, right);
+  }
+
+  /// @brief Return each max element of both inputs
+  static inline FloatVec Max(FloatVecRead left, FloatVecRead right) {
+    return Select(GreaterThan(left, right), left, right);
+  }
+
+  /// @brief Round each FloatVec element to the nearest integer
+  /// (halfway cases rounded to even, as in the default rounding mode)
+  static inline FloatVec Round(FloatVecRead input) {
+    FloatVec output(input);
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = std::nearbyint(input[i]);
+    }
+    return output;
+  }
+
+  /// @brief Round each FloatVec element toward zero
+  static inline FloatVec Trunc(FloatVecRead input) {
+    FloatVec output(input);
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = std::trunc(input[i]);
+    }
+    return output;
+  }
+
+  /// @brief Round each FloatVec element toward negative infinity
+  static inline FloatVec Floor(FloatVecRead input) {
+    FloatVec output(input);
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = std::floor(input[i]);
+    }
+    return output;
+  }
+
+  /// @brief Round each FloatVec element toward positive infinity
+  static inline FloatVec Ceil(FloatVecRead input) {
+    FloatVec output(input);
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = std::ceil(input[i]);
+    }
+    return output;
+  }
+
+  /// @brief Helper function: increment the input and wraps it into [-1.0 ; 1.0[
+  ///
+  /// @param[in]  input         Input to be wrapped - supposed not to be < 1.0
+  /// @param[in]  increment     Increment to add to the input
+  /// @return the incremented output in [-1.0 ; 1.0[
+  static inline FloatVec IncrementAndWrap(FloatVecRead input,
+                                          FloatVecRead increment) {
+    const FloatVec output(Add(input, increment));
+    const FloatVec addition_mask(GreaterThan(output, Fill(1.0f)));
+    return Add(output, ExtractValueFromMask(Fill(-2.0f), addition_mask));
+  }
+
+  /// @brief Helper binary function: return true if all input elements are true
+  ///
+  /// @param[in]  input   Input to be checked
+  static inline bool IsMaskFull(FloatVecRead input) {
+    const IntVec bits(AsBits(input));
+    for (unsigned i(0); i < N; ++i) {
+      if (bits[i] >= 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// @brief Helper binary function: return true if all input elements are null
+  ///
+  /// @param[in]  input   Input to be checked
+  static inline bool IsMaskNull(FloatVecRead input) {
+    const IntVec bits(AsBits(input));
+    for (unsigned i(0); i < N; ++i) {
+      if (bits[i] < 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static inline FloatVec GreaterEqual(FloatVecRead threshold, FloatVecRead input) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return AsFloats((IntVec)(threshold >= input));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = threshold[i] >= input[i] ? -1 : 0;
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  static inline FloatVec GreaterThan(FloatVecRead threshold, FloatVecRead input) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return AsFloats((IntVec)(threshold > input));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = threshold[i] > input[i] ? -1 : 0;
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Helper binary function:
+  /// true if each threshold element is >= than the input element
+  static inline bool GreaterEqual(float threshold, FloatVecRead input) {
+    return IsMaskFull(GreaterEqual(Fill(threshold), input));
+  }
+
+  static inline bool GreaterEqualAny(float threshold, FloatVecRead input) {
+    return !IsMaskNull(GreaterEqual(Fill(threshold), input));
+  }
+
+  static inline bool GreaterThan(float threshold, FloatVecRead input) {
+    return IsMaskFull(GreaterThan(Fill(threshold), input));
+  }
+
+  static inline FloatVec LessEqual(FloatVecRead threshold, FloatVecRead input) {
+    return GreaterEqual(input, threshold);
+  }
+
+  static inline FloatVec LessThan(FloatVecRead threshold, FloatVecRead input) {
+    return GreaterThan(input, threshold);
+  }
+
+  /// @brief Helper binary function:
+  /// true if each threshold element is <= than the input element
+  static inline bool LessEqual(float threshold, FloatVecRead input) {
+    return IsMaskFull(LessEqual(Fill(threshold), input));
+  }
+
+  static inline bool LessThan(float threshold, FloatVecRead input) {
+    return IsMaskFull(LessThan(Fill(threshold), input));
+  }
+
+  static inline FloatVec Equal(FloatVecRead threshold, FloatVecRead input) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return AsFloats((IntVec)(threshold == input));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = threshold[i] == input[i] ? -1 : 0;
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  static inline bool Equal(float threshold, FloatVecRead input) {
+    return IsMaskFull(Equal(Fill(threshold), input));
+  }
+
+  /// @brief Beware, not an actual bitwise AND! More like a "float select"
+  static inline FloatVec ExtractValueFromMask(FloatVecRead value, FloatVecRead mask) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return AsFloats(AsBits(value) & AsBits(mask));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    const IntVec value_bits(AsBits(value));
+    const IntVec mask_bits(AsBits(mask));
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = value_bits[i] & mask_bits[i];
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Element-wise select: "if_true" where the mask is set,
+  /// "if_false" elsewhere
+  static inline FloatVec Select(FloatVecRead mask,
+                                FloatVecRead if_true,
+                                FloatVecRead if_false) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    const IntVec mask_bits(AsBits(mask));
+    return AsFloats((AsBits(if_true) & mask_bits)
+                    | (AsBits(if_false) & ~mask_bits));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    const IntVec mask_bits(AsBits(mask));
+    const IntVec true_bits(AsBits(if_true));
+    const IntVec false_bits(AsBits(if_false));
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = (true_bits[i] & mask_bits[i])
+                  | (false_bits[i] & ~mask_bits[i]);
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Element-wise mask AND
+  static inline FloatVec And(FloatVecRead left, FloatVecRead right) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return AsFloats(AsBits(left) & AsBits(right));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    const IntVec left_bits(AsBits(left));
+    const IntVec right_bits(AsBits(right));
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = left_bits[i] & right_bits[i];
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Element-wise mask "left AND NOT right"
+  static inline FloatVec AndNot(FloatVecRead left, FloatVecRead right) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return AsFloats(AsBits(left) & ~AsBits(right));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    const IntVec left_bits(AsBits(left));
+    const IntVec right_bits(AsBits(right));
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = left_bits[i] & ~right_bits[i];
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Element-wise mask OR
+  static inline FloatVec Or(FloatVecRead left, FloatVecRead right) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return AsFloats(AsBits(left) | AsBits(right));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    const IntVec left_bits(AsBits(left));
+    const IntVec right_bits(AsBits(right));
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = left_bits[i] | right_bits[i];
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Element-wise mask XOR
+  static inline FloatVec Xor(FloatVecRead left, FloatVecRead right) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return AsFloats(AsBits(left) ^ AsBits(right));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    const IntVec left_bits(AsBits(left));
+    const IntVec right_bits(AsBits(right));
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = left_bits[i] ^ right_bits[i];
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Element-wise mask NOT
+  static inline FloatVec Not(FloatVecRead mask) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return AsFloats(~AsBits(mask));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    const IntVec mask_bits(AsBits(mask));
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = ~mask_bits[i];
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Compile-time select: take the element from "right" where the
+  /// matching bit of Mask is set, from "left" elsewhere
+  template <unsigned int Mask>
+  static inline FloatVec Blend(FloatVecRead left, FloatVecRead right) {
+    static_assert(Mask < (1u << N), "Invalid blend mask");
+    FloatVec output(left);
+    for (unsigned i(0); i < N; ++i) {
+      if ((Mask >> i) & 1) {
+        output[i] = right[i];
+      }
+    }
+    return output;
+  }
+
+  /// @brief Pack the mask into an integer, bit i being set if element i is
+  /// set (sign bit of its integer bits, as movmskps)
+  static inline unsigned int MoveMask(FloatVecRead mask) {
+    const IntVec mask_bits(AsBits(mask));
+    unsigned int bits(0);
+    for (unsigned i(0); i < N; ++i) {
+      bits |= (mask_bits[i] < 0 ? 1u : 0u) << i;
+    }
+    return bits;
+  }
+
+  /// @brief Left-pack: store contiguously the elements of "values" where the
+  /// mask is set, return their count
+  ///
+  /// Beware, up to FloatVecSize elements may be written: only the first
+  /// returned count are meaningful. The output does not need to be aligned.
+  static inline unsigned int CompressStore(float* const output,
+                                           FloatVecRead mask,
+                                           FloatVecRead values) {
+    const IntVec mask_bits(AsBits(mask));
+    unsigned int index(0);
+    for (unsigned i(0); i < N; ++i) {
+      output[index] = values[i];
+      index += mask_bits[i] < 0 ? 1 : 0;
+    }
+    return index;
+  }
+
+  /// @brief Element-wise mask: set where the element is infinite or NaN
+  ///
+  /// Computed on the bits (exponent all ones): still valid with finite maths
+  /// compiler flags
+  static inline FloatVec IsNonFinite(FloatVecRead input) {
+    const IntVec bits(AsBits(input));
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return AsFloats((IntVec)((bits & 0x7f800000) == 0x7f800000));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = (bits[i] & 0x7f800000) == 0x7f800000 ? -1 : 0;
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Element-wise mask: set where the element is denormal
+  ///
+  /// Computed on the bits (null exponent, non-null mantissa): still valid
+  /// when denormals are treated as zero by arithmetic instructions
+  static inline FloatVec IsDenormal(FloatVecRead input) {
+    const IntVec bits(AsBits(input));
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return AsFloats((IntVec)((bits & 0x7f800000) == 0)
+                    & (IntVec)((bits & 0x7fffffff) != 0));
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = (bits[i] & 0x7f800000) == 0 && (bits[i] & 0x7fffffff) != 0
+                  ? -1 : 0;
+    }
+    return AsFloats(output);
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+  /// @brief Fill a whole FloatVec from FloatVecSize half precision values,
+  /// not necessarily aligned
+  static inline FloatVec FillFloat16(const Float16* const buffer) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output[i] = HalfConversion::ToFloat(buffer[i]);
+    }
+    return output;
+  }
+
+  /// @brief Store a whole FloatVec as half precision values (rounded to
+  /// nearest even), not necessarily aligned
+  static inline void StoreFloat16(Float16* const buffer, FloatVecRead input) {
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      buffer[i] = HalfConversion::ToFloat16(input[i]);
+    }
+  }
+
+  /// @brief Fill a whole FloatVec from FloatVecSize bfloat16 values,
+  /// not necessarily aligned
+  static inline FloatVec FillBFloat16(const BFloat16* const buffer) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output[i] = HalfConversion::ToFloat(buffer[i]);
+    }
+    return output;
+  }
+
+  /// @brief Store a whole FloatVec as bfloat16 values (rounded to nearest
+  /// even), not necessarily aligned
+  static inline void StoreBFloat16(BFloat16* const buffer, FloatVecRead input) {
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      buffer[i] = HalfConversion::ToBFloat16(input[i]);
+    }
+  }
+
+  /// @brief Element-wise unbiased exponent of normal numbers, as floats
+  /// (floor(log2(|input|)))
+  static inline FloatVec Exponent(FloatVecRead input) {
+    const IntVec bits(AsBits(input));
+    FloatVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = static_cast<float>(((bits[i] >> 23) & 0xff) - 127);
+    }
+    return output;
+  }
+
+  /// @brief Element-wise mantissa of normal numbers, within [1 ; 2[
+  /// (sign dropped)
+  static inline FloatVec Mantissa(FloatVecRead input) {
+    IntVec bits(AsBits(input));
+    for (unsigned i(0); i < N; ++i) {
+      bits[i] = (bits[i] & 0x007fffff) | 0x3f800000;
+    }
+    return AsFloats(bits);
+  }
+
+  /// @brief Element-wise 2^exponent, exponents being integers
+  /// within [-126 ; 127]
+  static inline FloatVec PowerOfTwo(FloatVecRead exponent) {
+    IntVec bits;
+    for (unsigned i(0); i < N; ++i) {
+      bits[i] = (static_cast<int>(exponent[i]) + 127) << 23;
+    }
+    return AsFloats(bits);
+  }
+
+  static inline IntVec TruncToInt(FloatVecRead float_value) {
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = static_cast<int>(float_value[i]);
+    }
+    return output;
+  }
+
+  /// @brief Element-wise integer to float conversion
+  static inline FloatVec IntToFloat(const IntVec input) {
+    FloatVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = static_cast<float>(input[i]);
+    }
+    return output;
+  }
+
+  /// @brief Fill a whole IntVec from an aligned buffer
+  static inline IntVec FillInt(const int* const buffer) {
+    IntVec output;
+    std::memcpy(&output, buffer, sizeof(output));
+    return output;
+  }
+
+  /// @brief Store a whole IntVec into an aligned buffer
+  static inline void StoreInt(int* const buffer, const IntVec input) {
+    std::memcpy(buffer, &input, sizeof(input));
+  }
+
+  /// @brief Element-wise count update: one added where the mask is set
+  ///
+  /// Set mask elements are -1 as integers: no conversion required
+  static inline IntVec CountMask(const IntVec counts, FloatVecRead mask) {
+#if _VEC_HAS_VECTOR_EXTENSIONS
+    return counts - AsBits(mask);
+#else  // _VEC_HAS_VECTOR_EXTENSIONS
+    const IntVec bits(AsBits(mask));
+    IntVec output;
+    for (unsigned i(0); i < N; ++i) {
+      output[i] = counts[i] - bits[i];
+    }
+    return output;
+#endif  // _VEC_HAS_VECTOR_EXTENSIONS
+  }
+
+ private:
+  /// @brief Reinterpret FloatVec bits as an IntVec
+  static inline IntVec AsBits(FloatVecRead input) {
+    IntVec output;
+    std::memcpy(&output, &input, sizeof(output));
+    return output;
+  }
+
+  /// @brief Reinterpret IntVec bits as a FloatVec
+  static inline FloatVec AsFloats(const IntVec input) {
+    FloatVec output;
+    std::memcpy(&output, &input, sizeof(output));
+    return output;
+  }
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_PLATFORM_IMPLEM_GENERIC_H_
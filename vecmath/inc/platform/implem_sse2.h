@@ -25,12 +25,16 @@
 #include <math.h>
 
 #include "vecmath/inc/common.h"
+#include "vecmath/inc/half.h"
 
 #if _VEC_USE_SSE
 
 extern "C" {
 #include <emmintrin.h>
 #include <mmintrin.h>
+#if defined(__FMA__) || defined(__AVX512VL__) || defined(__F16C__)
+#include <immintrin.h>
+#endif  // defined(__FMA__) || defined(__AVX512VL__) || defined(__F16C__)
 }
 
 namespace vecmath {
@@ -66,6 +70,15 @@ struct SSE2VectorMath {
     return _mm_load_ps(value);
   }
 
+  /// @brief Fill a whole FloatVec with the given float array,
+  /// not necessarily aligned
+  ///
+  /// @param[in]  value   Pointer to the float array to be used:
+  ///                     must be FloatVecSizeBytes long
+  static inline FloatVec FillUnaligned(const float* value) {
+    return _mm_loadu_ps(value);
+  }
+
   /// @brief Fill a whole FloatVec with all given scalars,
   /// beware of the order: SSE is "little-endian" (sort of)
   ///
@@ -93,21 +106,21 @@ struct SSE2VectorMath {
 
   /// @brief Extract one element from a FloatVec (compile-time version)
   ///
+  /// The element is shuffled into the lowest lane, so that it never goes
+  /// through memory
+  ///
   /// @param[in]  input   FloatVec to be read
-  // TODO(gm): faster _mm_store_ss specialization
   template<unsigned i>
   static float GetByIndex(FloatVecRead input) {
-    ConverterFloatScalarVector converter;
-    converter.sample_v = input;
-    return converter.sample[i];
+    static_assert(i < FloatVecSize, "Index out of bounds");
+    return _mm_cvtss_f32(_mm_shuffle_ps(input, input, _MM_SHUFFLE(i, i, i, i)));
   }
 
   /// @brief Integer version of the above
   template<unsigned i>
   static int GetByIndex(IntVec input) {
-    ConverterIntScalarVector converter;
-    converter.sample_v = input;
-    return converter.sample[i];
+    static_assert(i < FloatVecSize, "Index out of bounds");
+    return _mm_cvtsi128_si32(_mm_shuffle_epi32(input, _MM_SHUFFLE(i, i, i, i)));
   }
 
   /// @brief Extract one element from a FloatVec (runtime version, in loops)
@@ -121,6 +134,20 @@ struct SSE2VectorMath {
     return converter.sample[i];
   }
 
+  /// @brief Replace one element of a FloatVec (compile-time version)
+  ///
+  /// @param[in]  input   FloatVec to be modified
+  /// @param[in]  value   Value to be inserted at index i
+  template<unsigned i>
+  static FloatVec SetByIndex(FloatVecRead input, const float value) {
+    static_assert(i < FloatVecSize, "Index out of bounds");
+    const FloatVec lane_mask(_mm_castsi128_ps(_mm_set_epi32(i == 3 ? -1 : 0,
+                                                            i == 2 ? -1 : 0,
+                                                            i == 1 ? -1 : 0,
+                                                            i == 0 ? -1 : 0)));
+    return Select(lane_mask, Fill(value), input);
+  }
+
   /// @brief Add "left" to "right"
   static inline FloatVec Add(FloatVecRead left, FloatVecRead right) {
     return _mm_add_ps(left, right);
@@ -144,6 +171,100 @@ struct SSE2VectorMath {
     return _mm_mul_ps(left, right);
   }
 
+  /// @brief Element-wise division of "left" by "right" (exact)
+  ///
+  /// Fast math compiler flags would turn the division into a reciprocal
+  /// estimate refined by a Newton step (~3 ulps): it is then issued as is
+  static inline FloatVec Div(FloatVecRead left, FloatVecRead right) {
+#if defined(__GNUC__) && defined(__FAST_MATH__)
+    FloatVec output(left);
+#if defined(__AVX__)
+    __asm__("vdivps %2, %1, %0" : "=x"(output) : "x"(left), "x"(right));
+#else  // defined(__AVX__)
+    __asm__("divps %1, %0" : "+x"(output) : "x"(right));
+#endif  // defined(__AVX__)
+    return output;
+#else  // defined(__GNUC__) && defined(__FAST_MATH__)
+    return _mm_div_ps(left, right);
+#endif  // defined(__GNUC__) && defined(__FAST_MATH__)
+  }
+
+  /// @brief Element-wise square root (exact)
+  static inline FloatVec Sqrt(FloatVecRead input) {
+    return _mm_sqrt_ps(input);
+  }
+
+  /// @brief Element-wise reciprocal 1 / input (exact)
+  static inline FloatVec Reciprocal(FloatVecRead input) {
+    return Div(Fill(1.0f), input);
+  }
+
+  /// @brief Element-wise reciprocal square root 1 / sqrt(input) (exact)
+  static inline FloatVec ReciprocalSqrt(FloatVecRead input) {
+    return Div(Fill(1.0f), Sqrt(input));
+  }
+
+  /// @brief Element-wise approximate reciprocal 1 / input
+  ///
+  /// Hardware estimate refined by NewtonSteps Newton-Raphson iterations.
+  /// Maximum relative error, for normal inputs:
+  /// - 0 step: 1.5 * 2^-12 (~3.7e-4)
+  /// - 1 step: ~2e-7 (3.2 ulps, as measured by vecmath_accuracy)
+  /// - 2 steps: ~1.5e-7
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec ReciprocalFast(FloatVecRead input) {
+    static_assert(NewtonSteps <= 2, "At most 2 Newton-Raphson steps");
+    FloatVec estimate(_mm_rcp_ps(input));
+    for (unsigned i(0); i < NewtonSteps; ++i) {
+      // x1 = x0 * (2 - a * x0)
+      estimate = Mul(estimate, Sub(Fill(2.0f), Mul(input, estimate)));
+    }
+    return estimate;
+  }
+
+  /// @brief Element-wise approximate reciprocal square root 1 / sqrt(input)
+  ///
+  /// Hardware estimate refined by NewtonSteps Newton-Raphson iterations.
+  /// Maximum relative error, for normal positive inputs:
+  /// - 0 step: 1.5 * 2^-12 (~3.7e-4)
+  /// - 1 step: ~3e-7
+  /// - 2 steps: ~1.5e-7
+  /// Refined results are only valid for inputs below 2^125: above it the
+  /// squared estimate may underflow if operations get reassociated (-Ofast)
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec ReciprocalSqrtFast(FloatVecRead input) {
+    static_assert(NewtonSteps <= 2, "At most 2 Newton-Raphson steps");
+    FloatVec estimate(_mm_rsqrt_ps(input));
+    for (unsigned i(0); i < NewtonSteps; ++i) {
+      // y1 = 0.5 * y0 * (3 - a * y0 * y0)
+      const FloatVec squared(Mul(Mul(input, estimate), estimate));
+      estimate = Mul(Mul(Fill(0.5f), estimate), Sub(Fill(3.0f), squared));
+    }
+    return estimate;
+  }
+
+  /// @brief Element-wise approximate square root, computed as
+  /// input * ReciprocalSqrtFast(input) - Sqrt(0.0) returns 0.0
+  ///
+  /// Maximum relative error is the one of ReciprocalSqrtFast,
+  /// for inputs within [2^-125 ; 2^125]
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec SqrtFast(FloatVecRead input) {
+    const FloatVec non_zero_mask(_mm_cmpneq_ps(input, _mm_setzero_ps()));
+    // Prevents 0 * inf from yielding a NaN
+    return _mm_and_ps(Mul(input, ReciprocalSqrtFast<NewtonSteps>(input)),
+                      non_zero_mask);
+  }
+
+  /// @brief Element-wise approximate division "left" / "right", computed as
+  /// left * ReciprocalFast(right)
+  ///
+  /// Maximum relative error is the one of ReciprocalFast, plus 0.5 ulp
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec DivFast(FloatVecRead left, FloatVecRead right) {
+    return Mul(left, ReciprocalFast<NewtonSteps>(right));
+  }
+
   /// @brief Shift to right all elements of the input by 1,
   /// and shift in the given value
   ///
@@ -176,6 +297,24 @@ struct SSE2VectorMath {
     return Add(Fill(0.0f, 0.0f, 0.0f, value), rotated);
   }
 
+  /// @brief Shift to right all elements of the input by Count,
+  /// and shift in the given value
+  ///
+  /// E.g. with Count = 2, given (x0, x1, x2, x3)
+  /// return (value, value, x0, x1)
+  ///
+  /// @param[in]  input   FloatVec to be shifted
+  /// @param[in]  value   value to be shifted in
+  template <unsigned Count>
+  static inline FloatVec ShiftOnRight(FloatVecRead input, const float value) {
+    static_assert(Count > 0 && Count < FloatVecSize, "Invalid shift");
+    const __m128i shifted(_mm_slli_si128(_mm_castps_si128(input), 4 * Count));
+    // "value" in the first Count elements, zeros elsewhere
+    const __m128i filled(_mm_srli_si128(_mm_castps_si128(Fill(value)),
+                                        4 * (FloatVecSize - Count)));
+    return _mm_castsi128_ps(_mm_or_si128(shifted, filled));
+  }
+
   /// @brief Return the sign of each element of the FloatVec
   ///
   /// Sgn(0.0) return 0.0
@@ -212,6 +351,15 @@ struct SSE2VectorMath {
     _mm_storeu_ps(buffer, input);
   }
 
+  /// @brief Get each left half of the two given vectors
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x0, x1, y0, y1)
+  static inline FloatVec TakeEachLeftHalf(FloatVecRead left,
+                                          FloatVecRead right) {
+    return _mm_movelh_ps(left, right);
+  }
+
   /// @brief Get each right half of the two given vectors
   ///
   /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
@@ -230,6 +378,87 @@ struct SSE2VectorMath {
     return _mm_shuffle_ps(value, value, _MM_SHUFFLE(0, 1, 2, 3));
   }
 
+  /// @brief Element-wise multiply-add: left * right + addend
+  ///
+  /// Fused (single rounding) when compiled with FMA support
+  static inline FloatVec MulAdd(FloatVecRead left,
+                                FloatVecRead right,
+                                FloatVecRead addend) {
+#if defined(__FMA__)
+    return _mm_fmadd_ps(left, right, addend);
+#else  // defined(__FMA__)
+    return Add(Mul(left, right), addend);
+#endif  // defined(__FMA__)
+  }
+
+  /// @brief Alternatively substract and add "right" to "left"
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x0 - y0, x1 + y1, x2 - y2, x3 + y3)
+  static inline FloatVec AddSub(FloatVecRead left, FloatVecRead right) {
+    const FloatVec even_signs(_mm_castsi128_ps(
+      _mm_set_epi32(0, 0x80000000, 0, 0x80000000)));
+    return Add(left, _mm_xor_ps(right, even_signs));
+  }
+
+  /// @brief Duplicate each even element
+  ///
+  /// Given value = (x0, x1, x2, x3)
+  /// it will return (x0, x0, x2, x2)
+  static inline FloatVec DuplicateEven(FloatVecRead value) {
+    return _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 2, 0, 0));
+  }
+
+  /// @brief Duplicate each odd element
+  ///
+  /// Given value = (x0, x1, x2, x3)
+  /// it will return (x1, x1, x3, x3)
+  static inline FloatVec DuplicateOdd(FloatVecRead value) {
+    return _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 1, 1));
+  }
+
+  /// @brief Swap elements of each pair
+  ///
+  /// Given value = (x0, x1, x2, x3)
+  /// it will return (x1, x0, x3, x2)
+  static inline FloatVec SwapPairs(FloatVecRead value) {
+    return _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1));
+  }
+
+  /// @brief Interleave the low halves of the two given vectors
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x0, y0, x1, y1)
+  static inline FloatVec InterleaveLow(FloatVecRead left, FloatVecRead right) {
+    return _mm_unpacklo_ps(left, right);
+  }
+
+  /// @brief Interleave the high halves of the two given vectors
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x2, y2, x3, y3)
+  static inline FloatVec InterleaveHigh(FloatVecRead left, FloatVecRead right) {
+    return _mm_unpackhi_ps(left, right);
+  }
+
+  /// @brief Gather even elements of the two given vectors
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x0, x2, y0, y2)
+  static inline FloatVec DeinterleaveEven(FloatVecRead left,
+                                          FloatVecRead right) {
+    return _mm_shuffle_ps(left, right, _MM_SHUFFLE(2, 0, 2, 0));
+  }
+
+  /// @brief Gather odd elements of the two given vectors
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x1, x3, y1, y3)
+  static inline FloatVec DeinterleaveOdd(FloatVecRead left,
+                                         FloatVecRead right) {
+    return _mm_shuffle_ps(left, right, _MM_SHUFFLE(3, 1, 3, 1));
+  }
+
   /// @brief Return each min element of both inputs
   static inline FloatVec Min(FloatVecRead left, FloatVecRead right) {
     return _mm_min_ps(left, right);
@@ -245,18 +474,32 @@ struct SSE2VectorMath {
   }
 
   /// @brief Round each FloatVec element to the nearest integer
+  /// (halfway cases rounded to even, as in the default rounding mode)
   static inline FloatVec Round(FloatVecRead input) {
-#if (_VEC_USE_SSE)
-    const FloatVec kZero(_mm_setzero_ps());
-    const FloatVec kPlus(Fill(0.5f));
-    const FloatVec kMinus(Fill(-0.5f));
-    const FloatVec kPlusMask(_mm_and_ps(_mm_cmpge_ps(input, kZero), kPlus));
-    const FloatVec kMinusMask(_mm_and_ps(_mm_cmplt_ps(input, kZero), kMinus));
-    const FloatVec kAddMask(Add(kPlusMask, kMinusMask));
-    return Add(kAddMask, input);
-#else
-    return (input > 0.0f) ? (input + 0.5f) : (input - 0.5f);
-#endif  // (_VEC_USE_SSE)
+    const FloatVec rounded(_mm_cvtepi32_ps(_mm_cvtps_epi32(input)));
+    return RestoreIntegral(input, rounded);
+  }
+
+  /// @brief Round each FloatVec element toward zero
+  static inline FloatVec Trunc(FloatVecRead input) {
+    const FloatVec truncated(_mm_cvtepi32_ps(_mm_cvttps_epi32(input)));
+    return RestoreIntegral(input, truncated);
+  }
+
+  /// @brief Round each FloatVec element toward negative infinity
+  static inline FloatVec Floor(FloatVecRead input) {
+    const FloatVec truncated(Trunc(input));
+    const FloatVec correction(_mm_and_ps(_mm_cmpgt_ps(truncated, input),
+                                         Fill(1.0f)));
+    return Sub(truncated, correction);
+  }
+
+  /// @brief Round each FloatVec element toward positive infinity
+  static inline FloatVec Ceil(FloatVecRead input) {
+    const FloatVec truncated(Trunc(input));
+    const FloatVec correction(_mm_and_ps(_mm_cmplt_ps(truncated, input),
+                                         Fill(1.0f)));
+    return Add(truncated, correction);
   }
 
   /// @brief Helper function: increment the input and wraps it into [-1.0 ; 1.0[
@@ -356,9 +599,303 @@ struct SSE2VectorMath {
     return _mm_and_ps(value, mask);
   }
 
+  /// @brief Element-wise select: "if_true" where the mask is set,
+  /// "if_false" elsewhere
+  static inline FloatVec Select(FloatVecRead mask,
+                                FloatVecRead if_true,
+                                FloatVecRead if_false) {
+    return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+  }
+
+  /// @brief Element-wise mask AND
+  static inline FloatVec And(FloatVecRead left, FloatVecRead right) {
+    return _mm_and_ps(left, right);
+  }
+
+  /// @brief Element-wise mask "left AND NOT right"
+  ///
+  /// Beware, the operands order differs from _mm_andnot_ps!
+  static inline FloatVec AndNot(FloatVecRead left, FloatVecRead right) {
+    return _mm_andnot_ps(right, left);
+  }
+
+  /// @brief Element-wise mask OR
+  static inline FloatVec Or(FloatVecRead left, FloatVecRead right) {
+    return _mm_or_ps(left, right);
+  }
+
+  /// @brief Element-wise mask XOR
+  static inline FloatVec Xor(FloatVecRead left, FloatVecRead right) {
+    return _mm_xor_ps(left, right);
+  }
+
+  /// @brief Element-wise mask NOT
+  static inline FloatVec Not(FloatVecRead mask) {
+    return _mm_xor_ps(mask, _mm_castsi128_ps(_mm_set1_epi32(-1)));
+  }
+
+  /// @brief Compile-time select: take the element from "right" where the
+  /// matching bit of Mask is set, from "left" elsewhere
+  ///
+  /// Given left = (x0, x1, x2, x3), right = (y0, y1, y2, y3) and Mask = 0b0101
+  /// it will return (y0, x1, y2, x3)
+  template <unsigned int Mask>
+  static inline FloatVec Blend(FloatVecRead left, FloatVecRead right) {
+    static_assert(Mask < (1 << FloatVecSize), "Invalid blend mask");
+    const FloatVec mask(_mm_castsi128_ps(_mm_set_epi32((Mask & 8) ? -1 : 0,
+                                                       (Mask & 4) ? -1 : 0,
+                                                       (Mask & 2) ? -1 : 0,
+                                                       (Mask & 1) ? -1 : 0)));
+    return Select(mask, right, left);
+  }
+
+  /// @brief Pack the mask into an integer, bit i being set if element i is
+  /// set (movmskps reads the sign bit of each element)
+  static inline unsigned int MoveMask(FloatVecRead mask) {
+    return static_cast<unsigned int>(_mm_movemask_ps(mask));
+  }
+
+  /// @brief Left-pack: store contiguously the elements of "values" where the
+  /// mask is set, return their count
+  ///
+  /// Beware, up to FloatVecSize elements may be written: only the first
+  /// returned count are meaningful. The output does not need to be aligned.
+  static inline unsigned int CompressStore(float* const output,
+                                           FloatVecRead mask,
+                                           FloatVecRead values) {
+    const unsigned int bits(MoveMask(mask));
+#if defined(__AVX512VL__)
+    _mm_mask_compressstoreu_ps(output, static_cast<__mmask8>(bits), values);
+#else  // defined(__AVX512VL__)
+    alignas(FloatVecSizeBytes) float lanes[FloatVecSize];
+    Store(lanes, values);
+    // Branchless: always write, only advance over selected elements
+    unsigned int index(0);
+    for (unsigned int i(0); i < FloatVecSize; ++i) {
+      output[index] = lanes[i];
+      index += (bits >> i) & 1;
+    }
+#endif  // defined(__AVX512VL__)
+    return PopCount(bits);
+  }
+
+  /// @brief Element-wise mask: set where the element is infinite or NaN
+  ///
+  /// Computed on the bits (exponent all ones): still valid with finite maths
+  /// compiler flags
+  static inline FloatVec IsNonFinite(FloatVecRead input) {
+    const IntVec kExponentMask(_mm_set1_epi32(0x7f800000));
+    return _mm_castsi128_ps(_mm_cmpeq_epi32(
+      _mm_and_si128(_mm_castps_si128(input), kExponentMask),
+      kExponentMask));
+  }
+
+  /// @brief Element-wise mask: set where the element is denormal
+  ///
+  /// Computed on the bits (null exponent, non-null mantissa): still valid
+  /// when denormals are treated as zero by arithmetic instructions
+  static inline FloatVec IsDenormal(FloatVecRead input) {
+    const IntVec kMagnitudeMask(_mm_set1_epi32(0x7fffffff));
+    // Magnitudes within [1 ; 0x7fffff] moved to the bottom of the signed
+    // range, zero wrapping to its top: a single signed comparison
+    const IntVec shifted(_mm_add_epi32(
+      _mm_and_si128(_mm_castps_si128(input), kMagnitudeMask),
+      kMagnitudeMask));
+    return _mm_castsi128_ps(_mm_cmplt_epi32(
+      shifted,
+      _mm_set1_epi32(static_cast<int>(0x807fffffu))));
+  }
+
+  /// @brief Fill a whole FloatVec from FloatVecSize half precision values,
+  /// not necessarily aligned
+  static inline FloatVec FillFloat16(const Float16* const buffer) {
+    const IntVec packed(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(buffer)));
+#if defined(__F16C__)
+    return _mm_cvtph_ps(packed);
+#else  // defined(__F16C__)
+    const IntVec kShiftedExponent(_mm_set1_epi32(0x7c00 << 13));
+    const IntVec half(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+    const IntVec shifted(_mm_slli_epi32(
+      _mm_and_si128(half, _mm_set1_epi32(0x7fff)), 13));
+    const IntVec exponent(_mm_and_si128(shifted, kShiftedExponent));
+    IntVec output(_mm_add_epi32(shifted, _mm_set1_epi32(0x38000000)));
+    // Infinity or NaN
+    output = _mm_add_epi32(
+      output,
+      _mm_and_si128(_mm_cmpeq_epi32(exponent, kShiftedExponent),
+                    _mm_set1_epi32(0x38000000)));
+    // Denormal or zero: renormalized by an exact subtraction
+    const IntVec renormalized(_mm_castps_si128(_mm_sub_ps(
+      _mm_castsi128_ps(_mm_add_epi32(output, _mm_set1_epi32(0x00800000))),
+      _mm_castsi128_ps(_mm_set1_epi32(0x38800000)))));
+    output = SelectBits(_mm_cmpeq_epi32(exponent, _mm_setzero_si128()),
+                        renormalized,
+                        output);
+    const IntVec sign(_mm_and_si128(_mm_slli_epi32(half, 16),
+                                    _mm_set1_epi32(0x80000000)));
+    return _mm_castsi128_ps(_mm_or_si128(output, sign));
+#endif  // defined(__F16C__)
+  }
+
+  /// @brief Store a whole FloatVec as half precision values (rounded to
+  /// nearest even), not necessarily aligned
+  static inline void StoreFloat16(Float16* const buffer, FloatVecRead input) {
+#if defined(__F16C__)
+    const IntVec packed(_mm_cvtps_ph(input, _MM_FROUND_TO_NEAREST_INT));
+#else  // defined(__F16C__)
+    const IntVec bits(_mm_castps_si128(input));
+    const IntVec sign(_mm_and_si128(bits, _mm_set1_epi32(0x80000000)));
+    const IntVec magnitude(_mm_xor_si128(bits, sign));
+    // Normal: rebias the exponent, round to nearest even
+    const IntVec odd(_mm_and_si128(_mm_srli_epi32(magnitude, 13),
+                                   _mm_set1_epi32(1)));
+    IntVec output(_mm_srli_epi32(
+      _mm_add_epi32(_mm_add_epi32(magnitude,
+                                  _mm_set1_epi32(0xc8000fff)),
+                    odd),
+      13));
+    // Denormal or zero: adding 0.5 aligns the mantissa, the FPU rounds it
+    const IntVec denormal(_mm_sub_epi32(
+      _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(magnitude),
+                                  _mm_set1_ps(0.5f))),
+      _mm_set1_epi32(0x3f000000)));
+    output = SelectBits(_mm_cmplt_epi32(magnitude, _mm_set1_epi32(0x38800000)),
+                        denormal,
+                        output);
+    // Overflow: infinity, NaN remains (quiet) NaN
+    const IntVec overflow(_mm_or_si128(
+      _mm_set1_epi32(0x7c00),
+      _mm_and_si128(_mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x7f800000)),
+                    _mm_set1_epi32(0x0200))));
+    output = SelectBits(_mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x477fffff)),
+                        overflow,
+                        output);
+    output = _mm_or_si128(output, _mm_srli_epi32(sign, 16));
+    const IntVec packed(PackLowHalves(output));
+#endif  // defined(__F16C__)
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(buffer), packed);
+  }
+
+  /// @brief Fill a whole FloatVec from FloatVecSize bfloat16 values,
+  /// not necessarily aligned
+  static inline FloatVec FillBFloat16(const BFloat16* const buffer) {
+    const IntVec packed(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(buffer)));
+    return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), packed));
+  }
+
+  /// @brief Store a whole FloatVec as bfloat16 values (rounded to nearest
+  /// even), not necessarily aligned
+  static inline void StoreBFloat16(BFloat16* const buffer, FloatVecRead input) {
+    const IntVec bits(_mm_castps_si128(input));
+    const IntVec odd(_mm_and_si128(_mm_srli_epi32(bits, 16),
+                                   _mm_set1_epi32(1)));
+    const IntVec rounded(_mm_add_epi32(
+      _mm_add_epi32(bits, _mm_set1_epi32(0x7fff)), odd));
+    // NaN: rounding could turn it into infinity
+    const IntVec is_nan(_mm_cmpgt_epi32(
+      _mm_and_si128(bits, _mm_set1_epi32(0x7fffffff)),
+      _mm_set1_epi32(0x7f800000)));
+    const IntVec output(SelectBits(
+      is_nan,
+      _mm_or_si128(bits, _mm_set1_epi32(0x00400000)),
+      rounded));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(buffer),
+                     PackLowHalves(_mm_srli_epi32(output, 16)));
+  }
+
+  /// @brief Element-wise unbiased exponent of normal numbers, as floats
+  /// (floor(log2(|input|)))
+  static inline FloatVec Exponent(FloatVecRead input) {
+    const IntVec biased(_mm_and_si128(
+      _mm_srli_epi32(_mm_castps_si128(input), 23),
+      _mm_set1_epi32(0xff)));
+    return _mm_cvtepi32_ps(_mm_sub_epi32(biased, _mm_set1_epi32(127)));
+  }
+
+  /// @brief Element-wise mantissa of normal numbers, within [1 ; 2[
+  /// (sign dropped)
+  static inline FloatVec Mantissa(FloatVecRead input) {
+    return _mm_castsi128_ps(_mm_or_si128(
+      _mm_and_si128(_mm_castps_si128(input), _mm_set1_epi32(0x007fffff)),
+      _mm_set1_epi32(0x3f800000)));
+  }
+
+  /// @brief Element-wise 2^exponent, exponents being integers
+  /// within [-126 ; 127]
+  static inline FloatVec PowerOfTwo(FloatVecRead exponent) {
+    return _mm_castsi128_ps(_mm_slli_epi32(
+      _mm_add_epi32(_mm_cvttps_epi32(exponent), _mm_set1_epi32(127)),
+      23));
+  }
+
   static inline IntVec TruncToInt(FloatVecRead float_value) {
     return _mm_cvttps_epi32(float_value);
   }
+
+  /// @brief Element-wise integer to float conversion
+  static inline FloatVec IntToFloat(const IntVec input) {
+    return _mm_cvtepi32_ps(input);
+  }
+
+  /// @brief Fill a whole IntVec from an aligned buffer
+  static inline IntVec FillInt(const int* const buffer) {
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(buffer));
+  }
+
+  /// @brief Store a whole IntVec into an aligned buffer
+  static inline void StoreInt(int* const buffer, const IntVec input) {
+    _mm_store_si128(reinterpret_cast<__m128i*>(buffer), input);
+  }
+
+  /// @brief Element-wise count update: one added where the mask is set
+  ///
+  /// Set mask elements are -1 as integers: no conversion required
+  static inline IntVec CountMask(const IntVec counts, FloatVecRead mask) {
+    return _mm_sub_epi32(counts, _mm_castps_si128(mask));
+  }
+
+ protected:
+  /// @brief Bitwise select: "if_true" bits where "mask" bits are set
+  static inline IntVec SelectBits(const IntVec mask,
+                                  const IntVec if_true,
+                                  const IntVec if_false) {
+    return _mm_or_si128(_mm_and_si128(mask, if_true),
+                        _mm_andnot_si128(mask, if_false));
+  }
+
+  /// @brief Pack the low 16 bits of each element into the low 64 bits
+  static inline IntVec PackLowHalves(const IntVec input) {
+    // Sign extension makes the signed saturation of packs a no-op
+    const IntVec extended(_mm_srai_epi32(_mm_slli_epi32(input, 16), 16));
+    return _mm_packs_epi32(extended, extended);
+  }
+
+  /// @brief Count the bits set in a MoveMask() result
+  static inline unsigned int PopCount(const unsigned int bits) {
+    static const unsigned char kCounts[16] = {
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+    };
+    return kCounts[bits & 15];
+  }
+
+ private:
+  /// @brief Rounding helper: select the rounded value where the input fits
+  /// into an integer, the input itself elsewhere (already integral, inf, NaN)
+  ///
+  /// The input sign is also restored, so that e.g. -0.2 rounds to -0.0
+  static inline FloatVec RestoreIntegral(FloatVecRead input,
+                                         FloatVecRead rounded) {
+    const FloatVec kSignMask(Fill(-0.0f));
+    // All floats above 2^23 are integers
+    const FloatVec kIntegralThreshold(Fill(8388608.0f));
+    const FloatVec fits_mask(_mm_cmplt_ps(_mm_andnot_ps(kSignMask, input),
+                                          kIntegralThreshold));
+    const FloatVec signed_rounded(_mm_or_ps(rounded,
+                                            _mm_and_ps(kSignMask, input)));
+    return Select(fits_mask, signed_rounded, input);
+  }
 };
 
 }  // namespace vecmath
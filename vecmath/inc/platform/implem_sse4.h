@@ -0,0 +1,165 @@
+/// @file implem_sse4.h
+/// @brief Maths header - SSE4.1 implementation
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of VecMath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_INC_PLATFORM_IMPLEM_SSE4_H_
+#define VECMATH_INC_PLATFORM_IMPLEM_SSE4_H_
+
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/platform/implem_sse2.h"
+
+#if _VEC_USE_SSE4
+
+extern "C" {
+#include <smmintrin.h>
+}
+
+namespace vecmath {
+
+/// @brief SSE4.1 tier: only the primitives which have a native SSE3/SSE4.1
+/// instruction are overridden, everything else comes from SSE2
+struct SSE4VectorMath : public SSE2VectorMath {
+  using SSE2VectorMath::GetByIndex;
+
+  /// @brief Integer version of GetByIndex (compile-time version)
+  template<unsigned i>
+  static int GetByIndex(IntVec input) {
+    static_assert(i < FloatVecSize, "Index out of bounds");
+    return _mm_extract_epi32(input, i);
+  }
+
+  /// @brief Replace one element of a FloatVec (compile-time version)
+  ///
+  /// @param[in]  input   FloatVec to be modified
+  /// @param[in]  value   Value to be inserted at index i
+  template<unsigned i>
+  static FloatVec SetByIndex(FloatVecRead input, const float value) {
+    static_assert(i < FloatVecSize, "Index out of bounds");
+    return _mm_insert_ps(input, _mm_set_ss(value), i << 4);
+  }
+
+  /// @brief Round each FloatVec element to the nearest integer
+  /// (halfway cases rounded to even, as in the default rounding mode)
+  static inline FloatVec Round(FloatVecRead input) {
+    return _mm_round_ps(input, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+
+  /// @brief Round each FloatVec element toward zero
+  static inline FloatVec Trunc(FloatVecRead input) {
+    return _mm_round_ps(input, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  }
+
+  /// @brief Round each FloatVec element toward negative infinity
+  static inline FloatVec Floor(FloatVecRead input) {
+    return _mm_floor_ps(input);
+  }
+
+  /// @brief Round each FloatVec element toward positive infinity
+  static inline FloatVec Ceil(FloatVecRead input) {
+    return _mm_ceil_ps(input);
+  }
+
+  /// @brief Element-wise select: "if_true" where the mask is set,
+  /// "if_false" elsewhere
+  static inline FloatVec Select(FloatVecRead mask,
+                                FloatVecRead if_true,
+                                FloatVecRead if_false) {
+    return _mm_blendv_ps(if_false, if_true, mask);
+  }
+
+  /// @brief Compile-time select: take the element from "right" where the
+  /// matching bit of Mask is set, from "left" elsewhere
+  template <unsigned int Mask>
+  static inline FloatVec Blend(FloatVecRead left, FloatVecRead right) {
+    static_assert(Mask < (1 << FloatVecSize), "Invalid blend mask");
+    return _mm_blend_ps(left, right, Mask);
+  }
+
+  /// @brief Left-pack: store contiguously the elements of "values" where the
+  /// mask is set, return their count
+  ///
+  /// Beware, up to FloatVecSize elements may be written: only the first
+  /// returned count are meaningful. The output does not need to be aligned.
+  static inline unsigned int CompressStore(float* const output,
+                                           FloatVecRead mask,
+                                           FloatVecRead values) {
+#if defined(__AVX512VL__)
+    return SSE2VectorMath::CompressStore(output, mask, values);
+#else  // defined(__AVX512VL__)
+    // Byte shuffles packing the selected elements on the left,
+    // indexed by the mask bits (Z zeroes the byte)
+    static const signed char Z(-128);
+    alignas(16) static const signed char kPermutations[16][16] = {
+      {Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z},
+      {0, 1, 2, 3, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z},
+      {4, 5, 6, 7, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, Z, Z, Z, Z, Z, Z, Z, Z},
+      {8, 9, 10, 11, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z},
+      {0, 1, 2, 3, 8, 9, 10, 11, Z, Z, Z, Z, Z, Z, Z, Z},
+      {4, 5, 6, 7, 8, 9, 10, 11, Z, Z, Z, Z, Z, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, Z, Z, Z, Z},
+      {12, 13, 14, 15, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z},
+      {0, 1, 2, 3, 12, 13, 14, 15, Z, Z, Z, Z, Z, Z, Z, Z},
+      {4, 5, 6, 7, 12, 13, 14, 15, Z, Z, Z, Z, Z, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 12, 13, 14, 15, Z, Z, Z, Z},
+      {8, 9, 10, 11, 12, 13, 14, 15, Z, Z, Z, Z, Z, Z, Z, Z},
+      {0, 1, 2, 3, 8, 9, 10, 11, 12, 13, 14, 15, Z, Z, Z, Z},
+      {4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, Z, Z, Z, Z},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}
+    };
+    const unsigned int bits(MoveMask(mask));
+    const __m128i permutation(_mm_load_si128(
+      reinterpret_cast<const __m128i*>(kPermutations[bits])));
+    StoreUnaligned(output, _mm_castsi128_ps(_mm_shuffle_epi8(
+      _mm_castps_si128(values), permutation)));
+    return PopCount(bits);
+#endif  // defined(__AVX512VL__)
+  }
+
+  /// @brief Alternatively substract and add "right" to "left"
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x0 - y0, x1 + y1, x2 - y2, x3 + y3)
+  static inline FloatVec AddSub(FloatVecRead left, FloatVecRead right) {
+    return _mm_addsub_ps(left, right);
+  }
+
+  /// @brief Duplicate each even element
+  ///
+  /// Given value = (x0, x1, x2, x3)
+  /// it will return (x0, x0, x2, x2)
+  static inline FloatVec DuplicateEven(FloatVecRead value) {
+    return _mm_moveldup_ps(value);
+  }
+
+  /// @brief Duplicate each odd element
+  ///
+  /// Given value = (x0, x1, x2, x3)
+  /// it will return (x1, x1, x3, x3)
+  static inline FloatVec DuplicateOdd(FloatVecRead value) {
+    return _mm_movehdup_ps(value);
+  }
+};
+
+}  // namespace vecmath
+
+#endif  // _VEC_USE_SSE4
+
+#endif  // VECMATH_INC_PLATFORM_IMPLEM_SSE4_H_
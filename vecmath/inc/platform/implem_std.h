@@ -26,6 +26,7 @@
 #include <cstring>
 
 #include "vecmath/inc/common.h"
+#include "vecmath/inc/half.h"
 
 namespace vecmath {
 
@@ -83,10 +84,13 @@ struct StandardVectorMath {
     return Fill( value[0], value[1], value[2], value[3] );
   }
 
+  static inline FloatVec FillUnaligned(BlockIn value) {
+    return Fill(value);
+  }
+
   /// @brief Extract one element from a FloatVec (compile-time version)
   ///
   /// @param[in]  input   FloatVec to be read
-  // TODO(gm): faster _mm_store_ss specialization
   template<unsigned i>
   static float GetByIndex(FloatVecRead input) {
     return input.data_[i];
@@ -107,6 +111,17 @@ struct StandardVectorMath {
     return input.data_[i];
   }
 
+  /// @brief Replace one element of a FloatVec (compile-time version)
+  ///
+  /// @param[in]  input   FloatVec to be modified
+  /// @param[in]  value   Value to be inserted at index i
+  template<unsigned i>
+  static FloatVec SetByIndex(FloatVecRead input, const float value) {
+    FloatVec output(input);
+    output.data_[i] = value;
+    return output;
+  }
+
   /// @brief Add "left" to "right"
   static inline FloatVec Add(FloatVecRead left, FloatVecRead right) {
     return Fill(
@@ -142,6 +157,71 @@ struct StandardVectorMath {
       left.data_[3] * right.data_[3] );
   }
 
+  /// @brief Element-wise division of "left" by "right" (exact)
+  static inline FloatVec Div(FloatVecRead left, FloatVecRead right) {
+    return Fill(
+      left.data_[0] / right.data_[0],
+      left.data_[1] / right.data_[1],
+      left.data_[2] / right.data_[2],
+      left.data_[3] / right.data_[3] );
+  }
+
+  /// @brief Element-wise square root (exact)
+  static inline FloatVec Sqrt(FloatVecRead input) {
+    return Fill(
+      std::sqrt(input.data_[0]),
+      std::sqrt(input.data_[1]),
+      std::sqrt(input.data_[2]),
+      std::sqrt(input.data_[3]) );
+  }
+
+  /// @brief Element-wise reciprocal 1 / input (exact)
+  static inline FloatVec Reciprocal(FloatVecRead input) {
+    return Div(Fill(1.0f), input);
+  }
+
+  /// @brief Element-wise reciprocal square root 1 / sqrt(input) (exact)
+  static inline FloatVec ReciprocalSqrt(FloatVecRead input) {
+    return Div(Fill(1.0f), Sqrt(input));
+  }
+
+  /// @brief Element-wise approximate reciprocal 1 / input
+  ///
+  /// There is no hardware estimate here: this is the exact version,
+  /// hence more accurate than any of the SIMD implementations
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec ReciprocalFast(FloatVecRead input) {
+    static_assert(NewtonSteps <= 2, "At most 2 Newton-Raphson steps");
+    return Reciprocal(input);
+  }
+
+  /// @brief Element-wise approximate reciprocal square root 1 / sqrt(input)
+  ///
+  /// Exact version, see ReciprocalFast
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec ReciprocalSqrtFast(FloatVecRead input) {
+    static_assert(NewtonSteps <= 2, "At most 2 Newton-Raphson steps");
+    return ReciprocalSqrt(input);
+  }
+
+  /// @brief Element-wise approximate square root
+  ///
+  /// Exact version, see ReciprocalFast
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec SqrtFast(FloatVecRead input) {
+    static_assert(NewtonSteps <= 2, "At most 2 Newton-Raphson steps");
+    return Sqrt(input);
+  }
+
+  /// @brief Element-wise approximate division "left" / "right"
+  ///
+  /// Exact version, see ReciprocalFast
+  template <unsigned NewtonSteps = 1>
+  static inline FloatVec DivFast(FloatVecRead left, FloatVecRead right) {
+    static_assert(NewtonSteps <= 2, "At most 2 Newton-Raphson steps");
+    return Div(left, right);
+  }
+
   /// @brief Shift to right all elements of the input by 1,
   /// and shift in the given value
   ///
@@ -174,6 +254,24 @@ struct StandardVectorMath {
       value);
   }
 
+  /// @brief Shift to right all elements of the input by Count,
+  /// and shift in the given value
+  ///
+  /// E.g. with Count = 2, given (x0, x1, x2, x3)
+  /// return (value, value, x0, x1)
+  ///
+  /// @param[in]  input   FloatVec to be shifted
+  /// @param[in]  value   value to be shifted in
+  template <unsigned Count>
+  static inline FloatVec ShiftOnRight(FloatVecRead input, const float value) {
+    static_assert(Count > 0 && Count < FloatVecSize, "Invalid shift");
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = i < Count ? value : input.data_[i - Count];
+    }
+    return output;
+  }
+
   /// @brief Return the sign of each element of the FloatVec
   ///
   /// Sgn(0.0) return 0.0
@@ -208,6 +306,16 @@ struct StandardVectorMath {
     Store(buffer, input);
   }
 
+  /// @brief Get each left half of the two given vectors
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x0, x1, y0, y1)
+  static inline FloatVec TakeEachLeftHalf(FloatVecRead left,
+                                          FloatVecRead right) {
+    return Fill( left.data_[0], left.data_[1],
+             right.data_[0], right.data_[1] );
+  }
+
   /// @brief Get each right half of the two given vectors
   ///
   /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
@@ -230,6 +338,90 @@ struct StandardVectorMath {
       input.data_[0] );
   }
 
+  /// @brief Element-wise multiply-add: left * right + addend
+  static inline FloatVec MulAdd(FloatVecRead left,
+                                FloatVecRead right,
+                                FloatVecRead addend) {
+    return Add(Mul(left, right), addend);
+  }
+
+  /// @brief Alternatively substract and add "right" to "left"
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x0 - y0, x1 + y1, x2 - y2, x3 + y3)
+  static inline FloatVec AddSub(FloatVecRead left, FloatVecRead right) {
+    return Fill(
+      left.data_[0] - right.data_[0],
+      left.data_[1] + right.data_[1],
+      left.data_[2] - right.data_[2],
+      left.data_[3] + right.data_[3] );
+  }
+
+  /// @brief Duplicate each even element
+  ///
+  /// Given value = (x0, x1, x2, x3)
+  /// it will return (x0, x0, x2, x2)
+  static inline FloatVec DuplicateEven(FloatVecRead value) {
+    return Fill(value.data_[0], value.data_[0],
+                value.data_[2], value.data_[2]);
+  }
+
+  /// @brief Duplicate each odd element
+  ///
+  /// Given value = (x0, x1, x2, x3)
+  /// it will return (x1, x1, x3, x3)
+  static inline FloatVec DuplicateOdd(FloatVecRead value) {
+    return Fill(value.data_[1], value.data_[1],
+                value.data_[3], value.data_[3]);
+  }
+
+  /// @brief Swap elements of each pair
+  ///
+  /// Given value = (x0, x1, x2, x3)
+  /// it will return (x1, x0, x3, x2)
+  static inline FloatVec SwapPairs(FloatVecRead value) {
+    return Fill(value.data_[1], value.data_[0],
+                value.data_[3], value.data_[2]);
+  }
+
+  /// @brief Interleave the low halves of the two given vectors
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x0, y0, x1, y1)
+  static inline FloatVec InterleaveLow(FloatVecRead left, FloatVecRead right) {
+    return Fill(left.data_[0], right.data_[0],
+                left.data_[1], right.data_[1]);
+  }
+
+  /// @brief Interleave the high halves of the two given vectors
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x2, y2, x3, y3)
+  static inline FloatVec InterleaveHigh(FloatVecRead left, FloatVecRead right) {
+    return Fill(left.data_[2], right.data_[2],
+                left.data_[3], right.data_[3]);
+  }
+
+  /// @brief Gather even elements of the two given vectors
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x0, x2, y0, y2)
+  static inline FloatVec DeinterleaveEven(FloatVecRead left,
+                                          FloatVecRead right) {
+    return Fill(left.data_[0], left.data_[2],
+                right.data_[0], right.data_[2]);
+  }
+
+  /// @brief Gather odd elements of the two given vectors
+  ///
+  /// Given left = (x0, x1, x2, x3) and right = (y0, y1, y2, y3)
+  /// it will return (x1, x3, y1, y3)
+  static inline FloatVec DeinterleaveOdd(FloatVecRead left,
+                                         FloatVecRead right) {
+    return Fill(left.data_[1], left.data_[3],
+                right.data_[1], right.data_[3]);
+  }
+
   /// @brief Return each min element of both inputs
   static inline FloatVec Min(FloatVecRead left, FloatVecRead right) {
     return Fill(
@@ -249,13 +441,42 @@ struct StandardVectorMath {
   }
 
   /// @brief Round each FloatVec element to the nearest integer
+  /// (halfway cases rounded to even, as in the default rounding mode)
   static inline FloatVec Round(FloatVecRead input) {
     return Fill(
-      input.data_[0] > 0.0f ? input.data_[0] + 0.5f : input.data_[0] - 0.5f,
-      input.data_[1] > 0.0f ? input.data_[1] + 0.5f : input.data_[1] - 0.5f,
-      input.data_[2] > 0.0f ? input.data_[2] + 0.5f : input.data_[2] - 0.5f,
-      input.data_[3] > 0.0f ? input.data_[3] + 0.5f : input.data_[3] - 0.5f );
+      std::nearbyint(input.data_[0]),
+      std::nearbyint(input.data_[1]),
+      std::nearbyint(input.data_[2]),
+      std::nearbyint(input.data_[3]) );
   }
+
+  /// @brief Round each FloatVec element toward zero
+  static inline FloatVec Trunc(FloatVecRead input) {
+    return Fill(
+      std::trunc(input.data_[0]),
+      std::trunc(input.data_[1]),
+      std::trunc(input.data_[2]),
+      std::trunc(input.data_[3]) );
+  }
+
+  /// @brief Round each FloatVec element toward negative infinity
+  static inline FloatVec Floor(FloatVecRead input) {
+    return Fill(
+      std::floor(input.data_[0]),
+      std::floor(input.data_[1]),
+      std::floor(input.data_[2]),
+      std::floor(input.data_[3]) );
+  }
+
+  /// @brief Round each FloatVec element toward positive infinity
+  static inline FloatVec Ceil(FloatVecRead input) {
+    return Fill(
+      std::ceil(input.data_[0]),
+      std::ceil(input.data_[1]),
+      std::ceil(input.data_[2]),
+      std::ceil(input.data_[3]) );
+  }
+
   /// @brief Helper function: increment the input and wraps it into [-1.0 ; 1.0[
   ///
   /// @param[in]  input         Input to be wrapped - supposed not to be < 1.0
@@ -389,6 +610,202 @@ struct StandardVectorMath {
       mask.data_[3] == 0xffffffff ? value.data_[3] : 0.0f);
   }
 
+  /// @brief Element-wise select: "if_true" where the mask is set,
+  /// "if_false" elsewhere
+  static inline FloatVec Select(FloatVecRead mask,
+                                FloatVecRead if_true,
+                                FloatVecRead if_false) {
+    return Fill(
+      mask.data_[0] == 0xffffffff ? if_true.data_[0] : if_false.data_[0],
+      mask.data_[1] == 0xffffffff ? if_true.data_[1] : if_false.data_[1],
+      mask.data_[2] == 0xffffffff ? if_true.data_[2] : if_false.data_[2],
+      mask.data_[3] == 0xffffffff ? if_true.data_[3] : if_false.data_[3]);
+  }
+
+  /// @brief Element-wise mask AND
+  static inline FloatVec And(FloatVecRead left, FloatVecRead right) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = LaneMask(IsLaneSet(left.data_[i])
+                                 && IsLaneSet(right.data_[i]));
+    }
+    return output;
+  }
+
+  /// @brief Element-wise mask "left AND NOT right"
+  static inline FloatVec AndNot(FloatVecRead left, FloatVecRead right) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = LaneMask(IsLaneSet(left.data_[i])
+                                 && !IsLaneSet(right.data_[i]));
+    }
+    return output;
+  }
+
+  /// @brief Element-wise mask OR
+  static inline FloatVec Or(FloatVecRead left, FloatVecRead right) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = LaneMask(IsLaneSet(left.data_[i])
+                                 || IsLaneSet(right.data_[i]));
+    }
+    return output;
+  }
+
+  /// @brief Element-wise mask XOR
+  static inline FloatVec Xor(FloatVecRead left, FloatVecRead right) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = LaneMask(IsLaneSet(left.data_[i])
+                                 != IsLaneSet(right.data_[i]));
+    }
+    return output;
+  }
+
+  /// @brief Element-wise mask NOT
+  static inline FloatVec Not(FloatVecRead mask) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = LaneMask(!IsLaneSet(mask.data_[i]));
+    }
+    return output;
+  }
+
+  /// @brief Compile-time select: take the element from "right" where the
+  /// matching bit of Mask is set, from "left" elsewhere
+  template <unsigned int Mask>
+  static inline FloatVec Blend(FloatVecRead left, FloatVecRead right) {
+    static_assert(Mask < (1 << FloatVecSize), "Invalid blend mask");
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = ((Mask >> i) & 1) ? right.data_[i] : left.data_[i];
+    }
+    return output;
+  }
+
+  /// @brief Pack the mask into an integer, bit i being set if element i is
+  /// set (see IsLaneSet)
+  static inline unsigned int MoveMask(FloatVecRead mask) {
+    unsigned int bits(0);
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      bits |= (IsLaneSet(mask.data_[i]) ? 1u : 0u) << i;
+    }
+    return bits;
+  }
+
+  /// @brief Left-pack: store contiguously the elements of "values" where the
+  /// mask is set, return their count
+  ///
+  /// Beware, up to FloatVecSize elements may be written: only the first
+  /// returned count are meaningful. The output does not need to be aligned.
+  static inline unsigned int CompressStore(float* const output,
+                                           FloatVecRead mask,
+                                           FloatVecRead values) {
+    unsigned int index(0);
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output[index] = values.data_[i];
+      index += IsLaneSet(mask.data_[i]) ? 1 : 0;
+    }
+    return index;
+  }
+
+  /// @brief Element-wise mask: set where the element is infinite or NaN
+  ///
+  /// Computed on the bits (exponent all ones): still valid with finite maths
+  /// compiler flags
+  static inline FloatVec IsNonFinite(FloatVecRead input) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = LaneMask((LaneBits(input.data_[i]) & 0x7f800000u)
+                                 == 0x7f800000u);
+    }
+    return output;
+  }
+
+  /// @brief Element-wise mask: set where the element is denormal
+  ///
+  /// Computed on the bits (null exponent, non-null mantissa): still valid
+  /// when denormals are treated as zero by arithmetic instructions
+  static inline FloatVec IsDenormal(FloatVecRead input) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      const unsigned int bits(LaneBits(input.data_[i]));
+      output.data_[i] = LaneMask((bits & 0x7f800000u) == 0
+                                 && (bits & 0x7fffffffu) != 0);
+    }
+    return output;
+  }
+
+  /// @brief Fill a whole FloatVec from FloatVecSize half precision values,
+  /// not necessarily aligned
+  static inline FloatVec FillFloat16(const Float16* const buffer) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = HalfConversion::ToFloat(buffer[i]);
+    }
+    return output;
+  }
+
+  /// @brief Store a whole FloatVec as half precision values (rounded to
+  /// nearest even), not necessarily aligned
+  static inline void StoreFloat16(Float16* const buffer, FloatVecRead input) {
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      buffer[i] = HalfConversion::ToFloat16(input.data_[i]);
+    }
+  }
+
+  /// @brief Fill a whole FloatVec from FloatVecSize bfloat16 values,
+  /// not necessarily aligned
+  static inline FloatVec FillBFloat16(const BFloat16* const buffer) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = HalfConversion::ToFloat(buffer[i]);
+    }
+    return output;
+  }
+
+  /// @brief Store a whole FloatVec as bfloat16 values (rounded to nearest
+  /// even), not necessarily aligned
+  static inline void StoreBFloat16(BFloat16* const buffer, FloatVecRead input) {
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      buffer[i] = HalfConversion::ToBFloat16(input.data_[i]);
+    }
+  }
+
+  /// @brief Element-wise unbiased exponent of normal numbers, as floats
+  /// (floor(log2(|input|)))
+  static inline FloatVec Exponent(FloatVecRead input) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = static_cast<float>(
+        static_cast<int>((LaneBits(input.data_[i]) >> 23) & 0xffu) - 127);
+    }
+    return output;
+  }
+
+  /// @brief Element-wise mantissa of normal numbers, within [1 ; 2[
+  /// (sign dropped)
+  static inline FloatVec Mantissa(FloatVecRead input) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = FromLaneBits(
+        (LaneBits(input.data_[i]) & 0x007fffffu) | 0x3f800000u);
+    }
+    return output;
+  }
+
+  /// @brief Element-wise 2^exponent, exponents being integers
+  /// within [-126 ; 127]
+  static inline FloatVec PowerOfTwo(FloatVecRead exponent) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = FromLaneBits(
+        static_cast<unsigned int>(static_cast<int>(exponent.data_[i]) + 127)
+        << 23);
+    }
+    return output;
+  }
+
   static inline IntVec TruncToInt(FloatVecRead float_value) {
     return Fill(
       static_cast<int>(float_value.data_[0]),
@@ -396,6 +813,56 @@ struct StandardVectorMath {
       static_cast<int>(float_value.data_[2]),
       static_cast<int>(float_value.data_[3]));
   }
+
+  /// @brief Element-wise integer to float conversion
+  static inline FloatVec IntToFloat(const IntVec input) {
+    FloatVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = static_cast<float>(input.data_[i]);
+    }
+    return output;
+  }
+
+  /// @brief Fill a whole IntVec from an aligned buffer
+  static inline IntVec FillInt(const int* const buffer) {
+    return Fill(buffer[0], buffer[1], buffer[2], buffer[3]);
+  }
+
+  /// @brief Store a whole IntVec into an aligned buffer
+  static inline void StoreInt(int* const buffer, const IntVec input) {
+    std::memcpy(buffer, &input.data_[0], sizeof(input.data_));
+  }
+
+  /// @brief Element-wise count update: one added where the mask is set
+  static inline IntVec CountMask(const IntVec counts, FloatVecRead mask) {
+    IntVec output;
+    for (unsigned i(0); i < FloatVecSize; ++i) {
+      output.data_[i] = counts.data_[i] + (IsLaneSet(mask.data_[i]) ? 1 : 0);
+    }
+    return output;
+  }
+
+ private:
+  /// @brief Mask elements are either 0xffffffff (set) or 0.0f
+  static inline bool IsLaneSet(const float mask_element) {
+    return mask_element == 0xffffffff;
+  }
+
+  static inline float LaneMask(const bool set) {
+    return set ? 0xffffffff : 0.0f;
+  }
+
+  static inline unsigned int LaneBits(const float element) {
+    unsigned int bits;
+    std::memcpy(&bits, &element, sizeof(bits));
+    return bits;
+  }
+
+  static inline float FromLaneBits(const unsigned int bits) {
+    float element;
+    std::memcpy(&element, &bits, sizeof(element));
+    return element;
+  }
 };
 
 }  // namespace vecmath
@@ -0,0 +1,330 @@
+/// @file polynomial.h
+/// @brief Compile-time polynomial, rational and spline evaluators
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Coefficient tables are given as types holding static constexpr arrays,
+/// in increasing powers order, e.g.:
+///
+/// struct Cubic {
+///   static constexpr float kCoefficients[] = {1.0f, 0.5f, 0.0f, -0.25f};
+/// };
+///
+/// Polynomial<Cubic>::Evaluate(x) then computes 1 + 0.5 x - 0.25 x^3
+/// with all coefficients baked in the generated code.
+
+#ifndef VECMATH_INC_POLYNOMIAL_H_
+#define VECMATH_INC_POLYNOMIAL_H_
+
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Compile-time access to Table::kCoefficients[Index]
+template <typename Table, unsigned int Index>
+struct TableCoefficient {
+  static constexpr float kValue = Table::kCoefficients[Index];
+};
+
+template <typename Table, unsigned int Index>
+constexpr float TableCoefficient<Table, Index>::kValue;
+
+/// @brief Compile-time access to Table::kKnots[Index]
+template <typename Table, unsigned int Index>
+struct TableKnot {
+  static constexpr float kValue = Table::kKnots[Index];
+};
+
+template <typename Table, unsigned int Index>
+constexpr float TableKnot<Table, Index>::kValue;
+
+/// @brief Polynomial of Table::kCoefficients
+///
+/// Evaluate() uses Horner scheme for low degrees; from degree 4 on the
+/// Estrin scheme is used instead, shortening the dependency chain
+/// at the cost of a few more multiplications.
+/// All multiply-add are done through PlatformVectorMath::MulAdd,
+/// thus fused whenever the platform supports it.
+template <typename Table>
+class Polynomial {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Number of coefficients
+  static constexpr unsigned int kCount =
+    sizeof(Table::kCoefficients) / sizeof(float);
+  static constexpr unsigned int kDegree = kCount - 1;
+
+  static_assert(kCount > 0, "Empty coefficient table");
+
+  /// @brief Element-wise evaluation, best scheme chosen upon the degree
+  static inline FloatVec Evaluate(FloatVecRead input) {
+    return (kDegree >= 4) ? EvaluateEstrin(input) : EvaluateHorner(input);
+  }
+
+  /// @brief Element-wise evaluation, Horner scheme
+  static inline FloatVec EvaluateHorner(FloatVecRead input) {
+    return HornerSteps<0>::Apply(input);
+  }
+
+  /// @brief Element-wise evaluation, Estrin scheme
+  static inline FloatVec EvaluateEstrin(FloatVecRead input) {
+    // powers[k] = input^(2^k)
+    FloatVec powers[EstrinLevels(kCount)];
+    powers[0] = input;
+    for (unsigned int level(1); level < EstrinLevels(kCount); ++level) {
+      powers[level] = PlatformVectorMath::Mul(powers[level - 1],
+                                              powers[level - 1]);
+    }
+    return EstrinSteps<0, kCount>::Apply(&powers[0]);
+  }
+
+  /// @brief Scalar evaluation, Horner scheme, usable at compile time
+  static constexpr float Evaluate(const float input) {
+    return ScalarHornerSteps<0>::Apply(input);
+  }
+
+ private:
+  /// @brief Largest power of two strictly below "count" (count >= 2)
+  static constexpr unsigned int EstrinSplit(const unsigned int count,
+                                            const unsigned int half = 1) {
+    return (half * 2 >= count) ? half : EstrinSplit(count, half * 2);
+  }
+
+  /// @brief Number of powers of the input required by the Estrin scheme
+  static constexpr unsigned int EstrinLevels(const unsigned int count,
+                                             const unsigned int levels = 1) {
+    return ((1u << levels) >= count) ? levels
+                                     : EstrinLevels(count, levels + 1);
+  }
+
+  static constexpr unsigned int Log2(const unsigned int value) {
+    return (value <= 1) ? 0 : 1 + Log2(value / 2);
+  }
+
+  template <unsigned int Index, bool Last = (Index == kCount - 1)>
+  struct HornerSteps {
+    static inline FloatVec Apply(FloatVecRead input) {
+      return PlatformVectorMath::MulAdd(
+        HornerSteps<Index + 1>::Apply(input),
+        input,
+        PlatformVectorMath::Fill(TableCoefficient<Table, Index>::kValue));
+    }
+  };
+
+  template <unsigned int Index>
+  struct HornerSteps<Index, true> {
+    static inline FloatVec Apply(FloatVecRead /*input*/) {
+      return PlatformVectorMath::Fill(TableCoefficient<Table, Index>::kValue);
+    }
+  };
+
+  template <unsigned int Index, bool Last = (Index == kCount - 1)>
+  struct ScalarHornerSteps {
+    static constexpr float Apply(const float input) {
+      return TableCoefficient<Table, Index>::kValue
+             + input * ScalarHornerSteps<Index + 1>::Apply(input);
+    }
+  };
+
+  template <unsigned int Index>
+  struct ScalarHornerSteps<Index, true> {
+    static constexpr float Apply(const float /*input*/) {
+      return TableCoefficient<Table, Index>::kValue;
+    }
+  };
+
+  /// @brief Coefficients [Begin ; Begin + Count[ split into a low part
+  /// and a high part multiplied by the matching power of two of the input
+  template <unsigned int Begin, unsigned int Count, bool Single = (Count == 1)>
+  struct EstrinSteps {
+    static constexpr unsigned int kHalf = EstrinSplit(Count);
+
+    static inline FloatVec Apply(const FloatVec* powers) {
+      return PlatformVectorMath::MulAdd(
+        powers[Log2(kHalf)],
+        EstrinSteps<Begin + kHalf, Count - kHalf>::Apply(powers),
+        EstrinSteps<Begin, kHalf>::Apply(powers));
+    }
+  };
+
+  template <unsigned int Begin, unsigned int Count>
+  struct EstrinSteps<Begin, Count, true> {
+    static inline FloatVec Apply(const FloatVec* /*powers*/) {
+      return PlatformVectorMath::Fill(TableCoefficient<Table, Begin>::kValue);
+    }
+  };
+};
+
+/// @brief Rational function P(x) / Q(x), e.g. a Pade approximant
+///
+/// Both Numerator and Denominator are coefficient tables
+template <typename Numerator, typename Denominator>
+class Rational {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Element-wise evaluation
+  static inline FloatVec Evaluate(FloatVecRead input) {
+    return PlatformVectorMath::Div(
+      Polynomial<Numerator>::Evaluate(input),
+      Polynomial<Denominator>::Evaluate(input));
+  }
+
+  /// @brief Scalar evaluation, usable at compile time
+  static constexpr float Evaluate(const float input) {
+    return Polynomial<Numerator>::Evaluate(input)
+           / Polynomial<Denominator>::Evaluate(input);
+  }
+};
+
+/// @brief Piecewise polynomial (spline)
+///
+/// Table holds:
+/// - kKnots: the N + 1 sorted segments boundaries
+/// - kCoefficients: the N segments polynomials, one after the other,
+///   each one of the same degree and of the local variable (x - kKnots[i])
+///
+/// Segments are selected element-wise with comparisons, so that each
+/// element may lie within a different segment; inputs out of
+/// [kKnots[0] ; kKnots[N]] are extrapolated from the first/last segment.
+/// Cost grows linearly with the number of segments: meant for short tables.
+template <typename Table>
+class Spline {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  static constexpr unsigned int kSegments =
+    sizeof(Table::kKnots) / sizeof(float) - 1;
+  /// @brief Number of coefficients of each segment polynomial
+  static constexpr unsigned int kOrder =
+    sizeof(Table::kCoefficients) / sizeof(float) / kSegments;
+
+  static_assert(kSegments > 0, "At least two knots are required");
+  static_assert(kSegments * kOrder == sizeof(Table::kCoefficients)
+                                      / sizeof(float),
+                "Coefficients count must be a multiple of segments count");
+
+  /// @brief Element-wise evaluation
+  static inline FloatVec Evaluate(FloatVecRead input) {
+    // masks[i] set where the input lies at or after the i-th knot
+    FloatVec masks[kSegments];
+    ComputeMasks<1>::Apply(input, &masks[0]);
+    const FloatVec origin(SelectKnot<1>::Apply(
+      &masks[0],
+      PlatformVectorMath::Fill(TableKnot<Table, 0>::kValue)));
+    return HornerSteps<0>::Apply(PlatformVectorMath::Sub(input, origin),
+                                 &masks[0]);
+  }
+
+ private:
+  template <unsigned int Segment, bool Done = (Segment >= kSegments)>
+  struct ComputeMasks {
+    static inline void Apply(FloatVecRead input, FloatVec* masks) {
+      masks[Segment] = PlatformVectorMath::GreaterEqual(
+        input,
+        PlatformVectorMath::Fill(TableKnot<Table, Segment>::kValue));
+      ComputeMasks<Segment + 1>::Apply(input, masks);
+    }
+  };
+
+  template <unsigned int Segment>
+  struct ComputeMasks<Segment, true> {
+    static inline void Apply(FloatVecRead /*input*/, FloatVec* /*masks*/) {
+    }
+  };
+
+  template <unsigned int Segment, bool Done = (Segment >= kSegments)>
+  struct SelectKnot {
+    static inline FloatVec Apply(const FloatVec* masks, FloatVecRead current) {
+      return SelectKnot<Segment + 1>::Apply(
+        masks,
+        PlatformVectorMath::Select(
+          masks[Segment],
+          PlatformVectorMath::Fill(TableKnot<Table, Segment>::kValue),
+          current));
+    }
+  };
+
+  template <unsigned int Segment>
+  struct SelectKnot<Segment, true> {
+    static inline FloatVec Apply(const FloatVec* /*masks*/,
+                                 FloatVecRead current) {
+      return current;
+    }
+  };
+
+  /// @brief Select the coefficient of the given power within each
+  /// element segment
+  template <unsigned int Power,
+            unsigned int Segment,
+            bool Done = (Segment >= kSegments)>
+  struct SelectCoefficient {
+    static inline FloatVec Apply(const FloatVec* masks, FloatVecRead current) {
+      return SelectCoefficient<Power, Segment + 1>::Apply(
+        masks,
+        PlatformVectorMath::Select(
+          masks[Segment],
+          PlatformVectorMath::Fill(
+            TableCoefficient<Table, Segment * kOrder + Power>::kValue),
+          current));
+    }
+  };
+
+  template <unsigned int Power, unsigned int Segment>
+  struct SelectCoefficient<Power, Segment, true> {
+    static inline FloatVec Apply(const FloatVec* /*masks*/,
+                                 FloatVecRead current) {
+      return current;
+    }
+  };
+
+  template <unsigned int Power>
+  static inline FloatVec Coefficient(const FloatVec* masks) {
+    return SelectCoefficient<Power, 1>::Apply(
+      masks,
+      PlatformVectorMath::Fill(TableCoefficient<Table, Power>::kValue));
+  }
+
+  template <unsigned int Power, bool Last = (Power == kOrder - 1)>
+  struct HornerSteps {
+    static inline FloatVec Apply(FloatVecRead input, const FloatVec* masks) {
+      return PlatformVectorMath::MulAdd(
+        HornerSteps<Power + 1>::Apply(input, masks),
+        input,
+        Coefficient<Power>(masks));
+    }
+  };
+
+  template <unsigned int Power>
+  struct HornerSteps<Power, true> {
+    static inline FloatVec Apply(FloatVecRead /*input*/,
+                                 const FloatVec* masks) {
+      return Coefficient<Power>(masks);
+    }
+  };
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_POLYNOMIAL_H_
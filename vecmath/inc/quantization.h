@@ -0,0 +1,268 @@
+/// @file quantization.h
+/// @brief Uniform and companded (mu-law, A-law) quantization
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_INC_QUANTIZATION_H_
+#define VECMATH_INC_QUANTIZATION_H_
+
+#include "vecmath/inc/approximations.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Stateless quantization kernels
+///
+/// Samples within [-1 ; 1] are mapped to signed integer codes within
+/// [-2^(bits - 1) ; 2^(bits - 1) - 1], as PCM does: code = round(x 2^(bits - 1)),
+/// out of range samples being clamped.
+/// Companded variants apply the continuous mu-law (mu = 255) or A-law
+/// (A = 87.6) curve before uniform quantization, and its inverse after
+/// dequantization: 8 bits codes then have G.711 resolution (but not its
+/// bit layout).
+///
+/// All blocks are aligned, their length being a multiple of FloatVecSize.
+struct QuantizationVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+  typedef PlatformVectorMath::IntVec IntVec;
+
+  /// @brief Element-wise uniform quantization
+  ///
+  /// @param[in]  input   Samples to quantize
+  /// @param[in]  bits   Code width, within [2 ; 24]
+  static inline IntVec Quantize(FloatVecRead input, const unsigned int bits) {
+    const float scale(static_cast<float>(1u << (bits - 1)));
+    return PlatformVectorMath::TruncToInt(PlatformVectorMath::Round(
+      CommonVectorMath::Clamp(PlatformVectorMath::Mul(
+                                input,
+                                PlatformVectorMath::Fill(scale)),
+                              PlatformVectorMath::Fill(-scale),
+                              PlatformVectorMath::Fill(scale - 1.0f))));
+  }
+
+  /// @brief Element-wise uniform dequantization
+  static inline FloatVec Dequantize(const IntVec codes, const unsigned int bits) {
+    return PlatformVectorMath::Mul(
+      PlatformVectorMath::IntToFloat(codes),
+      PlatformVectorMath::Fill(1.0f / static_cast<float>(1u << (bits - 1))));
+  }
+
+  /// @brief Element-wise mu-law compression of [-1 ; 1]:
+  /// sign(x) ln(1 + mu |x|) / ln(1 + mu)
+  static inline FloatVec MuLawCompress(FloatVecRead input) {
+    const FloatVec magnitude(PlatformVectorMath::Mul(
+      ApproxVectorMath::Log2(PlatformVectorMath::MulAdd(
+        CommonVectorMath::Abs(input),
+        PlatformVectorMath::Fill(kMu),
+        PlatformVectorMath::Fill(1.0f))),
+      PlatformVectorMath::Fill(1.0f / kLog2OnePlusMu)));
+    return CopySign(magnitude, input);
+  }
+
+  /// @brief Element-wise mu-law expansion, inverse of MuLawCompress()
+  static inline FloatVec MuLawExpand(FloatVecRead input) {
+    const FloatVec magnitude(PlatformVectorMath::Mul(
+      PlatformVectorMath::Sub(
+        ApproxVectorMath::Exp2(PlatformVectorMath::Mul(
+          CommonVectorMath::Abs(input),
+          PlatformVectorMath::Fill(kLog2OnePlusMu))),
+        PlatformVectorMath::Fill(1.0f)),
+      PlatformVectorMath::Fill(1.0f / kMu)));
+    return CopySign(magnitude, input);
+  }
+
+  /// @brief Element-wise A-law compression of [-1 ; 1]:
+  /// sign(x) A |x| / (1 + ln(A)) below 1 / A,
+  /// sign(x) (1 + ln(A |x|)) / (1 + ln(A)) above
+  static inline FloatVec ALawCompress(FloatVecRead input) {
+    const FloatVec scaled(PlatformVectorMath::Mul(CommonVectorMath::Abs(input),
+                                                  PlatformVectorMath::Fill(kA)));
+    const FloatVec logarithmic(PlatformVectorMath::MulAdd(
+      ApproxVectorMath::Log2(scaled),
+      PlatformVectorMath::Fill(kLn2),
+      PlatformVectorMath::Fill(1.0f)));
+    const FloatVec magnitude(PlatformVectorMath::Mul(
+      PlatformVectorMath::Select(
+        PlatformVectorMath::LessThan(scaled, PlatformVectorMath::Fill(1.0f)),
+        scaled,
+        logarithmic),
+      PlatformVectorMath::Fill(1.0f / kOnePlusLnA)));
+    return CopySign(magnitude, input);
+  }
+
+  /// @brief Element-wise A-law expansion, inverse of ALawCompress()
+  static inline FloatVec ALawExpand(FloatVecRead input) {
+    // |y| (1 + ln(A)), that is A |x| in the linear segment
+    const FloatVec scaled(PlatformVectorMath::Mul(CommonVectorMath::Abs(input),
+                                                  PlatformVectorMath::Fill(
+                                                    kOnePlusLnA)));
+    const FloatVec exponential(ApproxVectorMath::Exp2(PlatformVectorMath::Mul(
+      PlatformVectorMath::Sub(scaled, PlatformVectorMath::Fill(1.0f)),
+      PlatformVectorMath::Fill(1.0f / kLn2))));
+    const FloatVec magnitude(PlatformVectorMath::Mul(
+      PlatformVectorMath::Select(
+        PlatformVectorMath::LessThan(scaled, PlatformVectorMath::Fill(1.0f)),
+        scaled,
+        exponential),
+      PlatformVectorMath::Fill(1.0f / kA)));
+    return CopySign(magnitude, input);
+  }
+
+  /// @brief Block uniform quantization
+  ///
+  /// @param[in]  input   Samples to quantize
+  /// @param[in]  length   Block length
+  /// @param[in]  bits   Code width, within [2 ; 24]
+  /// @param[out]  codes   Quantized samples
+  static inline void Quantize(BlockIn input,
+                              const unsigned int length,
+                              const unsigned int bits,
+                              int* const codes) {
+    VECMATH_PROFILE_KERNEL("Quantize", length, length * 2 * sizeof(float));
+    QuantizeBlock<Identity>(input, length, bits, codes);
+  }
+
+  /// @brief Block uniform dequantization
+  static inline void Dequantize(const int* const codes,
+                                const unsigned int length,
+                                const unsigned int bits,
+                                BlockOut output) {
+    VECMATH_PROFILE_KERNEL("Dequantize", length, length * 2 * sizeof(float));
+    DequantizeBlock<Identity>(codes, length, bits, output);
+  }
+
+  /// @brief Block mu-law quantization
+  static inline void MuLawQuantize(BlockIn input,
+                                   const unsigned int length,
+                                   const unsigned int bits,
+                                   int* const codes) {
+    VECMATH_PROFILE_KERNEL("MuLawQuantize", length, length * 2 * sizeof(float));
+    QuantizeBlock<MuLaw>(input, length, bits, codes);
+  }
+
+  /// @brief Block mu-law dequantization
+  static inline void MuLawDequantize(const int* const codes,
+                                     const unsigned int length,
+                                     const unsigned int bits,
+                                     BlockOut output) {
+    VECMATH_PROFILE_KERNEL("MuLawDequantize", length, length * 2 * sizeof(float));
+    DequantizeBlock<MuLaw>(codes, length, bits, output);
+  }
+
+  /// @brief Block A-law quantization
+  static inline void ALawQuantize(BlockIn input,
+                                  const unsigned int length,
+                                  const unsigned int bits,
+                                  int* const codes) {
+    VECMATH_PROFILE_KERNEL("ALawQuantize", length, length * 2 * sizeof(float));
+    QuantizeBlock<ALaw>(input, length, bits, codes);
+  }
+
+  /// @brief Block A-law dequantization
+  static inline void ALawDequantize(const int* const codes,
+                                    const unsigned int length,
+                                    const unsigned int bits,
+                                    BlockOut output) {
+    VECMATH_PROFILE_KERNEL("ALawDequantize", length, length * 2 * sizeof(float));
+    DequantizeBlock<ALaw>(codes, length, bits, output);
+  }
+
+ private:
+  static constexpr float kMu = 255.0f;
+  /// @brief log2(1 + mu)
+  static constexpr float kLog2OnePlusMu = 8.0f;
+  static constexpr float kA = 87.6f;
+  /// @brief 1 + ln(A)
+  static constexpr float kOnePlusLnA = 5.47278099794235f;
+  static constexpr float kLn2 = 0.693147180559945f;
+
+  struct Identity {
+    static inline FloatVec Compress(FloatVecRead input) {
+      return input;
+    }
+    static inline FloatVec Expand(FloatVecRead input) {
+      return input;
+    }
+  };
+
+  struct MuLaw {
+    static inline FloatVec Compress(FloatVecRead input) {
+      return MuLawCompress(input);
+    }
+    static inline FloatVec Expand(FloatVecRead input) {
+      return MuLawExpand(input);
+    }
+  };
+
+  struct ALaw {
+    static inline FloatVec Compress(FloatVecRead input) {
+      return ALawCompress(input);
+    }
+    static inline FloatVec Expand(FloatVecRead input) {
+      return ALawExpand(input);
+    }
+  };
+
+  /// @brief Magnitude negated where "sign" is negative
+  ///
+  /// Through Select: And/Or are mask operations on some platforms
+  static inline FloatVec CopySign(FloatVecRead magnitude, FloatVecRead sign) {
+    return PlatformVectorMath::Select(
+      PlatformVectorMath::LessThan(sign, PlatformVectorMath::Fill(0.0f)),
+      PlatformVectorMath::Sub(PlatformVectorMath::Fill(0.0f), magnitude),
+      magnitude);
+  }
+
+  template <typename Companding>
+  static inline void QuantizeBlock(BlockIn input,
+                                   const unsigned int length,
+                                   const unsigned int bits,
+                                   int* const codes) {
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    VECMATH_ASSERT(bits >= 2 && bits <= 24);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::StoreInt(
+        &codes[i],
+        Quantize(Companding::Compress(PlatformVectorMath::Fill(&input[i])),
+                 bits));
+    }
+  }
+
+  template <typename Companding>
+  static inline void DequantizeBlock(const int* const codes,
+                                     const unsigned int length,
+                                     const unsigned int bits,
+                                     BlockOut output) {
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    VECMATH_ASSERT(bits >= 2 && bits <= 24);
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(
+        &output[i],
+        Companding::Expand(Dequantize(PlatformVectorMath::FillInt(&codes[i]),
+                                      bits)));
+    }
+  }
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_QUANTIZATION_H_
@@ -0,0 +1,400 @@
+/// @file ramp.h
+/// @brief Click-free parameter ramps, gain ramps and crossfades
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Ramps are generated one FloatVec at a time: the ramp progress of each
+/// element is computed from the number of samples already generated,
+/// then clamped to the ramp end, so that no per-sample branch is required.
+
+#ifndef VECMATH_INC_RAMP_H_
+#define VECMATH_INC_RAMP_H_
+
+#include <algorithm>
+#include <cmath>
+
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+#include "vecmath/inc/polynomial.h"
+
+namespace vecmath {
+
+/// @brief Stateless ramp kernels
+struct RampVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief (1, 2, ..., FloatVecSize) * increment
+  static inline FloatVec Offsets(const float increment) {
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float offsets[PlatformVectorMath::FloatVecSize];
+    for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+      offsets[i] = static_cast<float>(i + 1) * increment;
+    }
+    return PlatformVectorMath::Fill(&offsets[0]);
+  }
+
+  /// @brief sin(pi / 2 * progress), for progress within [0 ; 1]
+  ///
+  /// Maximum error ~1e-7
+  static inline FloatVec QuarterSine(FloatVecRead progress) {
+    return PlatformVectorMath::Mul(
+      progress,
+      Polynomial<QuarterSineCoefficients>::Evaluate(
+        PlatformVectorMath::Mul(progress, progress)));
+  }
+
+  /// @brief Equal-power fade gains: cos(pi / 2 * progress) for the fading
+  /// out signal, sin(pi / 2 * progress) for the fading in one
+  static inline void EqualPowerGains(FloatVecRead progress,
+                                     FloatVec* fade_out,
+                                     FloatVec* fade_in) {
+    *fade_in = QuarterSine(progress);
+    *fade_out = QuarterSine(PlatformVectorMath::Sub(
+      PlatformVectorMath::Fill(1.0f),
+      progress));
+  }
+
+  /// @brief Apply a gain linearly interpolated over the block:
+  /// sample t is multiplied by start + (end - start) * (t + 1) / length
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[out]  output   Aligned output block, may be the input
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  /// @param[in]  start   Gain before the block
+  /// @param[in]  end   Gain reached at the block last sample
+  static inline void ApplyGainRamp(const float* const input,
+                                   float* const output,
+                                   const unsigned int length,
+                                   const float start,
+                                   const float end) {
+    VECMATH_PROFILE_KERNEL("ApplyGainRamp", length, length * 2 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const float increment((end - start) / static_cast<float>(length));
+    const FloatVec offsets(Offsets(increment));
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      const FloatVec gains(PlatformVectorMath::Add(
+        PlatformVectorMath::Fill(start + static_cast<float>(i) * increment),
+        offsets));
+      PlatformVectorMath::Store(
+        &output[i],
+        PlatformVectorMath::Mul(PlatformVectorMath::Fill(&input[i]), gains));
+    }
+  }
+
+  /// @brief Linear crossfade over the block, from "from" to "to"
+  ///
+  /// @param[in]  from   Aligned block fading out
+  /// @param[in]  to   Aligned block fading in
+  /// @param[out]  output   Aligned output block, may be one of the inputs
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  static inline void CrossfadeLinear(const float* const from,
+                                     const float* const to,
+                                     float* const output,
+                                     const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("CrossfadeLinear",
+                           length,
+                           length * 3 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const float increment(1.0f / static_cast<float>(length));
+    const FloatVec offsets(Offsets(increment));
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      const FloatVec progress(PlatformVectorMath::Add(
+        PlatformVectorMath::Fill(static_cast<float>(i) * increment),
+        offsets));
+      const FloatVec fading_out(PlatformVectorMath::Fill(&from[i]));
+      PlatformVectorMath::Store(
+        &output[i],
+        PlatformVectorMath::MulAdd(
+          PlatformVectorMath::Sub(PlatformVectorMath::Fill(&to[i]),
+                                  fading_out),
+          progress,
+          fading_out));
+    }
+  }
+
+  /// @brief Equal-power (constant power for uncorrelated signals)
+  /// crossfade over the block, from "from" to "to"
+  ///
+  /// @param[in]  from   Aligned block fading out
+  /// @param[in]  to   Aligned block fading in
+  /// @param[out]  output   Aligned output block, may be one of the inputs
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  static inline void CrossfadeEqualPower(const float* const from,
+                                         const float* const to,
+                                         float* const output,
+                                         const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("CrossfadeEqualPower",
+                           length,
+                           length * 3 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const float increment(1.0f / static_cast<float>(length));
+    const FloatVec offsets(Offsets(increment));
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      const FloatVec progress(PlatformVectorMath::Add(
+        PlatformVectorMath::Fill(static_cast<float>(i) * increment),
+        offsets));
+      FloatVec fade_out;
+      FloatVec fade_in;
+      EqualPowerGains(progress, &fade_out, &fade_in);
+      PlatformVectorMath::Store(
+        &output[i],
+        PlatformVectorMath::MulAdd(
+          PlatformVectorMath::Fill(&to[i]),
+          fade_in,
+          PlatformVectorMath::Mul(PlatformVectorMath::Fill(&from[i]),
+                                  fade_out)));
+    }
+  }
+
+ private:
+  /// @brief sin(pi / 2 * x) = x * P(x^2), Taylor expansion
+  struct QuarterSineCoefficients {
+    static constexpr float kCoefficients[] = {1.5707963268e+00f,
+                                              -6.4596409751e-01f,
+                                              7.9692626246e-02f,
+                                              -4.6817541353e-03f,
+                                              1.6044118479e-04f,
+                                              -3.5988432352e-06f};
+  };
+};
+
+/// @brief Stateful smoothed parameter: each new target is reached after
+/// the given number of samples, following the chosen shape
+///
+/// - linear: constant increment
+/// - exponential: constant ratio, for gains (perceptually linear);
+///   values must be positive, null ones being approached down to -100dB
+/// - equal power: quarter sine shaped, for fades
+class SmoothedValue {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  enum Shape {
+    kLinear = 0,
+    kExponential,
+    kEqualPower
+  };
+
+  /// @param[in]  shape   Ramps shape
+  /// @param[in]  initial   Initial value
+  explicit SmoothedValue(const Shape shape = kLinear,
+                         const float initial = 0.0f)
+      : shape_(shape),
+        start_(initial),
+        target_(initial),
+        length_(0),
+        done_(0),
+        ratio_(1.0) {
+  }
+
+  /// @brief Start a ramp from the current value to the given target
+  ///
+  /// @param[in]  target   Value to be reached
+  /// @param[in]  length   Ramp length in samples; null for a jump
+  void SetTarget(const float target, const unsigned int length) {
+    if (length == 0) {
+      Jump(target);
+      return;
+    }
+    start_ = Current();
+    target_ = target;
+    length_ = length;
+    done_ = 0;
+    if (shape_ == kExponential) {
+      VECMATH_ASSERT(start_ >= 0.0f && target_ >= 0.0f);
+      ratio_ = std::pow(static_cast<double>(ExponentialValue(target_))
+                        / ExponentialValue(start_),
+                        1.0 / length);
+    }
+  }
+
+  /// @brief Set the value at once, cancelling any ramp
+  void Jump(const float value) {
+    start_ = value;
+    target_ = value;
+    length_ = 0;
+    done_ = 0;
+  }
+
+  /// @brief Last generated value
+  float Current() const {
+    if (!IsSmoothing()) {
+      return target_;
+    }
+    const double progress(static_cast<double>(done_) / length_);
+    switch (shape_) {
+      case kExponential:
+        return static_cast<float>(ExponentialValue(start_)
+                                  * std::pow(ratio_, done_));
+      case kEqualPower:
+        return start_ + (target_ - start_)
+                        * static_cast<float>(std::sin(kHalfPi * progress));
+      default:
+        return start_ + (target_ - start_) * static_cast<float>(progress);
+    }
+  }
+
+  float Target() const {
+    return target_;
+  }
+
+  /// @brief True while the target is not reached
+  bool IsSmoothing() const {
+    return done_ < length_;
+  }
+
+  /// @brief Write the next values
+  ///
+  /// @param[out]  output   Aligned output block
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  void Generate(BlockOut output, const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("SmoothedValue", length, length * sizeof(float));
+    Run(length, [output](const unsigned int i, FloatVecRead values) {
+      PlatformVectorMath::Store(&output[i], values);
+    });
+  }
+
+  /// @brief Multiply the input by the next values
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[out]  output   Aligned output block, may be the input
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  void ApplyGainRamp(const float* const input,
+                     float* const output,
+                     const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("SmoothedGain", length, length * 2 * sizeof(float));
+    Run(length, [input, output](const unsigned int i, FloatVecRead gains) {
+      PlatformVectorMath::Store(
+        &output[i],
+        PlatformVectorMath::Mul(PlatformVectorMath::Fill(&input[i]), gains));
+    });
+  }
+
+ private:
+  static constexpr float kExponentialFloor = 1e-5f;
+  static constexpr double kHalfPi = 1.5707963267948966;
+
+  /// @brief Value clamped to the exponential ramps floor
+  static float ExponentialValue(const float value) {
+    const float floor(kExponentialFloor);
+    return std::max(value, floor);
+  }
+
+  /// @brief Call operation(index, values) for each FloatVec of the block:
+  /// ramping ones first, then constant ones once the target is reached
+  template <typename Operation>
+  void Run(const unsigned int length, Operation operation) {
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    unsigned int i(0);
+    if (IsSmoothing()) {
+      switch (shape_) {
+        case kExponential:
+          i = RunExponential(length, operation);
+          break;
+        case kEqualPower:
+          i = RunProgress<true>(length, operation);
+          break;
+        default:
+          i = RunProgress<false>(length, operation);
+          break;
+      }
+      if (!IsSmoothing()) {
+        Jump(target_);
+      }
+    }
+    const FloatVec target(PlatformVectorMath::Fill(target_));
+    for (; i < length; i += PlatformVectorMath::FloatVecSize) {
+      operation(i, target);
+    }
+  }
+
+  /// @brief Linear or equal-power ramp, computed from its progress
+  ///
+  /// @return Number of samples generated
+  template <bool EqualPower, typename Operation>
+  unsigned int RunProgress(const unsigned int length, Operation operation) {
+    const float increment(1.0f / static_cast<float>(length_));
+    const FloatVec offsets(RampVectorMath::Offsets(increment));
+    const FloatVec one(PlatformVectorMath::Fill(1.0f));
+    const FloatVec start(PlatformVectorMath::Fill(start_));
+    const FloatVec delta(PlatformVectorMath::Fill(target_ - start_));
+    unsigned int i(0);
+    for (; i < length && IsSmoothing(); i += PlatformVectorMath::FloatVecSize) {
+      FloatVec progress(PlatformVectorMath::Min(
+        PlatformVectorMath::Add(
+          PlatformVectorMath::Fill(static_cast<float>(done_) * increment),
+          offsets),
+        one));
+      if (EqualPower) {
+        progress = RampVectorMath::QuarterSine(progress);
+      }
+      operation(i, PlatformVectorMath::MulAdd(delta, progress, start));
+      done_ += PlatformVectorMath::FloatVecSize;
+    }
+    return i;
+  }
+
+  /// @brief Geometric ramp: each FloatVec is the previous last value
+  /// multiplied by (r, r^2, ..., r^FloatVecSize)
+  ///
+  /// @return Number of samples generated
+  template <typename Operation>
+  unsigned int RunExponential(const unsigned int length, Operation operation) {
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float powers[PlatformVectorMath::FloatVecSize];
+    double power(1.0);
+    for (unsigned int j(0); j < PlatformVectorMath::FloatVecSize; ++j) {
+      power *= ratio_;
+      powers[j] = static_cast<float>(power);
+    }
+    const FloatVec ratios(PlatformVectorMath::Fill(&powers[0]));
+    const FloatVec target(PlatformVectorMath::Fill(
+      ExponentialValue(target_)));
+    const bool rising(ratio_ > 1.0);
+    double current(Current());
+    unsigned int i(0);
+    for (; i < length && IsSmoothing(); i += PlatformVectorMath::FloatVecSize) {
+      const FloatVec values(PlatformVectorMath::Mul(
+        PlatformVectorMath::Fill(static_cast<float>(current)),
+        ratios));
+      // Clamp the elements after the ramp end
+      operation(i, rising ? PlatformVectorMath::Min(values, target)
+                          : PlatformVectorMath::Max(values, target));
+      current *= power;
+      done_ += PlatformVectorMath::FloatVecSize;
+    }
+    return i;
+  }
+
+  Shape shape_;
+  float start_;
+  float target_;
+  unsigned int length_;
+  /// @brief Samples generated since the ramp start
+  unsigned int done_;
+  /// @brief Exponential ramps: ratio between consecutive samples
+  double ratio_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_RAMP_H_
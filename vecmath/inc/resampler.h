@@ -0,0 +1,381 @@
+/// @file resampler.h
+/// @brief Arbitrary ratio sample rate converter
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_INC_RESAMPLER_H_
+#define VECMATH_INC_RESAMPLER_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/filter_design.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/interpolation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Streaming sample rate converter, for any ratio
+///
+/// High quality modes use a polyphase Kaiser-windowed sinc filter: each
+/// output is a dot product between the input history and a filter phase,
+/// itself linearly interpolated between two precomputed phases.
+/// The lowpass cutoff follows the ratio when downsampling, at the cost
+/// of proportionally more taps.
+///
+/// Linear and cubic (Catmull-Rom) modes are cheaper and vectorized across
+/// outputs, suited to continuously modulated ratios.
+///
+/// Outputs are time aligned with the input: output[j] matches the input
+/// at time j / ratio. Producing it requires Latency() further input
+/// samples, so that the last outputs are only flushed by feeding that
+/// many zeros.
+///
+/// The input history is allocated once at construction: Process never
+/// allocates, and only takes up to InputAvailable() input samples - at
+/// least max_input_count as long as all outputs are retrieved.
+class Resampler {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  enum Quality {
+    kLinear = 0,
+    kCubic,
+    // Polyphase: 16 taps, 60dB stopband
+    kLow,
+    // Polyphase: 32 taps, 90dB stopband
+    kMedium,
+    // Polyphase: 64 taps, 110dB stopband
+    kHigh,
+    // Polyphase: 128 taps, 120dB stopband
+    kBest
+  };
+
+  /// @param[in]  input_rate   Input sampling rate
+  /// @param[in]  output_rate   Output sampling rate
+  /// @param[in]  max_input_count   Longest input block, see Process
+  /// @param[in]  quality   Interpolation kind, see Quality
+  Resampler(const double input_rate,
+            const double output_rate,
+            const unsigned int max_input_count,
+            const Quality quality = kHigh)
+      : quality_(quality),
+        taps_(0),
+        phases_(0),
+        step_(0),
+        step_fraction_(0.0),
+        start_(0),
+        fraction_(0.0),
+        fill_(0) {
+    VECMATH_ASSERT(input_rate > 0.0);
+    VECMATH_ASSERT(output_rate > 0.0);
+    VECMATH_ASSERT(max_input_count > 0);
+    SetRatio(output_rate / input_rate);
+    if (quality_ == kLinear) {
+      taps_ = 2;
+    } else if (quality_ == kCubic) {
+      taps_ = 4;
+    } else {
+      Design(output_rate / input_rate);
+    }
+    // Less than taps_ samples are kept between calls once all outputs
+    // are retrieved
+    buffer_.resize(taps_ + max_input_count);
+    Reset();
+  }
+
+  /// @brief Clear the input history
+  void Reset() {
+    const unsigned int history(taps_ / 2 - 1);
+    std::fill(buffer_.begin(), buffer_.end(), 0.0f);
+    fill_ = history;
+    start_ = 0;
+    fraction_ = 0.0;
+  }
+
+  /// @brief Change the conversion ratio (output rate / input rate)
+  ///
+  /// Meant for modulation: polyphase modes keep the lowpass cutoff
+  /// designed at construction.
+  void SetRatio(const double ratio) {
+    VECMATH_ASSERT(ratio > 0.0);
+    const double step(1.0 / ratio);
+    step_ = static_cast<unsigned int>(step);
+    step_fraction_ = step - step_;
+  }
+
+  /// @brief Number of input samples required after an output time
+  /// before this output is computed
+  unsigned int Latency() const {
+    return taps_ / 2;
+  }
+
+  /// @brief Filter length, in input samples
+  unsigned int Taps() const {
+    return taps_;
+  }
+
+  /// @brief Maximum number of output samples produced for the given
+  /// input samples count, when all previous outputs were retrieved
+  unsigned int MaxOutputCount(const unsigned int input_count) const {
+    return static_cast<unsigned int>(
+      std::ceil(input_count / (step_ + step_fraction_))) + 1;
+  }
+
+  /// @brief Input samples the next Process call can take
+  ///
+  /// At least max_input_count when all previous outputs were retrieved:
+  /// outputs left for lack of output capacity keep their inputs buffered.
+  unsigned int InputAvailable() const {
+    return static_cast<unsigned int>(buffer_.size()) - fill_;
+  }
+
+  /// @brief Consume the input block, produce as many outputs as possible
+  ///
+  /// Only the first InputAvailable() input samples are taken, which is
+  /// the whole block when input_count <= max_input_count and
+  /// output_capacity >= MaxOutputCount(input_count) on each call.
+  /// Outputs not produced for lack of capacity are kept for the next call.
+  ///
+  /// @param[in]  input   Input block, no alignment requirement
+  /// @param[in]  input_count   Input block length
+  /// @param[out]  output   Output block, no alignment requirement
+  /// @param[in]  output_capacity   Output block maximum length
+  ///
+  /// @return Number of samples written into output
+  unsigned int Process(const float* const input,
+                       const unsigned int input_count,
+                       float* const output,
+                       const unsigned int output_capacity) {
+    VECMATH_PROFILE_KERNEL("Resampler",
+                           input_count,
+                           input_count * 2 * sizeof(float));
+    const unsigned int taken(std::min(input_count, InputAvailable()));
+    std::copy(input, input + taken, buffer_.begin() + fill_);
+    fill_ += taken;
+    unsigned int produced(0);
+    if (quality_ == kLinear) {
+      produced = ProcessInterpolated<LinearKernel>(output, output_capacity);
+    } else if (quality_ == kCubic) {
+      produced = ProcessInterpolated<CubicKernel>(output, output_capacity);
+    } else {
+      produced = ProcessPolyphase(output, output_capacity);
+    }
+    // Discard samples no longer needed
+    const unsigned int consumed(std::min(start_, fill_));
+    std::memmove(&buffer_[0], &buffer_[consumed],
+                 (fill_ - consumed) * sizeof(float));
+    fill_ -= consumed;
+    start_ -= consumed;
+    return produced;
+  }
+
+ private:
+  /// @brief Move to the next output time
+  void Advance() {
+    start_ += step_;
+    fraction_ += step_fraction_;
+    if (fraction_ >= 1.0) {
+      fraction_ -= 1.0;
+      start_ += 1;
+    }
+  }
+
+  /// @brief Compute the polyphase table for the given ratio
+  void Design(const double ratio) {
+    static const unsigned int kBaseTaps[] = {16, 32, 64, 128};
+    static const double kAttenuations[] = {60.0, 90.0, 110.0, 120.0};
+    static const unsigned int kPhases[] = {64, 128, 256, 512};
+    const unsigned int index(quality_ - kLow);
+    const double scale(std::min(1.0, ratio));
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    taps_ = static_cast<unsigned int>(std::ceil(kBaseTaps[index] / scale));
+    taps_ = (taps_ + kVecSize - 1) / kVecSize * kVecSize;
+    phases_ = kPhases[index];
+    const double transition(FilterDesign::KaiserTransition(
+      kAttenuations[index],
+      kBaseTaps[index]));
+    // Stopband starting at the (lowest) Nyquist frequency
+    const double cutoff(scale * (0.5 - 0.5 * transition));
+    const double beta(FilterDesign::KaiserBeta(kAttenuations[index]));
+    const double half_width(0.5 * taps_);
+    const double center(0.5 * taps_ - 1.0);
+    // One more phase (fraction = 1) to interpolate the last one
+    AlignedVector<double> phases((phases_ + 1) * taps_);
+    for (unsigned int phase(0); phase <= phases_; ++phase) {
+      const double fraction(static_cast<double>(phase) / phases_);
+      double sum(0.0);
+      for (unsigned int tap(0); tap < taps_; ++tap) {
+        const double value(FilterDesign::WindowedSinc(tap - center - fraction,
+                                                      cutoff,
+                                                      half_width,
+                                                      beta));
+        phases[phase * taps_ + tap] = value;
+        sum += value;
+      }
+      // Unity DC gain for each phase
+      for (unsigned int tap(0); tap < taps_; ++tap) {
+        phases[phase * taps_ + tap] /= sum;
+      }
+    }
+    // Each phase is stored with its difference to the next one
+    table_.resize(2 * phases_ * taps_);
+    for (unsigned int phase(0); phase < phases_; ++phase) {
+      for (unsigned int tap(0); tap < taps_; ++tap) {
+        const double current(phases[phase * taps_ + tap]);
+        const double next(phases[(phase + 1) * taps_ + tap]);
+        table_[2 * phase * taps_ + tap] = static_cast<float>(current);
+        table_[(2 * phase + 1) * taps_ + tap] =
+          static_cast<float>(next - current);
+      }
+    }
+  }
+
+  unsigned int ProcessPolyphase(float* const output,
+                                const unsigned int output_capacity) {
+    unsigned int produced(0);
+    while (produced < output_capacity) {
+      if (start_ + taps_ > fill_) {
+        break;
+      }
+      const double phase_position(fraction_ * phases_);
+      const unsigned int phase(static_cast<unsigned int>(phase_position));
+      const FloatVec fraction(PlatformVectorMath::Fill(
+        static_cast<float>(phase_position - phase)));
+      const float* const coefficients(&table_[2 * phase * taps_]);
+      const float* const differences(coefficients + taps_);
+      const float* const samples(&buffer_[start_]);
+      // Phases interpolation applied on the dot products rather than on
+      // the coefficients: two independent accumulations
+      FloatVec sum(PlatformVectorMath::Fill(0.0f));
+      FloatVec difference_sum(PlatformVectorMath::Fill(0.0f));
+      for (unsigned int tap(0);
+           tap < taps_;
+           tap += PlatformVectorMath::FloatVecSize) {
+        const FloatVec input(PlatformVectorMath::FillUnaligned(&samples[tap]));
+        sum = PlatformVectorMath::MulAdd(
+          input,
+          PlatformVectorMath::Fill(&coefficients[tap]),
+          sum);
+        difference_sum = PlatformVectorMath::MulAdd(
+          input,
+          PlatformVectorMath::Fill(&differences[tap]),
+          difference_sum);
+      }
+      output[produced] = PlatformVectorMath::AddHorizontal(
+        PlatformVectorMath::MulAdd(difference_sum, fraction, sum));
+      produced += 1;
+      Advance();
+    }
+    return produced;
+  }
+
+  /// @brief Linear interpolation between the two samples
+  struct LinearKernel {
+    static inline FloatVec Apply(const FloatVec* samples,
+                                 FloatVecRead fraction) {
+      return InterpolationVectorMath::Linear(samples[0], samples[1], fraction);
+    }
+  };
+
+  /// @brief Catmull-Rom interpolation between the second and third samples
+  struct CubicKernel {
+    static inline FloatVec Apply(const FloatVec* samples,
+                                 FloatVecRead fraction) {
+      return InterpolationVectorMath::CatmullRom(samples, fraction);
+    }
+  };
+
+  /// @brief Compute FloatVecSize outputs at once, gathering the
+  /// samples around each output position
+  template <typename Kernel>
+  unsigned int ProcessInterpolated(float* const output,
+                                   const unsigned int output_capacity) {
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float gathered[4][PlatformVectorMath::FloatVecSize] = {};
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float fractions[PlatformVectorMath::FloatVecSize] = {};
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float results[PlatformVectorMath::FloatVecSize];
+    unsigned int produced(0);
+    while (produced < output_capacity) {
+      unsigned int count(0);
+      for (; count < kVecSize && produced + count < output_capacity; ++count) {
+        if (start_ + taps_ > fill_) {
+          break;
+        }
+        for (unsigned int tap(0); tap < taps_; ++tap) {
+          gathered[tap][count] = buffer_[start_ + tap];
+        }
+        fractions[count] = static_cast<float>(fraction_);
+        Advance();
+      }
+      if (count == 0) {
+        break;
+      }
+      // Unused lanes are computed on leftovers and discarded
+      FloatVec samples[4];
+      for (unsigned int tap(0); tap < 4; ++tap) {
+        samples[tap] = PlatformVectorMath::Fill(&gathered[tap][0]);
+      }
+      const FloatVec fraction(PlatformVectorMath::Fill(&fractions[0]));
+      if (count == kVecSize) {
+        PlatformVectorMath::StoreUnaligned(&output[produced],
+                                           Kernel::Apply(&samples[0],
+                                                         fraction));
+      } else {
+        PlatformVectorMath::Store(&results[0],
+                                  Kernel::Apply(&samples[0], fraction));
+        std::copy(results, results + count, &output[produced]);
+      }
+      produced += count;
+      if (count < kVecSize) {
+        break;
+      }
+    }
+    return produced;
+  }
+
+  Quality quality_;
+  unsigned int taps_;
+  unsigned int phases_;
+  /// @brief Input samples between two outputs: integral part
+  unsigned int step_;
+  /// @brief Input samples between two outputs: fractional part
+  double step_fraction_;
+  /// @brief Next output time, relative to the buffer start: integral part,
+  /// kept apart so that the fractional part does not depend on
+  /// how the input is split into blocks
+  unsigned int start_;
+  /// @brief Next output time: fractional part
+  double fraction_;
+  unsigned int fill_;
+  AlignedVector<float> table_;
+  AlignedVector<float> buffer_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_RESAMPLER_H_
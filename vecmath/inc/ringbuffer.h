@@ -0,0 +1,345 @@
+/// @file ringbuffer.h
+/// @brief Lock-free ring buffers of aligned FloatVec blocks
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Buffers meant to hand audio between a real-time thread and workers.
+/// All lengths are in floats and multiples of FloatVecSize, so that any
+/// region returned starts on a FloatVec boundary: Fill(const float*) and
+/// Store(float*) can be used directly on it.
+
+#ifndef VECMATH_INC_RINGBUFFER_H_
+#define VECMATH_INC_RINGBUFFER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Copy an aligned block, FloatVec per FloatVec
+inline void CopyBlock(BlockIn input, BlockOut output, const unsigned int length) {
+  VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+  for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+    PlatformVectorMath::Store(&output[i], PlatformVectorMath::Fill(&input[i]));
+  }
+}
+
+/// @brief Up to two contiguous parts of a ring buffer, "first" coming first
+///
+/// Both are aligned, their lengths being multiples of FloatVecSize
+template <typename Type>
+struct RingRegion {
+  Type* first;
+  unsigned int first_length;
+  Type* second;
+  unsigned int second_length;
+
+  unsigned int Length() const {
+    return first_length + second_length;
+  }
+};
+
+/// @brief Wait-free single producer, single consumer ring buffer
+///
+/// One thread only may call the Write functions, one thread only the Read
+/// ones. Typical zero-copy usage on the producer side:
+///   RingBuffer::WriteRegion region(buffer.BeginWrite());
+///   ... fill region.first, then region.second ...
+///   buffer.CommitWrite(written);
+class RingBuffer {
+ public:
+  typedef RingRegion<float> WriteRegion;
+  typedef RingRegion<const float> ReadRegion;
+
+  /// @brief Constructor
+  ///
+  /// @param[in]  vector_capacity   Capacity in FloatVecs,
+  /// rounded up to a power of two
+  explicit RingBuffer(const unsigned int vector_capacity)
+      : capacity_(PowerOfTwoAbove(vector_capacity)
+                  * PlatformVectorMath::FloatVecSize),
+        mask_(capacity_ - 1),
+        storage_(capacity_, 0.0f) {
+    Reset();
+  }
+
+  /// @brief Capacity, in floats
+  unsigned int Capacity() const {
+    return capacity_;
+  }
+
+  /// @brief Empty the buffer - neither side may be running
+  void Reset() {
+    write_index_.store(0, std::memory_order_relaxed);
+    read_index_.store(0, std::memory_order_relaxed);
+    cached_read_index_ = 0;
+    cached_write_index_ = 0;
+  }
+
+  /// @brief Floats which can be written (producer side)
+  unsigned int WriteAvailable() {
+    const unsigned int write(write_index_.load(std::memory_order_relaxed));
+    if (capacity_ - (write - cached_read_index_) == 0) {
+      cached_read_index_ = read_index_.load(std::memory_order_acquire);
+    }
+    return capacity_ - (write - cached_read_index_);
+  }
+
+  /// @brief Floats which can be read (consumer side)
+  unsigned int ReadAvailable() {
+    const unsigned int read(read_index_.load(std::memory_order_relaxed));
+    if (cached_write_index_ == read) {
+      cached_write_index_ = write_index_.load(std::memory_order_acquire);
+    }
+    return cached_write_index_ - read;
+  }
+
+  /// @brief All the writable space, without copy
+  WriteRegion BeginWrite() {
+    // Always refresh: the whole free space is requested
+    cached_read_index_ = read_index_.load(std::memory_order_acquire);
+    const unsigned int write(write_index_.load(std::memory_order_relaxed));
+    const unsigned int available(capacity_ - (write - cached_read_index_));
+    return MakeRegion<float>(&storage_[0], write & mask_, available);
+  }
+
+  /// @brief Publish "length" floats written into the BeginWrite() region
+  void CommitWrite(const unsigned int length) {
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int write(write_index_.load(std::memory_order_relaxed));
+    VECMATH_ASSERT(length <= capacity_ - (write - cached_read_index_));
+    write_index_.store(write + length, std::memory_order_release);
+  }
+
+  /// @brief All the readable data, without copy
+  ReadRegion BeginRead() {
+    cached_write_index_ = write_index_.load(std::memory_order_acquire);
+    const unsigned int read(read_index_.load(std::memory_order_relaxed));
+    return MakeRegion<const float>(&storage_[0],
+                                   read & mask_,
+                                   cached_write_index_ - read);
+  }
+
+  /// @brief Release "length" floats read from the BeginRead() region
+  void CommitRead(const unsigned int length) {
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int read(read_index_.load(std::memory_order_relaxed));
+    VECMATH_ASSERT(length <= cached_write_index_ - read);
+    read_index_.store(read + length, std::memory_order_release);
+  }
+
+  /// @brief Copy as much of the input as fits, return the written length
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  unsigned int Write(BlockIn input, const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("RingBufferWrite", length, length * 2 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const WriteRegion region(BeginWrite());
+    const unsigned int first(std::min(length, region.first_length));
+    const unsigned int second(std::min(length - first, region.second_length));
+    CopyBlock(input, region.first, first);
+    CopyBlock(&input[first], region.second, second);
+    CommitWrite(first + second);
+    return first + second;
+  }
+
+  /// @brief Copy up to "length" floats out, return the read length
+  ///
+  /// @param[out]  output   Aligned output block
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  unsigned int Read(BlockOut output, const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("RingBufferRead", length, length * 2 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const ReadRegion region(BeginRead());
+    const unsigned int first(std::min(length, region.first_length));
+    const unsigned int second(std::min(length - first, region.second_length));
+    CopyBlock(region.first, output, first);
+    CopyBlock(region.second, &output[first], second);
+    CommitRead(first + second);
+    return first + second;
+  }
+
+ private:
+  /// @brief Split "length" floats starting at "offset" around the buffer end
+  template <typename Type>
+  RingRegion<Type> MakeRegion(Type* const data,
+                              const unsigned int offset,
+                              const unsigned int length) const {
+    const unsigned int first_length(std::min(length, capacity_ - offset));
+    const RingRegion<Type> region = {
+      &data[offset], first_length, data, length - first_length
+    };
+    return region;
+  }
+
+  // Indices are free-running counters of floats, wrapped on access:
+  // the capacity being a power of two, they may overflow safely.
+  // Each side is kept on its own cache line
+  const unsigned int capacity_;
+  const unsigned int mask_;
+  AlignedVector<float> storage_;
+  char padding_[kDefaultAlignment];
+  // Producer side
+  std::atomic<unsigned int> write_index_;
+  unsigned int cached_read_index_;
+  char write_padding_[kDefaultAlignment];
+  // Consumer side
+  std::atomic<unsigned int> read_index_;
+  unsigned int cached_write_index_;
+  char read_padding_[kDefaultAlignment];
+};
+
+/// @brief Lock-free multiple producers, single consumer queue of
+/// fixed-length aligned blocks
+///
+/// Each slot carries a sequence number telling whether it is free or ready,
+/// producers claim slots with a compare-and-swap: a stalled producer never
+/// blocks the others, only the consumer (waiting for this very slot).
+class MpscRingBuffer {
+ public:
+  /// @brief Constructor
+  ///
+  /// @param[in]  block_length   Length of each block in floats,
+  /// multiple of FloatVecSize
+  /// @param[in]  block_count   Number of blocks, rounded up to a power of two
+  MpscRingBuffer(const unsigned int block_length,
+                 const unsigned int block_count)
+      : block_length_(block_length),
+        block_count_(PowerOfTwoAbove(block_count)),
+        storage_(block_length_ * block_count_, 0.0f),
+        sequences_(block_count_) {
+    VECMATH_ASSERT(block_length % PlatformVectorMath::FloatVecSize == 0);
+    Reset();
+  }
+
+  /// @brief Empty the buffer - neither side may be running
+  void Reset() {
+    for (unsigned int i(0); i < block_count_; ++i) {
+      sequences_[i].store(i, std::memory_order_relaxed);
+    }
+    enqueue_position_.store(0, std::memory_order_relaxed);
+    dequeue_position_ = 0;
+  }
+
+  unsigned int BlockLength() const {
+    return block_length_;
+  }
+
+  unsigned int BlockCount() const {
+    return block_count_;
+  }
+
+  /// @brief Claim a free block and let "writer" fill it in place (zero-copy)
+  ///
+  /// @param[in]  writer   Called as writer(BlockOut) on the aligned block
+  /// @return false if the buffer is full (writer not called)
+  template <typename Writer>
+  bool Push(Writer writer) {
+    unsigned int position(enqueue_position_.load(std::memory_order_relaxed));
+    for (;;) {
+      const unsigned int sequence(
+        sequences_[position & (block_count_ - 1)].load(
+          std::memory_order_acquire));
+      const int difference(static_cast<int>(sequence - position));
+      if (difference == 0) {
+        // On failure "position" is updated to the current value
+        if (enqueue_position_.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        // Slot not consumed yet since the previous lap
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+    const unsigned int slot(position & (block_count_ - 1));
+    writer(&storage_[slot * block_length_]);
+    sequences_[slot].store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief Copy a whole aligned block into the buffer
+  ///
+  /// @return false if the buffer is full
+  bool Push(BlockIn input) {
+    const unsigned int length(block_length_);
+    return Push([input, length](BlockOut block) {
+      CopyBlock(input, block, length);
+    });
+  }
+
+  /// @brief The oldest ready block, or nullptr (consumer side, zero-copy)
+  const float* Front() const {
+    const unsigned int slot(dequeue_position_ & (block_count_ - 1));
+    const unsigned int sequence(
+      sequences_[slot].load(std::memory_order_acquire));
+    return sequence == dequeue_position_ + 1
+      ? &storage_[slot * block_length_]
+      : nullptr;
+  }
+
+  /// @brief Release the block returned by Front()
+  void Pop() {
+    const unsigned int slot(dequeue_position_ & (block_count_ - 1));
+    VECMATH_ASSERT(sequences_[slot].load(std::memory_order_relaxed)
+                   == dequeue_position_ + 1);
+    sequences_[slot].store(dequeue_position_ + block_count_,
+                           std::memory_order_release);
+    dequeue_position_ += 1;
+  }
+
+  /// @brief Copy the oldest ready block out
+  ///
+  /// @return false if no block is ready
+  bool Pop(BlockOut output) {
+    const float* const block(Front());
+    if (block == nullptr) {
+      return false;
+    }
+    CopyBlock(block, output, block_length_);
+    Pop();
+    return true;
+  }
+
+ private:
+  const unsigned int block_length_;
+  const unsigned int block_count_;
+  AlignedVector<float> storage_;
+  std::vector<std::atomic<unsigned int> > sequences_;
+  char padding_[kDefaultAlignment];
+  // Contended by the producers
+  std::atomic<unsigned int> enqueue_position_;
+  char enqueue_padding_[kDefaultAlignment];
+  // Consumer only
+  unsigned int dequeue_position_;
+  char dequeue_padding_[kDefaultAlignment];
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_RINGBUFFER_H_
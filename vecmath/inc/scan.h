@@ -0,0 +1,247 @@
+/// @file scan.h
+/// @brief Prefix scans, cumulative sums and moving average
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#ifndef VECMATH_INC_SCAN_H_
+#define VECMATH_INC_SCAN_H_
+
+#include <algorithm>
+#include <limits>
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief In-register prefix scans and block cumulative sums
+///
+/// Scans are computed in log2(FloatVecSize) shift-and-combine steps
+struct ScanVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+
+  /// @brief Inclusive prefix sum
+  ///
+  /// Given (x0, x1, x2, x3)
+  /// return (x0, x0 + x1, x0 + x1 + x2, x0 + x1 + x2 + x3)
+  static inline FloatVec PrefixSum(FloatVecRead input) {
+    return ScanSteps<AddOperation, 1>::Apply(input, 0.0f);
+  }
+
+  /// @brief Exclusive prefix sum
+  ///
+  /// Given (x0, x1, x2, x3)
+  /// return (0, x0, x0 + x1, x0 + x1 + x2)
+  static inline FloatVec PrefixSumExclusive(FloatVecRead input) {
+    return PlatformVectorMath::ShiftOnRight<1>(PrefixSum(input), 0.0f);
+  }
+
+  /// @brief Inclusive prefix maximum
+  ///
+  /// Given (x0, x1, x2, x3)
+  /// return (x0, max(x0, x1), max(x0, x1, x2), max(x0, x1, x2, x3))
+  static inline FloatVec PrefixMax(FloatVecRead input) {
+    return ScanSteps<MaxOperation, 1>::Apply(
+      input,
+      std::numeric_limits<float>::lowest());
+  }
+
+  /// @brief Inclusive prefix minimum
+  ///
+  /// Given (x0, x1, x2, x3)
+  /// return (x0, min(x0, x1), min(x0, x1, x2), min(x0, x1, x2, x3))
+  static inline FloatVec PrefixMin(FloatVecRead input) {
+    return ScanSteps<MinOperation, 1>::Apply(
+      input,
+      std::numeric_limits<float>::max());
+  }
+
+  /// @brief Broadcast the last element of the input to all elements
+  static inline FloatVec FillWithLast(FloatVecRead input) {
+    return PlatformVectorMath::Fill(
+      PlatformVectorMath::GetByIndex<PlatformVectorMath::FloatVecSize - 1>(
+        input));
+  }
+
+  /// @brief Cumulative sum over a whole block, carrying the running total
+  /// from one FloatVec to the next
+  ///
+  /// output[i] = carry + input[0] + ... + input[i]
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[out]  output   Aligned output block
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  /// @param[in]  carry   Running total before this block
+  ///
+  /// @return the running total after this block, to be given as the carry
+  /// of the next one
+  static inline float CumulativeSum(BlockIn input,
+                                    BlockOut output,
+                                    const unsigned int length,
+                                    const float carry = 0.0f) {
+    VECMATH_PROFILE_KERNEL("CumulativeSum", length, length * 2 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    FloatVec total(PlatformVectorMath::Fill(carry));
+    for (unsigned int i(0); i < length; i += PlatformVectorMath::FloatVecSize) {
+      const FloatVec sum(PlatformVectorMath::Add(
+        PrefixSum(PlatformVectorMath::Fill(&input[i])),
+        total));
+      PlatformVectorMath::Store(&output[i], sum);
+      total = FillWithLast(sum);
+    }
+    return PlatformVectorMath::GetByIndex<0>(total);
+  }
+
+ private:
+  struct AddOperation {
+    static inline FloatVec Apply(FloatVecRead left, FloatVecRead right) {
+      return PlatformVectorMath::Add(left, right);
+    }
+  };
+
+  struct MaxOperation {
+    static inline FloatVec Apply(FloatVecRead left, FloatVecRead right) {
+      return PlatformVectorMath::Max(left, right);
+    }
+  };
+
+  struct MinOperation {
+    static inline FloatVec Apply(FloatVecRead left, FloatVecRead right) {
+      return PlatformVectorMath::Min(left, right);
+    }
+  };
+
+  /// @brief Combine each element with the one Count elements before,
+  /// then recurse with twice the shift
+  template <typename TypeOperation,
+            unsigned Count,
+            bool Done = (Count >= PlatformVectorMath::FloatVecSize)>
+  struct ScanSteps {
+    static inline FloatVec Apply(FloatVecRead input, const float identity) {
+      return ScanSteps<TypeOperation, Count * 2>::Apply(
+        TypeOperation::Apply(
+          input,
+          PlatformVectorMath::ShiftOnRight<Count>(input, identity)),
+        identity);
+    }
+  };
+
+  template <typename TypeOperation, unsigned Count>
+  struct ScanSteps<TypeOperation, Count, true> {
+    static inline FloatVec Apply(FloatVecRead input, const float /*identity*/) {
+      return input;
+    }
+  };
+};
+
+/// @brief Moving average (boxcar filter) over the last "length" samples
+///
+/// O(1) per sample whatever the window length: the window sum is updated
+/// with the difference between incoming and outgoing samples, through a
+/// cumulative sum. It is recomputed from scratch once per window length,
+/// so that rounding errors do not accumulate.
+class MovingAverage {
+ public:
+  typedef PlatformVectorMath::FloatVec FloatVec;
+
+  /// @param[in]  length   Window length, in samples
+  explicit MovingAverage(const unsigned int length)
+      : history_(length, 0.0f),
+        position_(0),
+        since_resync_(0),
+        sum_(0.0f),
+        normalization_(1.0f / static_cast<float>(length)) {
+    VECMATH_ASSERT(length > 0);
+  }
+
+  /// @brief Clear the history: previous samples are considered null
+  void Reset() {
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    position_ = 0;
+    since_resync_ = 0;
+    sum_ = 0.0f;
+  }
+
+  /// @brief Window length, in samples
+  unsigned int Length() const {
+    return static_cast<unsigned int>(history_.size());
+  }
+
+  /// @brief Process a whole block: output[i] is the mean of the last
+  /// "length" input samples up to input[i]
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[out]  output   Aligned output block
+  /// @param[in]  count   Block length, multiple of FloatVecSize
+  void Process(BlockIn input, BlockOut output, const unsigned int count) {
+    VECMATH_PROFILE_KERNEL("MovingAverage", count, count * 3 * sizeof(float));
+    VECMATH_ASSERT(count % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int length(Length());
+    const FloatVec normalization(PlatformVectorMath::Fill(normalization_));
+    FloatVec total(PlatformVectorMath::Fill(sum_));
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float outgoing[PlatformVectorMath::FloatVecSize];
+    for (unsigned int i(0); i < count; i += PlatformVectorMath::FloatVecSize) {
+      // Swap incoming samples with the ones leaving the window
+      for (unsigned int j(0); j < PlatformVectorMath::FloatVecSize; ++j) {
+        outgoing[j] = history_[position_];
+        history_[position_] = input[i + j];
+        position_ = position_ + 1 < length ? position_ + 1 : 0;
+      }
+      const FloatVec difference(PlatformVectorMath::Sub(
+        PlatformVectorMath::Fill(&input[i]),
+        PlatformVectorMath::Fill(&outgoing[0])));
+      const FloatVec sum(PlatformVectorMath::Add(
+        ScanVectorMath::PrefixSum(difference),
+        total));
+      PlatformVectorMath::Store(&output[i],
+                                PlatformVectorMath::Mul(sum, normalization));
+      total = ScanVectorMath::FillWithLast(sum);
+    }
+    sum_ = PlatformVectorMath::GetByIndex<0>(total);
+    since_resync_ += count;
+    if (since_resync_ >= length) {
+      Resync();
+    }
+  }
+
+ private:
+  /// @brief Recompute the window sum from the history
+  void Resync() {
+    double sum(0.0);
+    for (float value : history_) {
+      sum += value;
+    }
+    sum_ = static_cast<float>(sum);
+    since_resync_ = 0;
+  }
+
+  AlignedVector<float> history_;
+  unsigned int position_;
+  unsigned int since_resync_;
+  float sum_;
+  float normalization_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_SCAN_H_
@@ -0,0 +1,232 @@
+/// @file validation.h
+/// @brief Block health checks: non-finite and denormal scans, comparisons
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// Inner loops process kUnroll FloatVecs per iteration with independent
+/// accumulators, and checks exit on the first iteration settling the result.
+/// Non-finite and denormal values are detected on the bits, so that the
+/// checks hold whatever the floating point compiler flags.
+
+#ifndef VECMATH_INC_VALIDATION_H_
+#define VECMATH_INC_VALIDATION_H_
+
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+
+namespace vecmath {
+
+/// @brief Stateless block checks
+///
+/// All blocks are aligned, their length being a multiple of FloatVecSize
+struct ValidationVectorMath {
+  typedef PlatformVectorMath::FloatVec FloatVec;
+  typedef PlatformVectorMath::FloatVecRead FloatVecRead;
+  typedef PlatformVectorMath::IntVec IntVec;
+
+  /// @brief FloatVecs processed per inner loop iteration
+  static constexpr unsigned int kUnroll = 4;
+  static_assert(kUnroll == 4, "Inner loops are unrolled by hand");
+  /// @brief FloatVecs processed per CountDenormals iteration, no early exit
+  /// there to limit it
+  static constexpr unsigned int kCountUnroll = 2 * kUnroll;
+
+  /// @brief True if any sample is infinite or NaN
+  static inline bool ContainsNonFinite(BlockIn input,
+                                       const unsigned int length) {
+    return FirstNonFiniteIndex(input, length) != length;
+  }
+
+  /// @brief Index of the first infinite or NaN sample, "length" if none
+  static inline unsigned int FirstNonFiniteIndex(BlockIn input,
+                                                 const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("FirstNonFiniteIndex", length, length * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    unsigned int i(0);
+    for (; i + kUnroll * kVecSize <= length; i += kUnroll * kVecSize) {
+      const FloatVec found(PlatformVectorMath::Or(
+        PlatformVectorMath::Or(
+          PlatformVectorMath::IsNonFinite(PlatformVectorMath::Fill(&input[i])),
+          PlatformVectorMath::IsNonFinite(
+            PlatformVectorMath::Fill(&input[i + kVecSize]))),
+        PlatformVectorMath::Or(
+          PlatformVectorMath::IsNonFinite(
+            PlatformVectorMath::Fill(&input[i + 2 * kVecSize])),
+          PlatformVectorMath::IsNonFinite(
+            PlatformVectorMath::Fill(&input[i + 3 * kVecSize])))));
+      if (!PlatformVectorMath::IsMaskNull(found)) {
+        // Located below
+        break;
+      }
+    }
+    for (; i < length; i += kVecSize) {
+      const unsigned int bits(PlatformVectorMath::MoveMask(
+        PlatformVectorMath::IsNonFinite(PlatformVectorMath::Fill(&input[i]))));
+      if (bits != 0) {
+        return i + LowestBitIndex(bits);
+      }
+    }
+    return length;
+  }
+
+  /// @brief Number of denormal samples
+  ///
+  /// Masks are accumulated as integers (a set lane being -1), over
+  /// kCountUnroll FloatVecs per iteration: the loop is bound by loads and
+  /// bit tests only.
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  static inline unsigned int CountDenormals(BlockIn input,
+                                            const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("CountDenormals", length, length * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    IntVec counts[kUnroll];
+    for (unsigned int j(0); j < kUnroll; ++j) {
+      counts[j] = PlatformVectorMath::TruncToInt(PlatformVectorMath::Fill(0.0f));
+    }
+    unsigned int i(0);
+    for (; i + kCountUnroll * kVecSize <= length;
+         i += kCountUnroll * kVecSize) {
+      for (unsigned int j(0); j < kCountUnroll; ++j) {
+        counts[j % kUnroll] = PlatformVectorMath::CountMask(
+          counts[j % kUnroll],
+          PlatformVectorMath::IsDenormal(
+            PlatformVectorMath::Fill(&input[i + j * kVecSize])));
+      }
+    }
+    for (; i < length; i += kVecSize) {
+      counts[0] = PlatformVectorMath::CountMask(
+        counts[0],
+        PlatformVectorMath::IsDenormal(PlatformVectorMath::Fill(&input[i])));
+    }
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      int elements[kUnroll][PlatformVectorMath::FloatVecSize];
+    unsigned int count(0);
+    for (unsigned int j(0); j < kUnroll; ++j) {
+      PlatformVectorMath::StoreInt(&elements[j][0], counts[j]);
+      for (unsigned int k(0); k < kVecSize; ++k) {
+        count += static_cast<unsigned int>(elements[j][k]);
+      }
+    }
+    return count;
+  }
+
+  /// @brief True if all samples differ by no more than the tolerance
+  /// (any NaN makes the blocks differ)
+  static inline bool AllNear(BlockIn left,
+                             BlockIn right,
+                             const unsigned int length,
+                             const float tolerance) {
+    VECMATH_PROFILE_KERNEL("AllNear", length, length * 2 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    const FloatVec threshold(PlatformVectorMath::Fill(tolerance));
+    unsigned int i(0);
+    for (; i + kUnroll * kVecSize <= length; i += kUnroll * kVecSize) {
+      const FloatVec near(PlatformVectorMath::And(
+        PlatformVectorMath::And(
+          IsNear(&left[i], &right[i], threshold),
+          IsNear(&left[i + kVecSize], &right[i + kVecSize], threshold)),
+        PlatformVectorMath::And(
+          IsNear(&left[i + 2 * kVecSize], &right[i + 2 * kVecSize], threshold),
+          IsNear(&left[i + 3 * kVecSize], &right[i + 3 * kVecSize],
+                 threshold))));
+      if (!PlatformVectorMath::IsMaskFull(near)) {
+        return false;
+      }
+    }
+    for (; i < length; i += kVecSize) {
+      if (!PlatformVectorMath::IsMaskFull(
+            IsNear(&left[i], &right[i], threshold))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// @brief Largest absolute difference between the blocks samples
+  /// (supposed finite)
+  static inline float MaxAbsDifference(BlockIn left,
+                                       BlockIn right,
+                                       const unsigned int length) {
+    VECMATH_PROFILE_KERNEL("MaxAbsDifference", length, length * 2 * sizeof(float));
+    VECMATH_ASSERT(length % PlatformVectorMath::FloatVecSize == 0);
+    const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+    FloatVec maxima[kUnroll];
+    for (unsigned int j(0); j < kUnroll; ++j) {
+      maxima[j] = PlatformVectorMath::Fill(0.0f);
+    }
+    unsigned int i(0);
+    for (; i + kUnroll * kVecSize <= length; i += kUnroll * kVecSize) {
+      for (unsigned int j(0); j < kUnroll; ++j) {
+        maxima[j] = PlatformVectorMath::Max(
+          maxima[j],
+          AbsDifference(&left[i + j * kVecSize], &right[i + j * kVecSize]));
+      }
+    }
+    for (; i < length; i += kVecSize) {
+      maxima[0] = PlatformVectorMath::Max(maxima[0],
+                                          AbsDifference(&left[i], &right[i]));
+    }
+    alignas(PlatformVectorMath::FloatVecSizeBytes)
+      float elements[PlatformVectorMath::FloatVecSize];
+    PlatformVectorMath::Store(
+      &elements[0],
+      PlatformVectorMath::Max(PlatformVectorMath::Max(maxima[0], maxima[1]),
+                              PlatformVectorMath::Max(maxima[2], maxima[3])));
+    float result(elements[0]);
+    for (unsigned int j(1); j < kVecSize; ++j) {
+      result = result > elements[j] ? result : elements[j];
+    }
+    return result;
+  }
+
+ private:
+  static inline FloatVec AbsDifference(const float* const left,
+                                       const float* const right) {
+    return CommonVectorMath::Abs(PlatformVectorMath::Sub(
+      PlatformVectorMath::Fill(left),
+      PlatformVectorMath::Fill(right)));
+  }
+
+  /// @brief Mask set where |left - right| <= threshold
+  static inline FloatVec IsNear(const float* const left,
+                                const float* const right,
+                                FloatVecRead threshold) {
+    return PlatformVectorMath::GreaterEqual(threshold,
+                                            AbsDifference(left, right));
+  }
+
+  /// @brief Index of the lowest bit set (bits != 0)
+  static inline unsigned int LowestBitIndex(const unsigned int bits) {
+    unsigned int index(0);
+    while (((bits >> index) & 1) == 0) {
+      ++index;
+    }
+    return index;
+  }
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_VALIDATION_H_
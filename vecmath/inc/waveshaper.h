@@ -0,0 +1,164 @@
+/// @file waveshaper.h
+/// @brief Oversampled waveshaping
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+///
+/// A waveshaper upsamples the block, applies a memoryless shaper (hard or
+/// soft clipping, tanh, or a user polynomial) FloatVecSize samples at once
+/// at the oversampled rate, then decimates it back: harmonics above the
+/// original Nyquist frequency are filtered out instead of aliasing.
+
+#ifndef VECMATH_INC_WAVESHAPER_H_
+#define VECMATH_INC_WAVESHAPER_H_
+
+#include "vecmath/inc/approximations.h"
+#include "vecmath/inc/common.h"
+#include "vecmath/inc/instrumentation.h"
+#include "vecmath/inc/maths.h"
+#include "vecmath/inc/oversampling.h"
+#include "vecmath/inc/polynomial.h"
+
+namespace vecmath {
+
+/// @brief Clip to [-1 ; 1]
+struct HardClipShaper {
+  static inline PlatformVectorMath::FloatVec Apply(
+      PlatformVectorMath::FloatVecRead input) {
+    return CommonVectorMath::Clamp(input,
+                                   PlatformVectorMath::Fill(-1.0f),
+                                   PlatformVectorMath::Fill(1.0f));
+  }
+};
+
+/// @brief Cubic soft clipping: 3/2 x - 1/2 x^3 within [-1 ; 1],
+/// saturating to +/-1 with a null derivative
+struct SoftClipShaper {
+  static inline PlatformVectorMath::FloatVec Apply(
+      PlatformVectorMath::FloatVecRead input) {
+    const PlatformVectorMath::FloatVec clipped(HardClipShaper::Apply(input));
+    return PlatformVectorMath::Mul(
+      clipped,
+      PlatformVectorMath::Sub(
+        PlatformVectorMath::Fill(1.5f),
+        PlatformVectorMath::Mul(PlatformVectorMath::Fill(0.5f),
+                                PlatformVectorMath::Mul(clipped, clipped))));
+  }
+};
+
+/// @brief Hyperbolic tangent, absolute error below 1e-6
+struct TanhShaper {
+  static inline PlatformVectorMath::FloatVec Apply(
+      PlatformVectorMath::FloatVecRead input) {
+    // tanh(|x|) = (1 - e^(-2|x|)) / (1 + e^(-2|x|)), 1.0f beyond 9
+    const PlatformVectorMath::FloatVec exponential(ApproxVectorMath::Exp2(
+      PlatformVectorMath::Mul(
+        PlatformVectorMath::Min(CommonVectorMath::Abs(input),
+                                PlatformVectorMath::Fill(9.0f)),
+        PlatformVectorMath::Fill(-2.0f * 1.44269504088896f))));
+    const PlatformVectorMath::FloatVec magnitude(PlatformVectorMath::Div(
+      PlatformVectorMath::Sub(PlatformVectorMath::Fill(1.0f), exponential),
+      PlatformVectorMath::Add(PlatformVectorMath::Fill(1.0f), exponential)));
+    return PlatformVectorMath::Select(
+      PlatformVectorMath::LessThan(input, PlatformVectorMath::Fill(0.0f)),
+      PlatformVectorMath::Sub(PlatformVectorMath::Fill(0.0f), magnitude),
+      magnitude);
+  }
+};
+
+/// @brief User polynomial, see Polynomial for the Table requirements
+template <typename Table>
+struct PolynomialShaper {
+  static inline PlatformVectorMath::FloatVec Apply(
+      PlatformVectorMath::FloatVecRead input) {
+    return Polynomial<Table>::Evaluate(input);
+  }
+};
+
+/// @brief Memoryless nonlinearity computed at an oversampled rate
+///
+/// Harmonics generated above the original Nyquist frequency are removed
+/// by the decimation filters instead of aliasing back, as long as they
+/// stay below the oversampled Nyquist frequency.
+///
+/// Shaper is a struct providing:
+/// static FloatVec Apply(FloatVecRead input)
+template <typename Shaper>
+class Waveshaper {
+ public:
+  /// @param[in]  factor   Oversampling factor
+  /// @param[in]  max_block_length   Longest block, multiple of FloatVecSize
+  Waveshaper(const Oversampler::Factor factor,
+             const unsigned int max_block_length)
+      : oversampler_(factor, max_block_length),
+        drive_(1.0f) {}
+
+  /// @brief Gain applied before shaping
+  void SetDrive(const float drive) {
+    drive_ = drive;
+  }
+
+  /// @brief Oversampling ratio
+  unsigned int Ratio() const {
+    return oversampler_.Ratio();
+  }
+
+  /// @brief Delay of the output, in samples
+  unsigned int Latency() const {
+    return oversampler_.Latency();
+  }
+
+  void Reset() {
+    oversampler_.Reset();
+  }
+
+  /// @brief Process a whole block
+  ///
+  /// @param[in]  input   Aligned input block
+  /// @param[out]  output   Aligned output block, may be the input: the
+  ///                        whole input is consumed before any output
+  /// @param[in]  length   Block length, multiple of FloatVecSize
+  void Process(const float* const input,
+               float* const output,
+               const unsigned int length) {
+    float* const oversampled(oversampler_.Upsample(input, length));
+    const unsigned int oversampled_length(length * Ratio());
+    VECMATH_PROFILE_KERNEL("Waveshaper",
+                           oversampled_length,
+                           oversampled_length * 2 * sizeof(float));
+    const PlatformVectorMath::FloatVec drive(PlatformVectorMath::Fill(drive_));
+    for (unsigned int i(0);
+         i < oversampled_length;
+         i += PlatformVectorMath::FloatVecSize) {
+      PlatformVectorMath::Store(
+        &oversampled[i],
+        Shaper::Apply(PlatformVectorMath::Mul(
+          drive,
+          PlatformVectorMath::Fill(&oversampled[i]))));
+    }
+    oversampler_.Downsample(output, length);
+  }
+
+ private:
+  Oversampler oversampler_;
+  float drive_;
+};
+
+}  // namespace vecmath
+
+#endif  // VECMATH_INC_WAVESHAPER_H_
@@ -21,6 +21,11 @@
 
 #include "vecmath/tests/tests.h"
 
+#include "vecmath/inc/allocator.h"
+
+using vecmath::BFloat16;
+using vecmath::Float16;
+
 TEST(Parity, FillOne) {
   const float random_scalar = kNormDistribution(kRandomGenerator);
   const StdFloatVec std_fill = StandardVectorMath::Fill(random_scalar);
@@ -43,3 +48,456 @@ TEST(Parity, Fill) {
                                                     random_scalar_3);
   EXPECT_EQ_SAMPLES(std_fill, sse2_fill);
 }
+
+TEST(Parity, FillUnaligned) {
+  alignas(16) float values[8];
+  for (unsigned i(0); i < 8; ++i) {
+    values[i] = kNormDistribution(kRandomGenerator);
+  }
+  for (unsigned offset(0); offset < 4; ++offset) {
+    const StdFloatVec std_fill =
+      StandardVectorMath::FillUnaligned(&values[offset]);
+    const SSE2FloatVec sse2_fill = SSE2VectorMath::FillUnaligned(&values[offset]);
+    EXPECT_EQ_SAMPLES(std_fill, sse2_fill);
+    EXPECT_EQ(values[offset], SSE2VectorMath::GetByIndex<0>(sse2_fill));
+  }
+}
+
+TEST(Parity, Div) {
+  for (unsigned i(0); i < 256; ++i) {
+    const float left = kNormDistribution(kRandomGenerator);
+    const float right = kNormDistribution(kRandomGenerator);
+    const StdFloatVec std_div = StandardVectorMath::Div(
+      StandardVectorMath::Fill(left),
+      StandardVectorMath::Fill(right));
+    const SSE2FloatVec sse2_div = SSE2VectorMath::Div(
+      SSE2VectorMath::Fill(left),
+      SSE2VectorMath::Fill(right));
+    EXPECT_EQ_SAMPLES(std_div, sse2_div);
+  }
+}
+
+TEST(Parity, Sqrt) {
+  for (unsigned i(0); i < 256; ++i) {
+    const float random_scalar = kNormPosDistribution(kRandomGenerator);
+    const StdFloatVec std_sqrt = StandardVectorMath::Sqrt(
+      StandardVectorMath::Fill(random_scalar));
+    const SSE2FloatVec sse2_sqrt = SSE2VectorMath::Sqrt(
+      SSE2VectorMath::Fill(random_scalar));
+    EXPECT_EQ_SAMPLES(std_sqrt, sse2_sqrt);
+  }
+}
+
+TEST(Parity, ReciprocalFast) {
+  for (unsigned i(0); i < 256; ++i) {
+    const float random_scalar = kNormDistribution(kRandomGenerator);
+    const StdFloatVec std_input = StandardVectorMath::Fill(random_scalar);
+    const SSE2FloatVec sse2_input = SSE2VectorMath::Fill(random_scalar);
+    EXPECT_NEAR_RELATIVE_SAMPLES(StandardVectorMath::Reciprocal(std_input),
+                                 SSE2VectorMath::ReciprocalFast<0>(sse2_input),
+                                 3.7e-4f);
+    EXPECT_NEAR_RELATIVE_SAMPLES(StandardVectorMath::Reciprocal(std_input),
+                                 SSE2VectorMath::ReciprocalFast<1>(sse2_input),
+                                 2.5e-7f);
+    EXPECT_NEAR_RELATIVE_SAMPLES(StandardVectorMath::Reciprocal(std_input),
+                                 SSE2VectorMath::ReciprocalFast<2>(sse2_input),
+                                 1.5e-7f);
+  }
+}
+
+TEST(Parity, ReciprocalSqrtFast) {
+  for (unsigned i(0); i < 256; ++i) {
+    const float random_scalar = kNormPosDistribution(kRandomGenerator);
+    const StdFloatVec std_input = StandardVectorMath::Fill(random_scalar);
+    const SSE2FloatVec sse2_input = SSE2VectorMath::Fill(random_scalar);
+    EXPECT_NEAR_RELATIVE_SAMPLES(StandardVectorMath::ReciprocalSqrt(std_input),
+                                 SSE2VectorMath::ReciprocalSqrtFast<0>(sse2_input),
+                                 3.7e-4f);
+    EXPECT_NEAR_RELATIVE_SAMPLES(StandardVectorMath::ReciprocalSqrt(std_input),
+                                 SSE2VectorMath::ReciprocalSqrtFast<1>(sse2_input),
+                                 3e-7f);
+    EXPECT_NEAR_RELATIVE_SAMPLES(StandardVectorMath::Sqrt(std_input),
+                                 SSE2VectorMath::SqrtFast<2>(sse2_input),
+                                 1.5e-7f);
+  }
+}
+
+TEST(Parity, SqrtFastZero) {
+  const SSE2FloatVec sse2_sqrt = SSE2VectorMath::SqrtFast(
+    SSE2VectorMath::Fill(0.0f));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(0.0f), sse2_sqrt);
+}
+
+TEST(Parity, Rounding) {
+  for (float value : kRoundingValues) {
+    const StdFloatVec std_input = StandardVectorMath::Fill(value);
+    const SSE2FloatVec sse2_input = SSE2VectorMath::Fill(value);
+    EXPECT_EQ_SAMPLES(StandardVectorMath::Round(std_input),
+                      SSE2VectorMath::Round(sse2_input));
+    EXPECT_EQ_SAMPLES(StandardVectorMath::Trunc(std_input),
+                      SSE2VectorMath::Trunc(sse2_input));
+    EXPECT_EQ_SAMPLES(StandardVectorMath::Floor(std_input),
+                      SSE2VectorMath::Floor(sse2_input));
+    EXPECT_EQ_SAMPLES(StandardVectorMath::Ceil(std_input),
+                      SSE2VectorMath::Ceil(sse2_input));
+  }
+}
+
+TEST(Parity, Select) {
+  const float random_scalar_0 = kNormDistribution(kRandomGenerator);
+  const float random_scalar_1 = kNormDistribution(kRandomGenerator);
+  const float random_scalar_2 = kNormDistribution(kRandomGenerator);
+  const float random_scalar_3 = kNormDistribution(kRandomGenerator);
+  const StdFloatVec std_input = StandardVectorMath::Fill(random_scalar_0,
+                                                         random_scalar_1,
+                                                         random_scalar_2,
+                                                         random_scalar_3);
+  const SSE2FloatVec sse2_input = SSE2VectorMath::Fill(random_scalar_0,
+                                                       random_scalar_1,
+                                                       random_scalar_2,
+                                                       random_scalar_3);
+  const StdFloatVec std_mask = StandardVectorMath::GreaterThan(
+    StandardVectorMath::Fill(0.0f), std_input);
+  const SSE2FloatVec sse2_mask = SSE2VectorMath::GreaterThan(
+    SSE2VectorMath::Fill(0.0f), sse2_input);
+  EXPECT_EQ_SAMPLES(
+    StandardVectorMath::Select(std_mask, std_input, StandardVectorMath::Fill(2.0f)),
+    SSE2VectorMath::Select(sse2_mask, sse2_input, SSE2VectorMath::Fill(2.0f)));
+}
+
+TEST(Parity, MaskLogic) {
+  for (unsigned i(0); i < 64; ++i) {
+    float left[4];
+    float right[4];
+    for (unsigned j(0); j < 4; ++j) {
+      left[j] = kNormDistribution(kRandomGenerator);
+      right[j] = kNormDistribution(kRandomGenerator);
+    }
+    const StdFloatVec std_left = StandardVectorMath::Fill(left);
+    const StdFloatVec std_right = StandardVectorMath::Fill(right);
+    const SSE2FloatVec sse2_left = SSE2VectorMath::FillUnaligned(left);
+    const SSE2FloatVec sse2_right = SSE2VectorMath::FillUnaligned(right);
+    const StdFloatVec std_zero = StandardVectorMath::Fill(0.0f);
+    const SSE2FloatVec sse2_zero = SSE2VectorMath::Fill(0.0f);
+    const StdFloatVec std_a = StandardVectorMath::GreaterThan(std_left, std_zero);
+    const StdFloatVec std_b = StandardVectorMath::GreaterThan(std_right, std_zero);
+    const SSE2FloatVec sse2_a = SSE2VectorMath::GreaterThan(sse2_left, sse2_zero);
+    const SSE2FloatVec sse2_b = SSE2VectorMath::GreaterThan(sse2_right, sse2_zero);
+    // Masks representation differ: compare what they select
+#define EXPECT_EQ_MASKS(std_mask, sse2_mask) \
+    EXPECT_EQ_SAMPLES(StandardVectorMath::Select(std_mask, std_left, std_right), \
+                      SSE2VectorMath::Select(sse2_mask, sse2_left, sse2_right)); \
+    EXPECT_EQ(StandardVectorMath::MoveMask(std_mask), \
+              SSE2VectorMath::MoveMask(sse2_mask))
+    EXPECT_EQ_MASKS(StandardVectorMath::And(std_a, std_b),
+                    SSE2VectorMath::And(sse2_a, sse2_b));
+    EXPECT_EQ_MASKS(StandardVectorMath::AndNot(std_a, std_b),
+                    SSE2VectorMath::AndNot(sse2_a, sse2_b));
+    EXPECT_EQ_MASKS(StandardVectorMath::Or(std_a, std_b),
+                    SSE2VectorMath::Or(sse2_a, sse2_b));
+    EXPECT_EQ_MASKS(StandardVectorMath::Xor(std_a, std_b),
+                    SSE2VectorMath::Xor(sse2_a, sse2_b));
+    EXPECT_EQ_MASKS(StandardVectorMath::Not(std_a),
+                    SSE2VectorMath::Not(sse2_a));
+#undef EXPECT_EQ_MASKS
+    unsigned int expected_bits(0);
+    for (unsigned j(0); j < 4; ++j) {
+      expected_bits |= (left[j] > 0.0f && right[j] <= 0.0f ? 1u : 0u) << j;
+    }
+    EXPECT_EQ(expected_bits,
+              SSE2VectorMath::MoveMask(SSE2VectorMath::AndNot(sse2_a, sse2_b)));
+  }
+}
+
+TEST(Parity, Blend) {
+  const StdFloatVec std_left = StandardVectorMath::Fill(1.0f, 2.0f, 3.0f, 4.0f);
+  const StdFloatVec std_right = StandardVectorMath::Fill(5.0f, 6.0f, 7.0f, 8.0f);
+  const SSE2FloatVec sse2_left = SSE2VectorMath::Fill(1.0f, 2.0f, 3.0f, 4.0f);
+  const SSE2FloatVec sse2_right = SSE2VectorMath::Fill(5.0f, 6.0f, 7.0f, 8.0f);
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(5.0f, 2.0f, 7.0f, 4.0f),
+                    SSE2VectorMath::Blend<5>(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Blend<12>(std_left, std_right),
+                    SSE2VectorMath::Blend<12>(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Blend<0>(std_left, std_right),
+                    sse2_left);
+}
+
+TEST(Parity, CompressStore) {
+  const float values[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+  const StdFloatVec std_values = StandardVectorMath::Fill(values);
+  const SSE2FloatVec sse2_values = SSE2VectorMath::FillUnaligned(values);
+  for (unsigned bits(0); bits < 16; ++bits) {
+    float mask[4];
+    for (unsigned j(0); j < 4; ++j) {
+      mask[j] = ((bits >> j) & 1) ? 1.0f : -1.0f;
+    }
+    const StdFloatVec std_mask = StandardVectorMath::GreaterThan(
+      StandardVectorMath::Fill(mask), StandardVectorMath::Fill(0.0f));
+    const SSE2FloatVec sse2_mask = SSE2VectorMath::GreaterThan(
+      SSE2VectorMath::FillUnaligned(mask), SSE2VectorMath::Fill(0.0f));
+    float std_output[4] = {0.0f};
+    float sse2_output[4] = {0.0f};
+    const unsigned int std_count(
+      StandardVectorMath::CompressStore(std_output, std_mask, std_values));
+    const unsigned int sse2_count(
+      SSE2VectorMath::CompressStore(sse2_output, sse2_mask, sse2_values));
+    unsigned int expected_count(0);
+    for (unsigned j(0); j < 4; ++j) {
+      if ((bits >> j) & 1) {
+        EXPECT_EQ(values[j], std_output[expected_count]);
+        EXPECT_EQ(values[j], sse2_output[expected_count]);
+        ++expected_count;
+      }
+    }
+    EXPECT_EQ(expected_count, std_count);
+    EXPECT_EQ(expected_count, sse2_count);
+  }
+}
+
+TEST(Parity, Classification) {
+  // Built from bits: denormals would be flushed by finite maths flags
+  const unsigned int kBits[] = {
+    0x00000000u, 0x80000000u, 0x00000001u, 0x807fffffu, 0x00800000u,
+    0x3f800000u, 0x7f7fffffu, 0x7f800000u, 0xff800000u, 0x7fc00000u,
+    0xffffffffu, 0x7f800001u
+  };
+  const unsigned int kCount(sizeof(kBits) / sizeof(kBits[0]));
+  for (unsigned i(0); i + 4 <= kCount; ++i) {
+    float values[4];
+    std::memcpy(values, &kBits[i], sizeof(values));
+    const StdFloatVec std_input = StandardVectorMath::Fill(values);
+    const SSE2FloatVec sse2_input = SSE2VectorMath::FillUnaligned(values);
+    unsigned int non_finite(0);
+    unsigned int denormal(0);
+    for (unsigned j(0); j < 4; ++j) {
+      const unsigned int exponent(kBits[i + j] & 0x7f800000u);
+      non_finite |= (exponent == 0x7f800000u ? 1u : 0u) << j;
+      denormal |= (exponent == 0 && (kBits[i + j] & 0x7fffffu) != 0 ? 1u : 0u)
+                  << j;
+    }
+    EXPECT_EQ(non_finite,
+              StandardVectorMath::MoveMask(StandardVectorMath::IsNonFinite(std_input)));
+    EXPECT_EQ(non_finite,
+              SSE2VectorMath::MoveMask(SSE2VectorMath::IsNonFinite(sse2_input)));
+    EXPECT_EQ(denormal,
+              StandardVectorMath::MoveMask(StandardVectorMath::IsDenormal(std_input)));
+    EXPECT_EQ(denormal,
+              SSE2VectorMath::MoveMask(SSE2VectorMath::IsDenormal(sse2_input)));
+  }
+}
+
+static bool IsHalfNaN(const std::uint16_t bits) {
+  return (bits & 0x7c00u) == 0x7c00u && (bits & 0x03ffu) != 0;
+}
+
+TEST(Parity, HalfConversion) {
+  // Every half precision value, then float bit patterns spread over all
+  // exponents (NaNs included)
+  for (unsigned int bits(0); bits < 0x10000u; bits += 4) {
+    Float16 halves[4];
+    for (unsigned j(0); j < 4; ++j) {
+      halves[j].bits = static_cast<std::uint16_t>(bits + j);
+    }
+    float std_output[4];
+    float sse2_output[4];
+    StandardVectorMath::Store(std_output,
+                              StandardVectorMath::FillFloat16(halves));
+    SSE2VectorMath::StoreUnaligned(sse2_output,
+                                   SSE2VectorMath::FillFloat16(halves));
+    for (unsigned j(0); j < 4; ++j) {
+      unsigned int std_bits;
+      unsigned int sse2_bits;
+      std::memcpy(&std_bits, &std_output[j], sizeof(std_bits));
+      std::memcpy(&sse2_bits, &sse2_output[j], sizeof(sse2_bits));
+      if (IsHalfNaN(halves[j].bits)) {
+        // F16C quiets signaling NaNs
+        EXPECT_EQ(std_bits | 0x00400000u, sse2_bits | 0x00400000u);
+      } else {
+        EXPECT_EQ(std_bits, sse2_bits);
+      }
+    }
+  }
+  for (unsigned long bits(0); bits < 0x100000000ul; bits += 0x10003ul * 4) {
+    unsigned int patterns[4];
+    for (unsigned j(0); j < 4; ++j) {
+      patterns[j] = static_cast<unsigned int>(bits + j * 0x1001u);
+    }
+    float values[4];
+    std::memcpy(values, patterns, sizeof(values));
+    Float16 std_halves[4];
+    Float16 sse2_halves[4];
+    StandardVectorMath::StoreFloat16(std_halves,
+                                     StandardVectorMath::Fill(values));
+    SSE2VectorMath::StoreFloat16(sse2_halves,
+                                 SSE2VectorMath::FillUnaligned(values));
+    BFloat16 std_brains[4];
+    BFloat16 sse2_brains[4];
+    StandardVectorMath::StoreBFloat16(std_brains,
+                                      StandardVectorMath::Fill(values));
+    SSE2VectorMath::StoreBFloat16(sse2_brains,
+                                  SSE2VectorMath::FillUnaligned(values));
+    for (unsigned j(0); j < 4; ++j) {
+      if (IsHalfNaN(std_halves[j].bits)) {
+        // F16C keeps part of the NaN payload
+        EXPECT_TRUE(IsHalfNaN(sse2_halves[j].bits));
+      } else {
+        EXPECT_EQ(std_halves[j].bits, sse2_halves[j].bits);
+      }
+      EXPECT_EQ(std_brains[j].bits, sse2_brains[j].bits);
+    }
+    float sse2_output[4];
+    SSE2VectorMath::StoreUnaligned(sse2_output,
+                                   SSE2VectorMath::FillBFloat16(sse2_brains));
+    for (unsigned j(0); j < 4; ++j) {
+      unsigned int output_bits;
+      std::memcpy(&output_bits, &sse2_output[j], sizeof(output_bits));
+      EXPECT_EQ(static_cast<unsigned int>(sse2_brains[j].bits) << 16,
+                output_bits);
+    }
+  }
+}
+
+TEST(Parity, IntegerConversions) {
+  vecmath::AlignedVector<int> input(4);
+  for (unsigned j(0); j < 4; ++j) {
+    input[j] = static_cast<int>(kNormDistribution(kRandomGenerator) * 1e6f);
+  }
+  const StdFloatVec std_floats = StandardVectorMath::IntToFloat(
+    StandardVectorMath::FillInt(&input[0]));
+  const SSE2FloatVec sse2_floats = SSE2VectorMath::IntToFloat(
+    SSE2VectorMath::FillInt(&input[0]));
+  EXPECT_EQ_SAMPLES(std_floats, sse2_floats);
+  vecmath::AlignedVector<int> std_output(4);
+  vecmath::AlignedVector<int> sse2_output(4);
+  StandardVectorMath::StoreInt(&std_output[0],
+                               StandardVectorMath::TruncToInt(std_floats));
+  SSE2VectorMath::StoreInt(&sse2_output[0],
+                           SSE2VectorMath::TruncToInt(sse2_floats));
+  for (unsigned j(0); j < 4; ++j) {
+    EXPECT_EQ(input[j], std_output[j]);
+    EXPECT_EQ(input[j], sse2_output[j]);
+  }
+}
+
+TEST(Parity, CountMask) {
+  const float random_scalar = kNormDistribution(kRandomGenerator);
+  const StdFloatVec std_mask = StandardVectorMath::GreaterThan(
+    StandardVectorMath::Fill(-1.0f, 1.0f, random_scalar, 0.0f),
+    StandardVectorMath::Fill(0.0f));
+  const SSE2FloatVec sse2_mask = SSE2VectorMath::GreaterThan(
+    SSE2VectorMath::Fill(-1.0f, 1.0f, random_scalar, 0.0f),
+    SSE2VectorMath::Fill(0.0f));
+  StandardVectorMath::IntVec std_counts(
+    StandardVectorMath::TruncToInt(StandardVectorMath::Fill(2.0f)));
+  SSE2VectorMath::IntVec sse2_counts(
+    SSE2VectorMath::TruncToInt(SSE2VectorMath::Fill(2.0f)));
+  for (unsigned int k(0); k < 3; ++k) {
+    std_counts = StandardVectorMath::CountMask(std_counts, std_mask);
+    sse2_counts = SSE2VectorMath::CountMask(sse2_counts, sse2_mask);
+  }
+  vecmath::AlignedVector<int> std_output(4);
+  vecmath::AlignedVector<int> sse2_output(4);
+  StandardVectorMath::StoreInt(&std_output[0], std_counts);
+  SSE2VectorMath::StoreInt(&sse2_output[0], sse2_counts);
+  const int expected[] = {2, 5, random_scalar > 0.0f ? 5 : 2, 2};
+  for (unsigned j(0); j < 4; ++j) {
+    EXPECT_EQ(expected[j], std_output[j]);
+    EXPECT_EQ(expected[j], sse2_output[j]);
+  }
+}
+
+TEST(Parity, GetSetByIndex) {
+  const float random_scalar_0 = kNormDistribution(kRandomGenerator);
+  const float random_scalar_1 = kNormDistribution(kRandomGenerator);
+  const float random_scalar_2 = kNormDistribution(kRandomGenerator);
+  const float random_scalar_3 = kNormDistribution(kRandomGenerator);
+  const SSE2FloatVec sse2_input = SSE2VectorMath::Fill(random_scalar_0,
+                                                       random_scalar_1,
+                                                       random_scalar_2,
+                                                       random_scalar_3);
+  EXPECT_EQ(random_scalar_0, SSE2VectorMath::GetByIndex<0>(sse2_input));
+  EXPECT_EQ(random_scalar_1, SSE2VectorMath::GetByIndex<1>(sse2_input));
+  EXPECT_EQ(random_scalar_2, SSE2VectorMath::GetByIndex<2>(sse2_input));
+  EXPECT_EQ(random_scalar_3, SSE2VectorMath::GetByIndex<3>(sse2_input));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(random_scalar_0, 1.0f,
+                                             random_scalar_2, random_scalar_3),
+                    SSE2VectorMath::SetByIndex<1>(sse2_input, 1.0f));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(random_scalar_0, random_scalar_1,
+                                             random_scalar_2, -1.0f),
+                    SSE2VectorMath::SetByIndex<3>(sse2_input, -1.0f));
+}
+
+TEST(Parity, ComplexShuffles) {
+  const StdFloatVec std_left = StandardVectorMath::Fill(1.0f, 2.0f, 3.0f, 4.0f);
+  const StdFloatVec std_right = StandardVectorMath::Fill(5.0f, 6.0f, 7.0f, 8.0f);
+  const SSE2FloatVec sse2_left = SSE2VectorMath::Fill(1.0f, 2.0f, 3.0f, 4.0f);
+  const SSE2FloatVec sse2_right = SSE2VectorMath::Fill(5.0f, 6.0f, 7.0f, 8.0f);
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(-4.0f, 8.0f, -4.0f, 12.0f),
+                    SSE2VectorMath::AddSub(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::MulAdd(std_left, std_right, std_left),
+                    SSE2VectorMath::MulAdd(sse2_left, sse2_right, sse2_left));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(1.0f, 1.0f, 3.0f, 3.0f),
+                    SSE2VectorMath::DuplicateEven(sse2_left));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(2.0f, 2.0f, 4.0f, 4.0f),
+                    SSE2VectorMath::DuplicateOdd(sse2_left));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(2.0f, 1.0f, 4.0f, 3.0f),
+                    SSE2VectorMath::SwapPairs(sse2_left));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(1.0f, 5.0f, 2.0f, 6.0f),
+                    SSE2VectorMath::InterleaveLow(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(3.0f, 7.0f, 4.0f, 8.0f),
+                    SSE2VectorMath::InterleaveHigh(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(1.0f, 3.0f, 5.0f, 7.0f),
+                    SSE2VectorMath::DeinterleaveEven(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(2.0f, 4.0f, 6.0f, 8.0f),
+                    SSE2VectorMath::DeinterleaveOdd(sse2_left, sse2_right));
+  // Standard implementation
+  EXPECT_EQ_SAMPLES(StandardVectorMath::AddSub(std_left, std_right),
+                    SSE2VectorMath::AddSub(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::DuplicateEven(std_left),
+                    SSE2VectorMath::DuplicateEven(sse2_left));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::DuplicateOdd(std_left),
+                    SSE2VectorMath::DuplicateOdd(sse2_left));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::SwapPairs(std_left),
+                    SSE2VectorMath::SwapPairs(sse2_left));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::InterleaveLow(std_left, std_right),
+                    SSE2VectorMath::InterleaveLow(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::InterleaveHigh(std_left, std_right),
+                    SSE2VectorMath::InterleaveHigh(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::DeinterleaveEven(std_left, std_right),
+                    SSE2VectorMath::DeinterleaveEven(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::DeinterleaveOdd(std_left, std_right),
+                    SSE2VectorMath::DeinterleaveOdd(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(1.0f, 2.0f, 5.0f, 6.0f),
+                    SSE2VectorMath::TakeEachLeftHalf(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::TakeEachLeftHalf(std_left, std_right),
+                    SSE2VectorMath::TakeEachLeftHalf(sse2_left, sse2_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::TakeEachRightHalf(std_left, std_right),
+                    SSE2VectorMath::TakeEachRightHalf(sse2_left, sse2_right));
+}
+
+TEST(Parity, ShiftOnRight) {
+  const StdFloatVec std_input = StandardVectorMath::Fill(1.0f, 2.0f, 3.0f, 4.0f);
+  const SSE2FloatVec sse2_input = SSE2VectorMath::Fill(1.0f, 2.0f, 3.0f, 4.0f);
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(-1.0f, 1.0f, 2.0f, 3.0f),
+                    SSE2VectorMath::ShiftOnRight<1>(sse2_input, -1.0f));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(-1.0f, -1.0f, 1.0f, 2.0f),
+                    SSE2VectorMath::ShiftOnRight<2>(sse2_input, -1.0f));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(-1.0f, -1.0f, -1.0f, 1.0f),
+                    SSE2VectorMath::ShiftOnRight<3>(sse2_input, -1.0f));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::ShiftOnRight<1>(std_input, 5.0f),
+                    SSE2VectorMath::ShiftOnRight<1>(sse2_input, 5.0f));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::ShiftOnRight<2>(std_input, 5.0f),
+                    SSE2VectorMath::ShiftOnRight<2>(sse2_input, 5.0f));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::ShiftOnRight<3>(std_input, 5.0f),
+                    SSE2VectorMath::ShiftOnRight<3>(sse2_input, 5.0f));
+}
+
+TEST(Allocator, Overflow) {
+  vecmath::AlignedAllocator<float> allocator;
+  EXPECT_THROW(allocator.allocate(allocator.max_size() + 1), std::bad_alloc);
+  EXPECT_THROW(allocator.allocate(static_cast<std::size_t>(-1)),
+               std::bad_alloc);
+  float* const data(allocator.allocate(16));
+  EXPECT_TRUE(vecmath::IsAligned(data, vecmath::kDefaultAlignment));
+  allocator.deallocate(data, 16);
+}
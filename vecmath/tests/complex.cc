@@ -0,0 +1,233 @@
+/// @file tests/complex.cc
+/// @brief Complex vectors tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <complex>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/complex.h"
+
+using vecmath::ComplexVec;
+using vecmath::ComplexVectorMath;
+using vecmath::PlatformVectorMath;
+
+static const unsigned int kComplexCount = 64;
+static const float kComplexTolerance = 1e-6f;
+
+/// @brief Random complex values, split and interleaved
+struct ComplexData {
+  ComplexData() {
+    for (unsigned int i(0); i < kComplexCount; ++i) {
+      values[i] = std::complex<float>(kNormDistribution(kRandomGenerator),
+                                      kNormDistribution(kRandomGenerator));
+      re[i] = values[i].real();
+      im[i] = values[i].imag();
+      interleaved[2 * i] = values[i].real();
+      interleaved[2 * i + 1] = values[i].imag();
+    }
+  }
+
+  std::complex<float> values[kComplexCount];
+  alignas(16) float re[kComplexCount];
+  alignas(16) float im[kComplexCount];
+  alignas(16) float interleaved[2 * kComplexCount];
+};
+
+TEST(Complex, Split) {
+  const ComplexData left;
+  const ComplexData right;
+  const ComplexData addend;
+  for (unsigned int i(0); i < kComplexCount;
+       i += ComplexVectorMath::ComplexVecSize) {
+    const ComplexVec left_vec(ComplexVectorMath::Fill(&left.re[i],
+                                                      &left.im[i]));
+    const ComplexVec right_vec(ComplexVectorMath::Fill(&right.re[i],
+                                                       &right.im[i]));
+    const ComplexVec addend_vec(ComplexVectorMath::Fill(&addend.re[i],
+                                                        &addend.im[i]));
+    const ComplexVec product(ComplexVectorMath::Mul(left_vec, right_vec));
+    const ComplexVec conj_product(ComplexVectorMath::MulConj(left_vec,
+                                                             right_vec));
+    const ComplexVec mul_add(ComplexVectorMath::MulAdd(left_vec,
+                                                       right_vec,
+                                                       addend_vec));
+    for (unsigned int j(0); j < ComplexVectorMath::ComplexVecSize; ++j) {
+      const std::complex<float> expected_product(left.values[i + j]
+                                                 * right.values[i + j]);
+      const std::complex<float> expected_conj(
+        left.values[i + j] * std::conj(right.values[i + j]));
+      const std::complex<float> expected_mul_add(expected_product
+                                                 + addend.values[i + j]);
+      EXPECT_NEAR(expected_product.real(),
+                  PlatformVectorMath::GetByIndex(product.re, j),
+                  kComplexTolerance);
+      EXPECT_NEAR(expected_product.imag(),
+                  PlatformVectorMath::GetByIndex(product.im, j),
+                  kComplexTolerance);
+      EXPECT_NEAR(expected_conj.real(),
+                  PlatformVectorMath::GetByIndex(conj_product.re, j),
+                  kComplexTolerance);
+      EXPECT_NEAR(expected_conj.imag(),
+                  PlatformVectorMath::GetByIndex(conj_product.im, j),
+                  kComplexTolerance);
+      EXPECT_NEAR(expected_mul_add.real(),
+                  PlatformVectorMath::GetByIndex(mul_add.re, j),
+                  kComplexTolerance);
+      EXPECT_NEAR(expected_mul_add.imag(),
+                  PlatformVectorMath::GetByIndex(mul_add.im, j),
+                  kComplexTolerance);
+      EXPECT_NEAR(std::norm(left.values[i + j]),
+                  PlatformVectorMath::GetByIndex(
+                    ComplexVectorMath::SquaredMagnitude(left_vec), j),
+                  kComplexTolerance);
+      EXPECT_NEAR(std::abs(left.values[i + j]),
+                  PlatformVectorMath::GetByIndex(
+                    ComplexVectorMath::Magnitude(left_vec), j),
+                  kComplexTolerance);
+      EXPECT_NEAR(std::arg(left.values[i + j]),
+                  PlatformVectorMath::GetByIndex(
+                    ComplexVectorMath::Phase(left_vec), j),
+                  kComplexTolerance);
+    }
+  }
+}
+
+TEST(Complex, Interleaved) {
+  const ComplexData left;
+  const ComplexData right;
+  const unsigned int kStep(ComplexVectorMath::InterleavedSize);
+  for (unsigned int i(0); i < kComplexCount; i += kStep) {
+    const PlatformVectorMath::FloatVec left_vec(
+      PlatformVectorMath::Fill(&left.interleaved[2 * i]));
+    const PlatformVectorMath::FloatVec right_vec(
+      PlatformVectorMath::Fill(&right.interleaved[2 * i]));
+    const PlatformVectorMath::FloatVec product(
+      ComplexVectorMath::MulInterleaved(left_vec, right_vec));
+    const PlatformVectorMath::FloatVec conj_product(
+      ComplexVectorMath::MulConjInterleaved(left_vec, right_vec));
+    for (unsigned int j(0); j < kStep; ++j) {
+      const std::complex<float> expected_product(left.values[i + j]
+                                                 * right.values[i + j]);
+      const std::complex<float> expected_conj(
+        left.values[i + j] * std::conj(right.values[i + j]));
+      EXPECT_NEAR(expected_product.real(),
+                  PlatformVectorMath::GetByIndex(product, 2 * j),
+                  kComplexTolerance);
+      EXPECT_NEAR(expected_product.imag(),
+                  PlatformVectorMath::GetByIndex(product, 2 * j + 1),
+                  kComplexTolerance);
+      EXPECT_NEAR(expected_conj.real(),
+                  PlatformVectorMath::GetByIndex(conj_product, 2 * j),
+                  kComplexTolerance);
+      EXPECT_NEAR(expected_conj.imag(),
+                  PlatformVectorMath::GetByIndex(conj_product, 2 * j + 1),
+                  kComplexTolerance);
+    }
+  }
+  // Magnitudes and phases are computed over two interleaved vectors
+  const unsigned int kPairStep(PlatformVectorMath::FloatVecSize);
+  for (unsigned int i(0); i < kComplexCount; i += kPairStep) {
+    const PlatformVectorMath::FloatVec low(
+      PlatformVectorMath::Fill(&left.interleaved[2 * i]));
+    const PlatformVectorMath::FloatVec high(
+      PlatformVectorMath::Fill(&left.interleaved[2 * i + kPairStep]));
+    for (unsigned int j(0); j < kPairStep; ++j) {
+      EXPECT_NEAR(std::norm(left.values[i + j]),
+                  PlatformVectorMath::GetByIndex(
+                    ComplexVectorMath::SquaredMagnitudeInterleaved(low, high),
+                    j),
+                  kComplexTolerance);
+      EXPECT_NEAR(std::abs(left.values[i + j]),
+                  PlatformVectorMath::GetByIndex(
+                    ComplexVectorMath::MagnitudeInterleaved(low, high), j),
+                  kComplexTolerance);
+      EXPECT_NEAR(std::arg(left.values[i + j]),
+                  PlatformVectorMath::GetByIndex(
+                    ComplexVectorMath::PhaseInterleaved(low, high), j),
+                  kComplexTolerance);
+    }
+  }
+}
+
+TEST(Complex, PhaseCornerCases) {
+  const float kPi(3.14159265358979f);
+  const ComplexVec axes(ComplexVectorMath::Fill(
+    PlatformVectorMath::Fill(0.0f, 1.0f, 0.0f, -1.0f),
+    PlatformVectorMath::Fill(0.0f, 0.0f, 1.0f, 0.0f)));
+  const PlatformVectorMath::FloatVec phases(ComplexVectorMath::Phase(axes));
+  EXPECT_EQ(0.0f, PlatformVectorMath::GetByIndex<0>(phases));
+  EXPECT_EQ(0.0f, PlatformVectorMath::GetByIndex<1>(phases));
+  EXPECT_NEAR(kPi / 2.0f, PlatformVectorMath::GetByIndex<2>(phases),
+              kComplexTolerance);
+  EXPECT_NEAR(kPi, PlatformVectorMath::GetByIndex<3>(phases),
+              kComplexTolerance);
+}
+
+TEST(Complex, MultiplyAccumulate) {
+  const ComplexData left;
+  const ComplexData right;
+  ComplexData interleaved_accumulator;
+  ComplexData split_accumulator;
+  std::complex<float> expected[kComplexCount];
+  for (unsigned int i(0); i < kComplexCount; ++i) {
+    expected[i] = interleaved_accumulator.values[i]
+                  + left.values[i] * right.values[i];
+  }
+  ComplexVectorMath::MultiplyAccumulate(left.interleaved,
+                                        right.interleaved,
+                                        interleaved_accumulator.interleaved,
+                                        kComplexCount);
+  ComplexVectorMath::MultiplyAccumulate(left.re, left.im,
+                                        right.re, right.im,
+                                        split_accumulator.re,
+                                        split_accumulator.im,
+                                        kComplexCount);
+  for (unsigned int i(0); i < kComplexCount; ++i) {
+    const std::complex<float> split_expected(
+      split_accumulator.values[i] + left.values[i] * right.values[i]);
+    EXPECT_NEAR(expected[i].real(),
+                interleaved_accumulator.interleaved[2 * i],
+                kComplexTolerance);
+    EXPECT_NEAR(expected[i].imag(),
+                interleaved_accumulator.interleaved[2 * i + 1],
+                kComplexTolerance);
+    EXPECT_NEAR(split_expected.real(), split_accumulator.re[i],
+                kComplexTolerance);
+    EXPECT_NEAR(split_expected.imag(), split_accumulator.im[i],
+                kComplexTolerance);
+  }
+}
+
+TEST(Complex, LayoutConversions) {
+  const ComplexData input;
+  alignas(16) float re[kComplexCount];
+  alignas(16) float im[kComplexCount];
+  alignas(16) float interleaved[2 * kComplexCount];
+  ComplexVectorMath::InterleavedToSplit(input.interleaved, re, im,
+                                        kComplexCount);
+  ComplexVectorMath::SplitToInterleaved(re, im, interleaved, kComplexCount);
+  for (unsigned int i(0); i < kComplexCount; ++i) {
+    EXPECT_EQ(input.re[i], re[i]);
+    EXPECT_EQ(input.im[i], im[i]);
+    EXPECT_EQ(input.interleaved[2 * i], interleaved[2 * i]);
+    EXPECT_EQ(input.interleaved[2 * i + 1], interleaved[2 * i + 1]);
+  }
+}
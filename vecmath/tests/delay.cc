@@ -0,0 +1,152 @@
+/// @file tests/delay.cc
+/// @brief Delay line tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <cmath>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/delay.h"
+
+using vecmath::AlignedVector;
+using vecmath::DelayLine;
+using vecmath::PlatformVectorMath;
+
+static const unsigned int kDelayLength = 8192;
+static const unsigned int kMaxDelay = 300;
+static const float kDelayTolerance = 1e-5f;
+
+// Input sample at the given time, null before the start
+static float InputAt(const AlignedVector<float>& input, const int index) {
+  return index < 0 ? 0.0f : input[index];
+}
+
+// Slowly modulated delays, chorus-like, with a few integral values
+static void FillDelays(AlignedVector<float>* delays, const float min_delay) {
+  for (unsigned int i(0); i < delays->size(); ++i) {
+    (*delays)[i] = min_delay + (kMaxDelay - min_delay) * 0.5f
+      * (1.0f + static_cast<float>(std::sin(i * 0.003)));
+  }
+  (*delays)[100] = 7.0f;
+  (*delays)[101] = min_delay;
+  (*delays)[102] = static_cast<float>(kMaxDelay);
+}
+
+class DelayLineTest : public ::testing::Test {
+ protected:
+  DelayLineTest()
+      : input_(kDelayLength),
+        delays_(kDelayLength),
+        output_(kDelayLength) {
+    for (float& value : input_) {
+      value = kNormDistribution(kRandomGenerator);
+    }
+  }
+
+  AlignedVector<float> input_;
+  AlignedVector<float> delays_;
+  AlignedVector<float> output_;
+};
+
+TEST_F(DelayLineTest, Linear) {
+  FillDelays(&delays_, 0.0f);
+  DelayLine line(kMaxDelay);
+  line.Process(&input_[0], &delays_[0], &output_[0], kDelayLength,
+               DelayLine::kLinear);
+  for (unsigned int i(0); i < kDelayLength; ++i) {
+    const float whole(std::floor(delays_[i]));
+    const float fraction(delays_[i] - whole);
+    const int index(static_cast<int>(i) - static_cast<int>(whole));
+    const float expected(InputAt(input_, index)
+      + fraction * (InputAt(input_, index - 1) - InputAt(input_, index)));
+    EXPECT_NEAR(expected, output_[i], kDelayTolerance);
+  }
+}
+
+TEST_F(DelayLineTest, Cubic) {
+  FillDelays(&delays_, 1.0f);
+  DelayLine line(kMaxDelay);
+  line.Process(&input_[0], &delays_[0], &output_[0], kDelayLength,
+               DelayLine::kCubic);
+  for (unsigned int i(0); i < kDelayLength; ++i) {
+    // Interpolate between p1 (one sample older) and p2, at t = 1 - fraction
+    const float whole(std::floor(delays_[i]));
+    const float t(1.0f - (delays_[i] - whole));
+    const int index(static_cast<int>(i) - static_cast<int>(whole));
+    const float p0(InputAt(input_, index - 2));
+    const float p1(InputAt(input_, index - 1));
+    const float p2(InputAt(input_, index));
+    const float p3(InputAt(input_, index + 1));
+    const float expected(p1 + 0.5f * t * (p2 - p0
+      + t * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3
+             + t * (3.0f * (p1 - p2) + p3 - p0))));
+    EXPECT_NEAR(expected, output_[i], 1e-4f);
+  }
+}
+
+TEST_F(DelayLineTest, Allpass) {
+  FillDelays(&delays_, 1.0f);
+  DelayLine line(kMaxDelay);
+  line.Process(&input_[0], &delays_[0], &output_[0], kDelayLength,
+               DelayLine::kAllpass);
+  float previous(0.0f);
+  for (unsigned int i(0); i < kDelayLength; ++i) {
+    const int whole(static_cast<int>(std::ceil(delays_[i])) - 1);
+    const float fraction(delays_[i] - static_cast<float>(whole));
+    const float eta((1.0f - fraction) / (1.0f + fraction));
+    const int index(static_cast<int>(i) - whole);
+    previous = eta * InputAt(input_, index) + InputAt(input_, index - 1)
+               - eta * previous;
+    EXPECT_NEAR(previous, output_[i], 1e-4f);
+  }
+  // Integral delays: eta = 0, plain delay
+  std::fill(delays_.begin(), delays_.end(), 9.0f);
+  line.Reset();
+  line.Process(&input_[0], &delays_[0], &output_[0], kDelayLength,
+               DelayLine::kAllpass);
+  for (unsigned int i(0); i < kDelayLength; ++i) {
+    EXPECT_EQ(InputAt(input_, static_cast<int>(i) - 9), output_[i]);
+  }
+}
+
+TEST_F(DelayLineTest, Taps) {
+  const float kTapDelays[] = {0.0f, 13.25f, 128.0f, 299.5f};
+  const float kTapGains[] = {0.5f, -0.25f, 1.0f, 0.125f};
+  const unsigned int kTaps(sizeof(kTapDelays) / sizeof(kTapDelays[0]));
+  DelayLine line(kMaxDelay);
+  for (unsigned int i(0); i < kDelayLength;
+       i += PlatformVectorMath::FloatVecSize) {
+    line.Write(PlatformVectorMath::Fill(&input_[i]));
+    PlatformVectorMath::Store(&output_[i],
+                              line.ReadTaps(kTapDelays, kTapGains, kTaps));
+  }
+  for (unsigned int i(0); i < kDelayLength; ++i) {
+    float expected(0.0f);
+    for (unsigned int tap(0); tap < kTaps; ++tap) {
+      const float whole(std::floor(kTapDelays[tap]));
+      const float fraction(kTapDelays[tap] - whole);
+      const int index(static_cast<int>(i) - static_cast<int>(whole));
+      expected += kTapGains[tap] * (InputAt(input_, index)
+        + fraction * (InputAt(input_, index - 1) - InputAt(input_, index)));
+    }
+    EXPECT_NEAR(expected, output_[i], kDelayTolerance);
+  }
+}
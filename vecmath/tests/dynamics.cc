@@ -0,0 +1,193 @@
+/// @file tests/dynamics.cc
+/// @brief Dynamics tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/dynamics.h"
+
+using vecmath::AlignedVector;
+using vecmath::DynamicsProcessor;
+using vecmath::DynamicsVectorMath;
+using vecmath::PlatformVectorMath;
+using vecmath::SlidingMaximum;
+
+static const unsigned int kDynamicsLength = 4096;
+
+// dB <-> linear, within 1e-3 dB
+TEST(Dynamics, DecibelConversions) {
+  for (float decibels(-120.0f); decibels <= 24.0f; decibels += 0.37f) {
+    const float expected(std::pow(10.0f, decibels / 20.0f));
+    const float gain(PlatformVectorMath::GetByIndex<0>(
+      DynamicsVectorMath::DecibelsToGain(PlatformVectorMath::Fill(decibels))));
+    EXPECT_NEAR(expected, gain, expected * 1e-5f);
+    const float back(PlatformVectorMath::GetByIndex<0>(
+      DynamicsVectorMath::GainToDecibels(PlatformVectorMath::Fill(gain))));
+    EXPECT_NEAR(decibels, back, 1e-3f);
+  }
+}
+
+// Static curve: null below the knee, 1 / ratio above, continuous
+TEST(Dynamics, GainComputer) {
+  const float kThreshold(-12.0f);
+  const float kSlope(1.0f / 4.0f - 1.0f);
+  for (const float knee : {0.0f, 6.0f}) {
+    float previous(0.0f);
+    float previous_output(-100.0f);
+    for (float level(-40.0f); level <= 12.0f; level += 0.25f) {
+      const float gain(PlatformVectorMath::GetByIndex<0>(
+        DynamicsVectorMath::GainComputer(PlatformVectorMath::Fill(level),
+                                         kThreshold,
+                                         kSlope,
+                                         knee)));
+      if (level <= kThreshold - knee * 0.5f) {
+        EXPECT_EQ(0.0f, gain);
+      } else if (level >= kThreshold + knee * 0.5f) {
+        EXPECT_NEAR(kSlope * (level - kThreshold), gain, 1e-5f);
+      }
+      // Gain reduction only rises, output level too
+      EXPECT_GE(previous + 1e-5f, gain);
+      EXPECT_GT(level + gain, previous_output);
+      previous = gain;
+      previous_output = level + gain;
+    }
+    // Soft knee: the middle of the knee is 1/8 of its width below the
+    // hard knee curve asymptote, scaled by the slope
+    const float middle(PlatformVectorMath::GetByIndex<0>(
+      DynamicsVectorMath::GainComputer(PlatformVectorMath::Fill(kThreshold),
+                                       kThreshold,
+                                       kSlope,
+                                       knee)));
+    EXPECT_NEAR(kSlope * knee / 8.0f, middle, 1e-5f);
+  }
+}
+
+class SlidingMaximumTest : public ::testing::TestWithParam<unsigned int> {};
+
+// Against brute force, with irregular block lengths
+TEST_P(SlidingMaximumTest, BruteForce) {
+  const unsigned int window(GetParam());
+  AlignedVector<float> input(kDynamicsLength);
+  AlignedVector<float> output(kDynamicsLength);
+  for (float& value : input) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  SlidingMaximum maximum(window);
+  EXPECT_EQ(window, maximum.Window());
+  maximum.Reset(-100.0f);
+  const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+  unsigned int index(0);
+  unsigned int block(0);
+  while (index < kDynamicsLength) {
+    const unsigned int length(std::min(kVecSize * (1 + (block * 7) % 13),
+                                       kDynamicsLength - index));
+    maximum.Process(&input[index], &output[index], length);
+    index += length;
+    block += 1;
+  }
+  for (unsigned int i(0); i < kDynamicsLength; ++i) {
+    float expected(i + 1 < window ? -100.0f : input[i]);
+    for (unsigned int k(0); k < std::min(window, i + 1); ++k) {
+      expected = std::max(expected, input[i - k]);
+    }
+    ASSERT_EQ(expected, output[i]) << "window " << window << " index " << i;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Windows,
+                         SlidingMaximumTest,
+                         ::testing::Values(1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u,
+                                           9u, 10u, 11u, 12u, 13u, 15u, 16u,
+                                           17u, 18u, 31u, 32u, 33u, 37u,
+                                           100u, 257u, 1000u));
+
+class DynamicsProcessorTest : public ::testing::TestWithParam<bool> {};
+
+// Limiter: no output sample above the threshold, the signal delayed
+TEST_P(DynamicsProcessorTest, Limiter) {
+  const bool linked(GetParam());
+  const unsigned int kBlockLength(256);
+  const unsigned int kLookahead(64);
+  const float kThreshold(-6.0f);
+  DynamicsProcessor limiter(2, kBlockLength, 48000.0f, kLookahead, linked);
+  limiter.SetThreshold(kThreshold);
+  limiter.SetRatio(0.0f);
+  // Instantaneous attack: the look-ahead does the job
+  limiter.SetTimes(1e-6f, 0.05f);
+  EXPECT_EQ(kLookahead, limiter.Latency());
+  AlignedVector<float> left(kDynamicsLength);
+  AlignedVector<float> right(kDynamicsLength);
+  AlignedVector<float> left_out(kDynamicsLength);
+  AlignedVector<float> right_out(kDynamicsLength);
+  for (unsigned int i(0); i < kDynamicsLength; ++i) {
+    const float envelope(i > 1000 && i < 3000 ? 2.0f : 0.1f);
+    left[i] = envelope * static_cast<float>(std::sin(i * 0.05));
+    right[i] = 0.1f * static_cast<float>(std::sin(i * 0.011));
+  }
+  for (unsigned int i(0); i < kDynamicsLength; i += kBlockLength) {
+    const float* inputs[] = {&left[i], &right[i]};
+    float* outputs[] = {&left_out[i], &right_out[i]};
+    limiter.Process(inputs, outputs, kBlockLength);
+  }
+  const float limit(std::pow(10.0f, kThreshold / 20.0f) * 1.001f);
+  for (unsigned int i(0); i < kDynamicsLength; ++i) {
+    ASSERT_GE(limit, std::abs(left_out[i])) << i;
+    ASSERT_GE(limit, std::abs(right_out[i])) << i;
+  }
+  // Quiet parts are untouched, only delayed
+  for (unsigned int i(kLookahead); i < 900; ++i) {
+    EXPECT_NEAR(left[i - kLookahead], left_out[i], 1e-5f);
+    EXPECT_NEAR(right[i - kLookahead], right_out[i], 1e-5f);
+  }
+  // When loud, the right channel follows the left one only if linked
+  const unsigned int kLoud(2000 + kLookahead);
+  if (linked) {
+    EXPECT_GT(0.5f * std::abs(right[kLoud - kLookahead]) + 1e-6f,
+              std::abs(right_out[kLoud]));
+    EXPECT_LT(5.0f, limiter.GainReduction());
+  } else {
+    EXPECT_NEAR(right[kLoud - kLookahead], right_out[kLoud], 1e-5f);
+    EXPECT_LT(5.0f, limiter.GainReduction(0));
+    EXPECT_EQ(0.0f, limiter.GainReduction(1));
+  }
+}
+
+// In-place processing, makeup gain
+TEST(Dynamics, InPlaceMakeup) {
+  const unsigned int kBlockLength(64);
+  DynamicsProcessor compressor(1, kBlockLength, 48000.0f, 0);
+  compressor.SetThreshold(0.0f);
+  compressor.SetRatio(2.0f);
+  compressor.SetMakeup(6.0f);
+  AlignedVector<float> buffer(kBlockLength, 0.25f);
+  float* channels[] = {&buffer[0]};
+  compressor.Process(channels, channels, kBlockLength);
+  const float expected(0.25f * std::pow(10.0f, 6.0f / 20.0f));
+  for (const float value : buffer) {
+    EXPECT_NEAR(expected, value, 1e-5f);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Linking, DynamicsProcessorTest, ::testing::Bool());
@@ -0,0 +1,136 @@
+/// @file tests/fft.cc
+/// @brief FFT tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <complex>
+#include <vector>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/fft.h"
+
+using vecmath::AlignedVector;
+using vecmath::ComplexFFT;
+using vecmath::RealFFT;
+
+static const unsigned int kFFTSizes[] = {
+  1, 2, 3, 4, 5, 6, 8, 10, 12, 15, 16, 30, 32, 60, 64, 100, 120, 128,
+  240, 256, 480, 512, 1024, 2048
+};
+
+/// @brief Naive DFT, double precision reference
+static std::vector<std::complex<double> > NaiveDFT(
+    const std::vector<std::complex<double> >& input,
+    const bool inverse) {
+  const double kTwoPi(6.283185307179586);
+  const std::size_t size(input.size());
+  std::vector<std::complex<double> > output(size);
+  for (std::size_t k(0); k < size; ++k) {
+    std::complex<double> sum(0.0, 0.0);
+    for (std::size_t n(0); n < size; ++n) {
+      const double angle((inverse ? kTwoPi : -kTwoPi)
+                         * static_cast<double>((k * n) % size) / size);
+      sum += input[n] * std::complex<double>(std::cos(angle), std::sin(angle));
+    }
+    output[k] = sum;
+  }
+  return output;
+}
+
+/// @brief Error tolerance for a transform of the given size,
+/// with inputs in [-1 ; 1]
+static float FFTTolerance(const unsigned int size) {
+  return 1e-6f * static_cast<float>(size) + 1e-5f;
+}
+
+TEST(FFT, SupportedSizes) {
+  EXPECT_FALSE(ComplexFFT::IsSupportedSize(0));
+  EXPECT_TRUE(ComplexFFT::IsSupportedSize(1));
+  EXPECT_TRUE(ComplexFFT::IsSupportedSize(480));
+  EXPECT_FALSE(ComplexFFT::IsSupportedSize(7));
+  EXPECT_FALSE(ComplexFFT::IsSupportedSize(44));
+  EXPECT_TRUE(RealFFT::IsSupportedSize(960));
+  EXPECT_FALSE(RealFFT::IsSupportedSize(15));
+}
+
+TEST(FFT, ComplexAgainstNaive) {
+  for (unsigned int size : kFFTSizes) {
+    const ComplexFFT fft(size);
+    std::vector<std::complex<double> > input(size);
+    AlignedVector<float> data(2 * size);
+    for (unsigned int i(0); i < size; ++i) {
+      input[i] = std::complex<double>(kNormDistribution(kRandomGenerator),
+                                      kNormDistribution(kRandomGenerator));
+      data[2 * i] = static_cast<float>(input[i].real());
+      data[2 * i + 1] = static_cast<float>(input[i].imag());
+    }
+    const std::vector<std::complex<double> > expected(NaiveDFT(input, false));
+    fft.Forward(&data[0]);
+    for (unsigned int i(0); i < size; ++i) {
+      EXPECT_NEAR(expected[i].real(), data[2 * i], FFTTolerance(size))
+        << "size " << size << ", bin " << i;
+      EXPECT_NEAR(expected[i].imag(), data[2 * i + 1], FFTTolerance(size))
+        << "size " << size << ", bin " << i;
+    }
+    const std::vector<std::complex<double> > expected_inverse(
+      NaiveDFT(expected, true));
+    fft.Inverse(&data[0]);
+    for (unsigned int i(0); i < size; ++i) {
+      EXPECT_NEAR(expected_inverse[i].real(), data[2 * i],
+                  size * FFTTolerance(size));
+      EXPECT_NEAR(expected_inverse[i].imag(), data[2 * i + 1],
+                  size * FFTTolerance(size));
+    }
+  }
+}
+
+TEST(FFT, RealAgainstNaive) {
+  for (unsigned int complex_size : kFFTSizes) {
+    const unsigned int size(2 * complex_size);
+    const RealFFT fft(size);
+    std::vector<std::complex<double> > input(size);
+    AlignedVector<float> data(size);
+    for (unsigned int i(0); i < size; ++i) {
+      data[i] = kNormDistribution(kRandomGenerator);
+      input[i] = std::complex<double>(data[i], 0.0);
+    }
+    const std::vector<std::complex<double> > expected(NaiveDFT(input, false));
+    fft.Forward(&data[0]);
+    EXPECT_NEAR(expected[0].real(), data[0], FFTTolerance(size));
+    EXPECT_NEAR(expected[size / 2].real(), data[1], FFTTolerance(size));
+    for (unsigned int i(1); i < size / 2; ++i) {
+      EXPECT_NEAR(expected[i].real(), data[2 * i], FFTTolerance(size))
+        << "size " << size << ", bin " << i;
+      EXPECT_NEAR(expected[i].imag(), data[2 * i + 1], FFTTolerance(size))
+        << "size " << size << ", bin " << i;
+    }
+    fft.Inverse(&data[0]);
+    for (unsigned int i(0); i < size; ++i) {
+      EXPECT_NEAR(size * input[i].real(), data[i], size * FFTTolerance(size));
+    }
+  }
+}
+
+TEST(Allocator, Alignment) {
+  for (unsigned int size(1); size < 64; size += 7) {
+    const AlignedVector<float> data(size);
+    EXPECT_TRUE(vecmath::IsAligned(&data[0], vecmath::kDefaultAlignment));
+  }
+}
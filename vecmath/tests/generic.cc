@@ -0,0 +1,248 @@
+/// @file tests/generic.cc
+/// @brief Vecmath tests - width-generic implementation
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include "vecmath/tests/tests.h"
+
+// Every member has to build, with or without vector extensions
+// (see vecmath_tests_generic_fallback)
+template struct vecmath::GenericVectorMath<4>;
+template struct vecmath::GenericVectorMath<8>;
+
+typedef GenericVectorMath<4> Generic4VectorMath;
+
+// For tests only
+static void EXPECT_EQ_GENERIC_SAMPLES(const StdFloatVec & lhs,
+                                      const Generic4VectorMath::FloatVec & rhs) {
+  for (unsigned i(0); i < StandardVectorMath::FloatVecSize; ++i) {
+    EXPECT_EQ(StandardVectorMath::GetByIndex(lhs, i),
+              Generic4VectorMath::GetByIndex(rhs, i));
+  }
+}
+
+TEST(ParityGeneric, Arithmetic) {
+  for (unsigned i(0); i < 64; ++i) {
+    float left[4];
+    float right[4];
+    for (unsigned j(0); j < 4; ++j) {
+      left[j] = kNormDistribution(kRandomGenerator);
+      right[j] = kNormDistribution(kRandomGenerator);
+    }
+    const StdFloatVec std_left = StandardVectorMath::Fill(left);
+    const StdFloatVec std_right = StandardVectorMath::Fill(right);
+    const Generic4VectorMath::FloatVec generic_left =
+      Generic4VectorMath::Fill(left[0], left[1], left[2], left[3]);
+    const Generic4VectorMath::FloatVec generic_right =
+      Generic4VectorMath::Fill(right);
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Add(std_left, std_right),
+                      Generic4VectorMath::Add(generic_left, generic_right));
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Sub(std_left, std_right),
+                      Generic4VectorMath::Sub(generic_left, generic_right));
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Mul(std_left, std_right),
+                      Generic4VectorMath::Mul(generic_left, generic_right));
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Div(std_left, std_right),
+                      Generic4VectorMath::Div(generic_left, generic_right));
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Min(std_left, std_right),
+                      Generic4VectorMath::Min(generic_left, generic_right));
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Max(std_left, std_right),
+                      Generic4VectorMath::Max(generic_left, generic_right));
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Sgn(std_left),
+                      Generic4VectorMath::Sgn(generic_left));
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::SgnNoZero(std_left),
+                      Generic4VectorMath::SgnNoZero(generic_left));
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::IncrementAndWrap(std_left, std_right),
+                      Generic4VectorMath::IncrementAndWrap(generic_left,
+                                                           generic_right));
+    EXPECT_EQ(SSE2VectorMath::AddHorizontal(SSE2VectorMath::Fill(left)),
+              Generic4VectorMath::AddHorizontal(generic_left));
+  }
+}
+
+TEST(ParityGeneric, Shuffles) {
+  const float values[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+  const StdFloatVec std_input = StandardVectorMath::Fill(values);
+  const Generic4VectorMath::FloatVec generic_input =
+    Generic4VectorMath::Fill(values);
+  const float unaligned_values[5] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f};
+  EXPECT_EQ_GENERIC_SAMPLES(
+    StandardVectorMath::FillUnaligned(&unaligned_values[1]),
+    Generic4VectorMath::FillUnaligned(&unaligned_values[1]));
+  EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::RotateOnRight(std_input, 5.0f),
+                    Generic4VectorMath::RotateOnRight(generic_input, 5.0f));
+  EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::RotateOnLeft(std_input, 5.0f),
+                    Generic4VectorMath::RotateOnLeft(generic_input, 5.0f));
+  EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Revert(std_input),
+                    Generic4VectorMath::Revert(generic_input));
+  EXPECT_EQ_GENERIC_SAMPLES(
+    StandardVectorMath::TakeEachRightHalf(std_input,
+                                          StandardVectorMath::Fill(6.0f)),
+    Generic4VectorMath::TakeEachRightHalf(generic_input,
+                                          Generic4VectorMath::Fill(6.0f)));
+  EXPECT_EQ_GENERIC_SAMPLES(
+    StandardVectorMath::TakeEachLeftHalf(std_input,
+                                         StandardVectorMath::Fill(6.0f)),
+    Generic4VectorMath::TakeEachLeftHalf(generic_input,
+                                         Generic4VectorMath::Fill(6.0f)));
+  EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::ShiftOnRight<2>(std_input, 5.0f),
+                    Generic4VectorMath::ShiftOnRight<2>(generic_input, 5.0f));
+  EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::SetByIndex<2>(std_input, 0.5f),
+                    Generic4VectorMath::SetByIndex<2>(generic_input, 0.5f));
+  const StdFloatVec std_right = StandardVectorMath::Fill(5.0f, 6.0f, 7.0f, 8.0f);
+  const Generic4VectorMath::FloatVec generic_right =
+    Generic4VectorMath::Fill(5.0f, 6.0f, 7.0f, 8.0f);
+  EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::AddSub(std_input, std_right),
+                    Generic4VectorMath::AddSub(generic_input, generic_right));
+  EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::DuplicateEven(std_input),
+                    Generic4VectorMath::DuplicateEven(generic_input));
+  EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::DuplicateOdd(std_input),
+                    Generic4VectorMath::DuplicateOdd(generic_input));
+  EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::SwapPairs(std_input),
+                    Generic4VectorMath::SwapPairs(generic_input));
+  EXPECT_EQ_GENERIC_SAMPLES(
+    StandardVectorMath::InterleaveLow(std_input, std_right),
+    Generic4VectorMath::InterleaveLow(generic_input, generic_right));
+  EXPECT_EQ_GENERIC_SAMPLES(
+    StandardVectorMath::InterleaveHigh(std_input, std_right),
+    Generic4VectorMath::InterleaveHigh(generic_input, generic_right));
+  EXPECT_EQ_GENERIC_SAMPLES(
+    StandardVectorMath::DeinterleaveEven(std_input, std_right),
+    Generic4VectorMath::DeinterleaveEven(generic_input, generic_right));
+  EXPECT_EQ_GENERIC_SAMPLES(
+    StandardVectorMath::DeinterleaveOdd(std_input, std_right),
+    Generic4VectorMath::DeinterleaveOdd(generic_input, generic_right));
+}
+
+TEST(ParityGeneric, Rounding) {
+  for (float value : kRoundingValues) {
+    const StdFloatVec std_input = StandardVectorMath::Fill(value);
+    const Generic4VectorMath::FloatVec generic_input =
+      Generic4VectorMath::Fill(value);
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Round(std_input),
+                      Generic4VectorMath::Round(generic_input));
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Trunc(std_input),
+                      Generic4VectorMath::Trunc(generic_input));
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Floor(std_input),
+                      Generic4VectorMath::Floor(generic_input));
+    EXPECT_EQ_GENERIC_SAMPLES(StandardVectorMath::Ceil(std_input),
+                      Generic4VectorMath::Ceil(generic_input));
+  }
+}
+
+template <typename TypeVectorMath>
+class GenericWidth : public ::testing::Test {};
+
+typedef ::testing::Types<GenericVectorMath<4>,
+                         GenericVectorMath<8>,
+                         GenericVectorMath<16> > GenericWidths;
+TYPED_TEST_SUITE(GenericWidth, GenericWidths);
+
+TYPED_TEST(GenericWidth, AgainstScalar) {
+  typedef TypeParam VectorMath;
+  const unsigned kSize(VectorMath::FloatVecSize);
+  float left[kSize];
+  float right[kSize];
+  for (unsigned i(0); i < kSize; ++i) {
+    left[i] = kNormDistribution(kRandomGenerator);
+    right[i] = kNormDistribution(kRandomGenerator);
+  }
+  const typename VectorMath::FloatVec left_v(VectorMath::Fill(left));
+  const typename VectorMath::FloatVec right_v(VectorMath::Fill(right));
+  const typename VectorMath::FloatVec mul(VectorMath::Mul(left_v, right_v));
+  const typename VectorMath::FloatVec max(VectorMath::Max(left_v, right_v));
+  const typename VectorMath::FloatVec rotated(
+    VectorMath::RotateOnRight(left_v, 2.0f));
+  const typename VectorMath::FloatVec reverted(VectorMath::Revert(left_v));
+  const typename VectorMath::FloatVec shifted(
+    VectorMath::template ShiftOnRight<3>(left_v, 2.0f));
+  const typename VectorMath::FloatVec selected(
+    VectorMath::Select(VectorMath::GreaterThan(left_v, right_v),
+                       VectorMath::Fill(1.0f),
+                       VectorMath::Fill(-1.0f)));
+  float sum(0.0f);
+  for (unsigned i(0); i < kSize; ++i) {
+    EXPECT_EQ(left[i] * right[i], VectorMath::GetByIndex(mul, i));
+    EXPECT_EQ(std::max(left[i], right[i]), VectorMath::GetByIndex(max, i));
+    EXPECT_EQ(i == 0 ? 2.0f : left[i - 1], VectorMath::GetByIndex(rotated, i));
+    EXPECT_EQ(left[kSize - 1 - i], VectorMath::GetByIndex(reverted, i));
+    EXPECT_EQ(i < 3 ? 2.0f : left[i - 3], VectorMath::GetByIndex(shifted, i));
+    EXPECT_EQ(left[i] > right[i] ? 1.0f : -1.0f,
+              VectorMath::GetByIndex(selected, i));
+    sum += left[i];
+  }
+  const typename VectorMath::FloatVec left_mask(
+    VectorMath::GreaterThan(left_v, VectorMath::Fill(0.0f)));
+  const typename VectorMath::FloatVec right_mask(
+    VectorMath::GreaterThan(right_v, VectorMath::Fill(0.0f)));
+  const typename VectorMath::FloatVec blended(
+    VectorMath::template Blend<5>(left_v, right_v));
+  float packed[kSize];
+  const unsigned int packed_count(
+    VectorMath::CompressStore(packed, left_mask, right_v));
+  unsigned int expected_count(0);
+  for (unsigned i(0); i < kSize; ++i) {
+    const bool l(left[i] > 0.0f);
+    const bool r(right[i] > 0.0f);
+    const unsigned int bit(1u << i);
+    EXPECT_EQ(l && r, (VectorMath::MoveMask(
+      VectorMath::And(left_mask, right_mask)) & bit) != 0);
+    EXPECT_EQ(l && !r, (VectorMath::MoveMask(
+      VectorMath::AndNot(left_mask, right_mask)) & bit) != 0);
+    EXPECT_EQ(l || r, (VectorMath::MoveMask(
+      VectorMath::Or(left_mask, right_mask)) & bit) != 0);
+    EXPECT_EQ(l != r, (VectorMath::MoveMask(
+      VectorMath::Xor(left_mask, right_mask)) & bit) != 0);
+    EXPECT_EQ(!l, (VectorMath::MoveMask(VectorMath::Not(left_mask)) & bit) != 0);
+    EXPECT_EQ(i < 3 && i != 1 ? right[i] : left[i],
+              VectorMath::GetByIndex(blended, i));
+    if (l) {
+      EXPECT_EQ(right[i], packed[expected_count]);
+      ++expected_count;
+    }
+  }
+  EXPECT_EQ(expected_count, packed_count);
+  // Infinity in the first element, denormal in the last
+  const unsigned int kInfinityBits(0x7f800000u);
+  const unsigned int kDenormalBits(0x00000010u);
+  float special[kSize];
+  std::memcpy(special, left, sizeof(special));
+  std::memcpy(&special[0], &kInfinityBits, sizeof(float));
+  std::memcpy(&special[kSize - 1], &kDenormalBits, sizeof(float));
+  const typename VectorMath::FloatVec special_v(VectorMath::Fill(special));
+  EXPECT_EQ(1u, VectorMath::MoveMask(VectorMath::IsNonFinite(special_v)));
+  EXPECT_EQ(1u << (kSize - 1),
+            VectorMath::MoveMask(VectorMath::IsDenormal(special_v)));
+  EXPECT_NEAR(sum, VectorMath::AddHorizontal(left_v), 1e-5f);
+  EXPECT_TRUE(VectorMath::IsMaskFull(VectorMath::Equal(left_v, left_v)));
+  EXPECT_TRUE(VectorMath::IsMaskNull(VectorMath::GreaterThan(left_v, left_v)));
+  vecmath::Float16 halves[kSize];
+  vecmath::BFloat16 brains[kSize];
+  VectorMath::StoreFloat16(halves, left_v);
+  VectorMath::StoreBFloat16(brains, left_v);
+  const typename VectorMath::FloatVec from_half(VectorMath::FillFloat16(halves));
+  const typename VectorMath::FloatVec from_brain(
+    VectorMath::FillBFloat16(brains));
+  for (unsigned i(0); i < kSize; ++i) {
+    EXPECT_EQ(vecmath::HalfConversion::ToFloat16(left[i]).bits, halves[i].bits);
+    EXPECT_EQ(vecmath::HalfConversion::ToFloat(halves[i]),
+              VectorMath::GetByIndex(from_half, i));
+    EXPECT_EQ(vecmath::HalfConversion::ToFloat(brains[i]),
+              VectorMath::GetByIndex(from_brain, i));
+  }
+}
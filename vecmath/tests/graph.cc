@@ -0,0 +1,196 @@
+/// @file tests/graph.cc
+/// @brief Processing graph tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <memory>
+#include <vector>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/graph.h"
+
+using vecmath::AlignedVector;
+using vecmath::BlockOut;
+using vecmath::FunctionNode;
+using vecmath::GainNode;
+using vecmath::GraphNode;
+using vecmath::MixNode;
+using vecmath::PlatformVectorMath;
+using vecmath::ProcessingGraph;
+using vecmath::SchedulingMode;
+
+static const unsigned int kGraphBlockLength = 64;
+
+static std::unique_ptr<GraphNode> MakeGain(const float gain) {
+  return std::unique_ptr<GraphNode>(new GainNode(gain));
+}
+
+static std::unique_ptr<GraphNode> MakeMix(const std::vector<float>& gains) {
+  return std::unique_ptr<GraphNode>(new MixNode(gains));
+}
+
+/// @brief A chain reuses two buffers, whatever its length
+TEST(Graph, ChainBuffers) {
+  ProcessingGraph graph(kGraphBlockLength, 0);
+  unsigned int last(graph.AddInput());
+  for (unsigned int i(0); i < 100; ++i) {
+    last = graph.AddNode(MakeGain(i % 2 == 0 ? 2.0f : 0.5f), {last});
+  }
+  graph.AddOutput(last);
+  graph.Prepare();
+  EXPECT_EQ(2u, graph.BufferCount());
+  EXPECT_EQ(100u, graph.LevelCount());
+
+  AlignedVector<float> input(kGraphBlockLength);
+  AlignedVector<float> output(kGraphBlockLength);
+  for (float& value : input) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  const float* inputs[] = {&input[0]};
+  float* outputs[] = {&output[0]};
+  graph.Process(inputs, outputs, kGraphBlockLength);
+  for (unsigned int i(0); i < kGraphBlockLength; ++i) {
+    EXPECT_EQ(input[i], output[i]);
+  }
+}
+
+/// @brief A diamond: outputs stay valid although buffers are shared
+TEST(Graph, Diamond) {
+  ProcessingGraph graph(kGraphBlockLength, 0);
+  const unsigned int input(graph.AddInput());
+  const unsigned int left(graph.AddNode(MakeGain(2.0f), {input}));
+  const unsigned int right(graph.AddNode(MakeGain(-3.0f), {input}));
+  const unsigned int mix(graph.AddNode(MakeMix({1.0f, 0.5f}), {left, right}));
+  // Unused node: its buffer is released right away
+  graph.AddNode(MakeGain(4.0f), {mix});
+  const unsigned int tail(graph.AddNode(MakeGain(0.25f), {mix}));
+  graph.AddOutput(tail);
+  graph.AddOutput(left);
+  graph.AddOutput(input);
+  graph.Prepare();
+  EXPECT_EQ(3u, graph.LevelCount());
+
+  AlignedVector<float> in(kGraphBlockLength);
+  AlignedVector<float> out(3 * kGraphBlockLength);
+  for (unsigned int block(0); block < 4; ++block) {
+    for (float& value : in) {
+      value = kNormDistribution(kRandomGenerator);
+    }
+    const float* inputs[] = {&in[0]};
+    float* outputs[] = {&out[0],
+                        &out[kGraphBlockLength],
+                        &out[2 * kGraphBlockLength]};
+    // Shorter blocks are allowed
+    const unsigned int length(block % 2 == 0
+                              ? kGraphBlockLength
+                              : 4 * PlatformVectorMath::FloatVecSize);
+    graph.Process(inputs, outputs, length);
+    for (unsigned int i(0); i < length; ++i) {
+      EXPECT_FLOAT_EQ(0.25f * (2.0f * in[i] - 1.5f * in[i]), out[i]);
+      EXPECT_EQ(2.0f * in[i], out[kGraphBlockLength + i]);
+      EXPECT_EQ(in[i], out[2 * kGraphBlockLength + i]);
+    }
+  }
+}
+
+class GraphSchedulingTest
+    : public ::testing::TestWithParam<SchedulingMode> {};
+
+/// @brief Hundreds of nodes on several workers match the single threaded
+/// result, block after block
+TEST_P(GraphSchedulingTest, WideMix) {
+  const unsigned int kInputs(16);
+  const unsigned int kBranches(12);
+  const unsigned int kBusses(8);
+  std::vector<std::unique_ptr<ProcessingGraph> > graphs;
+  graphs.emplace_back(new ProcessingGraph(kGraphBlockLength, 0));
+  graphs.emplace_back(new ProcessingGraph(kGraphBlockLength, 3, GetParam()));
+  for (auto& graph : graphs) {
+    std::vector<unsigned int> inputs;
+    for (unsigned int i(0); i < kInputs; ++i) {
+      inputs.push_back(graph->AddInput());
+    }
+    std::vector<std::vector<unsigned int> > busses(kBusses);
+    for (unsigned int i(0); i < kInputs; ++i) {
+      for (unsigned int branch(0); branch < kBranches; ++branch) {
+        const unsigned int gain(graph->AddNode(
+          MakeGain(0.01f * static_cast<float>(i * kBranches + branch)),
+          {inputs[i]}));
+        // Stateful node wrapping a kernel: one sample delay per FloatVec
+        std::shared_ptr<float> state(new float(0.0f));
+        const unsigned int delayed(graph->AddNode(
+          std::unique_ptr<GraphNode>(new FunctionNode(
+            [state](const float* const* sources, unsigned int,
+                    float* output, unsigned int length) {
+              for (unsigned int t(0); t < length;
+                   t += PlatformVectorMath::FloatVecSize) {
+                const PlatformVectorMath::FloatVec value(
+                  PlatformVectorMath::Fill(&sources[0][t]));
+                PlatformVectorMath::Store(
+                  &output[t],
+                  PlatformVectorMath::RotateOnRight(value, *state));
+                *state = PlatformVectorMath::GetByIndex<
+                  PlatformVectorMath::FloatVecSize - 1>(value);
+              }
+            })),
+          {gain}));
+        busses[(i + branch) % kBusses].push_back(delayed);
+      }
+    }
+    std::vector<unsigned int> bus_ids;
+    for (const auto& bus : busses) {
+      bus_ids.push_back(graph->AddNode(
+        MakeMix(std::vector<float>(bus.size(), 0.5f)), bus));
+    }
+    graph->AddOutput(graph->AddNode(
+      MakeMix(std::vector<float>(kBusses, 1.0f)), bus_ids));
+    graph->AddOutput(bus_ids[3]);
+    graph->Prepare();
+    EXPECT_EQ(4u, graph->LevelCount());
+    // Gains and delays are alive together, busses reuse the gains buffers
+    EXPECT_EQ(kInputs * kBranches * 2, graph->BufferCount());
+  }
+
+  AlignedVector<float> in(kInputs * kGraphBlockLength);
+  std::vector<AlignedVector<float> > out(
+    graphs.size(), AlignedVector<float>(2 * kGraphBlockLength));
+  std::vector<const float*> inputs;
+  for (unsigned int i(0); i < kInputs; ++i) {
+    inputs.push_back(&in[i * kGraphBlockLength]);
+  }
+  for (unsigned int block(0); block < 50; ++block) {
+    for (float& value : in) {
+      value = kNormDistribution(kRandomGenerator);
+    }
+    for (unsigned int graph(0); graph < graphs.size(); ++graph) {
+      float* outputs[] = {&out[graph][0], &out[graph][kGraphBlockLength]};
+      graphs[graph]->Process(&inputs[0], outputs, kGraphBlockLength);
+    }
+    for (unsigned int i(0); i < 2 * kGraphBlockLength; ++i) {
+      ASSERT_EQ(out[0][i], out[1][i]);
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Modes,
+                         GraphSchedulingTest,
+                         ::testing::Values(vecmath::kSchedulingThroughput,
+                                           vecmath::kSchedulingLatencyBounded));
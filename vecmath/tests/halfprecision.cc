@@ -0,0 +1,192 @@
+/// @file tests/halfprecision.cc
+/// @brief 16 bits floating point storage tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/half.h"
+#include "vecmath/inc/halfprecision.h"
+
+using vecmath::AlignedVector;
+using vecmath::BFloat16;
+using vecmath::Float16;
+using vecmath::HalfConversion;
+using vecmath::HalfPrecisionVectorMath;
+using vecmath::PlatformVectorMath;
+
+static const unsigned int kHalfLength = 1024;
+
+// Built from bits: the compiler or the FPU might flush denormals
+static float HalfTestFromBits(const unsigned int bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static std::uint16_t HalfBits(const float value) {
+  return HalfConversion::ToFloat16(value).bits;
+}
+
+static std::uint16_t BrainBits(const float value) {
+  return HalfConversion::ToBFloat16(value).bits;
+}
+
+TEST(Half, Float16Values) {
+  EXPECT_EQ(0x0000, HalfBits(0.0f));
+  EXPECT_EQ(0x8000, HalfBits(-0.0f));
+  EXPECT_EQ(0x3c00, HalfBits(1.0f));
+  EXPECT_EQ(0xc000, HalfBits(-2.0f));
+  EXPECT_EQ(0x3555, HalfBits(1.0f / 3.0f));
+  // Largest finite, then rounding up to infinity
+  EXPECT_EQ(0x7bff, HalfBits(65504.0f));
+  EXPECT_EQ(0x7bff, HalfBits(65519.0f));
+  EXPECT_EQ(0x7c00, HalfBits(65520.0f));
+  EXPECT_EQ(0xfc00, HalfBits(-1e10f));
+  // Smallest normal and denormals
+  EXPECT_EQ(0x0400, HalfBits(6.103515625e-05f));
+  EXPECT_EQ(0x0001, HalfBits(5.9604644775390625e-08f));
+  EXPECT_EQ(0x0000, HalfBits(HalfTestFromBits(0x33000000u)));
+  EXPECT_EQ(0x0001, HalfBits(HalfTestFromBits(0x33000001u)));
+  // Ties to even: 1 + 2^-11 is halfway between 0x3c00 and 0x3c01
+  EXPECT_EQ(0x3c00, HalfBits(1.0f + 1.0f / 2048.0f));
+  EXPECT_EQ(0x3c02, HalfBits(1.0f + 3.0f / 2048.0f));
+  // Infinities and NaN, whatever the payload
+  EXPECT_EQ(0x7c00, HalfBits(HalfTestFromBits(0x7f800000u)));
+  EXPECT_EQ(0x7e00, HalfBits(HalfTestFromBits(0x7fc00000u)));
+  EXPECT_EQ(0x7e00, HalfBits(HalfTestFromBits(0x7f800001u)));
+  EXPECT_EQ(0xfe00, HalfBits(HalfTestFromBits(0xffc00000u)));
+
+  // Every finite half value survives a round trip
+  for (unsigned int bits(0); bits < 0x10000u; ++bits) {
+    if ((bits & 0x7c00u) == 0x7c00u) {
+      continue;
+    }
+    Float16 half;
+    half.bits = static_cast<std::uint16_t>(bits);
+    EXPECT_EQ(bits, HalfBits(HalfConversion::ToFloat(half)));
+  }
+  Float16 denormal;
+  denormal.bits = 0x0001;
+  EXPECT_EQ(5.9604644775390625e-08f, HalfConversion::ToFloat(denormal));
+}
+
+TEST(Half, BFloat16Values) {
+  EXPECT_EQ(0x3f80, BrainBits(1.0f));
+  EXPECT_EQ(0xc000, BrainBits(-2.0f));
+  EXPECT_EQ(0x3eab, BrainBits(1.0f / 3.0f));
+  // Ties to even
+  EXPECT_EQ(0x3f80, BrainBits(HalfTestFromBits(0x3f808000u)));
+  EXPECT_EQ(0x3f82, BrainBits(HalfTestFromBits(0x3f818000u)));
+  EXPECT_EQ(0x3f81, BrainBits(HalfTestFromBits(0x3f808001u)));
+  // Overflow to infinity, NaN never rounded to infinity
+  EXPECT_EQ(0x7f80, BrainBits(HalfTestFromBits(0x7f7fffffu)));
+  EXPECT_EQ(0x7fc0, BrainBits(HalfTestFromBits(0x7fc00000u)));
+  EXPECT_EQ(0x7fc0, BrainBits(HalfTestFromBits(0x7f800001u)));
+  BFloat16 brain;
+  brain.bits = 0xbf80;
+  EXPECT_EQ(-1.0f, HalfConversion::ToFloat(brain));
+}
+
+template <typename Half>
+class HalfKernelsTest : public ::testing::Test {
+ protected:
+  HalfKernelsTest()
+      : input_(kHalfLength),
+        weights_(kHalfLength),
+        stored_(kHalfLength),
+        reference_(kHalfLength) {
+    for (unsigned int i(0); i < kHalfLength; ++i) {
+      input_[i] = kNormDistribution(kRandomGenerator);
+      weights_[i] = kNormDistribution(kRandomGenerator);
+    }
+    HalfPrecisionVectorMath::ToHalf(&input_[0], kHalfLength, &stored_[0]);
+    for (unsigned int i(0); i < kHalfLength; ++i) {
+      reference_[i] = HalfConversion::ToFloat(stored_[i]);
+    }
+  }
+
+  AlignedVector<float> input_;
+  AlignedVector<float> weights_;
+  std::vector<Half> stored_;
+  // Exact values of the stored samples
+  std::vector<float> reference_;
+};
+
+typedef ::testing::Types<Float16, BFloat16> HalfTypes;
+TYPED_TEST_SUITE(HalfKernelsTest, HalfTypes);
+
+TYPED_TEST(HalfKernelsTest, Conversions) {
+  // Relative precision: 11 (resp. 8) significant bits
+  const float kEpsilon(std::is_same<TypeParam, Float16>::value
+                       ? 1.0f / 2048.0f
+                       : 1.0f / 256.0f);
+  for (unsigned int i(0); i < kHalfLength; ++i) {
+    EXPECT_NEAR(this->input_[i],
+                this->reference_[i],
+                std::abs(this->input_[i]) * kEpsilon);
+  }
+  AlignedVector<float> output(kHalfLength);
+  HalfPrecisionVectorMath::FromHalf(&this->stored_[0], kHalfLength, &output[0]);
+  for (unsigned int i(0); i < kHalfLength; ++i) {
+    EXPECT_EQ(this->reference_[i], output[i]);
+  }
+}
+
+TYPED_TEST(HalfKernelsTest, FusedKernels) {
+  const float kGain(0.75f);
+  AlignedVector<float> scaled(kHalfLength);
+  HalfPrecisionVectorMath::Scale(&this->stored_[0], kHalfLength, kGain,
+                                 &scaled[0]);
+  AlignedVector<float> accumulated(this->weights_);
+  HalfPrecisionVectorMath::Accumulate(&this->stored_[0], kHalfLength, kGain,
+                                      &accumulated[0]);
+  double expected_dot(0.0);
+  for (unsigned int i(0); i < kHalfLength; ++i) {
+    EXPECT_FLOAT_EQ(kGain * this->reference_[i], scaled[i]);
+    EXPECT_NEAR(this->weights_[i] + kGain * this->reference_[i],
+                accumulated[i],
+                1e-6f);
+    expected_dot += static_cast<double>(this->reference_[i])
+                    * this->weights_[i];
+  }
+  EXPECT_NEAR(expected_dot,
+              HalfPrecisionVectorMath::DotProduct(&this->stored_[0],
+                                                  &this->weights_[0],
+                                                  kHalfLength),
+              1e-3);
+  // Odd FloatVec count: the tail is handled separately
+  const unsigned int kShortLength(3 * PlatformVectorMath::FloatVecSize);
+  double expected_short(0.0);
+  for (unsigned int i(0); i < kShortLength; ++i) {
+    expected_short += static_cast<double>(this->reference_[i])
+                      * this->weights_[i];
+  }
+  EXPECT_NEAR(expected_short,
+              HalfPrecisionVectorMath::DotProduct(&this->stored_[0],
+                                                  &this->weights_[0],
+                                                  kShortLength),
+              1e-5);
+}
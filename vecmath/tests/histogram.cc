@@ -0,0 +1,182 @@
+/// @file tests/histogram.cc
+/// @brief Histogram and quantization tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/histogram.h"
+#include "vecmath/inc/quantization.h"
+
+using vecmath::AlignedVector;
+using vecmath::Histogram;
+using vecmath::PlatformVectorMath;
+using vecmath::QuantizationVectorMath;
+
+static const unsigned int kHistogramLength = 8192;
+
+// Scalar reference bin
+static unsigned int ReferenceBin(const float value,
+                                 const unsigned int bins,
+                                 const float minimum,
+                                 const float maximum) {
+  if (!(value < maximum)) {
+    return bins - 1;
+  }
+  if (value < minimum) {
+    return 0;
+  }
+  const float position((value - minimum)
+                       * (static_cast<float>(bins) / (maximum - minimum)));
+  return std::min(bins - 1, static_cast<unsigned int>(position));
+}
+
+TEST(Histogram, Reference) {
+  const unsigned int kBins(37);
+  const float kMinimum(-2.0f);
+  const float kMaximum(3.0f);
+  AlignedVector<float> input(kHistogramLength);
+  for (float& value : input) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  input[5] = std::numeric_limits<float>::quiet_NaN();
+  input[6] = std::numeric_limits<float>::infinity();
+  input[7] = -std::numeric_limits<float>::infinity();
+  input[8] = kMaximum;
+  input[9] = kMinimum;
+  // Repeated values, all in the same lanes
+  for (unsigned int i(100); i < 200; ++i) {
+    input[i] = 0.5f;
+  }
+  Histogram histogram(kBins, kMinimum, kMaximum);
+  EXPECT_EQ(kBins, histogram.Bins());
+  // Irregular block lengths
+  const unsigned int kVecSize(PlatformVectorMath::FloatVecSize);
+  unsigned int index(0);
+  for (unsigned int block(0); index < kHistogramLength; ++block) {
+    const unsigned int length(std::min(kVecSize * (1 + (block * 5) % 9),
+                                       kHistogramLength - index));
+    histogram.Accumulate(&input[index], length);
+    index += length;
+  }
+  std::vector<std::uint64_t> expected(kBins, 0);
+  for (const float value : input) {
+    expected[ReferenceBin(value, kBins, kMinimum, kMaximum)] += 1;
+  }
+  std::vector<std::uint64_t> counts(kBins);
+  histogram.Counts(&counts[0]);
+  for (unsigned int bin(0); bin < kBins; ++bin) {
+    EXPECT_EQ(expected[bin], counts[bin]) << bin;
+    EXPECT_EQ(expected[bin], histogram.Count(bin)) << bin;
+  }
+  EXPECT_EQ(kHistogramLength, histogram.Total());
+  EXPECT_EQ(kBins - 1, histogram.BinIndex(kMaximum));
+  EXPECT_EQ(0u, histogram.BinIndex(kMinimum));
+  EXPECT_EQ(ReferenceBin(0.5f, kBins, kMinimum, kMaximum),
+            histogram.BinIndex(0.5f));
+  histogram.Reset();
+  EXPECT_EQ(0u, histogram.Total());
+}
+
+TEST(Quantization, Uniform) {
+  const unsigned int kBits(12);
+  const float kStep(1.0f / 2048.0f);
+  AlignedVector<float> input(kHistogramLength);
+  AlignedVector<int> codes(kHistogramLength);
+  AlignedVector<float> output(kHistogramLength);
+  for (unsigned int i(0); i < kHistogramLength; ++i) {
+    input[i] = -1.2f + 2.4f * static_cast<float>(i) / kHistogramLength;
+  }
+  QuantizationVectorMath::Quantize(&input[0], kHistogramLength, kBits, &codes[0]);
+  QuantizationVectorMath::Dequantize(&codes[0],
+                                     kHistogramLength,
+                                     kBits,
+                                     &output[0]);
+  for (unsigned int i(0); i < kHistogramLength; ++i) {
+    ASSERT_LE(-2048, codes[i]);
+    ASSERT_GE(2047, codes[i]);
+    const float clamped(std::min(1.0f - kStep, std::max(-1.0f, input[i])));
+    EXPECT_NEAR(clamped, output[i], 0.5f * kStep) << i;
+    EXPECT_EQ(static_cast<float>(codes[i]) * kStep, output[i]);
+  }
+}
+
+// Companding curves against their scalar definitions, and round trips
+TEST(Quantization, Companding) {
+  const double kMu(255.0);
+  const double kA(87.6);
+  for (float input(-1.0f); input <= 1.0f; input += 0.001f) {
+    const double magnitude(std::abs(input));
+    const double sign(input < 0.0f ? -1.0 : 1.0);
+    const double mu_law(sign * std::log1p(kMu * magnitude) / std::log1p(kMu));
+    const double a_law(sign * (kA * magnitude < 1.0
+                               ? kA * magnitude
+                               : 1.0 + std::log(kA * magnitude))
+                       / (1.0 + std::log(kA)));
+    const PlatformVectorMath::FloatVec value(PlatformVectorMath::Fill(input));
+    const float mu_compressed(PlatformVectorMath::GetByIndex<0>(
+      QuantizationVectorMath::MuLawCompress(value)));
+    const float a_compressed(PlatformVectorMath::GetByIndex<0>(
+      QuantizationVectorMath::ALawCompress(value)));
+    EXPECT_NEAR(mu_law, mu_compressed, 1e-6);
+    EXPECT_NEAR(a_law, a_compressed, 1e-6);
+    EXPECT_NEAR(input,
+                PlatformVectorMath::GetByIndex<0>(
+                  QuantizationVectorMath::MuLawExpand(
+                    PlatformVectorMath::Fill(mu_compressed))),
+                1e-5f);
+    EXPECT_NEAR(input,
+                PlatformVectorMath::GetByIndex<0>(
+                  QuantizationVectorMath::ALawExpand(
+                    PlatformVectorMath::Fill(a_compressed))),
+                1e-5f);
+  }
+}
+
+// 8 bits companded codes: roughly constant relative error over a wide range
+TEST(Quantization, CompandedCodes) {
+  const unsigned int kLength(64);
+  AlignedVector<float> input(kLength);
+  AlignedVector<int> codes(kLength);
+  AlignedVector<float> output(kLength);
+  for (unsigned int i(0); i < kLength; ++i) {
+    // From -60dB to 0dB, both signs
+    input[i] = (i % 2 ? -1.0f : 1.0f)
+               * std::pow(10.0f, -3.0f + 3.0f * i / (kLength - 1));
+  }
+  QuantizationVectorMath::MuLawQuantize(&input[0], kLength, 8, &codes[0]);
+  QuantizationVectorMath::MuLawDequantize(&codes[0], kLength, 8, &output[0]);
+  for (unsigned int i(0); i < kLength; ++i) {
+    EXPECT_NEAR(input[i], output[i], std::abs(input[i]) * 0.05f + 1e-4f) << i;
+  }
+  QuantizationVectorMath::ALawQuantize(&input[0], kLength, 8, &codes[0]);
+  QuantizationVectorMath::ALawDequantize(&codes[0], kLength, 8, &output[0]);
+  for (unsigned int i(0); i < kLength; ++i) {
+    ASSERT_LE(-128, codes[i]);
+    ASSERT_GE(127, codes[i]);
+    EXPECT_NEAR(input[i], output[i], std::abs(input[i]) * 0.05f + 2e-4f) << i;
+  }
+}
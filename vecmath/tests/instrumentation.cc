@@ -0,0 +1,81 @@
+/// @file tests/instrumentation.cc
+/// @brief Vecmath tests - hot-path instrumentation (built instrumented)
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <sstream>
+#include <thread>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/instrumentation.h"
+
+using vecmath::Instrumentation;
+using vecmath::KernelReport;
+
+static void DummyKernel(const unsigned length) {
+  VECMATH_PROFILE_KERNEL("DummyKernel", length, length * sizeof(float));
+}
+
+static KernelReport FindReport(const char* name) {
+  const std::vector<KernelReport> reports(Instrumentation::Collect());
+  for (unsigned i(0); i < reports.size(); ++i) {
+    if (reports[i].name == name) {
+      return reports[i];
+    }
+  }
+  const KernelReport empty = {name, 0, 0, 0, 0, 0};
+  return empty;
+}
+
+TEST(Instrumentation, Counters) {
+  Instrumentation::Reset();
+  for (unsigned i(0); i < 10; ++i) {
+    DummyKernel(64);
+  }
+  const KernelReport report(FindReport("DummyKernel"));
+  EXPECT_EQ(10u, report.calls);
+  EXPECT_EQ(640u, report.samples);
+  EXPECT_EQ(640u * sizeof(float), report.bytes);
+}
+
+TEST(Instrumentation, Threads) {
+  Instrumentation::Reset();
+  std::thread worker([]() {
+    for (unsigned i(0); i < 5; ++i) {
+      DummyKernel(16);
+    }
+  });
+  DummyKernel(16);
+  worker.join();
+  // The worker table has been retired, its counters must remain
+  const KernelReport report(FindReport("DummyKernel"));
+  EXPECT_EQ(6u, report.calls);
+  EXPECT_EQ(96u, report.samples);
+}
+
+TEST(Instrumentation, Report) {
+  Instrumentation::Reset();
+  DummyKernel(4);
+  std::ostringstream stream;
+  Instrumentation::Report(stream);
+  EXPECT_NE(std::string::npos, stream.str().find("DummyKernel"));
+  Instrumentation::Reset();
+  EXPECT_EQ(0u, FindReport("DummyKernel").calls);
+}
@@ -0,0 +1,91 @@
+/// @file tests/leftpack.cc
+/// @brief Left-packing kernels tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <cmath>
+#include <vector>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/leftpack.h"
+
+using vecmath::AlignedVector;
+using vecmath::LeftPackVectorMath;
+using vecmath::PlatformVectorMath;
+
+static const unsigned int kLeftPackLength = 4096;
+
+TEST(LeftPack, CompressAgainstScalar) {
+  AlignedVector<float> input(kLeftPackLength);
+  for (float& value : input) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  // Densities from none to all selected
+  const float kThresholds[] = {2.0f, 0.9f, 0.0f, -0.9f, -2.0f};
+  for (const float threshold : kThresholds) {
+    std::vector<float> expected;
+    for (const float value : input) {
+      if (value > threshold) {
+        expected.push_back(value);
+      }
+    }
+    std::vector<float> output(kLeftPackLength);
+    const PlatformVectorMath::FloatVec threshold_v(
+      PlatformVectorMath::Fill(threshold));
+    const unsigned int count(LeftPackVectorMath::Compress(
+      &input[0], kLeftPackLength,
+      [threshold_v](PlatformVectorMath::FloatVecRead values) {
+        return PlatformVectorMath::GreaterThan(values, threshold_v);
+      },
+      &output[0]));
+    ASSERT_EQ(expected.size(), count);
+    for (unsigned int i(0); i < count; ++i) {
+      EXPECT_EQ(expected[i], output[i]);
+    }
+  }
+}
+
+TEST(LeftPack, IndicesAbove) {
+  AlignedVector<float> input(kLeftPackLength);
+  for (float& value : input) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  // Sparse "onsets"
+  input[0] = -3.0f;
+  input[17] = 3.0f;
+  input[kLeftPackLength - 1] = 3.0f;
+  const float kThreshold(0.995f);
+  std::vector<unsigned int> expected;
+  for (unsigned int i(0); i < kLeftPackLength; ++i) {
+    if (std::fabs(input[i]) > kThreshold) {
+      expected.push_back(i);
+    }
+  }
+  std::vector<unsigned int> indices(kLeftPackLength);
+  const unsigned int count(LeftPackVectorMath::IndicesAbove(
+    &input[0], kLeftPackLength, kThreshold, &indices[0]));
+  ASSERT_EQ(expected.size(), count);
+  for (unsigned int i(0); i < count; ++i) {
+    EXPECT_EQ(expected[i], indices[i]);
+  }
+  EXPECT_EQ(0u, indices[0]);
+  EXPECT_EQ(kLeftPackLength - 1, indices[count - 1]);
+}
@@ -0,0 +1,125 @@
+/// @file tests/loudness.cc
+/// @brief Loudness and true-peak meter tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/loudness.h"
+
+using vecmath::LoudnessMeter;
+
+static const double kLoudnessRate = 48000.0;
+// Copied: gtest takes its arguments by reference
+static const double kSilence = LoudnessMeter::kSilence;
+
+// Fill "count" frames of "channels" identical channels with a sine wave
+static void AppendSine(const double frequency,
+                       const double amplitude,
+                       const double phase,
+                       const unsigned int count,
+                       std::vector<float>* const signal) {
+  const double kTwoPi(6.283185307179586);
+  const std::size_t offset(signal->size());
+  for (unsigned int i(0); i < count; ++i) {
+    signal->push_back(static_cast<float>(
+      amplitude * std::sin(kTwoPi * frequency * (offset + i) / kLoudnessRate
+                           + phase)));
+  }
+}
+
+// Feed the same signal to all channels, by irregular block lengths
+static void Measure(const std::vector<float>& signal,
+                    const unsigned int channels,
+                    LoudnessMeter* const meter) {
+  const unsigned int kBlockLengths[] = {64, 1000, 7, 4800, 333};
+  std::size_t done(0);
+  unsigned int block(0);
+  while (done < signal.size()) {
+    const unsigned int length(static_cast<unsigned int>(
+      std::min<std::size_t>(kBlockLengths[block % 5], signal.size() - done)));
+    std::vector<const float*> inputs(channels, &signal[done]);
+    meter->Process(&inputs[0], length);
+    done += length;
+    block += 1;
+  }
+}
+
+/// @brief Stereo 1kHz sine at -23dBFS reads -23LUFS (EBU Tech 3341)
+TEST(Loudness, ReferenceSine) {
+  std::vector<float> signal;
+  AppendSine(1000.0, std::pow(10.0, -23.0 / 20.0), 0.0, 480000, &signal);
+  LoudnessMeter meter(2, kLoudnessRate);
+  EXPECT_EQ(kSilence, meter.Momentary());
+  EXPECT_EQ(kSilence, meter.Integrated());
+  Measure(signal, 2, &meter);
+  EXPECT_NEAR(-23.0, meter.Momentary(), 0.1);
+  EXPECT_NEAR(-23.0, meter.ShortTerm(), 0.1);
+  EXPECT_NEAR(-23.0, meter.Integrated(), 0.1);
+
+  // Odd channel counts: only the first channel of the group is weighted
+  LoudnessMeter mono(5, kLoudnessRate);
+  for (unsigned int channel(1); channel < 5; ++channel) {
+    mono.SetChannelWeight(channel, 0.0f);
+  }
+  Measure(signal, 5, &mono);
+  EXPECT_NEAR(-26.01, mono.Integrated(), 0.1);
+
+  meter.Reset();
+  EXPECT_EQ(kSilence, meter.Integrated());
+}
+
+/// @brief Gating: quiet parts do not lower the integrated loudness
+TEST(Loudness, Gating) {
+  // EBU Tech 3341 case 3, shortened
+  std::vector<float> signal;
+  AppendSine(1000.0, std::pow(10.0, -36.0 / 20.0), 0.0, 240000, &signal);
+  AppendSine(1000.0, std::pow(10.0, -23.0 / 20.0), 0.0, 960000, &signal);
+  AppendSine(1000.0, std::pow(10.0, -36.0 / 20.0), 0.0, 240000, &signal);
+  // Below the absolute gate
+  AppendSine(1000.0, std::pow(10.0, -80.0 / 20.0), 0.0, 480000, &signal);
+  LoudnessMeter meter(2, kLoudnessRate);
+  Measure(signal, 2, &meter);
+  EXPECT_NEAR(-23.0, meter.Integrated(), 0.1);
+  EXPECT_NEAR(-80.0, meter.ShortTerm(), 0.1);
+}
+
+/// @brief Inter-sample peaks are detected by oversampling
+TEST(Loudness, TruePeak) {
+  // fs/4 sine sampled at +-45 degrees: sample peaks are 3dB below
+  std::vector<float> signal;
+  AppendSine(12000.0, 0.5, 0.25 * 3.141592653589793, 48000, &signal);
+  float sample_peak(0.0f);
+  for (const float sample : signal) {
+    sample_peak = std::max(sample_peak, std::abs(sample));
+  }
+  LoudnessMeter meter(3, kLoudnessRate);
+  Measure(signal, 3, &meter);
+  const double expected(20.0 * std::log10(0.5));
+  EXPECT_NEAR(expected - 3.01, 20.0 * std::log10(sample_peak), 0.01);
+  for (unsigned int channel(0); channel < 3; ++channel) {
+    EXPECT_NEAR(expected, meter.TruePeak(channel), 0.5);
+    EXPECT_LE(meter.TruePeak(channel), expected + 0.1);
+  }
+  EXPECT_EQ(meter.TruePeak(0), meter.MaxTruePeak());
+}
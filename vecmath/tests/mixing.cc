@@ -0,0 +1,164 @@
+/// @file tests/mixing.cc
+/// @brief Mixing matrices tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <vector>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/mixing.h"
+
+using vecmath::AlignedVector;
+using vecmath::MixingMatrix;
+using vecmath::MixingVectorMath;
+using vecmath::PlatformVectorMath;
+
+static const float kMixingTolerance = 1e-5f;
+static const unsigned int kMixingLength = 256;
+
+/// @brief Planar buffers and their pointers
+struct PlanarBuffers {
+  PlanarBuffers(const unsigned int channels, const unsigned int length)
+      : data(channels * length, 0.0f),
+        pointers(channels) {
+    for (unsigned int i(0); i < channels; ++i) {
+      pointers[i] = &data[i * length];
+    }
+  }
+
+  AlignedVector<float> data;
+  std::vector<float*> pointers;
+};
+
+static std::vector<float> RandomGains(const unsigned int count) {
+  std::vector<float> gains(count);
+  for (float& gain : gains) {
+    gain = kNormDistribution(kRandomGenerator);
+  }
+  return gains;
+}
+
+TEST(Mixing, AgainstScalar) {
+  const unsigned int kSizes[][2] = {{1, 1}, {3, 5}, {4, 4}, {8, 2}, {2, 7}};
+  for (const auto& size : kSizes) {
+    const unsigned int inputs_count(size[0]);
+    const unsigned int outputs_count(size[1]);
+    PlanarBuffers inputs(inputs_count, kMixingLength);
+    PlanarBuffers outputs(outputs_count, kMixingLength);
+    for (float& value : inputs.data) {
+      value = kNormDistribution(kRandomGenerator);
+    }
+    const std::vector<float> gains(RandomGains(inputs_count * outputs_count));
+    const std::vector<float> targets(RandomGains(inputs_count * outputs_count));
+    AlignedVector<float> start(gains.size() * PlatformVectorMath::FloatVecSize);
+    AlignedVector<float> delta(start.size());
+    std::vector<float> differences(gains.size());
+    for (unsigned int i(0); i < gains.size(); ++i) {
+      differences[i] = targets[i] - gains[i];
+    }
+    MixingVectorMath::BroadcastGains(&gains[0], gains.size(), &start[0]);
+    MixingVectorMath::BroadcastGains(&differences[0], gains.size(), &delta[0]);
+
+    MixingVectorMath::Mix(&start[0], &inputs.pointers[0], inputs_count,
+                          &outputs.pointers[0], outputs_count, kMixingLength);
+    for (unsigned int output(0); output < outputs_count; ++output) {
+      for (unsigned int t(0); t < kMixingLength; ++t) {
+        float expected(0.0f);
+        for (unsigned int input(0); input < inputs_count; ++input) {
+          expected += gains[output * inputs_count + input]
+                      * inputs.pointers[input][t];
+        }
+        EXPECT_NEAR(expected, outputs.pointers[output][t], kMixingTolerance);
+      }
+    }
+
+    MixingVectorMath::MixRamp(&start[0], &delta[0],
+                              &inputs.pointers[0], inputs_count,
+                              &outputs.pointers[0], outputs_count,
+                              kMixingLength);
+    for (unsigned int output(0); output < outputs_count; ++output) {
+      for (unsigned int t(0); t < kMixingLength; ++t) {
+        const float position(static_cast<float>(t + 1) / kMixingLength);
+        float expected(0.0f);
+        for (unsigned int input(0); input < inputs_count; ++input) {
+          const unsigned int index(output * inputs_count + input);
+          expected += (gains[index] + differences[index] * position)
+                      * inputs.pointers[input][t];
+        }
+        EXPECT_NEAR(expected, outputs.pointers[output][t], kMixingTolerance);
+      }
+    }
+  }
+}
+
+TEST(Mixing, MatrixSmoothing) {
+  const unsigned int kInputs(2);
+  const unsigned int kOutputs(3);
+  PlanarBuffers inputs(kInputs, kMixingLength);
+  PlanarBuffers outputs(kOutputs, kMixingLength);
+  std::fill(inputs.data.begin(), inputs.data.end(), 1.0f);
+  MixingMatrix matrix(kInputs, kOutputs);
+  const std::vector<float> gains(RandomGains(kInputs * kOutputs));
+  matrix.SetGains(&gains[0]);
+  matrix.Jump();
+  matrix.Process(&inputs.pointers[0], &outputs.pointers[0], kMixingLength);
+  EXPECT_NEAR(gains[0] + gains[1], outputs.pointers[0][0], kMixingTolerance);
+  // Ramp from the previous gains to the new one
+  matrix.SetGain(2, 1, gains[5] + 1.0f);
+  matrix.Process(&inputs.pointers[0], &outputs.pointers[0], kMixingLength);
+  const float expected_start(gains[4] + gains[5]);
+  for (unsigned int t(0); t < kMixingLength; ++t) {
+    EXPECT_NEAR(expected_start + static_cast<float>(t + 1) / kMixingLength,
+                outputs.pointers[2][t],
+                kMixingTolerance);
+    EXPECT_NEAR(gains[0] + gains[1], outputs.pointers[0][t], kMixingTolerance);
+  }
+  EXPECT_EQ(gains[5] + 1.0f, matrix.Gain(2, 1));
+  // Then constant again
+  matrix.Process(&inputs.pointers[0], &outputs.pointers[0], kMixingLength);
+  EXPECT_NEAR(expected_start + 1.0f, outputs.pointers[2][0], kMixingTolerance);
+}
+
+TEST(Mixing, TransformFrames) {
+  const unsigned int kSize(PlatformVectorMath::FloatVecSize);
+  const unsigned int kFrames(64);
+  AlignedVector<float> matrix(kSize * kSize);
+  AlignedVector<float> input(kFrames * kSize);
+  AlignedVector<float> output(kFrames * kSize);
+  for (float& value : matrix) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  for (float& value : input) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  MixingVectorMath::TransformFrames(&matrix[0], &input[0], &output[0],
+                                    kFrames);
+  for (unsigned int frame(0); frame < kFrames; ++frame) {
+    for (unsigned int row(0); row < kSize; ++row) {
+      float expected(0.0f);
+      for (unsigned int column(0); column < kSize; ++column) {
+        expected += matrix[column * kSize + row]
+                    * input[frame * kSize + column];
+      }
+      EXPECT_NEAR(expected, output[frame * kSize + row], kMixingTolerance);
+    }
+  }
+}
@@ -0,0 +1,120 @@
+/// @file tests/multichannel.cc
+/// @brief Multichannel buffer tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+
+#include <utility>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/multichannel.h"
+
+using vecmath::ConstMultiChannelView;
+using vecmath::IsAligned;
+using vecmath::MultiChannelBuffer;
+using vecmath::MultiChannelView;
+using vecmath::PlatformVectorMath;
+
+TEST(MultiChannel, Layout) {
+  const unsigned int kLengths[] = {4, 60, 64, 256, 512, 1000, 1024, 2048, 4096};
+  for (const unsigned int length : kLengths) {
+    MultiChannelBuffer buffer(5, length);
+    EXPECT_EQ(5u, buffer.Channels());
+    EXPECT_EQ(length, buffer.Length());
+    EXPECT_LE(length, buffer.Stride());
+    // Whole cache lines, channels never a multiple of 4KiB apart
+    EXPECT_EQ(0u, buffer.Stride() % 16);
+    for (unsigned int k(1); k < 64; ++k) {
+      EXPECT_NE(0u, (k * buffer.Stride() * sizeof(float)) % 4096);
+    }
+    for (unsigned int channel(0); channel < buffer.Channels(); ++channel) {
+      EXPECT_TRUE(IsAligned(buffer.Channel(channel), 64));
+      EXPECT_EQ(buffer.Channel(channel), buffer.Pointers()[channel]);
+      EXPECT_EQ(buffer.Channel(channel), buffer.View().Channel(channel));
+      for (unsigned int i(0); i < length; ++i) {
+        EXPECT_EQ(0.0f, buffer.Channel(channel)[i]);
+      }
+    }
+  }
+  EXPECT_EQ(1040u, MultiChannelBuffer::PaddedStride(1024));
+  EXPECT_EQ(1008u, MultiChannelBuffer::PaddedStride(1000));
+  EXPECT_EQ(16u, MultiChannelBuffer::PaddedStride(4));
+  EXPECT_EQ(528u, MultiChannelBuffer::PaddedStride(512));
+  EXPECT_EQ(272u, MultiChannelBuffer::PaddedStride(256));
+}
+
+TEST(MultiChannel, Views) {
+  MultiChannelBuffer buffer(4, 256);
+  for (unsigned int channel(0); channel < 4; ++channel) {
+    for (unsigned int i(0); i < 256; ++i) {
+      buffer.Channel(channel)[i] = static_cast<float>(channel * 1000 + i);
+    }
+  }
+  const MultiChannelView view(buffer.View());
+  const MultiChannelView range(view.Range(32, 64).ChannelRange(1, 2));
+  EXPECT_EQ(2u, range.Channels());
+  EXPECT_EQ(64u, range.Length());
+  EXPECT_EQ(buffer.Stride(), range.Stride());
+  EXPECT_EQ(1032.0f, range.Channel(0)[0]);
+  EXPECT_EQ(2095.0f, range.Channel(1)[63]);
+  // Const conversion, from the const buffer too
+  const ConstMultiChannelView const_range(range);
+  EXPECT_EQ(range.Channel(1), const_range.Channel(1));
+  const MultiChannelBuffer& const_buffer(buffer);
+  EXPECT_EQ(buffer.Channel(3), const_buffer.View().Channel(3));
+  EXPECT_EQ(buffer.Channel(3), const_buffer.Pointers()[3]);
+  // Moving keeps the channels
+  float* const first(buffer.Channel(0));
+  MultiChannelBuffer moved(std::move(buffer));
+  EXPECT_EQ(first, moved.Channel(0));
+  EXPECT_EQ(moved.Channel(2), moved.Pointers()[2]);
+}
+
+TEST(MultiChannel, Apply) {
+  MultiChannelBuffer input(3, 128);
+  MultiChannelBuffer output(3, 128);
+  input.View().Apply([](float* const samples, const unsigned int length) {
+    for (unsigned int i(0); i < length; ++i) {
+      samples[i] = static_cast<float>(i);
+    }
+  });
+  // Only the middle of each channel
+  vecmath::ApplyChannels(
+    input.View().Range(16, 64),
+    output.View().Range(16, 64),
+    [](vecmath::BlockIn in, vecmath::BlockOut out, const unsigned int length) {
+      for (unsigned int i(0); i < length;
+           i += PlatformVectorMath::FloatVecSize) {
+        PlatformVectorMath::Store(
+          &out[i],
+          PlatformVectorMath::Mul(PlatformVectorMath::Fill(&in[i]),
+                                  PlatformVectorMath::Fill(2.0f)));
+      }
+    });
+  for (unsigned int channel(0); channel < 3; ++channel) {
+    for (unsigned int i(0); i < 128; ++i) {
+      const float expected(i >= 16 && i < 80 ? 2.0f * i : 0.0f);
+      EXPECT_EQ(expected, output.Channel(channel)[i]);
+    }
+  }
+  output.Clear();
+  EXPECT_EQ(0.0f, output.Channel(2)[40]);
+}
@@ -0,0 +1,152 @@
+/// @file tests/onepole.cc
+/// @brief First order recursive filters tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <cmath>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/onepole.h"
+
+using vecmath::AlignedVector;
+using vecmath::DCBlocker;
+using vecmath::EnvelopeFollower;
+using vecmath::OnePole;
+using vecmath::PlatformVectorMath;
+using vecmath::RecursiveVectorMath;
+
+static const float kRecursiveTolerance = 1e-5f;
+static const unsigned int kRecursiveLength = 4096;
+
+TEST(OnePole, ScanAndPowers) {
+  const float kPole(0.75f);
+  alignas(16) float input[PlatformVectorMath::FloatVecSize];
+  for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+    input[i] = kNormDistribution(kRandomGenerator);
+  }
+  const PlatformVectorMath::FloatVec scanned(
+    RecursiveVectorMath::Scan(PlatformVectorMath::Fill(input), kPole));
+  const PlatformVectorMath::FloatVec powers(
+    RecursiveVectorMath::Powers(kPole));
+  float expected(0.0f);
+  float expected_power(1.0f);
+  for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+    expected = kPole * expected + input[i];
+    expected_power *= kPole;
+    EXPECT_NEAR(expected, PlatformVectorMath::GetByIndex(scanned, i),
+                kRecursiveTolerance);
+    EXPECT_FLOAT_EQ(expected_power, PlatformVectorMath::GetByIndex(powers, i));
+  }
+}
+
+TEST(OnePole, ScanVarying) {
+  alignas(16) float input[PlatformVectorMath::FloatVecSize];
+  alignas(16) float coefficients[PlatformVectorMath::FloatVecSize];
+  for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+    input[i] = kNormDistribution(kRandomGenerator);
+    coefficients[i] = kNormDistribution(kRandomGenerator);
+  }
+  PlatformVectorMath::FloatVec products;
+  const PlatformVectorMath::FloatVec scanned(RecursiveVectorMath::ScanVarying(
+    PlatformVectorMath::Fill(input),
+    PlatformVectorMath::Fill(coefficients),
+    &products));
+  float expected(0.0f);
+  float expected_product(1.0f);
+  for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+    expected = coefficients[i] * expected + input[i];
+    expected_product *= coefficients[i];
+    EXPECT_NEAR(expected, PlatformVectorMath::GetByIndex(scanned, i),
+                kRecursiveTolerance);
+    EXPECT_NEAR(expected_product, PlatformVectorMath::GetByIndex(products, i),
+                kRecursiveTolerance);
+  }
+}
+
+TEST(OnePole, AgainstScalar) {
+  const float kPoles[] = {0.0f, 0.5f, -0.7f, 0.999f};
+  AlignedVector<float> input(kRecursiveLength);
+  AlignedVector<float> output(kRecursiveLength);
+  for (float& value : input) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  for (const float pole : kPoles) {
+    OnePole filter(pole, 1.0f - pole);
+    OnePole reference(filter);
+    filter.Reset(0.25f);
+    reference.Reset(0.25f);
+    // Split in several blocks to check the state carry
+    const unsigned int kSplit(kRecursiveLength / 4);
+    filter.Process(&input[0], &output[0], kSplit);
+    filter.Process(&input[kSplit], &output[kSplit], kRecursiveLength - kSplit);
+    for (unsigned int i(0); i < kRecursiveLength; ++i) {
+      EXPECT_NEAR(reference.Process(input[i]), output[i], kRecursiveTolerance);
+    }
+    EXPECT_NEAR(reference.State(), filter.State(), kRecursiveTolerance);
+  }
+}
+
+TEST(OnePole, Smoother) {
+  const float kSamplingRate(48000.0f);
+  OnePole smoother(OnePole::Smoother(0.001f, kSamplingRate));
+  AlignedVector<float> step(48, 1.0f);
+  smoother.Process(&step[0], 48);
+  // One time constant: 1 - 1/e
+  EXPECT_NEAR(1.0f - std::exp(-1.0f), step[47], 1e-4f);
+}
+
+TEST(OnePole, DCBlocker) {
+  const float kPole(0.99f);
+  DCBlocker blocker(kPole);
+  AlignedVector<float> input(kRecursiveLength);
+  AlignedVector<float> output(kRecursiveLength);
+  for (float& value : input) {
+    value = 1.0f + kNormDistribution(kRandomGenerator);
+  }
+  blocker.Process(&input[0], &output[0], kRecursiveLength / 2);
+  blocker.Process(&input[kRecursiveLength / 2],
+                  &output[kRecursiveLength / 2],
+                  kRecursiveLength / 2);
+  float previous_input(0.0f);
+  float previous_output(0.0f);
+  for (unsigned int i(0); i < kRecursiveLength; ++i) {
+    previous_output = input[i] - previous_input + kPole * previous_output;
+    previous_input = input[i];
+    EXPECT_NEAR(previous_output, output[i], kRecursiveTolerance);
+  }
+}
+
+TEST(OnePole, EnvelopeFollower) {
+  EnvelopeFollower follower(0.2f, 0.01f);
+  EnvelopeFollower reference(follower);
+  AlignedVector<float> input(kRecursiveLength);
+  AlignedVector<float> output(kRecursiveLength);
+  // Bursts of noise separated by silences
+  for (unsigned int i(0); i < kRecursiveLength; ++i) {
+    const float burst((i / 512) % 2 == 0 ? 1.0f : 0.0f);
+    input[i] = burst * kNormDistribution(kRandomGenerator);
+  }
+  follower.Process(&input[0], &output[0], kRecursiveLength);
+  for (unsigned int i(0); i < kRecursiveLength; ++i) {
+    EXPECT_NEAR(reference.Process(input[i]), output[i], kRecursiveTolerance);
+  }
+  EXPECT_NEAR(reference.State(), follower.State(), kRecursiveTolerance);
+}
@@ -0,0 +1,162 @@
+/// @file tests/polynomial.cc
+/// @brief Polynomial, rational and spline evaluators tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <cmath>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/polynomial.h"
+
+using vecmath::PlatformVectorMath;
+using vecmath::Polynomial;
+using vecmath::Rational;
+using vecmath::Spline;
+
+static const float kPolynomialTolerance = 1e-5f;
+
+/// @brief exp(x) Taylor expansion, up to x^7
+struct ExpTaylor {
+  static constexpr float kCoefficients[] = {1.0f,
+                                            1.0f,
+                                            1.0f / 2.0f,
+                                            1.0f / 6.0f,
+                                            1.0f / 24.0f,
+                                            1.0f / 120.0f,
+                                            1.0f / 720.0f,
+                                            1.0f / 5040.0f};
+};
+
+struct Quadratic {
+  static constexpr float kCoefficients[] = {1.0f, -2.0f, 0.5f};
+};
+
+struct Constant {
+  static constexpr float kCoefficients[] = {3.0f};
+};
+
+/// @brief tanh(x) [3/2] Pade approximant: x (27 + x^2) / (27 + 9 x^2)
+struct TanhNumerator {
+  static constexpr float kCoefficients[] = {0.0f, 27.0f, 0.0f, 1.0f};
+};
+
+struct TanhDenominator {
+  static constexpr float kCoefficients[] = {27.0f, 0.0f, 9.0f};
+};
+
+/// @brief Three segments: x^2 on [-1 ; 0], x on [0 ; 1], 1 on [1 ; 2]
+struct Pieces {
+  static constexpr float kKnots[] = {-1.0f, 0.0f, 1.0f, 2.0f};
+  static constexpr float kCoefficients[] = {1.0f, -2.0f, 1.0f,
+                                            0.0f, 1.0f, 0.0f,
+                                            1.0f, 0.0f, 0.0f};
+};
+
+// Definitions required by the runtime-indexed reference implementation
+constexpr float ExpTaylor::kCoefficients[];
+constexpr float Quadratic::kCoefficients[];
+
+static_assert(Polynomial<Quadratic>::Evaluate(2.0f) == -1.0f,
+              "Compile-time evaluation");
+static_assert(Polynomial<ExpTaylor>::kDegree == 7, "Degree");
+static_assert(Spline<Pieces>::kSegments == 3, "Segments count");
+static_assert(Spline<Pieces>::kOrder == 3, "Segments order");
+
+template <typename Table>
+static double ReferencePolynomial(const double input) {
+  double output(0.0);
+  const unsigned int count(sizeof(Table::kCoefficients) / sizeof(float));
+  for (unsigned int i(count); i > 0; --i) {
+    output = output * input + Table::kCoefficients[i - 1];
+  }
+  return output;
+}
+
+static float ReferencePieces(const float input) {
+  if (input < 0.0f) {
+    return input * input;
+  } else if (input < 1.0f) {
+    return input;
+  }
+  return 1.0f;
+}
+
+TEST(Polynomial, HornerAndEstrin) {
+  std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+  for (unsigned int j(0); j < 256; ++j) {
+    const float value(distribution(kRandomGenerator));
+    const PlatformVectorMath::FloatVec input(PlatformVectorMath::Fill(value));
+    const float expected_exp(
+      static_cast<float>(ReferencePolynomial<ExpTaylor>(value)));
+    EXPECT_NEAR(expected_exp,
+                PlatformVectorMath::GetByIndex<0>(
+                  Polynomial<ExpTaylor>::EvaluateHorner(input)),
+                kPolynomialTolerance * 8.0f);
+    EXPECT_NEAR(expected_exp,
+                PlatformVectorMath::GetByIndex<0>(
+                  Polynomial<ExpTaylor>::EvaluateEstrin(input)),
+                kPolynomialTolerance * 8.0f);
+    EXPECT_NEAR(expected_exp, Polynomial<ExpTaylor>::Evaluate(value),
+                kPolynomialTolerance * 8.0f);
+    const float expected_quadratic(
+      static_cast<float>(ReferencePolynomial<Quadratic>(value)));
+    EXPECT_NEAR(expected_quadratic,
+                PlatformVectorMath::GetByIndex<0>(
+                  Polynomial<Quadratic>::EvaluateEstrin(input)),
+                kPolynomialTolerance);
+    EXPECT_NEAR(expected_quadratic,
+                PlatformVectorMath::GetByIndex<0>(
+                  Polynomial<Quadratic>::Evaluate(input)),
+                kPolynomialTolerance);
+    EXPECT_EQ(3.0f, PlatformVectorMath::GetByIndex<0>(
+                      Polynomial<Constant>::Evaluate(input)));
+  }
+}
+
+TEST(Polynomial, Rational) {
+  typedef Rational<TanhNumerator, TanhDenominator> PadeTanh;
+  std::uniform_real_distribution<float> distribution(-3.0f, 3.0f);
+  for (unsigned int j(0); j < 256; ++j) {
+    const float value(distribution(kRandomGenerator));
+    const float expected(value * (27.0f + value * value)
+                         / (27.0f + 9.0f * value * value));
+    EXPECT_NEAR(expected,
+                PlatformVectorMath::GetByIndex<0>(
+                  PadeTanh::Evaluate(PlatformVectorMath::Fill(value))),
+                kPolynomialTolerance);
+    EXPECT_NEAR(expected, PadeTanh::Evaluate(value), kPolynomialTolerance);
+  }
+}
+
+TEST(Polynomial, Spline) {
+  // Each element within a different segment, plus extrapolated ones
+  const float kInputs[] = {-1.5f, -0.5f, 0.0f, 0.25f,
+                           0.999f, 1.0f, 1.5f, 3.0f};
+  for (unsigned int j(0); j < sizeof(kInputs) / sizeof(kInputs[0]);
+       j += PlatformVectorMath::FloatVecSize) {
+    const PlatformVectorMath::FloatVec output(Spline<Pieces>::Evaluate(
+      PlatformVectorMath::Fill(&kInputs[j])));
+    for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+      EXPECT_NEAR(ReferencePieces(kInputs[i + j]),
+                  PlatformVectorMath::GetByIndex(output, i),
+                  kPolynomialTolerance);
+    }
+  }
+}
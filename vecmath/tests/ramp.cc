@@ -0,0 +1,151 @@
+/// @file tests/ramp.cc
+/// @brief Ramps, gain ramps and crossfades tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <cmath>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/ramp.h"
+
+using vecmath::AlignedVector;
+using vecmath::PlatformVectorMath;
+using vecmath::RampVectorMath;
+using vecmath::SmoothedValue;
+
+static const float kRampTolerance = 1e-5f;
+static const double kRampHalfPi = 1.5707963267948966;
+
+TEST(Ramp, QuarterSine) {
+  for (unsigned int i(0); i <= 1024; ++i) {
+    const float progress(static_cast<float>(i) / 1024.0f);
+    const PlatformVectorMath::FloatVec input(
+      PlatformVectorMath::Fill(progress));
+    PlatformVectorMath::FloatVec fade_out;
+    PlatformVectorMath::FloatVec fade_in;
+    RampVectorMath::EqualPowerGains(input, &fade_out, &fade_in);
+    EXPECT_NEAR(std::sin(kRampHalfPi * progress),
+                PlatformVectorMath::GetByIndex<0>(fade_in),
+                2e-7);
+    EXPECT_NEAR(std::cos(kRampHalfPi * progress),
+                PlatformVectorMath::GetByIndex<0>(fade_out),
+                2e-7);
+  }
+}
+
+TEST(Ramp, StatelessKernels) {
+  const unsigned int kLength(128);
+  AlignedVector<float> from(kLength);
+  AlignedVector<float> to(kLength);
+  AlignedVector<float> output(kLength);
+  for (unsigned int i(0); i < kLength; ++i) {
+    from[i] = kNormDistribution(kRandomGenerator);
+    to[i] = kNormDistribution(kRandomGenerator);
+  }
+  RampVectorMath::ApplyGainRamp(&from[0], &output[0], kLength, 0.5f, -1.0f);
+  for (unsigned int i(0); i < kLength; ++i) {
+    const float gain(0.5f - 1.5f * static_cast<float>(i + 1) / kLength);
+    EXPECT_NEAR(from[i] * gain, output[i], kRampTolerance);
+  }
+  RampVectorMath::CrossfadeLinear(&from[0], &to[0], &output[0], kLength);
+  for (unsigned int i(0); i < kLength; ++i) {
+    const float progress(static_cast<float>(i + 1) / kLength);
+    EXPECT_NEAR(from[i] * (1.0f - progress) + to[i] * progress,
+                output[i],
+                kRampTolerance);
+  }
+  RampVectorMath::CrossfadeEqualPower(&from[0], &to[0], &output[0], kLength);
+  for (unsigned int i(0); i < kLength; ++i) {
+    const double angle(kRampHalfPi * (i + 1) / kLength);
+    EXPECT_NEAR(from[i] * std::cos(angle) + to[i] * std::sin(angle),
+                output[i],
+                kRampTolerance);
+  }
+}
+
+TEST(Ramp, SmoothedLinear) {
+  const unsigned int kRampLength(100);
+  SmoothedValue value(SmoothedValue::kLinear, 0.0f);
+  value.SetTarget(2.0f, kRampLength);
+  AlignedVector<float> output(160);
+  // Split in blocks: the ramp state must carry over
+  for (unsigned int i(0); i < output.size(); i += 32) {
+    value.Generate(&output[i], 32);
+  }
+  for (unsigned int i(0); i < output.size(); ++i) {
+    const float expected(2.0f * std::min(1.0f, (i + 1.0f) / kRampLength));
+    EXPECT_NEAR(expected, output[i], kRampTolerance);
+  }
+  EXPECT_FALSE(value.IsSmoothing());
+  EXPECT_EQ(2.0f, value.Current());
+}
+
+TEST(Ramp, SmoothedExponential) {
+  const unsigned int kRampLength(64);
+  SmoothedValue value(SmoothedValue::kExponential, 0.1f);
+  value.SetTarget(1.0f, kRampLength);
+  AlignedVector<float> input(128, 1.0f);
+  AlignedVector<float> output(128);
+  value.ApplyGainRamp(&input[0], &output[0], 32);
+  EXPECT_TRUE(value.IsSmoothing());
+  EXPECT_NEAR(0.1 * std::pow(10.0, 32.0 / kRampLength), value.Current(),
+              kRampTolerance);
+  value.ApplyGainRamp(&input[32], &output[32], 96);
+  for (unsigned int i(0); i < output.size(); ++i) {
+    const double expected(
+      0.1 * std::pow(10.0, std::min(1.0, (i + 1.0) / kRampLength)));
+    EXPECT_NEAR(expected, output[i], expected * kRampTolerance);
+  }
+  // Down to zero: -100dB reached, then exactly zero
+  value.SetTarget(0.0f, 32);
+  value.Generate(&output[0], 64);
+  EXPECT_NEAR(1e-5f, output[31], 1e-9f);
+  EXPECT_EQ(0.0f, output[32]);
+}
+
+TEST(Ramp, SmoothedEqualPower) {
+  const unsigned int kRampLength(48);
+  SmoothedValue value(SmoothedValue::kEqualPower, 1.0f);
+  value.SetTarget(0.0f, kRampLength);
+  AlignedVector<float> output(64);
+  value.Generate(&output[0], 64);
+  for (unsigned int i(0); i < output.size(); ++i) {
+    const double progress(std::min(1.0, (i + 1.0) / kRampLength));
+    EXPECT_NEAR(1.0 - std::sin(kRampHalfPi * progress),
+                output[i],
+                kRampTolerance);
+  }
+}
+
+TEST(Ramp, Retarget) {
+  SmoothedValue value(SmoothedValue::kLinear, 0.0f);
+  value.SetTarget(1.0f, 64);
+  AlignedVector<float> output(64);
+  value.Generate(&output[0], 16);
+  const float reached(value.Current());
+  EXPECT_NEAR(output[15], reached, kRampTolerance);
+  // The new ramp starts from the value reached
+  value.SetTarget(-1.0f, 32);
+  value.Generate(&output[16], 48);
+  EXPECT_NEAR(reached + (-1.0f - reached) / 32.0f, output[16], kRampTolerance);
+  EXPECT_NEAR(-1.0f, output[47], kRampTolerance);
+  EXPECT_EQ(-1.0f, output[63]);
+}
@@ -0,0 +1,210 @@
+/// @file tests/resampler.cc
+/// @brief Sample rate converter tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <cmath>
+#include <vector>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/filter_design.h"
+#include "vecmath/inc/resampler.h"
+
+using vecmath::FilterDesign;
+using vecmath::Resampler;
+
+static const double kResamplerTwoPi = 6.283185307179586;
+
+/// @brief Resample a sine wave of the given frequency,
+/// return the output signal to noise ratio in dB
+static double SineSNR(const double input_rate,
+                      const double output_rate,
+                      const Resampler::Quality quality,
+                      const double frequency) {
+  const unsigned int kInputLength(16384);
+  Resampler resampler(input_rate, output_rate, kInputLength, quality);
+  std::vector<float> input(kInputLength);
+  for (unsigned int i(0); i < kInputLength; ++i) {
+    input[i] = static_cast<float>(
+      std::sin(kResamplerTwoPi * frequency * i / input_rate));
+  }
+  std::vector<float> output(resampler.MaxOutputCount(kInputLength));
+  const unsigned int produced(resampler.Process(&input[0],
+                                                kInputLength,
+                                                &output[0],
+                                                output.size()));
+  // Skip the outputs computed from the initial null history
+  const unsigned int skip(static_cast<unsigned int>(
+    std::ceil(resampler.Taps() * output_rate / input_rate)));
+  double signal(0.0);
+  double noise(0.0);
+  for (unsigned int j(skip); j < produced; ++j) {
+    const double expected(std::sin(kResamplerTwoPi * frequency * j
+                                   / output_rate));
+    signal += expected * expected;
+    noise += (output[j] - expected) * (output[j] - expected);
+  }
+  return 10.0 * std::log10(signal / noise);
+}
+
+TEST(Resampler, FilterDesign) {
+  EXPECT_DOUBLE_EQ(1.0, FilterDesign::BesselI0(0.0));
+  EXPECT_NEAR(1.2660658777520082, FilterDesign::BesselI0(1.0), 1e-14);
+  EXPECT_NEAR(2815.716628466254, FilterDesign::BesselI0(10.0), 1e-8);
+  EXPECT_DOUBLE_EQ(0.0, FilterDesign::KaiserBeta(20.0));
+  EXPECT_NEAR(0.1102 * (100.0 - 8.7), FilterDesign::KaiserBeta(100.0), 1e-12);
+  const double kBeta(FilterDesign::KaiserBeta(90.0));
+  EXPECT_DOUBLE_EQ(1.0, FilterDesign::Kaiser(0.0, 8.0, kBeta));
+  EXPECT_DOUBLE_EQ(0.0, FilterDesign::Kaiser(8.0, 8.0, kBeta));
+  EXPECT_DOUBLE_EQ(FilterDesign::Kaiser(-3.5, 8.0, kBeta),
+                   FilterDesign::Kaiser(3.5, 8.0, kBeta));
+  // A lowpass filter DC gain is the sum of its taps
+  double sum(0.0);
+  for (int i(-32); i <= 32; ++i) {
+    sum += FilterDesign::WindowedSinc(i, 0.25, 32.0, kBeta);
+  }
+  EXPECT_NEAR(1.0, sum, 1e-4);
+}
+
+TEST(Resampler, PolyphaseQuality) {
+  const double kRates[][2] = {{44100.0, 48000.0},
+                              {48000.0, 44100.0},
+                              {48000.0, 96000.0},
+                              {96000.0, 48000.0}};
+  const Resampler::Quality kQualities[] = {Resampler::kLow,
+                                           Resampler::kMedium,
+                                           Resampler::kHigh,
+                                           Resampler::kBest};
+  const double kMinimumSNR[] = {60.0, 85.0, 105.0, 120.0};
+  for (const auto& rates : kRates) {
+    for (unsigned int i(0); i < 4; ++i) {
+      EXPECT_LT(kMinimumSNR[i],
+                SineSNR(rates[0], rates[1], kQualities[i], 997.0))
+        << rates[0] << " -> " << rates[1] << " quality " << kQualities[i];
+    }
+  }
+}
+
+TEST(Resampler, InterpolatedQuality) {
+  // Low frequency sine wave, as for modulation signals
+  EXPECT_LT(80.0, SineSNR(48000.0, 44100.0, Resampler::kLinear, 100.0));
+  EXPECT_LT(120.0, SineSNR(48000.0, 44100.0, Resampler::kCubic, 100.0));
+}
+
+TEST(Resampler, Streaming) {
+  const Resampler::Quality kQualities[] = {Resampler::kLinear,
+                                           Resampler::kCubic,
+                                           Resampler::kMedium};
+  const unsigned int kInputLength(8192);
+  std::vector<float> input(kInputLength);
+  for (float& value : input) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  std::uniform_int_distribution<unsigned int> block_lengths(1, 300);
+  for (const Resampler::Quality quality : kQualities) {
+    Resampler whole(44100.0, 48000.0, kInputLength, quality);
+    // Outputs left for later keep their inputs buffered as well
+    Resampler blocks(44100.0, 48000.0, kInputLength, quality);
+    std::vector<float> expected(whole.MaxOutputCount(kInputLength));
+    const unsigned int expected_count(whole.Process(&input[0],
+                                                    kInputLength,
+                                                    &expected[0],
+                                                    expected.size()));
+    // 48000 / 44100 outputs per input, minus the latency
+    EXPECT_NEAR((kInputLength - whole.Latency()) * 48000.0 / 44100.0,
+                expected_count,
+                2.0);
+    std::vector<float> output(expected.size());
+    unsigned int input_index(0);
+    unsigned int output_index(0);
+    while (input_index < kInputLength) {
+      const unsigned int length(std::min(block_lengths(kRandomGenerator),
+                                         kInputLength - input_index));
+      // Small output capacity as well, the remainder being kept for later
+      output_index += blocks.Process(&input[input_index],
+                                     length,
+                                     &output[output_index],
+                                     std::min(length,
+                                              static_cast<unsigned int>(
+                                                output.size() - output_index)));
+      input_index += length;
+    }
+    output_index += blocks.Process(&input[0],
+                                   0,
+                                   &output[output_index],
+                                   output.size() - output_index);
+    ASSERT_EQ(expected_count, output_index);
+    for (unsigned int j(0); j < expected_count; ++j) {
+      EXPECT_EQ(expected[j], output[j]);
+    }
+  }
+}
+
+TEST(Resampler, InterpolatedRamp) {
+  // Linear and cubic interpolations are exact on a ramp
+  const Resampler::Quality kQualities[] = {Resampler::kLinear,
+                                           Resampler::kCubic};
+  const unsigned int kInputLength(1024);
+  std::vector<float> input(kInputLength);
+  for (unsigned int i(0); i < kInputLength; ++i) {
+    input[i] = 0.01f * i;
+  }
+  for (const Resampler::Quality quality : kQualities) {
+    Resampler resampler(48000.0, 44100.0, kInputLength, quality);
+    std::vector<float> output(resampler.MaxOutputCount(kInputLength));
+    const unsigned int produced(resampler.Process(&input[0],
+                                                  kInputLength,
+                                                  &output[0],
+                                                  output.size()));
+    for (unsigned int j(2); j < produced; ++j) {
+      EXPECT_NEAR(0.01 * j * 48000.0 / 44100.0, output[j], 1e-4);
+    }
+  }
+}
+
+TEST(Resampler, InputOverflow) {
+  // Blocks longer than the history are truncated, never overflow it
+  const unsigned int kMaxInputCount(64);
+  const unsigned int kInputLength(1024);
+  std::vector<float> input(kInputLength);
+  for (float& value : input) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  Resampler resampler(44100.0, 48000.0, kMaxInputCount, Resampler::kMedium);
+  Resampler truncated(44100.0, 48000.0, kInputLength, Resampler::kMedium);
+  const unsigned int available(resampler.InputAvailable());
+  EXPECT_LE(kMaxInputCount, available);
+  EXPECT_GT(kInputLength, available);
+  std::vector<float> output(resampler.MaxOutputCount(kInputLength));
+  std::vector<float> expected(output.size());
+  const unsigned int produced(resampler.Process(&input[0],
+                                                kInputLength,
+                                                &output[0],
+                                                output.size()));
+  ASSERT_EQ(truncated.Process(&input[0],
+                              available,
+                              &expected[0],
+                              expected.size()),
+            produced);
+  for (unsigned int j(0); j < produced; ++j) {
+    EXPECT_EQ(expected[j], output[j]);
+  }
+  EXPECT_LE(kMaxInputCount, resampler.InputAvailable());
+}
@@ -0,0 +1,163 @@
+/// @file tests/ringbuffer.cc
+/// @brief Lock-free ring buffers tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <thread>
+#include <vector>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/ringbuffer.h"
+
+using vecmath::AlignedVector;
+using vecmath::IsAligned;
+using vecmath::MpscRingBuffer;
+using vecmath::PlatformVectorMath;
+using vecmath::RingBuffer;
+
+static const unsigned int kRingVectors = 64;
+static const unsigned int kRingTotal = 1 << 18;
+
+TEST(RingBuffer, RegionsWrapAround) {
+  const unsigned int kSize(PlatformVectorMath::FloatVecSize);
+  RingBuffer buffer(kRingVectors - 3);
+  EXPECT_EQ(kRingVectors * kSize, buffer.Capacity());
+  EXPECT_EQ(buffer.Capacity(), buffer.WriteAvailable());
+  EXPECT_EQ(0u, buffer.ReadAvailable());
+
+  AlignedVector<float> input(buffer.Capacity());
+  AlignedVector<float> output(buffer.Capacity());
+  for (unsigned int i(0); i < input.size(); ++i) {
+    input[i] = static_cast<float>(i);
+  }
+  // Move the indices close to the end
+  const unsigned int kOffset(buffer.Capacity() - 2 * kSize);
+  EXPECT_EQ(kOffset, buffer.Write(&input[0], kOffset));
+  EXPECT_EQ(kOffset, buffer.Read(&output[0], kOffset));
+
+  const RingBuffer::WriteRegion region(buffer.BeginWrite());
+  EXPECT_EQ(buffer.Capacity(), region.Length());
+  EXPECT_EQ(2 * kSize, region.first_length);
+  EXPECT_TRUE(IsAligned(region.first, PlatformVectorMath::FloatVecSizeBytes));
+  EXPECT_TRUE(IsAligned(region.second, PlatformVectorMath::FloatVecSizeBytes));
+  for (unsigned int i(0); i < region.first_length; ++i) {
+    region.first[i] = input[i];
+  }
+  for (unsigned int i(0); i < 2 * kSize; ++i) {
+    region.second[i] = input[region.first_length + i];
+  }
+  buffer.CommitWrite(4 * kSize);
+  EXPECT_EQ(4 * kSize, buffer.ReadAvailable());
+
+  // Full: writes are truncated
+  EXPECT_EQ(buffer.Capacity() - 4 * kSize,
+            buffer.Write(&input[0], buffer.Capacity()));
+  EXPECT_EQ(0u, buffer.WriteAvailable());
+  EXPECT_EQ(buffer.Capacity(), buffer.Read(&output[0], buffer.Capacity()));
+  for (unsigned int i(0); i < 4 * kSize; ++i) {
+    EXPECT_EQ(input[i], output[i]);
+  }
+  for (unsigned int i(4 * kSize); i < buffer.Capacity(); ++i) {
+    EXPECT_EQ(input[i - 4 * kSize], output[i]);
+  }
+  EXPECT_EQ(0u, buffer.ReadAvailable());
+}
+
+TEST(RingBuffer, ProducerConsumer) {
+  const unsigned int kBlock(4 * PlatformVectorMath::FloatVecSize);
+  RingBuffer buffer(kRingVectors);
+  std::thread producer([&buffer, kBlock]() {
+    AlignedVector<float> block(kBlock);
+    unsigned int written(0);
+    while (written < kRingTotal) {
+      for (unsigned int i(0); i < kBlock; ++i) {
+        block[i] = static_cast<float>(written + i);
+      }
+      // Short writes are resumed from where they stopped
+      unsigned int done(0);
+      while (done < kBlock) {
+        done += buffer.Write(&block[done], kBlock - done);
+      }
+      written += kBlock;
+    }
+  });
+  AlignedVector<float> output(3 * kBlock);
+  unsigned int read(0);
+  unsigned int errors(0);
+  while (read < kRingTotal) {
+    const unsigned int count(buffer.Read(&output[0], 3 * kBlock));
+    for (unsigned int i(0); i < count; ++i) {
+      errors += output[i] == static_cast<float>(read + i) ? 0 : 1;
+    }
+    read += count;
+  }
+  producer.join();
+  EXPECT_EQ(kRingTotal, read);
+  EXPECT_EQ(0u, errors);
+}
+
+TEST(MpscRingBuffer, Producers) {
+  const unsigned int kProducers(3);
+  const unsigned int kBlocksPerProducer(4096);
+  const unsigned int kBlock(2 * PlatformVectorMath::FloatVecSize);
+  MpscRingBuffer buffer(kBlock, 15);
+  EXPECT_EQ(16u, buffer.BlockCount());
+  std::vector<std::thread> producers;
+  for (unsigned int producer(0); producer < kProducers; ++producer) {
+    producers.push_back(std::thread([&buffer, producer, kBlock]() {
+      for (unsigned int block(0); block < kBlocksPerProducer; ++block) {
+        // Zero-copy push: each block holds (producer, block number, ...)
+        while (!buffer.Push([producer, block, kBlock](float* data) {
+                 for (unsigned int i(0); i < kBlock; ++i) {
+                   data[i] = static_cast<float>(i == 0 ? producer : block);
+                 }
+               })) {
+          std::this_thread::yield();
+        }
+      }
+    }));
+  }
+  std::vector<unsigned int> next(kProducers, 0);
+  AlignedVector<float> output(kBlock);
+  unsigned int errors(0);
+  for (unsigned int received(0);
+       received < kProducers * kBlocksPerProducer;
+       ++received) {
+    while (!buffer.Pop(&output[0])) {
+      std::this_thread::yield();
+    }
+    const unsigned int producer(static_cast<unsigned int>(output[0]));
+    ASSERT_LT(producer, kProducers);
+    // Blocks from a given producer come in order
+    for (unsigned int i(1); i < kBlock; ++i) {
+      errors += output[i] == static_cast<float>(next[producer]) ? 0 : 1;
+    }
+    next[producer] += 1;
+  }
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(0u, errors);
+  EXPECT_EQ(nullptr, buffer.Front());
+  for (unsigned int producer(0); producer < kProducers; ++producer) {
+    EXPECT_EQ(kBlocksPerProducer, next[producer]);
+  }
+}
@@ -0,0 +1,114 @@
+/// @file tests/scan.cc
+/// @brief Prefix scans tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <algorithm>
+#include <vector>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/scan.h"
+
+using vecmath::AlignedVector;
+using vecmath::MovingAverage;
+using vecmath::PlatformVectorMath;
+using vecmath::ScanVectorMath;
+
+static const float kScanTolerance = 1e-5f;
+
+TEST(Scan, PrefixScans) {
+  alignas(16) float input[PlatformVectorMath::FloatVecSize];
+  for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+    input[i] = kNormDistribution(kRandomGenerator);
+  }
+  const PlatformVectorMath::FloatVec vec(PlatformVectorMath::Fill(input));
+  const PlatformVectorMath::FloatVec sum(ScanVectorMath::PrefixSum(vec));
+  const PlatformVectorMath::FloatVec exclusive(
+    ScanVectorMath::PrefixSumExclusive(vec));
+  const PlatformVectorMath::FloatVec max(ScanVectorMath::PrefixMax(vec));
+  const PlatformVectorMath::FloatVec min(ScanVectorMath::PrefixMin(vec));
+  float expected_sum(0.0f);
+  float expected_max(input[0]);
+  float expected_min(input[0]);
+  for (unsigned int i(0); i < PlatformVectorMath::FloatVecSize; ++i) {
+    EXPECT_NEAR(expected_sum, PlatformVectorMath::GetByIndex(exclusive, i),
+                kScanTolerance);
+    expected_sum += input[i];
+    expected_max = std::max(expected_max, input[i]);
+    expected_min = std::min(expected_min, input[i]);
+    EXPECT_NEAR(expected_sum, PlatformVectorMath::GetByIndex(sum, i),
+                kScanTolerance);
+    EXPECT_EQ(expected_max, PlatformVectorMath::GetByIndex(max, i));
+    EXPECT_EQ(expected_min, PlatformVectorMath::GetByIndex(min, i));
+  }
+}
+
+TEST(Scan, CumulativeSumCarry) {
+  const unsigned int kLength(64);
+  AlignedVector<float> input(2 * kLength);
+  AlignedVector<float> output(2 * kLength);
+  for (float& value : input) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  // Two blocks, chained through the returned carry
+  const float carry(ScanVectorMath::CumulativeSum(&input[0], &output[0],
+                                                  kLength, 1.0f));
+  const float total(ScanVectorMath::CumulativeSum(&input[kLength],
+                                                  &output[kLength],
+                                                  kLength, carry));
+  float expected(1.0f);
+  for (unsigned int i(0); i < 2 * kLength; ++i) {
+    expected += input[i];
+    EXPECT_NEAR(expected, output[i], kScanTolerance);
+  }
+  EXPECT_NEAR(expected, total, kScanTolerance);
+}
+
+TEST(Scan, MovingAverage) {
+  const unsigned int kBlockLength(32);
+  const unsigned int kBlocks(16);
+  const unsigned int kWindowLengths[] = {1, 3, 4, 17, 64, 100};
+  std::vector<float> signal(kBlockLength * kBlocks);
+  for (float& value : signal) {
+    value = kNormDistribution(kRandomGenerator);
+  }
+  for (unsigned int window : kWindowLengths) {
+    MovingAverage average(window);
+    AlignedVector<float> input(kBlockLength);
+    AlignedVector<float> output(kBlockLength);
+    for (unsigned int block(0); block < kBlocks; ++block) {
+      std::copy(&signal[block * kBlockLength],
+                &signal[(block + 1) * kBlockLength],
+                input.begin());
+      average.Process(&input[0], &output[0], kBlockLength);
+      for (unsigned int i(0); i < kBlockLength; ++i) {
+        const unsigned int index(block * kBlockLength + i);
+        float expected(0.0f);
+        for (unsigned int j(index + 1 > window ? index + 1 - window : 0);
+             j <= index;
+             ++j) {
+          expected += signal[j];
+        }
+        EXPECT_NEAR(expected / window, output[i], kScanTolerance)
+          << "window " << window << ", sample " << index;
+      }
+    }
+  }
+}
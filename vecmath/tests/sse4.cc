@@ -0,0 +1,100 @@
+/// @file tests/sse4.cc
+/// @brief Vecmath tests - SSE4.1 tier (built with SSE4.1 enabled)
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include "vecmath/tests/tests.h"
+
+#if _VEC_USE_SSE4
+
+TEST(ParitySSE4, Rounding) {
+  for (float value : kRoundingValues) {
+    const StdFloatVec std_input = StandardVectorMath::Fill(value);
+    const SSE2FloatVec sse4_input = SSE4VectorMath::Fill(value);
+    EXPECT_EQ_SAMPLES(StandardVectorMath::Round(std_input),
+                      SSE4VectorMath::Round(sse4_input));
+    EXPECT_EQ_SAMPLES(StandardVectorMath::Trunc(std_input),
+                      SSE4VectorMath::Trunc(sse4_input));
+    EXPECT_EQ_SAMPLES(StandardVectorMath::Floor(std_input),
+                      SSE4VectorMath::Floor(sse4_input));
+    EXPECT_EQ_SAMPLES(StandardVectorMath::Ceil(std_input),
+                      SSE4VectorMath::Ceil(sse4_input));
+  }
+}
+
+TEST(ParitySSE4, Select) {
+  const SSE2FloatVec input = SSE4VectorMath::Fill(-1.0f, 2.0f, -3.0f, 4.0f);
+  const SSE2FloatVec mask = SSE4VectorMath::GreaterThan(
+    SSE4VectorMath::Fill(0.0f), input);
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(-1.0f, 0.5f, -3.0f, 0.5f),
+                    SSE4VectorMath::Select(mask, input,
+                                           SSE4VectorMath::Fill(0.5f)));
+}
+
+TEST(ParitySSE4, BlendAndCompress) {
+  const SSE2FloatVec left = SSE4VectorMath::Fill(1.0f, 2.0f, 3.0f, 4.0f);
+  const SSE2FloatVec right = SSE4VectorMath::Fill(5.0f, 6.0f, 7.0f, 8.0f);
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(5.0f, 2.0f, 7.0f, 4.0f),
+                    SSE4VectorMath::Blend<5>(left, right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(1.0f, 2.0f, 7.0f, 8.0f),
+                    SSE4VectorMath::Blend<12>(left, right));
+  for (unsigned bits(0); bits < 16; ++bits) {
+    const SSE2FloatVec mask = SSE4VectorMath::GreaterThan(
+      SSE4VectorMath::Fill((bits & 1) ? 1.0f : -1.0f,
+                           (bits & 2) ? 1.0f : -1.0f,
+                           (bits & 4) ? 1.0f : -1.0f,
+                           (bits & 8) ? 1.0f : -1.0f),
+      SSE4VectorMath::Fill(0.0f));
+    EXPECT_EQ(bits, SSE4VectorMath::MoveMask(mask));
+    float sse2_output[4] = {0.0f};
+    float sse4_output[4] = {0.0f};
+    const unsigned int sse2_count(
+      SSE2VectorMath::CompressStore(sse2_output, mask, left));
+    const unsigned int sse4_count(
+      SSE4VectorMath::CompressStore(sse4_output, mask, left));
+    EXPECT_EQ(sse2_count, sse4_count);
+    for (unsigned j(0); j < sse2_count; ++j) {
+      EXPECT_EQ(sse2_output[j], sse4_output[j]);
+    }
+  }
+}
+
+TEST(ParitySSE4, GetSetByIndex) {
+  const SSE2FloatVec input = SSE4VectorMath::Fill(1.0f, 2.0f, 3.0f, 4.0f);
+  EXPECT_EQ(1.0f, SSE4VectorMath::GetByIndex<0>(input));
+  EXPECT_EQ(4.0f, SSE4VectorMath::GetByIndex<3>(input));
+  EXPECT_EQ(3, SSE4VectorMath::GetByIndex<2>(SSE4VectorMath::TruncToInt(input)));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::Fill(1.0f, 2.0f, 5.0f, 4.0f),
+                    SSE4VectorMath::SetByIndex<2>(input, 5.0f));
+}
+
+TEST(ParitySSE4, ComplexShuffles) {
+  const StdFloatVec std_left = StandardVectorMath::Fill(1.0f, 2.0f, 3.0f, 4.0f);
+  const StdFloatVec std_right = StandardVectorMath::Fill(5.0f, 6.0f, 7.0f, 8.0f);
+  const SSE2FloatVec sse4_left = SSE4VectorMath::Fill(1.0f, 2.0f, 3.0f, 4.0f);
+  const SSE2FloatVec sse4_right = SSE4VectorMath::Fill(5.0f, 6.0f, 7.0f, 8.0f);
+  EXPECT_EQ_SAMPLES(StandardVectorMath::AddSub(std_left, std_right),
+                    SSE4VectorMath::AddSub(sse4_left, sse4_right));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::DuplicateEven(std_left),
+                    SSE4VectorMath::DuplicateEven(sse4_left));
+  EXPECT_EQ_SAMPLES(StandardVectorMath::DuplicateOdd(std_left),
+                    SSE4VectorMath::DuplicateOdd(sse4_left));
+}
+
+#endif  // _VEC_USE_SSE4
@@ -24,6 +24,8 @@
 
 // std::generate
 #include <algorithm>
+// std::fabs
+#include <cmath>
 #include <random>
 // std::memcmp
 #include <string>
@@ -32,11 +34,17 @@
 
 #include "vecmath/inc/common.h"
 
+#include "vecmath/inc/platform/implem_generic.h"
 #include "vecmath/inc/platform/implem_std.h"
 #include "vecmath/inc/platform/implem_sse2.h"
+#include "vecmath/inc/platform/implem_sse4.h"
 
+using vecmath::GenericVectorMath;
 using vecmath::StandardVectorMath;
 using vecmath::SSE2VectorMath;
+#if _VEC_USE_SSE4
+using vecmath::SSE4VectorMath;
+#endif  // _VEC_USE_SSE4
 
 typedef vecmath::StandardVectorMath::FloatVec StdFloatVec;
 typedef vecmath::SSE2VectorMath::FloatVec SSE2FloatVec;
@@ -48,19 +56,36 @@ static std::bernoulli_distribution kBoolDistribution;
 
 static std::default_random_engine kRandomGenerator;
 
+// Rounding corner cases: halfway values, signed zeros, above 2^23, infinity
+static const float kRoundingValues[] = {
+  0.0f, -0.0f, 0.2f, -0.2f, 0.5f, -0.5f, 1.5f, -1.5f, 2.5f, -2.5f,
+  0.7f, -0.7f, 3.99f, -3.99f, 1e7f, -1e7f, 8388609.0f, -8388609.0f,
+  3e9f, -3e9f, 1e30f, -1e30f, INFINITY, -INFINITY
+};
+
 // For tests only
-void EXPECT_EQ_SAMPLES(const StdFloatVec & lhs, const SSE2FloatVec & rhs) {
+inline void EXPECT_EQ_SAMPLES(const StdFloatVec & lhs, const SSE2FloatVec & rhs) {
   EXPECT_EQ(vecmath::StandardVectorMath::GetByIndex<0>(lhs), vecmath::SSE2VectorMath::GetByIndex<0>(rhs));
   EXPECT_EQ(vecmath::StandardVectorMath::GetByIndex<1>(lhs), vecmath::SSE2VectorMath::GetByIndex<1>(rhs));
   EXPECT_EQ(vecmath::StandardVectorMath::GetByIndex<2>(lhs), vecmath::SSE2VectorMath::GetByIndex<2>(rhs));
   EXPECT_EQ(vecmath::StandardVectorMath::GetByIndex<3>(lhs), vecmath::SSE2VectorMath::GetByIndex<3>(rhs));
 }
 
-void EXPECT_EQ_SAMPLES(const SSE2FloatVec & lhs, const StdFloatVec & rhs) {
+inline void EXPECT_EQ_SAMPLES(const SSE2FloatVec & lhs, const StdFloatVec & rhs) {
   EXPECT_EQ(vecmath::SSE2VectorMath::GetByIndex<0>(lhs), vecmath::StandardVectorMath::GetByIndex<0>(rhs));
   EXPECT_EQ(vecmath::SSE2VectorMath::GetByIndex<1>(lhs), vecmath::StandardVectorMath::GetByIndex<1>(rhs));
   EXPECT_EQ(vecmath::SSE2VectorMath::GetByIndex<2>(lhs), vecmath::StandardVectorMath::GetByIndex<2>(rhs));
   EXPECT_EQ(vecmath::SSE2VectorMath::GetByIndex<3>(lhs), vecmath::StandardVectorMath::GetByIndex<3>(rhs));
 }
 
+inline void EXPECT_NEAR_RELATIVE_SAMPLES(const StdFloatVec & lhs,
+                                         const SSE2FloatVec & rhs,
+                                         const float relative_tolerance) {
+  for (unsigned i(0); i < StandardVectorMath::FloatVecSize; ++i) {
+    const float expected(vecmath::StandardVectorMath::GetByIndex(lhs, i));
+    const float actual(vecmath::SSE2VectorMath::GetByIndex(rhs, i));
+    EXPECT_NEAR(expected, actual, std::fabs(expected) * relative_tolerance);
+  }
+}
+
 #endif  // VECMATH_TESTS_TESTS_H_
@@ -0,0 +1,131 @@
+/// @file tests/validation.cc
+/// @brief Block health checks tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include <cmath>
+#include <cstring>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/validation.h"
+
+using vecmath::AlignedVector;
+using vecmath::PlatformVectorMath;
+using vecmath::ValidationVectorMath;
+
+static const unsigned int kValidationLength = 1024;
+
+// Built from bits: the compiler or the FPU might flush denormals
+static float FromBits(const unsigned int bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+class ValidationTest : public ::testing::Test {
+ protected:
+  ValidationTest()
+      : input_(kValidationLength) {
+    for (float& value : input_) {
+      value = kNormDistribution(kRandomGenerator);
+    }
+  }
+
+  AlignedVector<float> input_;
+};
+
+TEST_F(ValidationTest, NonFinite) {
+  EXPECT_FALSE(ValidationVectorMath::ContainsNonFinite(&input_[0],
+                                                       kValidationLength));
+  EXPECT_EQ(kValidationLength,
+            ValidationVectorMath::FirstNonFiniteIndex(&input_[0],
+                                                      kValidationLength));
+  // Denormals and large values are finite
+  input_[3] = FromBits(0x00000001u);
+  input_[5] = 3e38f;
+  EXPECT_FALSE(ValidationVectorMath::ContainsNonFinite(&input_[0],
+                                                       kValidationLength));
+  // Within the unrolled part, the tail, and both
+  const unsigned int kPositions[] = {0, 17, 513, kValidationLength - 1};
+  const unsigned int kBits[] = {0x7f800000u, 0xff800000u, 0x7fc00000u};
+  for (const unsigned int position : kPositions) {
+    for (const unsigned int bits : kBits) {
+      AlignedVector<float> corrupted(input_);
+      corrupted[position] = FromBits(bits);
+      corrupted[kValidationLength - 1] = FromBits(bits);
+      EXPECT_TRUE(ValidationVectorMath::ContainsNonFinite(&corrupted[0],
+                                                          kValidationLength));
+      EXPECT_EQ(position,
+                ValidationVectorMath::FirstNonFiniteIndex(&corrupted[0],
+                                                          kValidationLength));
+    }
+  }
+  // Shorter than an unrolled iteration
+  const unsigned int kShort(2 * PlatformVectorMath::FloatVecSize);
+  input_[kShort - 2] = FromBits(0x7fc00000u);
+  EXPECT_EQ(kShort - 2,
+            ValidationVectorMath::FirstNonFiniteIndex(&input_[0], kShort));
+}
+
+TEST_F(ValidationTest, CountDenormals) {
+  EXPECT_EQ(0u, ValidationVectorMath::CountDenormals(&input_[0],
+                                                     kValidationLength));
+  unsigned int expected(0);
+  for (unsigned int i(0); i < kValidationLength; i += 7) {
+    input_[i] = FromBits((i % 2 ? 0x80000000u : 0u) | (i + 1));
+    expected += 1;
+  }
+  // Neither zeros nor the smallest normal are denormals
+  input_[1] = 0.0f;
+  input_[2] = FromBits(0x80000000u);
+  input_[3] = FromBits(0x00800000u);
+  // Largest denormals
+  input_[4] = FromBits(0x007fffffu);
+  input_[5] = FromBits(0x807fffffu);
+  expected += 2;
+  EXPECT_EQ(expected, ValidationVectorMath::CountDenormals(&input_[0],
+                                                           kValidationLength));
+}
+
+TEST_F(ValidationTest, Compare) {
+  AlignedVector<float> other(input_);
+  EXPECT_TRUE(ValidationVectorMath::AllNear(&input_[0], &other[0],
+                                            kValidationLength, 0.0f));
+  EXPECT_EQ(0.0f, ValidationVectorMath::MaxAbsDifference(&input_[0], &other[0],
+                                                         kValidationLength));
+  other[kValidationLength - 3] += 0.25f;
+  other[100] -= 0.125f;
+  EXPECT_NEAR(0.25f,
+              ValidationVectorMath::MaxAbsDifference(&input_[0], &other[0],
+                                                     kValidationLength),
+              1e-6f);
+  EXPECT_TRUE(ValidationVectorMath::AllNear(&input_[0], &other[0],
+                                            kValidationLength, 0.2501f));
+  EXPECT_FALSE(ValidationVectorMath::AllNear(&input_[0], &other[0],
+                                             kValidationLength, 0.2f));
+  // Early exit on the first block
+  other[0] += 1.0f;
+  EXPECT_FALSE(ValidationVectorMath::AllNear(&input_[0], &other[0],
+                                             kValidationLength, 0.5f));
+  other[0] = FromBits(0x7fc00000u);
+  EXPECT_FALSE(ValidationVectorMath::AllNear(&input_[0], &other[0],
+                                             kValidationLength, 10.0f));
+}
@@ -0,0 +1,153 @@
+/// @file tests/waveshaper.cc
+/// @brief Oversampling and waveshaping tests
+/// @author gm
+/// @copyright gm 2017
+///
+/// This file is part of Vecmath
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///                    Version 2, December 2004
+///
+/// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+///
+/// Everyone is permitted to copy and distribute verbatim or modified
+/// copies of this license document, and changing it is allowed as long
+/// as the name is changed.
+///
+///            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+///   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+///
+///  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+
+#include <cmath>
+
+#include "vecmath/tests/tests.h"
+
+#include "vecmath/inc/allocator.h"
+#include "vecmath/inc/oversampling.h"
+#include "vecmath/inc/waveshaper.h"
+
+using vecmath::AlignedVector;
+using vecmath::HardClipShaper;
+using vecmath::Oversampler;
+using vecmath::PlatformVectorMath;
+using vecmath::PolynomialShaper;
+using vecmath::SoftClipShaper;
+using vecmath::TanhShaper;
+using vecmath::Waveshaper;
+
+static const unsigned int kShaperLength = 8192;
+static const unsigned int kShaperBlock = 256;
+static const double kShaperTwoPi = 6.283185307179586;
+
+struct IdentityShaper {
+  static inline PlatformVectorMath::FloatVec Apply(
+      PlatformVectorMath::FloatVecRead input) {
+    return input;
+  }
+};
+
+// x - x^3 / 4
+struct CubicTable {
+  static constexpr float kCoefficients[] = {0.0f, 1.0f, 0.0f, -0.25f};
+};
+
+constexpr float CubicTable::kCoefficients[];
+
+// Scalar shaper result
+template <typename Shaper>
+static float ShapeScalar(const float input) {
+  return PlatformVectorMath::GetByIndex<0>(
+    Shaper::Apply(PlatformVectorMath::Fill(input)));
+}
+
+// Magnitude of the given normalized frequency over 4800 samples
+static double Magnitude(const AlignedVector<float>& signal,
+                        const double frequency) {
+  double real(0.0);
+  double imaginary(0.0);
+  for (unsigned int i(1024); i < 1024 + 4800; ++i) {
+    real += signal[i] * std::cos(kShaperTwoPi * frequency * i);
+    imaginary += signal[i] * std::sin(kShaperTwoPi * frequency * i);
+  }
+  return std::sqrt(real * real + imaginary * imaginary);
+}
+
+TEST(Waveshaper, Shapers) {
+  for (float input(-4.0f); input <= 4.0f; input += 0.01f) {
+    const float clipped(std::min(1.0f, std::max(-1.0f, input)));
+    EXPECT_EQ(clipped, ShapeScalar<HardClipShaper>(input));
+    EXPECT_NEAR(1.5f * clipped - 0.5f * clipped * clipped * clipped,
+                ShapeScalar<SoftClipShaper>(input),
+                1e-6f);
+    EXPECT_NEAR(std::tanh(input), ShapeScalar<TanhShaper>(input), 1e-6f);
+    EXPECT_NEAR(input - 0.25f * input * input * input,
+                ShapeScalar<PolynomialShaper<CubicTable> >(input),
+                1e-5f);
+  }
+  EXPECT_NEAR(1.0f, ShapeScalar<TanhShaper>(100.0f), 1e-6f);
+  EXPECT_NEAR(-1.0f, ShapeScalar<TanhShaper>(-100.0f), 1e-6f);
+}
+
+class WaveshaperTest : public ::testing::TestWithParam<Oversampler::Factor> {};
+
+// With a linear shaper, the input is only delayed by the reported latency
+TEST_P(WaveshaperTest, Latency) {
+  Waveshaper<IdentityShaper> shaper(GetParam(), kShaperBlock);
+  EXPECT_EQ(1u << GetParam(), shaper.Ratio());
+  AlignedVector<float> input(kShaperLength);
+  AlignedVector<float> output(kShaperLength);
+  for (unsigned int i(0); i < kShaperLength; ++i) {
+    // Up to 0.38 times the sampling rate
+    input[i] = static_cast<float>(0.5 * std::sin(0.01 * i)
+                                  + 0.3 * std::sin(2.4 * i));
+  }
+  for (unsigned int i(0); i < kShaperLength; i += kShaperBlock) {
+    shaper.Process(&input[i], &output[i], kShaperBlock);
+  }
+  const unsigned int latency(shaper.Latency());
+  // After the filters transient
+  for (unsigned int i(latency + 256); i < kShaperLength; ++i) {
+    EXPECT_NEAR(input[i - latency], output[i], 1e-4f) << i;
+  }
+  // The same, in place, after a reset
+  shaper.Reset();
+  for (unsigned int i(0); i < kShaperLength; i += kShaperBlock) {
+    shaper.Process(&input[i], &input[i], kShaperBlock);
+  }
+  for (unsigned int i(0); i < kShaperLength; ++i) {
+    EXPECT_EQ(output[i], input[i]) << i;
+  }
+}
+
+// Hard clipping a 5kHz sine, 48kHz: its 9th harmonic aliases to 3kHz
+// unless oversampled
+TEST_P(WaveshaperTest, Aliasing) {
+  const double kFundamental(5000.0 / 48000.0);
+  const double kAlias(3000.0 / 48000.0);
+  Waveshaper<HardClipShaper> shaper(GetParam(), kShaperBlock);
+  shaper.SetDrive(1.5f);
+  AlignedVector<float> input(kShaperLength);
+  AlignedVector<float> direct(kShaperLength);
+  AlignedVector<float> output(kShaperLength);
+  for (unsigned int i(0); i < kShaperLength; ++i) {
+    input[i] = static_cast<float>(std::sin(kShaperTwoPi * kFundamental * i));
+    direct[i] = ShapeScalar<HardClipShaper>(1.5f * input[i]);
+  }
+  for (unsigned int i(0); i < kShaperLength; i += kShaperBlock) {
+    shaper.Process(&input[i], &output[i], kShaperBlock);
+  }
+  const double direct_alias(20.0 * std::log10(Magnitude(direct, kAlias)
+                                               / Magnitude(direct,
+                                                           kFundamental)));
+  const double alias(20.0 * std::log10(Magnitude(output, kAlias)
+                                        / Magnitude(output, kFundamental)));
+  EXPECT_LT(alias, direct_alias - 20.0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Factors,
+                         WaveshaperTest,
+                         ::testing::Values(Oversampler::k2x,
+                                           Oversampler::k4x,
+                                           Oversampler::k8x));